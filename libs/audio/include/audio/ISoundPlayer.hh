@@ -19,6 +19,7 @@
 #define WORKRAVE_AUDIO_ISOUNDPLAYER_HH
 
 #include <string>
+#include <vector>
 
 #include <memory>
 
@@ -43,6 +44,9 @@ namespace workrave::audio
     virtual bool capability(SoundCapability cap) = 0;
     virtual void restore_mute() = 0;
     virtual void play_sound(const std::string &wavfile, bool mute_after_playback, int volume) = 0;
+
+    //! Prepares the sound files that are likely to be played, so that they start without delay.
+    virtual void preload_sounds(const std::vector<std::string> &wavfiles) = 0;
   };
 
   class SoundPlayerFactory
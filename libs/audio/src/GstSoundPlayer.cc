@@ -21,11 +21,16 @@
 
 #include "debug.hh"
 
+#include <spdlog/spdlog.h>
+
 #include "GstSoundPlayer.hh"
 #include "ISoundPlayerEvents.hh"
 
 using namespace std;
 
+//! Time after the last preloaded sound after which the persistent pipeline is stopped.
+static constexpr guint PIPELINE_IDLE_TIMEOUT_MS = 5000;
+
 GstSoundPlayer::GstSoundPlayer()
 {
   GError *error = nullptr;
@@ -42,6 +47,8 @@ GstSoundPlayer::GstSoundPlayer()
 
 GstSoundPlayer::~GstSoundPlayer()
 {
+  destroy_pipeline();
+
   if (gst_ok)
     {
       gst_deinit();
@@ -52,6 +59,11 @@ void
 GstSoundPlayer::init(ISoundPlayerEvents *events)
 {
   this->events = events;
+
+  if (gst_ok)
+    {
+      create_pipeline();
+    }
 }
 
 bool
@@ -65,6 +77,326 @@ GstSoundPlayer::play_sound(std::string wavfile, int volume)
 {
   TRACE_ENTRY_PAR(wavfile, volume);
 
+  auto it = sounds.find(wavfile);
+  if (it != sounds.end() && play_preloaded_sound(it->second, volume))
+    {
+      return;
+    }
+
+  play_sound_uri(wavfile, volume);
+}
+
+//! Decodes the specified sound files. Previously decoded files that are not specified are dropped.
+void
+GstSoundPlayer::preload_sounds(const std::vector<std::string> &wavfiles)
+{
+  TRACE_ENTRY();
+  std::map<std::string, PcmSound::Ptr> preloaded;
+
+  for (const auto &wavfile: wavfiles)
+    {
+      if (wavfile.empty() || preloaded.find(wavfile) != preloaded.end())
+        {
+          continue;
+        }
+
+      auto it = sounds.find(wavfile);
+      PcmSound::Ptr sound = it != sounds.end() ? it->second : PcmSound::load(wavfile);
+
+      // Only mono and stereo sounds can be played without a channel mask.
+      if (sound != nullptr && sound->get_channels() <= 2 && !sound->get_samples().empty())
+        {
+          preloaded[wavfile] = sound;
+        }
+    }
+
+  TRACE_MSG("{} sounds preloaded", preloaded.size());
+  sounds.swap(preloaded);
+}
+
+int64_t
+GstSoundPlayer::get_last_latency_usec() const
+{
+  return last_latency;
+}
+
+//! Creates the persistent pipeline for preloaded sounds.
+/*!
+ *  The pipeline is only playing while preloaded sounds are played. It is
+ *  kept in the READY state otherwise, so that it does not hold a running
+ *  audio stream while there is nothing to play.
+ */
+void
+GstSoundPlayer::create_pipeline()
+{
+  TRACE_ENTRY();
+  GError *error = nullptr;
+
+  pipeline = gst_parse_launch(
+    "appsrc name=source is-live=true do-timestamp=true format=time ! audioconvert ! audioresample ! volume name=volume ! autoaudiosink name=sink",
+    &error);
+
+  if (error != nullptr)
+    {
+      spdlog::warn("Failed to create sound pipeline: {}", error->message);
+      g_error_free(error);
+      error = nullptr;
+    }
+
+  if (pipeline == nullptr)
+    {
+      return;
+    }
+
+  source = gst_bin_get_by_name(GST_BIN(pipeline), "source");
+  volume_element = gst_bin_get_by_name(GST_BIN(pipeline), "volume");
+  GstElement *sink = gst_bin_get_by_name(GST_BIN(pipeline), "sink");
+
+  if (source == nullptr || volume_element == nullptr || sink == nullptr)
+    {
+      if (sink != nullptr)
+        {
+          gst_object_unref(sink);
+        }
+      destroy_pipeline();
+      return;
+    }
+
+  GstPad *pad = gst_element_get_static_pad(sink, "sink");
+  if (pad != nullptr)
+    {
+      gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, on_sink_buffer, this, nullptr);
+      gst_object_unref(pad);
+    }
+  gst_object_unref(sink);
+
+  GstBus *bus = gst_pipeline_get_bus(GST_PIPELINE(pipeline));
+  pipeline_watch_id = gst_bus_add_watch(bus, pipeline_bus_watch, this);
+  gst_object_unref(bus);
+
+  if (gst_element_set_state(pipeline, GST_STATE_READY) == GST_STATE_CHANGE_FAILURE)
+    {
+      spdlog::warn("Failed to start sound pipeline");
+      destroy_pipeline();
+    }
+}
+
+void
+GstSoundPlayer::destroy_pipeline()
+{
+  TRACE_ENTRY();
+  if (done_timeout_id != 0)
+    {
+      g_source_remove(done_timeout_id);
+      done_timeout_id = 0;
+    }
+
+  if (idle_timeout_id != 0)
+    {
+      g_source_remove(idle_timeout_id);
+      idle_timeout_id = 0;
+    }
+
+  if (pipeline_watch_id != 0)
+    {
+      g_source_remove(pipeline_watch_id);
+      pipeline_watch_id = 0;
+    }
+
+  if (pipeline != nullptr)
+    {
+      gst_element_set_state(pipeline, GST_STATE_NULL);
+    }
+
+  if (source != nullptr)
+    {
+      gst_object_unref(source);
+      source = nullptr;
+    }
+
+  if (volume_element != nullptr)
+    {
+      gst_object_unref(volume_element);
+      volume_element = nullptr;
+    }
+
+  if (pipeline != nullptr)
+    {
+      gst_object_unref(pipeline);
+      pipeline = nullptr;
+    }
+}
+
+//! Plays a preloaded sound through the persistent pipeline.
+/*!
+ *  \return false if the sound cannot be played by the persistent pipeline.
+ */
+bool
+GstSoundPlayer::play_preloaded_sound(const PcmSound::Ptr &sound, int volume)
+{
+  TRACE_ENTRY_PAR(volume);
+
+  if (pipeline == nullptr || done_timeout_id != 0)
+    {
+      // Not available, or still playing the previous sound.
+      return false;
+    }
+
+  const char *format = nullptr;
+  switch (sound->get_bits_per_sample())
+    {
+    case 8:
+      format = "U8";
+      break;
+    case 16:
+      format = "S16LE";
+      break;
+    case 24:
+      format = "S24LE";
+      break;
+    case 32:
+      format = "S32LE";
+      break;
+    default:
+      return false;
+    }
+
+  GstCaps *caps = gst_caps_new_simple("audio/x-raw",
+                                      "format",
+                                      G_TYPE_STRING,
+                                      format,
+                                      "layout",
+                                      G_TYPE_STRING,
+                                      "interleaved",
+                                      "rate",
+                                      G_TYPE_INT,
+                                      sound->get_rate(),
+                                      "channels",
+                                      G_TYPE_INT,
+                                      sound->get_channels(),
+                                      NULL);
+  g_object_set(G_OBJECT(source), "caps", caps, NULL);
+  gst_caps_unref(caps);
+
+  if (idle_timeout_id != 0)
+    {
+      g_source_remove(idle_timeout_id);
+      idle_timeout_id = 0;
+    }
+
+  // The source only accepts data once it is started.
+  if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+    {
+      spdlog::warn("Failed to start sound pipeline");
+      return false;
+    }
+
+  g_object_set(G_OBJECT(volume_element), "volume", volume / 100.0, NULL);
+
+  // The buffer refers to the decoded samples, and keeps them alive while it is in use.
+  const std::vector<uint8_t> &samples = sound->get_samples();
+  GstBuffer *buffer = gst_buffer_new_wrapped_full(GST_MEMORY_FLAG_READONLY,
+                                                  const_cast<uint8_t *>(samples.data()),
+                                                  samples.size(),
+                                                  0,
+                                                  samples.size(),
+                                                  new PcmSound::Ptr(sound),
+                                                  [](gpointer ref) { delete static_cast<PcmSound::Ptr *>(ref); });
+  GST_BUFFER_DURATION(buffer) = sound->get_duration_usec() * GST_USECOND;
+
+  play_time = g_get_monotonic_time();
+  waiting_for_first_sample = true;
+
+  GstFlowReturn ret = GST_FLOW_OK;
+  g_signal_emit_by_name(source, "push-buffer", buffer, &ret);
+  gst_buffer_unref(buffer);
+
+  if (ret != GST_FLOW_OK)
+    {
+      waiting_for_first_sample = false;
+      return false;
+    }
+
+  guint timeout = static_cast<guint>((sound->get_duration_usec() + last_latency) / 1000 + 1);
+  done_timeout_id = g_timeout_add(timeout, on_preloaded_sound_done, this);
+  return true;
+}
+
+//! Measures the latency of the first sample of a preloaded sound. Called from the streaming thread.
+GstPadProbeReturn
+GstSoundPlayer::on_sink_buffer(GstPad *pad, GstPadProbeInfo *info, gpointer data)
+{
+  (void)pad;
+  (void)info;
+
+  auto *self = static_cast<GstSoundPlayer *>(data);
+  bool waiting = true;
+  if (self->waiting_for_first_sample.compare_exchange_strong(waiting, false))
+    {
+      int64_t latency = g_get_monotonic_time() - self->play_time;
+      self->last_latency = latency;
+      spdlog::debug("Sound latency: {} us", latency);
+    }
+
+  return GST_PAD_PROBE_OK;
+}
+
+gboolean
+GstSoundPlayer::on_preloaded_sound_done(gpointer data)
+{
+  auto *self = static_cast<GstSoundPlayer *>(data);
+  self->done_timeout_id = 0;
+  self->idle_timeout_id = g_timeout_add(PIPELINE_IDLE_TIMEOUT_MS, on_pipeline_idle, self);
+
+  if (self->events != nullptr)
+    {
+      self->events->eos_event();
+    }
+
+  return FALSE;
+}
+
+//! Stops the persistent pipeline when no sound was played for a while.
+gboolean
+GstSoundPlayer::on_pipeline_idle(gpointer data)
+{
+  TRACE_ENTRY();
+  auto *self = static_cast<GstSoundPlayer *>(data);
+  self->idle_timeout_id = 0;
+
+  gst_element_set_state(self->pipeline, GST_STATE_READY);
+  return FALSE;
+}
+
+gboolean
+GstSoundPlayer::pipeline_bus_watch(GstBus *bus, GstMessage *msg, gpointer data)
+{
+  auto *self = static_cast<GstSoundPlayer *>(data);
+  GError *err = nullptr;
+
+  (void)bus;
+
+  if (GST_MESSAGE_TYPE(msg) == GST_MESSAGE_ERROR)
+    {
+      gst_message_parse_error(msg, &err, nullptr);
+      spdlog::warn("Sound pipeline failed: {}", err->message);
+      g_error_free(err);
+
+      // Fall back to a new pipeline for each sound. The watch is removed by returning FALSE.
+      self->pipeline_watch_id = 0;
+      self->destroy_pipeline();
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+//! Plays a sound file using a new playbin pipeline.
+void
+GstSoundPlayer::play_sound_uri(const std::string &wavfile, int volume)
+{
+  TRACE_ENTRY_PAR(wavfile, volume);
+
   GstElement *play = nullptr;
   GstElement *sink = gst_element_factory_make("autoaudiosink", "sink");
 
@@ -19,9 +19,24 @@
 #define GSTSOUNDPLAYER_HH
 
 #include "ISoundDriver.hh"
+#include "PcmSound.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
 
 #include <gst/gst.h>
 
+//! Sound driver using GStreamer.
+/*!
+ *  Preloaded sounds are decoded once and played through a persistent live
+ *  pipeline, so that playback starts without building a new pipeline. The
+ *  pipeline is stopped after a short idle delay. Other
+ *  sounds, and sounds that are played while a preloaded sound is still
+ *  playing, use a new playbin pipeline.
+ */
 class GstSoundPlayer : public ISoundDriver
 {
 public:
@@ -31,13 +46,51 @@ public:
   void init(ISoundPlayerEvents *events) override;
   bool capability(workrave::audio::SoundCapability cap) override;
   void play_sound(std::string wavfile, int volume) override;
+  void preload_sounds(const std::vector<std::string> &wavfiles) override;
+
+  //! Returns the time between the last play_sound call and its first sample reaching the audio sink.
+  int64_t get_last_latency_usec() const;
 
   static gboolean bus_watch(GstBus *bus, GstMessage *msg, gpointer data);
 
+private:
+  void create_pipeline();
+  void destroy_pipeline();
+  bool play_preloaded_sound(const PcmSound::Ptr &sound, int volume);
+  void play_sound_uri(const std::string &wavfile, int volume);
+
+  static gboolean pipeline_bus_watch(GstBus *bus, GstMessage *msg, gpointer data);
+  static GstPadProbeReturn on_sink_buffer(GstPad *pad, GstPadProbeInfo *info, gpointer data);
+  static gboolean on_preloaded_sound_done(gpointer data);
+  static gboolean on_pipeline_idle(gpointer data);
+
 private:
   gboolean gst_ok{false};
   ISoundPlayerEvents *events{nullptr};
 
+  //! Decoded sounds, by filename.
+  std::map<std::string, PcmSound::Ptr> sounds;
+
+  //! Persistent pipeline for preloaded sounds.
+  GstElement *pipeline{nullptr};
+  GstElement *source{nullptr};
+  GstElement *volume_element{nullptr};
+  guint pipeline_watch_id{0};
+
+  //! Timer that signals the end of the preloaded sound being played.
+  guint done_timeout_id{0};
+
+  //! Timer that stops the persistent pipeline after the last preloaded sound.
+  guint idle_timeout_id{0};
+
+  //! Monotonic time of the last play_sound call of a preloaded sound.
+  std::atomic<int64_t> play_time{0};
+
+  //! Is the first sample of the last preloaded sound still to reach the sink?
+  std::atomic<bool> waiting_for_first_sample{false};
+
+  std::atomic<int64_t> last_latency{0};
+
   struct WatchData
   {
     GstSoundPlayer *player{nullptr};
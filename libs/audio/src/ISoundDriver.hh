@@ -19,6 +19,7 @@
 #define ISOUNDDRIVER_HH
 
 #include <string>
+#include <vector>
 
 #include "audio/ISoundPlayer.hh"
 #include "ISoundPlayerEvents.hh"
@@ -31,6 +32,11 @@ public:
   virtual void init(ISoundPlayerEvents *events = nullptr) = 0;
   virtual bool capability(workrave::audio::SoundCapability cap) = 0;
   virtual void play_sound(std::string wavfile, int volume) = 0;
+
+  virtual void preload_sounds(const std::vector<std::string> &wavfiles)
+  {
+    (void)wavfiles;
+  }
 };
 
 #endif // ISOUNDDRIVER_HH
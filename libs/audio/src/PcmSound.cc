@@ -0,0 +1,145 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "PcmSound.hh"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "debug.hh"
+
+namespace
+{
+  constexpr uint16_t WAVE_FORMAT_PCM = 1;
+  constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xfffe;
+
+  uint16_t read_u16(const uint8_t *p)
+  {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+  }
+
+  uint32_t read_u32(const uint8_t *p)
+  {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16)
+           | (static_cast<uint32_t>(p[3]) << 24);
+  }
+} // namespace
+
+//! Loads an uncompressed PCM WAV file.
+/*!
+ *  \return the samples, or nullptr if the file cannot be read or is not an
+ *          uncompressed PCM file.
+ */
+PcmSound::Ptr
+PcmSound::load(const std::string &filename)
+{
+  TRACE_ENTRY_PAR(filename);
+
+  std::ifstream file(filename, std::ios::binary);
+  if (!file)
+    {
+      return nullptr;
+    }
+
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  return decode(data);
+}
+
+//! Decodes the contents of an uncompressed PCM WAV file.
+/*!
+ *  \return the samples, or nullptr if the data is not an uncompressed PCM file.
+ */
+PcmSound::Ptr
+PcmSound::decode(const std::vector<uint8_t> &data)
+{
+  TRACE_ENTRY();
+  if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) != 0 || memcmp(data.data() + 8, "WAVE", 4) != 0)
+    {
+      TRACE_MSG("not a WAV file");
+      return nullptr;
+    }
+
+  auto sound = std::make_shared<PcmSound>();
+  bool have_format = false;
+  bool have_data = false;
+  int block_align = 0;
+
+  size_t pos = 12;
+  while (pos + 8 <= data.size())
+    {
+      const uint8_t *chunk = data.data() + pos;
+      size_t size = read_u32(chunk + 4);
+      size_t available = data.size() - pos - 8;
+      if (size > available)
+        {
+          size = available;
+        }
+
+      if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16)
+        {
+          uint16_t format = read_u16(chunk + 8);
+          if (format == WAVE_FORMAT_EXTENSIBLE && size >= 26)
+            {
+              // The sub format GUID starts with the format tag.
+              format = read_u16(chunk + 8 + 24);
+            }
+          if (format != WAVE_FORMAT_PCM)
+            {
+              TRACE_MSG("unsupported format {}", format);
+              return nullptr;
+            }
+
+          sound->channels = read_u16(chunk + 10);
+          sound->rate = static_cast<int>(read_u32(chunk + 12));
+          block_align = read_u16(chunk + 20);
+          sound->bits_per_sample = read_u16(chunk + 22);
+          have_format = true;
+        }
+      else if (memcmp(chunk, "data", 4) == 0 && have_format)
+        {
+          sound->samples.assign(chunk + 8, chunk + 8 + size);
+          have_data = true;
+          break;
+        }
+
+      // Chunks are padded to an even size.
+      pos += 8 + size + (size & 1);
+    }
+
+  int bits = sound->bits_per_sample;
+  if (!have_data || sound->channels < 1 || sound->channels > 8 || sound->rate <= 0
+      || (bits != 8 && bits != 16 && bits != 24 && bits != 32) || block_align != sound->channels * bits / 8)
+    {
+      TRACE_MSG("unsupported layout");
+      return nullptr;
+    }
+
+  sound->samples.resize(sound->samples.size() - sound->samples.size() % block_align);
+  return sound;
+}
+
+int64_t
+PcmSound::get_duration_usec() const
+{
+  int64_t frames = static_cast<int64_t>(samples.size()) / (channels * bits_per_sample / 8);
+  return frames * 1000000 / rate;
+}
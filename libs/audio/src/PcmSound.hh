@@ -0,0 +1,67 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PCMSOUND_HH
+#define PCMSOUND_HH
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+//! Decoded PCM samples of a sound file.
+class PcmSound
+{
+public:
+  using Ptr = std::shared_ptr<PcmSound>;
+
+  static Ptr load(const std::string &filename);
+  static Ptr decode(const std::vector<uint8_t> &data);
+
+  int get_channels() const
+  {
+    return channels;
+  }
+
+  int get_rate() const
+  {
+    return rate;
+  }
+
+  //! Number of bits per sample: 8 (unsigned), 16, 24 or 32 (signed, little endian).
+  int get_bits_per_sample() const
+  {
+    return bits_per_sample;
+  }
+
+  const std::vector<uint8_t> &get_samples() const
+  {
+    return samples;
+  }
+
+  int64_t get_duration_usec() const;
+
+private:
+  int channels{0};
+  int rate{0};
+  int bits_per_sample{0};
+
+  //! Interleaved samples.
+  std::vector<uint8_t> samples;
+};
+
+#endif // PCMSOUND_HH
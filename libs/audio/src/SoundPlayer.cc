@@ -123,6 +123,16 @@ SoundPlayer::play_sound(const std::string &wavfile, bool mute_after_playback, in
     }
 }
 
+void
+SoundPlayer::preload_sounds(const std::vector<std::string> &wavfiles)
+{
+  TRACE_ENTRY();
+  if (driver != nullptr)
+    {
+      driver->preload_sounds(wavfiles);
+    }
+}
+
 bool
 SoundPlayer::capability(SoundCapability cap)
 {
@@ -34,6 +34,7 @@ public:
   bool capability(workrave::audio::SoundCapability cap) override;
   void restore_mute() override;
   void play_sound(const std::string &wavfile, bool mute_after_playback, int volume) override;
+  void preload_sounds(const std::vector<std::string> &wavfiles) override;
 
   void eos_event() override;
 
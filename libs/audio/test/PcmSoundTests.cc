@@ -0,0 +1,275 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#define BOOST_TEST_MODULE "workrave-audio-pcmsound"
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "PcmSound.hh"
+
+BOOST_AUTO_TEST_SUITE(workrave_audio_pcmsound)
+
+static void
+append_u16(std::vector<uint8_t> &data, uint16_t value)
+{
+  data.push_back(value & 0xff);
+  data.push_back(value >> 8);
+}
+
+static void
+append_u32(std::vector<uint8_t> &data, uint32_t value)
+{
+  append_u16(data, value & 0xffff);
+  append_u16(data, value >> 16);
+}
+
+static void
+append_chunk(std::vector<uint8_t> &data, const std::string &id, const std::vector<uint8_t> &payload, bool pad = true)
+{
+  data.insert(data.end(), id.begin(), id.end());
+  append_u32(data, payload.size());
+  data.insert(data.end(), payload.begin(), payload.end());
+  if (pad && payload.size() % 2 != 0)
+    {
+      data.push_back(0);
+    }
+}
+
+static std::vector<uint8_t>
+make_format(uint16_t format, int channels, int rate, int bits)
+{
+  std::vector<uint8_t> payload;
+  append_u16(payload, format);
+  append_u16(payload, channels);
+  append_u32(payload, rate);
+  append_u32(payload, rate * channels * bits / 8);
+  append_u16(payload, channels * bits / 8);
+  append_u16(payload, bits);
+  return payload;
+}
+
+static std::vector<uint8_t>
+make_samples(size_t size)
+{
+  std::vector<uint8_t> samples;
+  for (size_t i = 0; i < size; i++)
+    {
+      samples.push_back(i & 0xff);
+    }
+  return samples;
+}
+
+//! Returns a RIFF WAVE file with the specified chunks. The RIFF size is not checked by the decoder.
+static std::vector<uint8_t>
+make_wav(const std::vector<uint8_t> &chunks)
+{
+  std::vector<uint8_t> data{'R', 'I', 'F', 'F'};
+  append_u32(data, chunks.size() + 4);
+  data.insert(data.end(), {'W', 'A', 'V', 'E'});
+  data.insert(data.end(), chunks.begin(), chunks.end());
+  return data;
+}
+
+BOOST_AUTO_TEST_CASE(test_pcmsound_decode)
+{
+  std::vector<uint8_t> chunks;
+  append_chunk(chunks, "fmt ", make_format(1, 2, 44100, 16));
+  append_chunk(chunks, "data", make_samples(44100 * 4));
+
+  auto sound = PcmSound::decode(make_wav(chunks));
+  BOOST_REQUIRE(sound != nullptr);
+  BOOST_CHECK_EQUAL(sound->get_channels(), 2);
+  BOOST_CHECK_EQUAL(sound->get_rate(), 44100);
+  BOOST_CHECK_EQUAL(sound->get_bits_per_sample(), 16);
+  BOOST_CHECK(sound->get_samples() == make_samples(44100 * 4));
+  BOOST_CHECK_EQUAL(sound->get_duration_usec(), 1000000);
+}
+
+BOOST_AUTO_TEST_CASE(test_pcmsound_header)
+{
+  std::vector<uint8_t> chunks;
+  append_chunk(chunks, "fmt ", make_format(1, 1, 8000, 8));
+  append_chunk(chunks, "data", make_samples(16));
+
+  std::vector<uint8_t> wav = make_wav(chunks);
+  BOOST_CHECK(PcmSound::decode(wav) != nullptr);
+
+  std::vector<uint8_t> riff = wav;
+  riff[0] = 'X';
+  BOOST_CHECK(PcmSound::decode(riff) == nullptr);
+
+  std::vector<uint8_t> wave = wav;
+  wave[8] = 'X';
+  BOOST_CHECK(PcmSound::decode(wave) == nullptr);
+
+  BOOST_CHECK(PcmSound::decode(std::vector<uint8_t>(wav.begin(), wav.begin() + 11)) == nullptr);
+  BOOST_CHECK(PcmSound::decode({}) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_pcmsound_format)
+{
+  for (int bits: {8, 16, 24, 32})
+    {
+      std::vector<uint8_t> chunks;
+      append_chunk(chunks, "fmt ", make_format(1, 1, 8000, bits));
+      append_chunk(chunks, "data", make_samples(bits / 8 * 10));
+
+      auto sound = PcmSound::decode(make_wav(chunks));
+      BOOST_REQUIRE(sound != nullptr);
+      BOOST_CHECK_EQUAL(sound->get_bits_per_sample(), bits);
+      BOOST_CHECK_EQUAL(sound->get_samples().size(), bits / 8 * 10);
+    }
+
+  // Compressed formats, such as IEEE float and ADPCM.
+  for (uint16_t format: {3, 2})
+    {
+      std::vector<uint8_t> chunks;
+      append_chunk(chunks, "fmt ", make_format(format, 1, 8000, 16));
+      append_chunk(chunks, "data", make_samples(16));
+      BOOST_CHECK(PcmSound::decode(make_wav(chunks)) == nullptr);
+    }
+
+  // Unsupported sample size.
+  std::vector<uint8_t> chunks;
+  append_chunk(chunks, "fmt ", make_format(1, 1, 8000, 12));
+  append_chunk(chunks, "data", make_samples(16));
+  BOOST_CHECK(PcmSound::decode(make_wav(chunks)) == nullptr);
+
+  // Too short format chunk.
+  chunks.clear();
+  std::vector<uint8_t> format = make_format(1, 1, 8000, 16);
+  format.resize(14);
+  append_chunk(chunks, "fmt ", format);
+  append_chunk(chunks, "data", make_samples(16));
+  BOOST_CHECK(PcmSound::decode(make_wav(chunks)) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_pcmsound_extensible)
+{
+  std::vector<uint8_t> format = make_format(0xfffe, 2, 48000, 24);
+  append_u16(format, 22);
+  append_u16(format, 24);
+  append_u32(format, 3);
+  // Sub format GUID of PCM.
+  append_u16(format, 1);
+  format.insert(format.end(), {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71});
+
+  std::vector<uint8_t> chunks;
+  append_chunk(chunks, "fmt ", format);
+  append_chunk(chunks, "data", make_samples(60));
+
+  auto sound = PcmSound::decode(make_wav(chunks));
+  BOOST_REQUIRE(sound != nullptr);
+  BOOST_CHECK_EQUAL(sound->get_channels(), 2);
+  BOOST_CHECK_EQUAL(sound->get_rate(), 48000);
+  BOOST_CHECK_EQUAL(sound->get_bits_per_sample(), 24);
+}
+
+BOOST_AUTO_TEST_CASE(test_pcmsound_chunks)
+{
+  // Unknown chunks before and between the format and data chunks are skipped.
+  std::vector<uint8_t> chunks;
+  append_chunk(chunks, "LIST", make_samples(10));
+  append_chunk(chunks, "fmt ", make_format(1, 1, 8000, 16));
+  append_chunk(chunks, "fact", make_samples(4));
+  append_chunk(chunks, "data", make_samples(20));
+  append_chunk(chunks, "cue ", make_samples(6));
+
+  auto sound = PcmSound::decode(make_wav(chunks));
+  BOOST_REQUIRE(sound != nullptr);
+  BOOST_CHECK(sound->get_samples() == make_samples(20));
+
+  // Samples before the format are not understood.
+  chunks.clear();
+  append_chunk(chunks, "data", make_samples(20));
+  append_chunk(chunks, "fmt ", make_format(1, 1, 8000, 16));
+  BOOST_CHECK(PcmSound::decode(make_wav(chunks)) == nullptr);
+
+  // No samples.
+  chunks.clear();
+  append_chunk(chunks, "fmt ", make_format(1, 1, 8000, 16));
+  BOOST_CHECK(PcmSound::decode(make_wav(chunks)) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_pcmsound_odd_sized_chunks)
+{
+  // Odd sized chunks are followed by a pad byte.
+  std::vector<uint8_t> chunks;
+  append_chunk(chunks, "LIST", make_samples(7));
+  append_chunk(chunks, "fmt ", make_format(1, 1, 8000, 8));
+  append_chunk(chunks, "data", make_samples(9));
+
+  auto sound = PcmSound::decode(make_wav(chunks));
+  BOOST_REQUIRE(sound != nullptr);
+  BOOST_CHECK(sound->get_samples() == make_samples(9));
+
+  // Incomplete frames at the end of the samples are dropped.
+  chunks.clear();
+  append_chunk(chunks, "fmt ", make_format(1, 2, 8000, 16));
+  append_chunk(chunks, "data", make_samples(11));
+
+  sound = PcmSound::decode(make_wav(chunks));
+  BOOST_REQUIRE(sound != nullptr);
+  BOOST_CHECK(sound->get_samples() == make_samples(8));
+}
+
+BOOST_AUTO_TEST_CASE(test_pcmsound_truncated)
+{
+  // A data chunk that is cut off is decoded up to the end of the file.
+  std::vector<uint8_t> chunks;
+  append_chunk(chunks, "fmt ", make_format(1, 1, 8000, 16));
+  append_chunk(chunks, "data", make_samples(100));
+
+  std::vector<uint8_t> wav = make_wav(chunks);
+  wav.resize(wav.size() - 31);
+
+  auto sound = PcmSound::decode(wav);
+  BOOST_REQUIRE(sound != nullptr);
+  BOOST_CHECK(sound->get_samples() == make_samples(68));
+
+  // A format chunk that is cut off.
+  chunks.clear();
+  append_chunk(chunks, "fmt ", make_format(1, 1, 8000, 16));
+  wav = make_wav(chunks);
+  wav.resize(wav.size() - 4);
+  BOOST_CHECK(PcmSound::decode(wav) == nullptr);
+
+  // A chunk header that is cut off.
+  chunks.clear();
+  append_chunk(chunks, "fmt ", make_format(1, 1, 8000, 16));
+  chunks.insert(chunks.end(), {'d', 'a', 't', 'a', 10});
+  BOOST_CHECK(PcmSound::decode(make_wav(chunks)) == nullptr);
+
+  // A chunk size beyond the end of the file.
+  chunks.clear();
+  append_chunk(chunks, "LIST", make_samples(4));
+  wav = make_wav(chunks);
+  wav[16] = 0xff;
+  wav[17] = 0xff;
+  wav[18] = 0xff;
+  wav[19] = 0xff;
+  BOOST_CHECK(PcmSound::decode(wav) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -25,6 +25,8 @@
 #  include "MacOSHelpers.hh"
 #endif
 
+#include <algorithm>
+
 #include <boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
 
@@ -36,6 +38,35 @@
 
 using namespace workrave::utils;
 
+namespace
+{
+  template<typename T>
+  bool convert_value(const std::optional<ConfigValue> &v, T &out)
+  {
+    if (!v.has_value())
+      {
+        return false;
+      }
+
+    if (const T *value = std::get_if<T>(&v.value()))
+      {
+        out = *value;
+        return true;
+      }
+
+    try
+      {
+        std::visit([&out](auto &&arg) { out = boost::lexical_cast<T>(arg); }, v.value());
+        return true;
+      }
+    catch (boost::bad_lexical_cast &)
+      {
+      }
+
+    return false;
+  }
+} // namespace
+
 Configurator::Configurator(IConfigBackend *backend)
   : backend(backend)
 {
@@ -43,6 +74,13 @@ Configurator::Configurator(IConfigBackend *backend)
     {
       dynamic_cast<IConfigBackendMonitoring *>(backend)->set_listener(this);
     }
+  else
+    {
+      // Backends that report changes keep their own in-memory copy. Values of
+      // other backends are cached, as they are only changed through this
+      // configurator.
+      cache_enabled = true;
+    }
 }
 
 Configurator::~Configurator()
@@ -53,6 +91,7 @@ Configurator::~Configurator()
 bool
 Configurator::load(std::string filename)
 {
+  value_cache.clear();
   return backend->load(filename);
 }
 
@@ -60,6 +99,8 @@ void
 Configurator::save()
 {
   backend->save();
+  auto_save_time = 0;
+  auto_save_deadline = 0;
 }
 
 void
@@ -78,16 +119,14 @@ Configurator::heartbeat()
         {
           std::optional<ConfigValue> old_value = backend->get_value(delayed.key, ConfigValueToType(delayed.value));
           backend->set_value(delayed.key, delayed.value);
+          invalidate(delayed.key);
 
           if (dynamic_cast<IConfigBackendMonitoring *>(backend) == nullptr)
             {
               if (!old_value.has_value() || old_value != delayed.value)
                 {
                   fire_configurator_event(delayed.key);
-                  if (auto_save_time == 0)
-                    {
-                      auto_save_time = TimeSource::get_monotonic_time_sec() + 30;
-                    }
+                  schedule_save();
                 }
             }
 
@@ -100,10 +139,22 @@ Configurator::heartbeat()
   if (auto_save_time != 0 && now >= auto_save_time)
     {
       save();
-      auto_save_time = 0;
     }
 }
 
+//! Saves the configuration once a burst of changes is over.
+void
+Configurator::schedule_save()
+{
+  int64_t now = TimeSource::get_monotonic_time_sec();
+
+  if (auto_save_deadline == 0)
+    {
+      auto_save_deadline = now + AUTO_SAVE_MAX_DELAY;
+    }
+  auto_save_time = std::min(now + AUTO_SAVE_DELAY, auto_save_deadline);
+}
+
 void
 Configurator::set_delay(const std::string &key, int delay)
 {
@@ -119,7 +170,9 @@ Configurator::has_user_value(const std::string &key)
 void
 Configurator::remove_key(const std::string &key) const
 {
-  backend->remove_key(trim_key(key));
+  std::string ckey = trim_key(key);
+  backend->remove_key(ckey);
+  invalidate(ckey);
 }
 
 void
@@ -172,17 +225,14 @@ Configurator::set_value(const std::string &key, ConfigValue &value, workrave::co
       auto current_value = get_value(ckey, ConfigValueToType(value));
       bool valid = current_value.has_value();
       backend->set_value(ckey, value);
+      invalidate(ckey);
 
       if (dynamic_cast<IConfigBackendMonitoring *>(backend) == nullptr)
         {
           if (!valid || current_value != value)
             {
               fire_configurator_event(ckey);
-
-              if (auto_save_time == 0)
-                {
-                  auto_save_time = TimeSource::get_monotonic_time_sec() + 30;
-                }
+              schedule_save();
             }
         }
     }
@@ -193,123 +243,74 @@ Configurator::set_value(const std::string &key, ConfigValue &value, workrave::co
 std::optional<ConfigValue>
 Configurator::get_value(const std::string &key, ConfigType type) const
 {
-  std::optional<ConfigValue> ret;
-
-  std::string ckey = trim_key(key);
+  std::string_view ckey = trim_key_view(key);
 
   auto it = delayed_config.find(ckey);
   if (it != delayed_config.end())
     {
       const DelayedConfig &delayed = it->second;
-      ret = delayed.value;
+      return delayed.value;
     }
 
-  if (!ret.has_value())
+  if (cache_enabled)
     {
-      ret = backend->get_value(ckey, type);
+      auto cached = value_cache.find(ckey);
+      if (cached != value_cache.end() && cached->second.type == type)
+        {
+          return cached->second.value;
+        }
+    }
+
+  std::string backend_key{ckey};
+  std::optional<ConfigValue> ret = backend->get_value(backend_key, type);
+
+  if (cache_enabled)
+    {
+      value_cache[backend_key] = CachedValue{type, ret};
     }
 
   return ret;
 }
 
-bool
-Configurator::get_value(const std::string &key, std::string &out) const
+//! Drops the cached value of a key.
+void
+Configurator::invalidate(std::string_view key) const
 {
-  auto v = get_value(key, ConfigType::String);
-
-  try
-    {
-      if (v.has_value())
-        {
-          std::visit([&out](auto &&arg) { out = boost::lexical_cast<std::string>(arg); }, v.value());
-          return true;
-        }
-    }
-  catch (boost::bad_lexical_cast &)
+  auto it = value_cache.find(key);
+  if (it != value_cache.end())
     {
+      value_cache.erase(it);
     }
+}
 
-  return false;
+bool
+Configurator::get_value(const std::string &key, std::string &out) const
+{
+  return convert_value(get_value(key, ConfigType::String), out);
 }
 
 bool
 Configurator::get_value(const std::string &key, bool &out) const
 {
-  auto v = get_value(key, ConfigType::Bool);
-
-  try
-    {
-      if (v.has_value())
-        {
-          std::visit([&out](auto &&arg) { out = boost::lexical_cast<bool>(arg); }, v.value());
-          return true;
-        }
-    }
-  catch (boost::bad_lexical_cast &)
-    {
-    }
-
-  return false;
+  return convert_value(get_value(key, ConfigType::Bool), out);
 }
 
 bool
 Configurator::get_value(const std::string &key, int32_t &out) const
 {
-  auto v = get_value(key, ConfigType::Int32);
-
-  try
-    {
-      if (v.has_value())
-        {
-          std::visit([&out](auto &&arg) { out = boost::lexical_cast<int32_t>(arg); }, v.value());
-          return true;
-        }
-    }
-  catch (boost::bad_lexical_cast &)
-    {
-    }
-
-  return false;
+  return convert_value(get_value(key, ConfigType::Int32), out);
 }
 
 bool
 Configurator::get_value(const std::string &key, int64_t &out) const
 {
-  auto v = get_value(key, ConfigType::Int64);
-
-  try
-    {
-      if (v.has_value())
-        {
-          std::visit([&out](auto &&arg) { out = boost::lexical_cast<int64_t>(arg); }, v.value());
-          return true;
-        }
-    }
-  catch (boost::bad_lexical_cast &)
-    {
-    }
-
-  return false;
+  return convert_value(get_value(key, ConfigType::Int64), out);
 }
 
 bool
 Configurator::get_value(const std::string &key, double &out) const
 {
-  auto v = get_value(key, ConfigType::Double);
-
-  try
-    {
-      if (v.has_value())
-        {
-          std::visit([&out](auto &&arg) { out = boost::lexical_cast<double>(arg); }, v.value());
-          return true;
-        }
-    }
-  catch (boost::bad_lexical_cast &)
-    {
-    }
-
-  return false;
+  return convert_value(get_value(key, ConfigType::Double), out);
 }
 
 void
@@ -417,23 +418,7 @@ Configurator::add_listener(const std::string &key_prefix, IConfiguratorListener
 
   if (ret)
     {
-      auto i = listeners.begin();
-      while (ret && i != listeners.end())
-        {
-          if (key == i->first && listener == i->second)
-            {
-              // Already added. Skip
-              ret = false;
-            }
-
-          i++;
-        }
-    }
-
-  if (ret)
-    {
-      // not found -> add
-      listeners.emplace_back(key, listener);
+      ret = listeners.add(key, listener);
     }
 
   return ret;
@@ -443,51 +428,19 @@ bool
 Configurator::remove_listener(IConfiguratorListener *listener)
 {
   TRACE_ENTRY();
-  bool ret = false;
-
-  auto i = listeners.begin();
-  while (i != listeners.end())
-    {
-      if (listener == i->second)
-        {
-          // Found. Remove
-          i = listeners.erase(i);
-          ret = true;
-        }
-      else
-        {
-          i++;
-        }
-    }
-  return ret;
+  return listeners.remove(listener);
 }
 
 bool
 Configurator::remove_listener(const std::string &key_prefix, IConfiguratorListener *listener)
 {
   TRACE_ENTRY();
-  bool ret = false;
-
   if (dynamic_cast<IConfigBackendMonitoring *>(backend) != nullptr)
     {
       dynamic_cast<IConfigBackendMonitoring *>(backend)->remove_listener(key_prefix);
     }
 
-  auto i = listeners.begin();
-  while (i != listeners.end())
-    {
-      if (i->first == key_prefix && i->second == listener)
-        {
-          // Found. Remove
-          i = listeners.erase(i);
-          ret = true;
-        }
-      else
-        {
-          i++;
-        }
-    }
-  return ret;
+  return listeners.remove(trim_key(key_prefix), listener);
 }
 
 //! Fire a configuration changed event.
@@ -498,33 +451,31 @@ Configurator::fire_configurator_event(const std::string &key)
 
   std::string ckey = trim_key(key);
 
-  auto listeners_copy = listeners;
-
-  auto i = listeners_copy.begin();
-  while (i != listeners_copy.end())
-    {
-      std::string prefix = i->first;
-
-      if (ckey.substr(0, prefix.length()) == prefix)
-        {
-          IConfiguratorListener *l = i->second;
-          if (l != nullptr)
-            {
-              l->config_changed_notify(ckey);
-            }
-        }
-      i++;
-    }
+  listeners.fire(ckey);
 }
 
 std::string
 Configurator::trim_key(const std::string &key)
 {
-  return boost::trim_copy_if(key, boost::is_any_of("/"));
+  return std::string{trim_key_view(key)};
+}
+
+std::string_view
+Configurator::trim_key_view(std::string_view key)
+{
+  std::string_view::size_type begin = key.find_first_not_of('/');
+  if (begin == std::string_view::npos)
+    {
+      return {};
+    }
+
+  std::string_view::size_type end = key.find_last_not_of('/');
+  return key.substr(begin, end - begin + 1);
 }
 
 void
 Configurator::config_changed_notify(const std::string &key)
 {
+  invalidate(trim_key_view(key));
   fire_configurator_event(key);
 }
@@ -21,12 +21,14 @@
 #define CONFIGURATOR_HH
 
 #include <string>
+#include <string_view>
 #include <list>
 #include <map>
 
 #include "config/IConfigurator.hh"
 #include "config/IConfiguratorListener.hh"
 #include "IConfigBackend.hh"
+#include "ConfiguratorListeners.hh"
 
 #include "utils/Logging.hh"
 
@@ -83,21 +85,43 @@ private:
     int64_t until;
   };
 
+  struct CachedValue
+  {
+    ConfigType type{ConfigType::None};
+    std::optional<ConfigValue> value;
+  };
+
+  //! Number of seconds without changes after which the configuration is saved.
+  static constexpr int AUTO_SAVE_DELAY = 2;
+
+  //! Maximum number of seconds between a change and saving the configuration.
+  static constexpr int AUTO_SAVE_MAX_DELAY = 30;
+
 private:
   bool set_value(const std::string &key, ConfigValue &value, workrave::config::ConfigFlags flags = workrave::config::CONFIG_FLAG_NONE);
   std::optional<ConfigValue> get_value(const std::string &key, ConfigType type) const;
 
   static std::string trim_key(const std::string &key);
+  static std::string_view trim_key_view(std::string_view key);
+
+  void invalidate(std::string_view key) const;
+  void schedule_save();
 
   void fire_configurator_event(const std::string &key);
   void config_changed_notify(const std::string &key) override;
 
 private:
   std::map<std::string, int> delays;
-  std::map<std::string, DelayedConfig> delayed_config;
-  std::list<std::pair<std::string, workrave::config::IConfiguratorListener *>> listeners;
+  std::map<std::string, DelayedConfig, std::less<>> delayed_config;
+  ConfiguratorListeners listeners;
   IConfigBackend *backend{nullptr};
+
+  //! Values read from a backend that does not report changes, by key.
+  mutable std::map<std::string, CachedValue, std::less<>> value_cache;
+  bool cache_enabled{false};
+
   int64_t auto_save_time{0};
+  int64_t auto_save_deadline{0};
   std::string last_filename;
   std::shared_ptr<spdlog::logger> logger{workrave::utils::Logging::create("config")};
 };
@@ -0,0 +1,170 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "ConfiguratorListeners.hh"
+
+#include <algorithm>
+
+using namespace workrave::config;
+
+//! Adds a listener for all keys starting with key_prefix.
+bool
+ConfiguratorListeners::add(const std::string &key_prefix, IConfiguratorListener *listener)
+{
+  Node *node = find_node(key_prefix, true);
+
+  for (const auto &entry: node->entries)
+    {
+      if (entry->listener == listener)
+        {
+          // Already added. Skip
+          return false;
+        }
+    }
+
+  auto entry = std::make_shared<Entry>();
+  entry->key_prefix = key_prefix;
+  entry->listener = listener;
+  entry->seq = next_seq++;
+
+  node->entries.push_back(entry);
+  listener_entries[listener].push_back(entry);
+  return true;
+}
+
+//! Removes all registrations of a listener.
+bool
+ConfiguratorListeners::remove(IConfiguratorListener *listener)
+{
+  auto it = listener_entries.find(listener);
+  if (it == listener_entries.end())
+    {
+      return false;
+    }
+
+  std::vector<std::shared_ptr<Entry>> entries;
+  entries.swap(it->second);
+
+  for (const auto &entry: entries)
+    {
+      remove_entry(entry);
+    }
+  return true;
+}
+
+//! Removes the registration of a listener for key_prefix.
+bool
+ConfiguratorListeners::remove(const std::string &key_prefix, IConfiguratorListener *listener)
+{
+  Node *node = find_node(key_prefix, false);
+  if (node == nullptr)
+    {
+      return false;
+    }
+
+  auto it = std::find_if(node->entries.begin(), node->entries.end(), [listener](const auto &entry) {
+    return entry->listener == listener;
+  });
+  if (it == node->entries.end())
+    {
+      return false;
+    }
+
+  remove_entry(*it);
+  return true;
+}
+
+//! Notifies all listeners with a key prefix of key.
+void
+ConfiguratorListeners::fire(const std::string &key)
+{
+  std::vector<std::shared_ptr<Entry>> matches;
+
+  const Node *node = &root;
+  matches.insert(matches.end(), node->entries.begin(), node->entries.end());
+
+  for (char c: key)
+    {
+      auto it = node->children.find(c);
+      if (it == node->children.end())
+        {
+          break;
+        }
+      node = it->second.get();
+      matches.insert(matches.end(), node->entries.begin(), node->entries.end());
+    }
+
+  std::sort(matches.begin(), matches.end(), [](const auto &a, const auto &b) { return a->seq < b->seq; });
+
+  for (const auto &entry: matches)
+    {
+      if (!entry->removed && entry->listener != nullptr)
+        {
+          entry->listener->config_changed_notify(key);
+        }
+    }
+}
+
+ConfiguratorListeners::Node *
+ConfiguratorListeners::find_node(const std::string &key_prefix, bool create)
+{
+  Node *node = &root;
+
+  for (char c: key_prefix)
+    {
+      auto it = node->children.find(c);
+      if (it == node->children.end())
+        {
+          if (!create)
+            {
+              return nullptr;
+            }
+          it = node->children.emplace(c, std::make_unique<Node>()).first;
+        }
+      node = it->second.get();
+    }
+
+  return node;
+}
+
+void
+ConfiguratorListeners::remove_entry(std::shared_ptr<Entry> entry)
+{
+  entry->removed = true;
+
+  Node *node = find_node(entry->key_prefix, false);
+  if (node != nullptr)
+    {
+      auto &entries = node->entries;
+      entries.erase(std::remove(entries.begin(), entries.end(), entry), entries.end());
+    }
+
+  auto it = listener_entries.find(entry->listener);
+  if (it != listener_entries.end())
+    {
+      auto &entries = it->second;
+      entries.erase(std::remove(entries.begin(), entries.end(), entry), entries.end());
+      if (entries.empty())
+        {
+          listener_entries.erase(it);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef CONFIGURATORLISTENERS_HH
+#define CONFIGURATORLISTENERS_HH
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "config/IConfiguratorListener.hh"
+
+//! Configuration listeners, indexed by key prefix.
+/*!
+ *  The listeners are stored in a trie on the characters of their key
+ *  prefix, so finding the listeners of a key only visits the nodes along
+ *  that key. Listeners are notified in the order in which they were added.
+ *  Listeners removed while an event is being fired are not notified
+ *  anymore; listeners added while an event is being fired are notified of
+ *  the next event.
+ */
+class ConfiguratorListeners
+{
+public:
+  ConfiguratorListeners() = default;
+
+  ConfiguratorListeners(const ConfiguratorListeners &) = delete;
+  ConfiguratorListeners &operator=(const ConfiguratorListeners &) = delete;
+
+  bool add(const std::string &key_prefix, workrave::config::IConfiguratorListener *listener);
+  bool remove(workrave::config::IConfiguratorListener *listener);
+  bool remove(const std::string &key_prefix, workrave::config::IConfiguratorListener *listener);
+
+  void fire(const std::string &key);
+
+private:
+  struct Entry
+  {
+    std::string key_prefix;
+    workrave::config::IConfiguratorListener *listener{nullptr};
+    uint64_t seq{0};
+    bool removed{false};
+  };
+
+  struct Node
+  {
+    std::map<char, std::unique_ptr<Node>> children;
+    std::vector<std::shared_ptr<Entry>> entries;
+  };
+
+  Node *find_node(const std::string &key_prefix, bool create);
+  void remove_entry(std::shared_ptr<Entry> entry);
+
+private:
+  //! Root of the trie, holds the listeners of the empty prefix.
+  Node root;
+
+  //! Entries of each listener, for removing all registrations of a listener.
+  std::unordered_map<workrave::config::IConfiguratorListener *, std::vector<std::shared_ptr<Entry>>> listener_entries;
+
+  //! Sequence number of the next registration.
+  uint64_t next_seq{0};
+};
+
+#endif // CONFIGURATORLISTENERS_HH
@@ -860,6 +860,52 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_configurator_listener_add_remove, T, backend_
   BOOST_CHECK_EQUAL(ok, false);
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_configurator_listener_remove_while_firing, T, backend_types)
+{
+  init<T>();
+
+  class RemovingListener : public IConfiguratorListener
+  {
+  public:
+    RemovingListener(Configurator::Ptr configurator, IConfiguratorListener *other)
+      : configurator(configurator)
+      , other(other)
+    {
+    }
+
+    void config_changed_notify(const std::string &key) override
+    {
+      count++;
+      configurator->remove_listener(other);
+    }
+
+    Configurator::Ptr configurator;
+    IConfiguratorListener *other{nullptr};
+    int count{0};
+  };
+
+  RemovingListener remover(configurator, this);
+
+  bool ok{false};
+
+  ok = configurator->add_listener("test/", &remover);
+  BOOST_CHECK_EQUAL(ok, true);
+  ok = configurator->add_listener("test/other/int32", this);
+  BOOST_CHECK_EQUAL(ok, true);
+  ok = configurator->add_listener("test/other/", this);
+  BOOST_CHECK_EQUAL(ok, true);
+
+  expected_key = "test/other/int32";
+  configurator->set_value("test/other/int32", 1008);
+  BOOST_CHECK_EQUAL(remover.count, 1);
+  BOOST_CHECK_EQUAL(config_changed_count, 0);
+
+  ok = configurator->remove_listener("test/other/int32", this);
+  BOOST_CHECK_EQUAL(ok, false);
+
+  configurator->remove_listener(&remover);
+}
+
 BOOST_AUTO_TEST_CASE_TEMPLATE(test_configurator_leading_slash, T, backend_types)
 {
   init<T>();
@@ -1412,6 +1458,34 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_configurator_save_load, T, file_backend_types
   BOOST_CHECK_EQUAL(bvalue, false);
 }
 
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_configurator_auto_save, T, file_backend_types)
+{
+  init<T>();
+
+  configurator->load("temp-save");
+  configurator->set_value("/test/other/int32", 1040);
+  configurator->save();
+
+  auto saved_value = []() {
+    auto saved = std::make_shared<Configurator>(new T());
+    saved->load("temp-save");
+
+    int32_t value = 0;
+    saved->get_value("test/other/int32", value);
+    return value;
+  };
+
+  configurator->set_value("/test/other/int32", 1041);
+  tick();
+  configurator->set_value("/test/other/int32", 1042);
+  tick();
+  tick();
+  BOOST_CHECK_EQUAL(saved_value(), 1040);
+
+  tick();
+  BOOST_CHECK_EQUAL(saved_value(), 1042);
+}
+
 BOOST_AUTO_TEST_CASE_TEMPLATE(test_configurator_dummy_save_load, T, non_file_backend_types)
 {
   init<T>();
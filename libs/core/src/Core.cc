@@ -26,6 +26,7 @@
 
 #include "debug.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <fstream>
@@ -110,7 +111,7 @@ Core::Core()
 Core::~Core()
 {
   TRACE_ENTRY();
-  save_state();
+  save_state(true);
 
   if (monitor != nullptr)
     {
@@ -158,6 +159,8 @@ Core::init(int argc, char **argv, IApp *app, const char *display_name)
 
   load_state();
   load_misc();
+
+  update_timer_snapshot();
 }
 
 //! Initializes the configurator.
@@ -238,6 +241,7 @@ Core::init_bus()
       dbus->register_object_path(DBUS_PATH_WORKRAVE);
       dbus->connect(DBUS_PATH_WORKRAVE, "org.workrave.CoreInterface", this);
       dbus->connect(DBUS_PATH_WORKRAVE, "org.workrave.ConfigInterface", configurator.get());
+      dbus->connect(DBUS_PATH_WORKRAVE, "org.workrave.StatisticsInterface", statistics);
 
 #ifdef HAVE_TESTS
       dbus->connect("/org/workrave/Workrave/Debug", "org.workrave.DebugInterface", Test::get_instance());
@@ -295,6 +299,9 @@ Core::init_breaks()
     {
       breaks[i].init(BreakId(i), configurator, application);
     }
+
+  configurator->add_listener(CoreConfig::CFG_KEY_TIMERS, this);
+  configurator->add_listener(CoreConfig::CFG_KEY_BREAKS, this);
 }
 
 #ifdef HAVE_DISTRIBUTION
@@ -399,6 +406,11 @@ Core::config_changed_notify(const string &key)
       load_monitor_config();
     }
 
+  if (path == CoreConfig::CFG_KEY_TIMERS || path == CoreConfig::CFG_KEY_BREAKS)
+    {
+      timer_config_changed = true;
+    }
+
   if (key == CoreConfig::CFG_KEY_OPERATION_MODE)
     {
       int mode;
@@ -506,6 +518,20 @@ Core::get_statistics() const
   return statistics;
 }
 
+//! Returns the state of all timers at the last heartbeat.
+TimerSnapshot::Ptr
+Core::get_timer_snapshot() const
+{
+  return timer_snapshot;
+}
+
+//! Returns the writer of the state files.
+StateWriter *
+Core::get_state_writer()
+{
+  return &state_writer;
+}
+
 //! Returns the specified break controller.
 Break *
 Core::get_break(BreakId id)
@@ -633,6 +659,7 @@ Core::set_operation_mode_internal(OperationMode mode)
       operation_mode_regular = mode;
       update_active_operation_mode();
       CoreConfig::operation_mode().set(mode);
+      update_timer_snapshot();
       operation_mode_changed_signal(operation_mode_regular);
 
 #ifdef HAVE_DBUS
@@ -826,8 +853,9 @@ Core::set_powersave(bool down)
           powersave = true;
         }
 
-      save_state();
       statistics->update();
+      save_state(true);
+      state_writer.flush();
     }
   else
     {
@@ -1008,8 +1036,17 @@ Core::heartbeat()
       process_state();
     }
 
-  // Perform timer processing.
-  process_timers();
+  // Perform timer processing, unless none of the timers would change state.
+  if (is_timer_processing_required())
+    {
+      process_timers();
+    }
+
+  // Notify D-Bus clients of changed timers.
+  process_timer_subscriptions();
+
+  // Process input statistics.
+  statistics->heartbeat();
 
   // Send heartbeats to other components.
   for (int i = 0; i < BREAK_ID_SIZEOF; i++)
@@ -1024,8 +1061,8 @@ Core::heartbeat()
   // Set current time.
   int64_t current_time = TimeSource::get_real_time_sec();
 
-  // Make state persistent.
-  if (current_time % SAVESTATETIME == 0)
+  // Make state persistent. Heartbeats may be skipped, so check whether a save time has passed.
+  if (last_process_time != 0 && current_time / SAVESTATETIME != last_process_time / SAVESTATETIME)
     {
       statistics->update();
       save_state();
@@ -1033,6 +1070,103 @@ Core::heartbeat()
 
   // Done.
   last_process_time = current_time;
+  last_process_monotonic_time = TimeSource::get_monotonic_time_sec();
+
+  update_timer_snapshot();
+}
+
+//! Returns the time at which the next heartbeat is needed.
+int64_t
+Core::get_next_heartbeat_time()
+{
+  TRACE_ENTRY();
+  int64_t current_time = TimeSource::get_real_time_sec();
+
+  // The activity monitor and running breaks need to be processed every second.
+  if (monitor_state == ACTIVITY_ACTIVE || monitor_state == ACTIVITY_NOISE)
+    {
+      return current_time + 1;
+    }
+
+#ifdef HAVE_DISTRIBUTION
+  // Peers exchange state on each heartbeat.
+  if (dist_manager != nullptr && dist_manager->get_number_of_peers() > 0)
+    {
+      return current_time + 1;
+    }
+#endif
+
+  for (auto &brk: breaks)
+    {
+      BreakControl *bc = brk.get_break_control();
+      if (bc != nullptr && bc->need_heartbeat())
+        {
+          return current_time + 1;
+        }
+    }
+
+  // The GUI shows the elapsed time of running timers, and the rest progress of
+  // stopped timers until they are reset. Both change every second.
+  for (auto &brk: breaks)
+    {
+      Timer *timer = brk.get_timer();
+      bool resting = timer->is_auto_reset_enabled() && timer->get_auto_reset() > 0
+                     && timer->get_elapsed_idle_time() < timer->get_auto_reset();
+      if (brk.is_enabled() && (timer->is_running() || resting))
+        {
+          return current_time + 1;
+        }
+    }
+
+  // Make state persistent.
+  int64_t ret = (current_time / SAVESTATETIME + 1) * SAVESTATETIME;
+
+  for (auto &brk: breaks)
+    {
+      int64_t event_time = brk.get_timer()->get_next_event_time();
+      if (event_time != 0)
+        {
+          ret = std::min(ret, event_time);
+        }
+    }
+
+  for (const auto &[who, until]: external_activity)
+    {
+      ret = std::min(ret, until + 1);
+    }
+
+  int granularity = get_timer_subscription_granularity();
+  if (granularity > 0)
+    {
+      int64_t subscription_time = get_next_timer_subscription_time(current_time, granularity);
+      if (subscription_time != 0)
+        {
+          ret = std::min(ret, subscription_time);
+        }
+    }
+
+  auto auto_reset_time = CoreConfig::operation_mode_auto_reset_time()();
+  if (auto_reset_time.time_since_epoch().count() > 0)
+    {
+      ret = std::min(ret, static_cast<int64_t>(std::chrono::duration_cast<std::chrono::seconds>(auto_reset_time.time_since_epoch()).count()));
+    }
+
+  ret = std::max(ret, current_time + 1);
+  TRACE_MSG("next heartbeat {}", ret);
+
+  if (ret > current_time + 1)
+    {
+      // Heartbeats may be skipped, so user activity must wake up the GUI.
+      local_monitor->arm_wakeup();
+    }
+  return ret;
+}
+
+//! Sets the function to call when user input is detected while heartbeats are skipped.
+void
+Core::set_input_wakeup_handler(std::function<void()> handler)
+{
+  local_monitor->set_wakeup_handler(std::move(handler));
 }
 
 //! Performs all distribution processing.
@@ -1062,10 +1196,16 @@ Core::process_distribution()
         }
     }
 
+  if (previous_master_mode != master_node)
+    {
+      timer_replicator.request_snapshot();
+    }
+
   if ((previous_master_mode != master_node) || (master_node && local_state != state))
     {
       PacketBuffer buffer;
       buffer.create();
+      buffer.set_protocol(dist_manager->get_protocol());
 
       buffer.pack_ushort(1);
       buffer.pack_ushort(state);
@@ -1197,6 +1337,209 @@ Core::get_timer_overdue(BreakId id, int *value)
   *value = (int)timer->get_total_overdue_time();
 }
 
+//! Returns the state of all timers.
+void
+Core::get_timers_snapshot(TimerStatusList &timers)
+{
+  timers.clear();
+  timers.reserve(BREAK_ID_SIZEOF);
+
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      auto id = static_cast<BreakId>(i);
+
+      TimerStatus status;
+      status.timer_id = id;
+      is_timer_running(id, status.running);
+      get_timer_idle(id, &status.idle);
+      get_timer_elapsed(id, &status.elapsed);
+      get_timer_remaining(id, &status.remaining);
+      get_timer_overdue(id, &status.overdue);
+
+      timers.push_back(status);
+    }
+}
+
+//! Publishes a new timer snapshot if the state or configuration of the timers changed.
+void
+Core::update_timer_snapshot()
+{
+  auto snapshot = std::make_shared<TimerSnapshot>();
+  snapshot->operation_mode = operation_mode_regular;
+
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      const Break &b = breaks[i];
+      BreakTimerState &state = snapshot->timers[i];
+
+      state.enabled = b.is_enabled();
+      state.running = b.is_running();
+      state.taking = b.is_taking();
+      state.elapsed_time = b.get_elapsed_time();
+      state.elapsed_idle_time = b.get_elapsed_idle_time();
+      state.auto_reset = b.get_auto_reset();
+      state.auto_reset_enabled = b.is_auto_reset_enabled();
+      state.limit = b.get_limit();
+      state.limit_enabled = b.is_limit_enabled();
+    }
+
+  if (!timer_config_changed && timer_snapshot && timer_snapshot->same_state(*snapshot))
+    {
+      return;
+    }
+
+  timer_config_changed = false;
+  snapshot->version = timer_snapshot ? timer_snapshot->version + 1 : 1;
+  timer_snapshot = snapshot;
+}
+
+//! Subscribes a D-Bus client to the TimersChanged signal.
+/*!
+ *  The signal is sent when the state of a timer changes by at least the
+ *  requested granularity in seconds. With multiple subscribers, the smallest
+ *  granularity is used. The subscription ends when the client leaves the bus.
+ */
+void
+Core::subscribe_timers(int granularity, const std::string &sender)
+{
+  TRACE_ENTRY_PAR(granularity, sender);
+  if (sender.empty())
+    {
+      return;
+    }
+
+  if (timer_subscribers.find(sender) == timer_subscribers.end())
+    {
+      dbus->watch(sender, this);
+    }
+
+  timer_subscribers[sender] = std::max(granularity, 1);
+  last_timer_status.clear();
+}
+
+//! Unsubscribes a D-Bus client from the TimersChanged signal.
+void
+Core::unsubscribe_timers(const std::string &sender)
+{
+  TRACE_ENTRY_PAR(sender);
+  if (timer_subscribers.erase(sender) > 0)
+    {
+      dbus->unwatch(sender);
+    }
+}
+
+void
+Core::bus_name_presence(const std::string &name, bool present)
+{
+  TRACE_ENTRY_PAR(name, present);
+  if (!present)
+    {
+      unsubscribe_timers(name);
+    }
+}
+
+//! Returns the smallest granularity requested by the subscribers, or 0 without subscribers.
+int
+Core::get_timer_subscription_granularity() const
+{
+  int granularity = 0;
+
+  for (const auto &[sender, value]: timer_subscribers)
+    {
+      granularity = granularity == 0 ? value : std::min(granularity, value);
+    }
+
+  return granularity;
+}
+
+//! Returns the time at which a timer value next crosses a multiple of the granularity.
+/*!
+ *  Only the idle time of stopped timers, and the elapsed, remaining and
+ *  overdue times of running timers change. Changes of the running state
+ *  are timer events. Returns 0 if no value changes.
+ */
+int64_t
+Core::get_next_timer_subscription_time(int64_t current_time, int granularity)
+{
+  TimerStatusList timers;
+  get_timers_snapshot(timers);
+
+  int64_t delay = 0;
+  auto consider = [&delay](int64_t d) { delay = delay == 0 ? d : std::min(delay, d); };
+
+  // Seconds until an increasing value, or a decreasing value that is rounded up,
+  // is quantized differently.
+  auto next_up = [granularity](int32_t value) { return granularity - value % granularity; };
+  auto next_down = [granularity](int32_t value) { return (value - 1) % granularity + 1; };
+
+  for (const TimerStatus &status: timers)
+    {
+      if (status.running)
+        {
+          consider(next_up(status.elapsed));
+          if (status.remaining > 0)
+            {
+              consider(next_down(status.remaining));
+            }
+          else if (status.remaining == 0)
+            {
+              consider(next_up(status.overdue));
+            }
+        }
+      else if (status.idle >= 0)
+        {
+          consider(next_up(status.idle));
+        }
+    }
+
+  return delay != 0 ? current_time + delay : 0;
+}
+
+//! Sends the TimersChanged signal when a timer changed by at least the subscribed granularity.
+void
+Core::process_timer_subscriptions()
+{
+  int granularity = get_timer_subscription_granularity();
+  if (granularity == 0)
+    {
+      return;
+    }
+
+  TimerStatusList timers;
+  get_timers_snapshot(timers);
+
+  auto quantize = [granularity](int32_t value) { return value >= 0 ? value / granularity : -1; };
+
+  // Remaining time is rounded up, so that it changes together with the elapsed time.
+  auto quantize_remaining = [granularity](int32_t value) { return value >= 0 ? (value + granularity - 1) / granularity : -1; };
+
+  bool changed = timers.size() != last_timer_status.size();
+  for (size_t i = 0; !changed && i < timers.size(); i++)
+    {
+      const TimerStatus &a = timers[i];
+      const TimerStatus &b = last_timer_status[i];
+
+      changed = a.running != b.running || quantize(a.idle) != quantize(b.idle) || quantize(a.elapsed) != quantize(b.elapsed)
+                || quantize_remaining(a.remaining) != quantize_remaining(b.remaining) || quantize(a.overdue) != quantize(b.overdue);
+    }
+
+  if (!changed)
+    {
+      return;
+    }
+
+  last_timer_status = timers;
+  timers_changed_signal(timers);
+
+#ifdef HAVE_DBUS
+  org_workrave_CoreInterface *iface = org_workrave_CoreInterface::instance(dbus);
+  if (iface != nullptr)
+    {
+      iface->TimersChanged("/org/workrave/Workrave/Core", timers);
+    }
+#endif
+}
+
 //! Processes all timers.
 void
 Core::process_timers()
@@ -1265,6 +1608,48 @@ Core::process_timers()
     }
 }
 
+//! Returns whether processing the timers would change their state.
+bool
+Core::is_timer_processing_required()
+{
+  TRACE_ENTRY();
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      Timer *timer = breaks[i].get_timer();
+      bool enabled = breaks[i].is_enabled();
+
+      if (i == BREAK_ID_DAILY_LIMIT)
+        {
+          if ((enabled && !timer->is_enabled()) || (timer->is_limit_enabled() != (enabled && timer->get_limit() > 0)))
+            {
+              return true;
+            }
+        }
+      else if (timer->is_enabled() != enabled)
+        {
+          return true;
+        }
+
+      if (!(timer->has_activity_monitor()) && timer->is_processing_required(monitor_state))
+        {
+          return true;
+        }
+    }
+
+  // The state of timers with their own activity monitor depends on the
+  // other timers, which are unchanged at this point.
+  for (auto &brk: breaks)
+    {
+      Timer *timer = brk.get_timer();
+      if (timer->has_activity_monitor() && timer->is_processing_required(monitor_state))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
 #if defined(PLATFORM_OS_WINDOWS)
 
 //! Process a possible timewarp on Win32
@@ -1330,7 +1715,10 @@ Core::process_timewarp()
   TRACE_ENTRY();
   if (last_process_time != 0)
     {
-      int gap = current_time - 1 - last_process_time;
+      // The monotonic clock does not advance while the system is suspended.
+      // Heartbeats that were skipped or delayed do not count as timewarp.
+      int64_t monotonic_gap = TimeSource::get_monotonic_time_sec() - last_process_monotonic_time;
+      int64_t gap = current_time - last_process_time - monotonic_gap;
 
       if (gap >= 30)
         {
@@ -1550,23 +1938,40 @@ Core::daily_reset()
 }
 
 //! Saves the current state.
+/*!
+ *  The state is only written if the state of a timer changed since the last
+ *  save, unless force is set. The state file is written in the background,
+ *  together with any statistics staged since the last save.
+ */
 void
-Core::save_state() const
+Core::save_state(bool force)
 {
-  std::filesystem::path path = Paths::get_state_directory() / "state";
-  ofstream stateFile(path.string());
-
-  int64_t current_time = TimeSource::get_real_time_sec();
-  stateFile << "WorkRaveState 3" << endl << current_time << endl;
-
+  string timer_state;
   for (int i = 0; i < BREAK_ID_SIZEOF; i++)
     {
-      string stateStr = breaks[i].get_timer()->serialize_state();
+      timer_state += breaks[i].get_timer()->get_persistent_state();
+      timer_state += "\n";
+    }
+
+  if (force || timer_state != last_saved_state)
+    {
+      last_saved_state = timer_state;
 
-      stateFile << stateStr << endl;
+      stringstream ss;
+      int64_t current_time = TimeSource::get_real_time_sec();
+      ss << "WorkRaveState 3" << endl << current_time << endl;
+
+      for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+        {
+          string stateStr = breaks[i].get_timer()->serialize_state();
+
+          ss << stateStr << endl;
+        }
+
+      state_writer.stage(Paths::get_state_directory() / "state", ss.str());
     }
 
-  stateFile.close();
+  state_writer.commit();
 }
 
 //! Loads miscellaneous
@@ -1797,7 +2202,7 @@ Core::client_message(DistributionClientMessageID id, bool master, const char *cl
       break;
 
     case DCM_TIMERS:
-      ret = set_timer_state(buffer);
+      ret = set_timer_state(client_id, buffer);
       break;
 
     case DCM_MONITOR:
@@ -1891,10 +2296,36 @@ Core::set_break_state(bool master, PacketBuffer &buffer)
   return true;
 }
 
+//! Packs the state of all timers.
+/*!
+ *  The compact encoding packs the timer ids through the string table and
+ *  replicates the state of the timers as deltas to the previous message.
+ */
 bool
-Core::request_timer_state(PacketBuffer &buffer) const
+Core::request_timer_state(PacketBuffer &buffer)
 {
   TRACE_ENTRY();
+  if (buffer.is_compact())
+    {
+      std::vector<int64_t> values;
+      values.reserve(BREAK_ID_SIZEOF * TIMER_STATE_FIELDS);
+
+      buffer.pack_varint(BREAK_ID_SIZEOF);
+      for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+        {
+          Timer *t = breaks[i].get_timer();
+          buffer.pack_string_ref(t->get_id());
+
+          Timer::TimerStateData state_data{};
+          t->get_state_data(state_data);
+          timer_state_to_values(state_data, values);
+        }
+
+      timer_replicator.set_number_of_peers(dist_manager->get_number_of_peers());
+      timer_replicator.pack(buffer, values);
+      return true;
+    }
+
   buffer.pack_ushort(BREAK_ID_SIZEOF);
 
   for (int i = 0; i < BREAK_ID_SIZEOF; i++)
@@ -1925,10 +2356,44 @@ Core::request_timer_state(PacketBuffer &buffer) const
   return true;
 }
 
+//! Applies the state of the timers of a remote client.
 bool
-Core::set_timer_state(PacketBuffer &buffer)
+Core::set_timer_state(const char *client_id, PacketBuffer &buffer)
 {
   TRACE_ENTRY();
+  if (buffer.is_compact())
+    {
+      guint64 num_timers = buffer.unpack_varint();
+      if (client_id == nullptr || num_timers > static_cast<guint64>(buffer.bytes_available()))
+        {
+          return false;
+        }
+
+      std::vector<Timer *> timers;
+      for (guint64 i = 0; i < num_timers; i++)
+        {
+          timers.push_back(get_timer(std::string(buffer.unpack_string_ref())));
+        }
+
+      std::vector<int64_t> values;
+      if (!timer_replicator.unpack(client_id, buffer, values) || values.size() != timers.size() * TIMER_STATE_FIELDS)
+        {
+          TRACE_MSG("Waiting for snapshot");
+          return false;
+        }
+
+      for (std::size_t i = 0; i < timers.size(); i++)
+        {
+          if (timers[i] != nullptr)
+            {
+              Timer::TimerStateData state_data{};
+              values_to_timer_state(&values[i * TIMER_STATE_FIELDS], state_data);
+              timers[i]->set_state_data(state_data);
+            }
+        }
+      return true;
+    }
+
   int num_breaks = buffer.unpack_ushort();
 
   TRACE_MSG("numtimer = {}", num_breaks);
@@ -1976,6 +2441,34 @@ Core::set_timer_state(PacketBuffer &buffer)
   return true;
 }
 
+//! Appends the replicated fields of the timer state to values.
+void
+Core::timer_state_to_values(const Timer::TimerStateData &state_data, std::vector<int64_t> &values)
+{
+  values.push_back(state_data.current_time);
+  values.push_back(state_data.elapsed_time);
+  values.push_back(state_data.elapsed_idle_time);
+  values.push_back(state_data.last_pred_reset_time);
+  values.push_back(state_data.total_overdue_time);
+  values.push_back(state_data.last_limit_time);
+  values.push_back(state_data.last_limit_elapsed);
+  values.push_back(state_data.snooze_inhibited ? 1 : 0);
+}
+
+//! Restores the timer state from TIMER_STATE_FIELDS replicated fields.
+void
+Core::values_to_timer_state(const int64_t *values, Timer::TimerStateData &state_data)
+{
+  state_data.current_time = values[0];
+  state_data.elapsed_time = values[1];
+  state_data.elapsed_idle_time = values[2];
+  state_data.last_pred_reset_time = values[3];
+  state_data.total_overdue_time = values[4];
+  state_data.last_limit_time = values[5];
+  state_data.last_limit_elapsed = values[6];
+  state_data.snooze_inhibited = values[7] != 0;
+}
+
 bool
 Core::set_monitor_state(bool master, PacketBuffer &buffer)
 {
@@ -2027,6 +2520,8 @@ Core::signoff_remote_client(string client_id)
     }
 
   idlelog_manager->signoff_remote_client(client_id);
+  timer_replicator.forget(client_id);
+  statistics->signoff_remote_client(client_id);
 }
 
 void
@@ -2167,3 +2662,9 @@ Core::signal_usage_mode_changed()
 {
   return usage_mode_changed_signal;
 }
+
+boost::signals2::signal<void(const Core::TimerStatusList &)> &
+Core::signal_timers_changed()
+{
+  return timers_changed_signal;
+}
@@ -31,6 +31,7 @@
 #include <iostream>
 #include <string>
 #include <map>
+#include <vector>
 
 #include "Break.hh"
 #include "IActivityMonitor.hh"
@@ -42,8 +43,10 @@
 #include "utils/Diagnostics.hh"
 #include "CoreHooks.hh"
 #include "LocalActivityMonitor.hh"
+#include "StateWriter.hh"
 
 #include "dbus/IDBus.hh"
+#include "dbus/IDBusWatch.hh"
 
 using namespace workrave;
 
@@ -56,6 +59,7 @@ class BreakControl;
 #  include "DistributionManager.hh"
 #  include "IDistributionClientMessage.hh"
 #  include "DistributionListener.hh"
+#  include "DeltaReplicator.hh"
 #endif
 
 class Core
@@ -67,8 +71,22 @@ class Core
 #endif
   public ICore
   , public workrave::config::IConfiguratorListener
+  , public workrave::dbus::IDBusWatch
 {
 public:
+  //! State of a timer as published on D-Bus.
+  struct TimerStatus
+  {
+    BreakId timer_id{BREAK_ID_NONE};
+    bool running{false};
+    int32_t idle{0};
+    int32_t elapsed{0};
+    int32_t remaining{-1};
+    int32_t overdue{0};
+  };
+
+  using TimerStatusList = std::vector<TimerStatus>;
+
   Core();
   ~Core() override;
 
@@ -94,6 +112,8 @@ public:
   DistributionManager *get_distribution_manager() const override;
 #endif
   Statistics *get_statistics() const override;
+  TimerSnapshot::Ptr get_timer_snapshot() const override;
+  StateWriter *get_state_writer();
   void set_core_events_listener(ICoreEventListener *l) override;
   void force_break(BreakId id, workrave::utils::Flags<BreakHint> break_hint) override;
   void time_changed() override;
@@ -135,6 +155,10 @@ public:
   void get_timer_remaining(BreakId id, int *value);
   void get_timer_idle(BreakId id, int *value);
   void get_timer_overdue(BreakId id, int *value);
+  void get_timers_snapshot(TimerStatusList &timers);
+  void subscribe_timers(int granularity, const std::string &sender);
+  void unsubscribe_timers(const std::string &sender);
+  boost::signals2::signal<void(const TimerStatusList &)> &signal_timers_changed();
 
   void postpone_break(BreakId break_id);
   void skip_break(BreakId break_id);
@@ -161,15 +185,23 @@ private:
   void load_monitor_config();
   void config_changed_notify(const std::string &key) override;
   void heartbeat() override;
+  int64_t get_next_heartbeat_time() override;
+  void set_input_wakeup_handler(std::function<void()> handler) override;
   void timer_action(BreakId id, TimerInfo info);
   void process_distribution();
   void process_state();
   bool process_timewarp();
   void process_timers();
+  bool is_timer_processing_required();
+  void process_timer_subscriptions();
+  void update_timer_snapshot();
+  int get_timer_subscription_granularity() const;
+  int64_t get_next_timer_subscription_time(int64_t current_time, int granularity);
+  void bus_name_presence(const std::string &name, bool present) override;
   void start_break(BreakId break_id, BreakId resume_this_break = BREAK_ID_NONE);
   void stop_all_breaks();
   void daily_reset();
-  void save_state() const;
+  void save_state(bool force = false);
   void load_state();
   void load_misc();
   void do_postpone_break(BreakId break_id);
@@ -191,8 +223,10 @@ private:
   bool request_break_state(PacketBuffer &buffer);
   bool set_break_state(bool master, PacketBuffer &buffer);
 
-  bool request_timer_state(PacketBuffer &buffer) const;
-  bool set_timer_state(PacketBuffer &buffer);
+  bool request_timer_state(PacketBuffer &buffer);
+  bool set_timer_state(const char *client_id, PacketBuffer &buffer);
+  static void timer_state_to_values(const Timer::TimerStateData &state_data, std::vector<int64_t> &values);
+  static void values_to_timer_state(const int64_t *values, Timer::TimerStateData &state_data);
 
   bool set_monitor_state(bool master, PacketBuffer &buffer);
 
@@ -226,6 +260,9 @@ private:
   //! The time we last processed the timers.
   int64_t last_process_time{0};
 
+  //! The monotonic time we last processed the timers.
+  int64_t last_process_monotonic_time{0};
+
   //! Are we the master node??
   TracedField<bool> master_node{"core.master_node", true};
 
@@ -247,6 +284,12 @@ private:
   //! The statistics collector.
   Statistics *statistics{nullptr};
 
+  //! Background writer of the state files.
+  StateWriter state_writer;
+
+  //! Timer state that was last written to the state file.
+  std::string last_saved_state;
+
   //! Current operation mode.
   TracedField<OperationMode> operation_mode_active{"core.operation_mode_active", OperationMode::Normal};
 
@@ -289,6 +332,18 @@ private:
   //! Hooks to alter the backend behaviour.
   CoreHooks::Ptr hooks;
 
+  //! Requested granularity in seconds of each TimersChanged subscriber.
+  std::map<std::string, int> timer_subscribers;
+
+  //! Timer states last sent to the subscribers.
+  TimerStatusList last_timer_status;
+
+  //! State of all timers at the last heartbeat.
+  TimerSnapshot::Ptr timer_snapshot;
+
+  //! Has the timer or break configuration changed since the last snapshot?
+  bool timer_config_changed{false};
+
 #ifdef HAVE_DISTRIBUTION
   //! The Distribution Manager
   DistributionManager *dist_manager{nullptr};
@@ -299,6 +354,12 @@ private:
   //! Manager that collects idle times of all clients.
   IdleLogManager *idlelog_manager{nullptr};
 
+  //! Number of replicated fields per timer.
+  static constexpr int TIMER_STATE_FIELDS = 8;
+
+  //! Replicates the timer state to remote clients.
+  DeltaReplicator timer_replicator;
+
 #  ifndef NDEBUG
   //! A fake activity monitor for testing puposes.
   FakeActivityMonitor *fake_monitor{nullptr};
@@ -314,6 +375,9 @@ private:
   //! Usage mode changed notification.
   boost::signals2::signal<void(workrave::UsageMode)> usage_mode_changed_signal;
 
+  //! Timers changed notification for the TimersChanged subscribers.
+  boost::signals2::signal<void(const TimerStatusList &)> timers_changed_signal;
+
 #ifdef HAVE_TESTS
   friend class Test;
 #endif
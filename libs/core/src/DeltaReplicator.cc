@@ -0,0 +1,185 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "DeltaReplicator.hh"
+
+#include <algorithm>
+#include <utility>
+
+#include "debug.hh"
+#include "PacketBuffer.hh"
+
+DeltaReplicator::DeltaReplicator(int snapshot_interval)
+  : snapshot_interval(snapshot_interval)
+{
+}
+
+//! Packs the values as snapshot or as delta to the previous message.
+void
+DeltaReplicator::pack(PacketBuffer &buffer, const std::vector<int64_t> &values)
+{
+  TRACE_ENTRY();
+  bool snapshot = snapshot_requested || deltas_since_snapshot >= snapshot_interval || values.size() != last_values.size();
+
+  seq++;
+
+  buffer.pack_byte(snapshot ? MESSAGE_SNAPSHOT : MESSAGE_DELTA);
+  buffer.pack_varint(seq);
+
+  if (snapshot)
+    {
+      buffer.pack_varint(values.size());
+      for (int64_t value: values)
+        {
+          buffer.pack_svarint(value);
+        }
+
+      deltas_since_snapshot = 0;
+      snapshot_requested = false;
+    }
+  else
+    {
+      int changed = 0;
+      for (size_t i = 0; i < values.size(); i++)
+        {
+          if (values[i] != last_values[i])
+            {
+              changed++;
+            }
+        }
+
+      // Indices are packed relative to the previous changed field.
+      buffer.pack_varint(changed);
+      size_t prev = 0;
+      for (size_t i = 0; i < values.size(); i++)
+        {
+          if (values[i] != last_values[i])
+            {
+              buffer.pack_varint(i - prev);
+              buffer.pack_svarint(values[i] - last_values[i]);
+              prev = i;
+            }
+        }
+
+      deltas_since_snapshot++;
+    }
+
+  TRACE_MSG("seq = {} snapshot = {}", seq, snapshot);
+  last_values = values;
+}
+
+//! Unpacks a message of the specified remote client.
+/*!
+ *  Returns false if the message cannot be applied because a previous
+ *  message was missed. The values are not modified in that case.
+ */
+bool
+DeltaReplicator::unpack(const std::string &source, PacketBuffer &buffer, std::vector<int64_t> &values)
+{
+  TRACE_ENTRY_PAR(source);
+  int kind = buffer.unpack_byte();
+  uint64_t message_seq = buffer.unpack_varint();
+
+  if (kind == MESSAGE_SNAPSHOT)
+    {
+      // Each value takes at least one byte. Larger counts are malformed.
+      uint64_t count = buffer.unpack_varint();
+      if (count > (uint64_t)std::max(buffer.bytes_available(), 0))
+        {
+          TRACE_MSG("invalid snapshot size {}", count);
+          sources.erase(source);
+          return false;
+        }
+
+      Source &s = sources[source];
+      s.seq = message_seq;
+      s.values.resize(count);
+
+      for (auto &value: s.values)
+        {
+          value = buffer.unpack_svarint();
+        }
+
+      values = s.values;
+      return true;
+    }
+
+  auto it = sources.find(source);
+  if (kind != MESSAGE_DELTA || it == sources.end() || it->second.seq + 1 != message_seq)
+    {
+      TRACE_MSG("out of sequence, waiting for snapshot");
+      return false;
+    }
+
+  Source &s = it->second;
+  std::vector<int64_t> updated = s.values;
+  uint64_t count = buffer.unpack_varint();
+  size_t index = 0;
+
+  if (count > updated.size())
+    {
+      sources.erase(it);
+      return false;
+    }
+
+  for (uint64_t i = 0; i < count; i++)
+    {
+      index += buffer.unpack_varint();
+      int64_t delta = buffer.unpack_svarint();
+
+      if (index >= updated.size())
+        {
+          sources.erase(it);
+          return false;
+        }
+      updated[index] += delta;
+    }
+
+  s.seq = message_seq;
+  s.values = updated;
+  values = std::move(updated);
+  return true;
+}
+
+//! Requests a snapshot when the number of peers changed.
+void
+DeltaReplicator::set_number_of_peers(int peers)
+{
+  if (peers != number_of_peers)
+    {
+      number_of_peers = peers;
+      snapshot_requested = true;
+    }
+}
+
+//! Sends a snapshot in the next message.
+void
+DeltaReplicator::request_snapshot()
+{
+  snapshot_requested = true;
+}
+
+//! Forgets the values of a remote client.
+void
+DeltaReplicator::forget(const std::string &source)
+{
+  sources.erase(source);
+}
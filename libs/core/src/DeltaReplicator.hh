@@ -0,0 +1,88 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef DELTAREPLICATOR_HH
+#define DELTAREPLICATOR_HH
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+class PacketBuffer;
+
+//! Replicates a fixed set of integer fields to remote clients.
+/*!
+ *  Each message carries a sequence number and either a snapshot of all
+ *  fields or only the fields that changed since the previous message.
+ *  A receiver only applies a delta on top of the message that directly
+ *  preceded it; after a missed message it waits for the next snapshot.
+ *  Snapshots are sent periodically and whenever the set of peers changes.
+ *
+ *  Requires the compact packet protocol.
+ */
+class DeltaReplicator
+{
+public:
+  static constexpr int DEFAULT_SNAPSHOT_INTERVAL = 16;
+
+  explicit DeltaReplicator(int snapshot_interval = DEFAULT_SNAPSHOT_INTERVAL);
+
+  void pack(PacketBuffer &buffer, const std::vector<int64_t> &values);
+  bool unpack(const std::string &source, PacketBuffer &buffer, std::vector<int64_t> &values);
+
+  void set_number_of_peers(int peers);
+  void request_snapshot();
+  void forget(const std::string &source);
+
+private:
+  enum MessageKind
+  {
+    MESSAGE_SNAPSHOT = 1,
+    MESSAGE_DELTA = 2,
+  };
+
+  struct Source
+  {
+    uint64_t seq{0};
+    std::vector<int64_t> values;
+  };
+
+private:
+  //! Number of deltas between snapshots.
+  int snapshot_interval;
+
+  //! Values sent in the previous message.
+  std::vector<int64_t> last_values;
+
+  //! Sequence number of the previous message.
+  uint64_t seq{0};
+
+  //! Number of deltas sent since the last snapshot.
+  int deltas_since_snapshot{0};
+
+  //! Whether the next message must be a snapshot.
+  bool snapshot_requested{true};
+
+  //! Number of peers when the previous message was sent.
+  int number_of_peers{0};
+
+  //! Last received values for each remote client.
+  std::map<std::string, Source> sources;
+};
+
+#endif // DELTAREPLICATOR_HH
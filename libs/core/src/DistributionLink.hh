@@ -37,6 +37,9 @@ public:
   //! Returns the number of remote peers.
   virtual int get_number_of_peers() = 0;
 
+  //! Returns the packet protocol that all remote peers understand.
+  virtual int get_protocol() const = 0;
+
   //! Sets the callback interface to the distribution manager.
   // virtual void set_distribution_manager(DistributionLinkListener *dll) = 0;
 
@@ -102,6 +102,20 @@ DistributionManager::get_number_of_peers()
   return ret;
 }
 
+//! Returns the packet protocol that all remote peers understand.
+int
+DistributionManager::get_protocol() const
+{
+  int ret = PACKET_PROTOCOL_LEGACY;
+
+  if (link != nullptr)
+    {
+      ret = link->get_protocol();
+    }
+
+  return ret;
+}
+
 //! Returns true if this node is master.
 bool
 DistributionManager::is_master() const
@@ -59,6 +59,7 @@ public:
   std::string get_master_id() const;
   std::string get_my_id() const;
   int get_number_of_peers() override;
+  int get_protocol() const;
   bool claim();
   bool set_lock_master(bool lock);
   bool connect(std::string url) override;
@@ -51,6 +51,15 @@
 using namespace std;
 using namespace workrave::utils;
 
+namespace
+{
+  //! Number of bytes read from a socket at once.
+  constexpr int READ_SIZE = 16 * 1024;
+
+  //! Maximum number of frames written at once.
+  constexpr int MAX_GATHERED_FRAMES = 16;
+} // namespace
+
 //! Construct a new socket link.
 /*!
  *  \param conf Configurator to use.
@@ -99,6 +108,25 @@ DistributionSocketLink::heartbeat()
 
       time_t current_time = time(nullptr);
 
+      // Disconnect clients that do not accept their data. Closing a client removes its peers from the list.
+      list<Client *> pending;
+      for (Client *c: clients)
+        {
+          if (c->disconnect_pending && c->socket != nullptr)
+            {
+              pending.push_back(c);
+            }
+        }
+
+      for (Client *c: pending)
+        {
+          if (is_client_valid(c) && c->disconnect_pending && c->socket != nullptr)
+            {
+              dist_manager->log(_("Client %s is not accepting data, closing."), c->id == nullptr ? "Unknown" : c->id);
+              close_client(c, c->outbound);
+            }
+        }
+
       // See if we have some clients that need reconncting.
       list<Client *>::iterator i = clients.begin();
       while (i != clients.end())
@@ -117,6 +145,7 @@ DistributionSocketLink::heartbeat()
                   c->socket->close();
                   delete c->socket;
                 }
+              reset_client_stream(c);
 
               ISocket *socket = socket_driver->create_socket();
               socket->set_data(c);
@@ -197,6 +226,34 @@ DistributionSocketLink::get_number_of_peers()
   return count;
 }
 
+//! Returns the packet protocol that all clients understand.
+/*!
+ *  Newer protocols are only used when all clients are directly connected
+ *  and negotiated them, because packets are forwarded unchanged.
+ */
+int
+DistributionSocketLink::get_protocol() const
+{
+  int protocol = PACKET_PROTOCOL_CHUNKED;
+
+  for (const Client *c: clients)
+    {
+      if (c->type == CLIENTTYPE_SIGNEDOFF)
+        {
+          continue;
+        }
+
+      if (c->type != CLIENTTYPE_DIRECT)
+        {
+          protocol = PACKET_PROTOCOL_LEGACY;
+          break;
+        }
+      protocol = std::min(protocol, c->protocol);
+    }
+
+  return protocol;
+}
+
 //! Join the WR network.
 void
 DistributionSocketLink::connect(string url)
@@ -439,15 +496,18 @@ DistributionSocketLink::broadcast_client_message(DistributionClientMessageID dsi
   TRACE_ENTRY();
   PacketBuffer packet;
   packet.create();
+  packet.set_protocol(buffer.get_protocol());
   init_packet(packet, PACKET_CLIENTMSG);
 
   string id = get_master();
   packet.pack_string(id);
 
+  int pos = 0;
   packet.pack_ushort(1);
   packet.pack_ushort(dsid);
-  packet.pack_ushort(buffer.bytes_written());
+  packet.reserve_size(pos);
   packet.pack_raw((unsigned char *)buffer.get_buffer(), buffer.bytes_written());
+  packet.update_size(pos);
 
   send_packet_broadcast(packet);
   return true;
@@ -734,6 +794,7 @@ DistributionSocketLink::close_client(Client *client, bool reconnect /* = false*/
           // Still connected. Disconnect.
           delete client->socket;
           client->socket = nullptr;
+          reset_client_stream(client);
 
           if (reconnect)
             {
@@ -763,6 +824,7 @@ DistributionSocketLink::close_client(Client *client, bool reconnect /* = false*/
           // Still connected. Disconnect.
           delete client->socket;
           client->socket = nullptr;
+          reset_client_stream(client);
 
           client->reconnect_count = 0;
           client->reconnect_time = 0;
@@ -906,7 +968,7 @@ DistributionSocketLink::init_packet(PacketBuffer &packet, PacketCommand cmd)
   // Length.
   packet.pack_ushort(0);
   // Version
-  packet.pack_byte(3);
+  packet.pack_byte(packet.get_protocol());
   // Flags
   packet.pack_byte(0);
   // Command
@@ -926,11 +988,6 @@ void
 DistributionSocketLink::send_packet_except(PacketBuffer &packet, Client *client)
 {
   TRACE_ENTRY();
-  gint size = packet.bytes_written();
-
-  // Length.
-  packet.poke_ushort(0, size);
-
   list<Client *>::iterator i = clients.begin();
   while (i != clients.end())
     {
@@ -938,15 +995,8 @@ DistributionSocketLink::send_packet_except(PacketBuffer &packet, Client *client)
 
       if (c != client && c->socket != nullptr)
         {
-          int bytes_written = 0;
-          try
-            {
-              c->socket->write(packet.get_buffer(), size, bytes_written);
-            }
-          catch (SocketException &)
-            {
-              TRACE_MSG("Failed to send");
-            }
+          queue_packet(c, packet);
+          flush_client(c);
         }
       i++;
     }
@@ -990,21 +1040,95 @@ DistributionSocketLink::send_packet(Client *client, PacketBuffer &packet)
           TRACE_MSG("Sending to {}", client->id);
         }
 
-      gint size = packet.bytes_written();
+      queue_packet(client, packet);
+      flush_client(client);
+    }
+}
+
+//! Queues the specified packet for the specified client.
+/*!
+ *  Packets that do not fit in a single frame are split into PACKET_CHUNK
+ *  frames, if the client supports them.
+ */
+void
+DistributionSocketLink::queue_packet(Client *client, PacketBuffer &packet)
+{
+  TRACE_ENTRY();
+  if (client->disconnect_pending)
+    {
+      return;
+    }
+
+  if (client->stream.is_write_queue_full())
+    {
+      // Disconnected by the next heartbeat. The queue is only checked before queueing, so that a
+      // single large packet does not disconnect the client.
+      TRACE_MSG("Client is not reading");
+      client->disconnect_pending = true;
+      return;
+    }
+
+  if (!client->stream.queue_packet(packet, client->protocol >= PACKET_PROTOCOL_CHUNKED))
+    {
+      dist_manager->log(_("Packet for client %s is too large, dropping."), client->id == nullptr ? "Unknown" : client->id);
+    }
+}
+
+//! Writes as much of the write queue of a client as the socket accepts.
+/*!
+ *  \return false if writing failed.
+ */
+bool
+DistributionSocketLink::flush_client(Client *client)
+{
+  TRACE_ENTRY();
+  if (client->socket == nullptr)
+    {
+      return false;
+    }
 
-      // Length.
-      packet.poke_ushort(0, size);
+  bool ok = true;
+  while (client->stream.is_write_pending())
+    {
+      ISocket::WriteBuffer buffers[MAX_GATHERED_FRAMES];
+      int size = 0;
+      int count = client->stream.gather(buffers, MAX_GATHERED_FRAMES, size);
 
       int bytes_written = 0;
       try
         {
-          client->socket->write(packet.get_buffer(), size, bytes_written);
+          client->socket->write(buffers, count, bytes_written);
         }
       catch (SocketException &)
         {
           TRACE_MSG("Failed to send");
+          client->disconnect_pending = true;
+          ok = false;
+          break;
         }
+
+      client->stream.consume(bytes_written);
+
+      if (bytes_written < size)
+        {
+          // Socket buffer is full. Continue when the socket is writable.
+          break;
+        }
+    }
+
+  if (client->socket != nullptr)
+    {
+      client->socket->set_write_notify(ok && client->stream.is_write_pending());
     }
+  return ok;
+}
+
+//! Drops all buffered incoming and outgoing data of a client.
+void
+DistributionSocketLink::reset_client_stream(Client *client)
+{
+  client->stream.clear();
+  client->disconnect_pending = false;
 }
 
 //! Processed an incoming packet.
@@ -1016,12 +1140,15 @@ DistributionSocketLink::process_client_packet(Client *client)
 
   client->claim_count = 0;
 
+  // The size of a chunked packet is 0.
   gint size = packet.unpack_ushort();
-  g_assert(size == packet.bytes_written());
+  g_assert(size == 0 || size == packet.bytes_written());
 
   gint version = packet.unpack_byte();
   gint flags = packet.unpack_byte();
 
+  packet.set_protocol(version >= PACKET_PROTOCOL_COMPACT ? std::min<int>(version, PACKET_PROTOCOL_CHUNKED) : PACKET_PROTOCOL_LEGACY);
+
   gint type = packet.unpack_ushort();
   TRACE_MSG("type = {}", type);
   if (client != nullptr && client->id != nullptr)
@@ -1217,6 +1344,9 @@ DistributionSocketLink::send_hello1(Client *client)
   packet.pack_string(get_my_id());
   packet.pack_string(rnd);
 
+  // Older clients ignore trailing data.
+  packet.pack_byte(PACKET_PROTOCOL_CHUNKED);
+
   send_packet(client, packet);
 }
 
@@ -1229,6 +1359,11 @@ DistributionSocketLink::handle_hello1(PacketBuffer &packet, Client *client)
   gchar *id = packet.unpack_string();
   gchar *rnd = packet.unpack_string();
 
+  if (packet.bytes_available() > 0)
+    {
+      client->protocol = std::min<int>(packet.unpack_byte(), PACKET_PROTOCOL_CHUNKED);
+    }
+
   TRACE_VAR(user, id, rnd);
 
   dist_manager->log(_("Client %s saying hello."), id != nullptr ? id : "Unknown");
@@ -1269,6 +1404,7 @@ DistributionSocketLink::send_hello2(Client *client, gchar *rnd)
   packet.pack_string(username);
   packet.pack_string(g_hmac_get_string(hmac));
   packet.pack_string(get_my_id());
+  packet.pack_byte(PACKET_PROTOCOL_CHUNKED);
 
   g_hmac_unref(hmac);
 
@@ -1284,6 +1420,11 @@ DistributionSocketLink::handle_hello2(PacketBuffer &packet, Client *client)
   gchar *pass = packet.unpack_string();
   gchar *id = packet.unpack_string();
 
+  if (packet.bytes_available() > 0)
+    {
+      client->protocol = std::min<int>(packet.unpack_byte(), PACKET_PROTOCOL_CHUNKED);
+    }
+
   TRACE_VAR(user, pass, id, client->challenge);
 
   dist_manager->log(_("Client %s saying hello."), id != nullptr ? id : "Unknown");
@@ -1867,6 +2008,7 @@ DistributionSocketLink::send_client_message(DistributionClientMessageType type)
   TRACE_ENTRY();
   PacketBuffer packet;
   packet.create();
+  packet.set_protocol(get_protocol());
   init_packet(packet, PACKET_CLIENTMSG);
 
   string id = get_master();
@@ -1885,6 +2027,7 @@ DistributionSocketLink::send_client_message(DistributionClientMessageType type)
       int pos = 0;
       packet.pack_ushort(id);
       packet.reserve_size(pos);
+      packet.reset_string_table();
 
       if ((sl.type & type) != 0)
         {
@@ -1939,6 +2082,7 @@ DistributionSocketLink::handle_client_message(PacketBuffer &packet, Client *clie
         {
           // Narrow the buffer to the client message data.
           packet.narrow(-1, datalen);
+          packet.reset_string_table();
 
           ClientMessageMap::iterator it = client_message_map.find(id);
           if (it != client_message_map.end())
@@ -2028,33 +2172,29 @@ DistributionSocketLink::socket_io(ISocket *con, void *data)
       return;
     }
 
-  int bytes_read = 0;
-  int bytes_to_read = 4;
-
-  TRACE_MSG("2 {}", client->packet.bytes_available());
-
-  if (client->packet.bytes_available() >= 4)
+  // Read everything that is available.
+  bool closed = false;
+  bool ok = true;
+  try
     {
-      TRACE_MSG("3");
-
-      bytes_to_read = client->packet.peek_ushort(0) - 4;
+      for (;;)
+        {
+          guint8 *buffer = client->stream.prepare_read(READ_SIZE);
 
-      TRACE_MSG("4 {}", bytes_to_read);
+          int bytes_read = 0;
+          con->read(buffer, READ_SIZE, bytes_read);
+          client->stream.commit_read(bytes_read);
 
-      if (bytes_to_read + 4 > client->packet.get_buffer_size())
-        {
-          TRACE_MSG("5 {}", bytes_to_read, client->packet.get_buffer_size());
-          // FIXME: the 1024 is lame...
-          client->packet.resize(bytes_to_read + 4 + 1024);
+          if (bytes_read == 0)
+            {
+              closed = true;
+            }
+          if (bytes_read < READ_SIZE)
+            {
+              break;
+            }
         }
     }
-
-  TRACE_MSG("5");
-  bool ok = true;
-  try
-    {
-      con->read(client->packet.get_write_ptr(), bytes_to_read, bytes_read);
-    }
   catch (SocketException &)
     {
       ok = false;
@@ -2065,28 +2205,81 @@ DistributionSocketLink::socket_io(ISocket *con, void *data)
       dist_manager->log(_("Client %s read error, closing."), client->id == nullptr ? "Unknown" : client->id);
       ret = false;
     }
-  else if (bytes_read == 0)
+  else if (!process_frames(client))
+    {
+      // Client was closed or removed while processing its packets.
+      return;
+    }
+  else if (closed)
     {
       dist_manager->log(_("Client %s closed connection."), client->id == nullptr ? "Unknown" : client->id);
       ret = false;
     }
-  else
+
+  if (!ret)
     {
-      g_assert(bytes_read > 0);
-      client->packet.write_ptr += bytes_read;
+      close_client(client, client->outbound);
+    }
 
-      if (client->packet.peek_ushort(0) == client->packet.bytes_written())
+  return;
+}
+
+//! Processes all complete packets in the read buffer of a client.
+/*!
+ *  \return false if the client was closed or removed.
+ */
+bool
+DistributionSocketLink::process_frames(Client *client)
+{
+  TRACE_ENTRY();
+  ISocket *socket = client->socket;
+
+  for (;;)
+    {
+      PacketStream::ReadStatus status = client->stream.read_packet(client->packet);
+      if (status == PacketStream::ReadStatus::Incomplete)
         {
-          process_client_packet(client);
+          break;
+        }
+
+      if (status == PacketStream::ReadStatus::Invalid)
+        {
+          dist_manager->log(_("Client %s sent an invalid packet, closing."), client->id == nullptr ? "Unknown" : client->id);
+          close_client(client, client->outbound);
+          return false;
+        }
+
+      process_client_packet(client);
+
+      if (!is_client_valid(client) || client->socket != socket)
+        {
+          return false;
         }
     }
 
-  if (!ret)
+  return true;
+}
+
+void
+DistributionSocketLink::socket_writable(ISocket *con, void *data)
+{
+  TRACE_ENTRY();
+  (void)con;
+
+  Client *client = (Client *)data;
+  g_assert(client != nullptr);
+
+  if (!is_client_valid(client))
     {
-      close_client(client, client->outbound);
+      TRACE_MSG("Invalid client");
+      return;
     }
 
-  return;
+  if (!flush_client(client))
+    {
+      dist_manager->log(_("Client %s write error, closing."), client->id == nullptr ? "Unknown" : client->id);
+      close_client(client, client->outbound);
+    }
 }
 
 void
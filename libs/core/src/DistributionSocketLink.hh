@@ -25,6 +25,7 @@
 #include "IDistributionClientMessage.hh"
 #include "config/IConfiguratorListener.hh"
 #include "PacketBuffer.hh"
+#include "PacketStream.hh"
 
 #include "SocketDriver.hh"
 #include "utils/WRID.hh"
@@ -53,6 +54,7 @@ private:
     PACKET_CLAIM_REJECT = 0x0008,
     PACKET_SIGNOFF = 0x0009,
     PACKET_HELLO2 = 0x000A,
+    PACKET_CHUNK = 0x000B,
   };
 
   enum PacketFlags
@@ -125,9 +127,18 @@ private:
     //!
     bool welcome{false};
 
-    //!
+    //! Packet that is being processed.
     PacketBuffer packet;
 
+    //! Framing of the packets exchanged with the client.
+    PacketStream stream{PACKET_CHUNK};
+
+    //! The client does not accept its data, and is disconnected by the next heartbeat.
+    bool disconnect_pending{false};
+
+    //! Packet protocol negotiated with the client.
+    int protocol{PACKET_PROTOCOL_LEGACY};
+
     //! Reconnect counter;
     int reconnect_count{0};
 
@@ -154,6 +165,7 @@ public:
   void init_my_id();
   std::string get_my_id() const override;
   int get_number_of_peers() override;
+  int get_protocol() const override;
   void set_distribution_manager(DistributionManager *dll);
   void init();
   void heartbeat() override;
@@ -176,6 +188,7 @@ public:
   void socket_accepted(ISocketServer *server, ISocket *con) override;
   void socket_connected(ISocket *con, void *data) override;
   void socket_io(ISocket *con, void *data) override;
+  void socket_writable(ISocket *con, void *data) override;
   void socket_closed(ISocket *con, void *data) override;
 
 private:
@@ -200,6 +213,10 @@ private:
   void send_packet_broadcast(PacketBuffer &packet);
   void send_packet_except(PacketBuffer &packet, Client *client);
   void send_packet(Client *client, PacketBuffer &packet);
+  void queue_packet(Client *client, PacketBuffer &packet);
+  bool flush_client(Client *client);
+  void reset_client_stream(Client *client);
+  bool process_frames(Client *client);
   void forward_packet_except(PacketBuffer &packet, Client *client, Client *source);
   void forward_packet(PacketBuffer &packet, Client *dest, Client *source);
 
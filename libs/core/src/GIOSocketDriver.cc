@@ -21,6 +21,8 @@
 
 #if defined(HAVE_GIO_NET) && defined(HAVE_DISTRIBUTION)
 
+#  include <vector>
+
 #  include "debug.hh"
 #  include "GIOSocketDriver.hh"
 
@@ -159,6 +161,31 @@ GIOSocket::static_data_callback(GSocket *socket, GIOCondition condition, gpointe
   return ret;
 }
 
+gboolean
+GIOSocket::static_write_callback(GSocket *socket, GIOCondition condition, gpointer user_data)
+{
+  TRACE_ENTRY_PAR((int)condition);
+
+  GIOSocket *giosocket = (GIOSocket *)user_data;
+
+  (void)socket;
+
+  try
+    {
+      if ((condition & G_IO_OUT) && giosocket->listener != nullptr)
+        {
+          // The listener may disable notifications or delete the socket.
+          giosocket->listener->socket_writable(giosocket, giosocket->user_data);
+        }
+    }
+  catch (...)
+    {
+      // Make sure that no exception reach the glib mainloop.
+      TRACE_MSG("Exception");
+    }
+  return TRUE;
+}
+
 //! Creates a new connection.
 GIOSocket::GIOSocket(GSocketConnection *connection)
   : connection(connection)
@@ -200,6 +227,7 @@ GIOSocket::~GIOSocket()
     {
       g_source_destroy(source);
     }
+  set_write_notify(false);
 }
 
 //! Connects to the specified host.
@@ -265,7 +293,7 @@ GIOSocket::read(void *buf, int count, int &bytes_read)
   TRACE_ENTRY_PAR(count);
 
   GError *error = nullptr;
-  gsize num_read = 0;
+  gssize num_read = 0;
 
   if (socket != nullptr)
     {
@@ -273,7 +301,17 @@ GIOSocket::read(void *buf, int count, int &bytes_read)
 
       if (error != nullptr)
         {
-          throw SocketException(string("socket read error: ") + error->message);
+          if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK))
+            {
+              num_read = -1;
+              g_error_free(error);
+            }
+          else
+            {
+              string msg = error->message;
+              g_error_free(error);
+              throw SocketException("socket read error: " + msg);
+            }
         }
     }
 
@@ -284,26 +322,72 @@ GIOSocket::read(void *buf, int count, int &bytes_read)
 //! Write to the connection.
 void
 GIOSocket::write(void *buf, int count, int &bytes_written)
+{
+  WriteBuffer buffer;
+  buffer.data = buf;
+  buffer.size = count;
+  write(&buffer, 1, bytes_written);
+}
+
+//! Write a number of buffers to the connection.
+void
+GIOSocket::write(const WriteBuffer *buffers, int count, int &bytes_written)
 {
   GError *error = nullptr;
-  gsize num_written = 0;
+  gssize num_written = 0;
   if (socket != nullptr)
     {
-      num_written = g_socket_send(socket, (char *)buf, count, nullptr, &error);
+      std::vector<GOutputVector> vectors(count);
+      for (int i = 0; i < count; i++)
+        {
+          vectors[i].buffer = buffers[i].data;
+          vectors[i].size = buffers[i].size;
+        }
+
+      num_written = g_socket_send_message(socket, nullptr, vectors.data(), count, nullptr, 0, 0, nullptr, &error);
       if (error != nullptr)
         {
-          throw SocketException(string("socket write error: ") + error->message);
+          if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK))
+            {
+              num_written = 0;
+              g_error_free(error);
+            }
+          else
+            {
+              string msg = error->message;
+              g_error_free(error);
+              throw SocketException("socket write error: " + msg);
+            }
         }
     }
   bytes_written = (int)num_written;
 }
 
+//! Enables or disables notifications when the connection can accept more data.
+void
+GIOSocket::set_write_notify(bool enabled)
+{
+  if (enabled && write_source == nullptr && socket != nullptr)
+    {
+      write_source = g_socket_create_source(socket, G_IO_OUT, nullptr);
+      g_source_set_callback(write_source, reinterpret_cast<GSourceFunc>(static_write_callback), (void *)this, nullptr);
+      g_source_attach(write_source, nullptr);
+    }
+  else if (!enabled && write_source != nullptr)
+    {
+      g_source_destroy(write_source);
+      g_source_unref(write_source);
+      write_source = nullptr;
+    }
+}
+
 //! Close the connection.
 void
 GIOSocket::close()
 {
   TRACE_ENTRY();
   GError *error = nullptr;
+  set_write_notify(false);
   if (socket != nullptr)
     {
       g_socket_shutdown(socket, TRUE, TRUE, &error);
@@ -57,6 +57,8 @@ public:
   void connect(const std::string &hostname, int port) override;
   void read(void *buf, int count, int &bytes_read) override;
   void write(void *buf, int count, int &bytes_written) override;
+  void write(const WriteBuffer *buffers, int count, int &bytes_written) override;
+  void set_write_notify(bool enabled) override;
   void close() override;
 
 private:
@@ -68,11 +70,14 @@ private:
 
   static gboolean static_data_callback(GSocket *socket, GIOCondition condition, gpointer user_data);
 
+  static gboolean static_write_callback(GSocket *socket, GIOCondition condition, gpointer user_data);
+
 private:
   GSocketConnection *connection{nullptr};
   GSocket *socket{nullptr};
   GResolver *resolver{nullptr};
   GSource *source{nullptr};
+  GSource *write_source{nullptr};
   int port{0};
 };
 
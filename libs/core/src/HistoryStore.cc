@@ -0,0 +1,634 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "HistoryStore.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#if defined(PLATFORM_OS_WINDOWS)
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include "debug.hh"
+
+using namespace workrave;
+
+namespace
+{
+  const char HISTORY_MAGIC[4] = {'W', 'R', 'H', 'S'};
+  const uint32_t HISTORY_VERSION = 1;
+
+  // Header layout: magic, version, record size, break count, break value count, misc value count, 2 reserved.
+  const int MAGIC_OFFSET = 0;
+  const int VERSION_OFFSET = 4;
+  const int RECORD_SIZE_OFFSET = 8;
+  const int BREAK_COUNT_OFFSET = 12;
+  const int BREAK_VALUE_COUNT_OFFSET = 16;
+  const int MISC_VALUE_COUNT_OFFSET = 20;
+  const int HEADER_SIZE = 32;
+
+  // Record layout: date, start time, stop time, break stats, misc stats.
+  const int DATE_OFFSET = 0;
+  const int START_OFFSET = 4;
+  const int STOP_OFFSET = 24;
+  const int BREAK_STATS_OFFSET = 44;
+
+  uint32_t
+  misc_stats_offset(uint32_t break_count, uint32_t break_value_count)
+  {
+    uint32_t offset = BREAK_STATS_OFFSET + 4 * break_count * break_value_count;
+    return (offset + 7) & ~7U;
+  }
+
+  void
+  put_uint32(char *p, uint32_t value)
+  {
+    memcpy(p, &value, sizeof(value));
+  }
+
+  uint32_t
+  get_uint32(const char *p)
+  {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+  }
+
+  void
+  encode_time(const struct tm &t, char *p)
+  {
+    int32_t fields[5] = {t.tm_mday, t.tm_mon, t.tm_year, t.tm_hour, t.tm_min};
+    memcpy(p, fields, sizeof(fields));
+  }
+
+  void
+  decode_time(const char *p, struct tm &t)
+  {
+    int32_t fields[5];
+    memcpy(fields, p, sizeof(fields));
+
+    memset((void *)&t, 0, sizeof(t));
+    t.tm_mday = fields[0];
+    t.tm_mon = fields[1];
+    t.tm_year = fields[2];
+    t.tm_hour = fields[3];
+    t.tm_min = fields[4];
+  }
+
+  //! Flushes a file to disk, so that it survives a crash once it is renamed or reported as written.
+  bool
+  sync_file(FILE *file)
+  {
+    bool ok = std::fflush(file) == 0;
+#if defined(PLATFORM_OS_WINDOWS)
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    return ok;
+  }
+} // namespace
+
+bool
+HistoryStore::Layout::operator==(const Layout &other) const
+{
+  return record_size == other.record_size && break_count == other.break_count && break_value_count == other.break_value_count
+         && misc_value_count == other.misc_value_count;
+}
+
+HistoryStore::~HistoryStore()
+{
+  close();
+}
+
+//! Opens the history file, creating it if it does not exist.
+bool
+HistoryStore::open(const std::filesystem::path &p)
+{
+  TRACE_ENTRY_PAR(p.string());
+  close();
+
+  path = p;
+  layout = current_layout();
+
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(path, ec))
+    {
+      if (!write_all({}, layout))
+        {
+          path.clear();
+          return false;
+        }
+      return true;
+    }
+
+  char header[HEADER_SIZE];
+  Layout file_layout{};
+  {
+    std::ifstream file(path.string(), std::ios::binary);
+    file.read(header, sizeof(header));
+    if (!file || !decode_header(header, file_layout))
+      {
+        spdlog::warn("Invalid statistics history file {}", path.string());
+        path.clear();
+        return false;
+      }
+  }
+
+  if (file_layout.record_size < misc_stats_offset(file_layout.break_count, file_layout.break_value_count) + 8 * file_layout.misc_value_count)
+    {
+      spdlog::warn("Corrupt statistics history file {}", path.string());
+      path.clear();
+      return false;
+    }
+
+  auto file_size = std::filesystem::file_size(path, ec);
+  if (ec)
+    {
+      spdlog::warn("Cannot determine size of statistics history file {}: {}", path.string(), ec.message());
+      path.clear();
+      return false;
+    }
+
+  count = static_cast<int>((file_size - HEADER_SIZE) / file_layout.record_size);
+
+  // Drop a partially written record, so that new records are appended at a record boundary.
+  if (HEADER_SIZE + count * file_layout.record_size != file_size)
+    {
+      std::filesystem::resize_file(path, HEADER_SIZE + count * file_layout.record_size, ec);
+    }
+
+  if (!(file_layout == layout) && !upgrade(file_layout))
+    {
+      path.clear();
+      return false;
+    }
+
+  last_date = count > 0 ? get_date(count - 1) : 0;
+  return true;
+}
+
+//! Opens an empty history that is only kept in memory.
+void
+HistoryStore::open_in_memory()
+{
+  close();
+  path.clear();
+  layout = current_layout();
+  in_memory = true;
+}
+
+//! Closes the history file.
+void
+HistoryStore::close()
+{
+  unmap();
+  records.clear();
+  in_memory = false;
+  count = 0;
+  last_date = 0;
+}
+
+//! Removes the history file.
+bool
+HistoryStore::remove()
+{
+  if (in_memory)
+    {
+      open_in_memory();
+      return true;
+    }
+
+  close();
+  if (path.empty())
+    {
+      return true;
+    }
+
+  std::error_code ec;
+  std::filesystem::remove(path, ec);
+  if (ec)
+    {
+      return false;
+    }
+  return write_all({}, layout);
+}
+
+//! Returns whether the history is only kept in memory.
+bool
+HistoryStore::is_in_memory() const
+{
+  return in_memory;
+}
+
+//! Returns the number of days in the history.
+int
+HistoryStore::size() const
+{
+  return count;
+}
+
+//! Retrieves the statistics of the day with the specified index. Index 0 is the oldest day.
+void
+HistoryStore::get(int index, DailyStats &stats) const
+{
+  const char *r = record(index);
+  if (r != nullptr)
+    {
+      decode(layout, r, stats);
+    }
+}
+
+//! Returns the date of the day with the specified index.
+int
+HistoryStore::get_date(int index) const
+{
+  int32_t date = 0;
+  const char *r = record(index);
+  if (r != nullptr)
+    {
+      memcpy(&date, r + DATE_OFFSET, sizeof(date));
+    }
+  return date;
+}
+
+//! Returns the index of the first day at or after the specified date.
+int
+HistoryStore::lower_bound(int date) const
+{
+  int lo = 0;
+  int hi = count;
+
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+      if (get_date(mid) < date)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+  return lo;
+}
+
+//! Stores the statistics of a day.
+/*!
+ *  Days are normally added in chronological order and are appended to the
+ *  file. A day that is already present is replaced in place.
+ */
+void
+HistoryStore::put(const DailyStats &stats)
+{
+  TRACE_ENTRY();
+  if (path.empty() && !in_memory)
+    {
+      return;
+    }
+
+  int date = to_date(stats);
+
+  std::vector<char> data(layout.record_size, 0);
+  encode(layout, stats, data.data());
+
+  int index = (count == 0 || date > last_date) ? count : lower_bound(date);
+  bool replace = index < count && get_date(index) == date;
+
+  if (in_memory)
+    {
+      auto pos = records.begin() + static_cast<std::ptrdiff_t>(index * layout.record_size);
+      if (replace)
+        {
+          std::copy(data.begin(), data.end(), pos);
+        }
+      else
+        {
+          records.insert(pos, data.begin(), data.end());
+          count++;
+        }
+    }
+  else if (index == count || replace)
+    {
+      // Appended or replaced in place.
+      unmap();
+      if (write_at(data.data(), data.size(), HEADER_SIZE + index * layout.record_size) && !replace)
+        {
+          count++;
+        }
+    }
+  else
+    {
+      // Out of order, rewrite the file.
+      const char *first = record(0);
+      if (first == nullptr)
+        {
+          return;
+        }
+
+      std::vector<char> all(first, first + count * layout.record_size);
+      all.insert(all.begin() + static_cast<std::ptrdiff_t>(index * layout.record_size), data.begin(), data.end());
+
+      unmap();
+      if (write_all(all, layout))
+        {
+          count++;
+        }
+    }
+
+  last_date = count > 0 ? std::max(last_date, date) : 0;
+}
+
+//! Converts a date to the key used to sort the history.
+int
+HistoryStore::to_date(int y, int m, int d)
+{
+  return y * 10000 + m * 100 + d;
+}
+
+//! Returns the key of the start date of the specified day.
+int
+HistoryStore::to_date(const DailyStats &stats)
+{
+  return to_date(stats.start.tm_year + 1900, stats.start.tm_mon + 1, stats.start.tm_mday);
+}
+
+HistoryStore::Layout
+HistoryStore::current_layout()
+{
+  Layout l{};
+  l.break_count = BREAK_ID_SIZEOF;
+  l.break_value_count = IStatistics::STATS_BREAKVALUE_SIZEOF;
+  l.misc_value_count = IStatistics::STATS_VALUE_SIZEOF;
+  l.record_size = misc_stats_offset(l.break_count, l.break_value_count) + 8 * l.misc_value_count;
+  return l;
+}
+
+void
+HistoryStore::encode(const Layout &l, const DailyStats &stats, char *r)
+{
+  int32_t date = to_date(stats);
+  memcpy(r + DATE_OFFSET, &date, sizeof(date));
+
+  encode_time(stats.start, r + START_OFFSET);
+  encode_time(stats.stop, r + STOP_OFFSET);
+
+  char *p = r + BREAK_STATS_OFFSET;
+  for (uint32_t i = 0; i < l.break_count; i++)
+    {
+      for (uint32_t j = 0; j < l.break_value_count; j++)
+        {
+          int32_t value = (i < BREAK_ID_SIZEOF && j < IStatistics::STATS_BREAKVALUE_SIZEOF) ? stats.break_stats[i][j] : 0;
+          memcpy(p, &value, sizeof(value));
+          p += sizeof(value);
+        }
+    }
+
+  p = r + misc_stats_offset(l.break_count, l.break_value_count);
+  for (uint32_t j = 0; j < l.misc_value_count; j++)
+    {
+      int64_t value = j < IStatistics::STATS_VALUE_SIZEOF ? stats.misc_stats[j] : 0;
+      memcpy(p, &value, sizeof(value));
+      p += sizeof(value);
+    }
+}
+
+void
+HistoryStore::decode(const Layout &l, const char *r, DailyStats &stats)
+{
+  decode_time(r + START_OFFSET, stats.start);
+  decode_time(r + STOP_OFFSET, stats.stop);
+
+  memset((void *)stats.break_stats, 0, sizeof(stats.break_stats));
+  memset((void *)stats.misc_stats, 0, sizeof(stats.misc_stats));
+
+  const char *p = r + BREAK_STATS_OFFSET;
+  for (uint32_t i = 0; i < l.break_count; i++)
+    {
+      for (uint32_t j = 0; j < l.break_value_count; j++)
+        {
+          int32_t value;
+          memcpy(&value, p, sizeof(value));
+          p += sizeof(value);
+
+          if (i < BREAK_ID_SIZEOF && j < IStatistics::STATS_BREAKVALUE_SIZEOF)
+            {
+              stats.break_stats[i][j] = value;
+            }
+        }
+    }
+
+  p = r + misc_stats_offset(l.break_count, l.break_value_count);
+  for (uint32_t j = 0; j < l.misc_value_count && j < IStatistics::STATS_VALUE_SIZEOF; j++)
+    {
+      memcpy(&stats.misc_stats[j], p, sizeof(int64_t));
+      p += sizeof(int64_t);
+    }
+}
+
+void
+HistoryStore::encode_header(const Layout &l, char *header)
+{
+  memset(header, 0, HEADER_SIZE);
+  memcpy(header + MAGIC_OFFSET, HISTORY_MAGIC, sizeof(HISTORY_MAGIC));
+  put_uint32(header + VERSION_OFFSET, HISTORY_VERSION);
+  put_uint32(header + RECORD_SIZE_OFFSET, l.record_size);
+  put_uint32(header + BREAK_COUNT_OFFSET, l.break_count);
+  put_uint32(header + BREAK_VALUE_COUNT_OFFSET, l.break_value_count);
+  put_uint32(header + MISC_VALUE_COUNT_OFFSET, l.misc_value_count);
+}
+
+bool
+HistoryStore::decode_header(const char *header, Layout &l)
+{
+  if (memcmp(header + MAGIC_OFFSET, HISTORY_MAGIC, sizeof(HISTORY_MAGIC)) != 0 || get_uint32(header + VERSION_OFFSET) != HISTORY_VERSION)
+    {
+      return false;
+    }
+
+  l.record_size = get_uint32(header + RECORD_SIZE_OFFSET);
+  l.break_count = get_uint32(header + BREAK_COUNT_OFFSET);
+  l.break_value_count = get_uint32(header + BREAK_VALUE_COUNT_OFFSET);
+  l.misc_value_count = get_uint32(header + MISC_VALUE_COUNT_OFFSET);
+  return true;
+}
+
+bool
+HistoryStore::map() const
+{
+  if (region || !records.empty() || count == 0)
+    {
+      return true;
+    }
+
+  try
+    {
+      mapping = std::make_unique<boost::interprocess::file_mapping>(path.string().c_str(), boost::interprocess::read_only);
+      region = std::make_unique<boost::interprocess::mapped_region>(*mapping, boost::interprocess::read_only);
+    }
+  catch (boost::interprocess::interprocess_exception &e)
+    {
+      spdlog::warn("Failed to map statistics history file {}, reading it instead: {}", path.string(), e.what());
+      unmap();
+      return read_records();
+    }
+
+  if (region->get_size() < HEADER_SIZE + count * layout.record_size)
+    {
+      spdlog::warn("Statistics history file {} is smaller than expected, reading it instead", path.string());
+      unmap();
+      return read_records();
+    }
+  return true;
+}
+
+void
+HistoryStore::unmap() const
+{
+  region.reset();
+  mapping.reset();
+  if (!in_memory)
+    {
+      records.clear();
+    }
+}
+
+//! Reads all records of the history file into memory.
+bool
+HistoryStore::read_records() const
+{
+  records.resize(count * layout.record_size);
+
+  std::ifstream file(path.string(), std::ios::binary);
+  file.seekg(HEADER_SIZE);
+  file.read(records.data(), static_cast<std::streamsize>(records.size()));
+  if (!file)
+    {
+      spdlog::warn("Failed to read statistics history file {}", path.string());
+      records.clear();
+      return false;
+    }
+  return true;
+}
+
+const char *
+HistoryStore::record(int index) const
+{
+  if (index < 0 || index >= count || !map())
+    {
+      return nullptr;
+    }
+
+  const char *base = region ? static_cast<const char *>(region->get_address()) + HEADER_SIZE : records.data();
+  return base + index * layout.record_size;
+}
+
+//! Converts a history file written with a different set of statistics to the current layout.
+bool
+HistoryStore::upgrade(const Layout &from)
+{
+  TRACE_ENTRY();
+  Layout to = layout;
+  layout = from;
+
+  std::vector<char> converted(count * to.record_size, 0);
+  for (int i = 0; i < count; i++)
+    {
+      DailyStats stats{};
+      get(i, stats);
+      encode(to, stats, converted.data() + i * to.record_size);
+    }
+
+  unmap();
+  layout = to;
+  return write_all(converted, to);
+}
+
+//! Writes data at the specified offset of the history file and flushes it to disk.
+bool
+HistoryStore::write_at(const char *data, std::size_t size, std::size_t offset)
+{
+  FILE *file = std::fopen(path.string().c_str(), "r+b");
+  if (file == nullptr)
+    {
+      spdlog::warn("Failed to open statistics history file {}", path.string());
+      return false;
+    }
+
+  bool ok = std::fseek(file, static_cast<long>(offset), SEEK_SET) == 0;
+  ok = ok && std::fwrite(data, 1, size, file) == size;
+  ok = ok && sync_file(file);
+  ok = (std::fclose(file) == 0) && ok;
+
+  if (!ok)
+    {
+      spdlog::warn("Failed to write statistics history file {}", path.string());
+    }
+  return ok;
+}
+
+//! Atomically replaces the history file.
+bool
+HistoryStore::write_all(const std::vector<char> &data, const Layout &l)
+{
+  std::filesystem::path tmp_path = path;
+  tmp_path += ".tmp";
+
+  char header[HEADER_SIZE];
+  encode_header(l, header);
+
+  FILE *file = std::fopen(tmp_path.string().c_str(), "wb");
+  if (file == nullptr)
+    {
+      spdlog::warn("Failed to create statistics history file {}", tmp_path.string());
+      return false;
+    }
+
+  bool ok = std::fwrite(header, 1, sizeof(header), file) == sizeof(header);
+  ok = ok && std::fwrite(data.data(), 1, data.size(), file) == data.size();
+  ok = ok && sync_file(file);
+  ok = (std::fclose(file) == 0) && ok;
+
+  std::error_code ec;
+  if (!ok)
+    {
+      spdlog::warn("Failed to write statistics history file {}", tmp_path.string());
+      std::filesystem::remove(tmp_path, ec);
+      return false;
+    }
+
+  std::filesystem::rename(tmp_path, path, ec);
+  if (ec)
+    {
+      spdlog::warn("Failed to replace statistics history file {}: {}", path.string(), ec.message());
+      return false;
+    }
+  return true;
+}
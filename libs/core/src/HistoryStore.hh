@@ -0,0 +1,116 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef HISTORYSTORE_HH
+#define HISTORYSTORE_HH
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "core/IStatistics.hh"
+
+//! Binary, memory-mapped store of daily statistics.
+/*!
+ *  The store consists of a header followed by fixed size records, one per
+ *  day, sorted by start date. New days are appended; days are looked up by
+ *  index or by binary search on the date without reading the whole file.
+ *  If the file cannot be mapped, the records are read into memory instead.
+ *  A store opened with open_in_memory() has no file at all.
+ */
+class HistoryStore
+{
+public:
+  using DailyStats = workrave::IStatistics::DailyStats;
+
+  HistoryStore() = default;
+  ~HistoryStore();
+
+  HistoryStore(const HistoryStore &) = delete;
+  HistoryStore &operator=(const HistoryStore &) = delete;
+
+  bool open(const std::filesystem::path &path);
+  void open_in_memory();
+  void close();
+  bool remove();
+
+  bool is_in_memory() const;
+  int size() const;
+  void get(int index, DailyStats &stats) const;
+  int get_date(int index) const;
+  int lower_bound(int date) const;
+  void put(const DailyStats &stats);
+
+  static int to_date(int y, int m, int d);
+  static int to_date(const DailyStats &stats);
+
+private:
+  struct Layout
+  {
+    uint32_t record_size;
+    uint32_t break_count;
+    uint32_t break_value_count;
+    uint32_t misc_value_count;
+
+    bool operator==(const Layout &other) const;
+  };
+
+  static Layout current_layout();
+  static void encode(const Layout &layout, const DailyStats &stats, char *record);
+  static void decode(const Layout &layout, const char *record, DailyStats &stats);
+  static void encode_header(const Layout &layout, char *header);
+  static bool decode_header(const char *header, Layout &layout);
+
+  bool map() const;
+  void unmap() const;
+  bool read_records() const;
+  bool upgrade(const Layout &from);
+  bool write_at(const char *data, std::size_t size, std::size_t offset);
+  bool write_all(const std::vector<char> &data, const Layout &layout);
+  const char *record(int index) const;
+
+private:
+  //! Path of the history file.
+  std::filesystem::path path;
+
+  //! Layout of the records in the history file.
+  Layout layout{};
+
+  //! Number of records in the history file.
+  int count{0};
+
+  //! Date of the most recent record, or 0 if the store is empty.
+  int last_date{0};
+
+  //! Are the records only kept in memory?
+  bool in_memory{false};
+
+  //! Records kept in memory, either because there is no history file or because mapping it failed.
+  mutable std::vector<char> records;
+
+  //! Memory mapping of the history file.
+  mutable std::unique_ptr<boost::interprocess::file_mapping> mapping;
+
+  //! Mapped region of the history file.
+  mutable std::unique_ptr<boost::interprocess::mapped_region> region;
+};
+
+#endif // HISTORYSTORE_HH
@@ -0,0 +1,230 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "IdleLog.hh"
+
+#include <algorithm>
+
+bool
+IdleLog::empty() const
+{
+  return size() == 0;
+}
+
+int
+IdleLog::size() const
+{
+  return static_cast<int>(intervals.size()) - first;
+}
+
+void
+IdleLog::clear()
+{
+  intervals.clear();
+  active_prefix.clear();
+  skips.clear();
+  first = 0;
+  base = 0;
+}
+
+//! Returns the interval at the specified index. Index 0 is the oldest interval.
+IdleInterval &
+IdleLog::at(int index)
+{
+  return intervals[first + index];
+}
+
+const IdleInterval &
+IdleLog::at(int index) const
+{
+  return intervals[first + index];
+}
+
+IdleInterval &
+IdleLog::newest()
+{
+  return intervals.back();
+}
+
+const IdleInterval &
+IdleLog::newest() const
+{
+  return intervals.back();
+}
+
+//! Adds a new most recent interval.
+void
+IdleLog::push(const IdleInterval &idle)
+{
+  if (active_prefix.empty())
+    {
+      active_prefix.push_back(0);
+    }
+
+  intervals.push_back(idle);
+  active_prefix.push_back(0);
+  skips.emplace_back();
+
+  index(static_cast<int>(intervals.size()) - 1);
+}
+
+//! Removes the most recent interval.
+void
+IdleLog::pop()
+{
+  intervals.pop_back();
+  active_prefix.pop_back();
+  skips.pop_back();
+
+  if (size() <= 0)
+    {
+      clear();
+    }
+}
+
+//! Removes the specified number of oldest intervals.
+void
+IdleLog::expire(int count)
+{
+  first += std::min(count, size());
+
+  if (first > 0 && first >= static_cast<int>(intervals.size()) / 2)
+    {
+      intervals.erase(intervals.begin(), intervals.begin() + first);
+      active_prefix.erase(active_prefix.begin(), active_prefix.begin() + first);
+      skips.erase(skips.begin(), skips.begin() + first);
+      base += first;
+      first = 0;
+    }
+}
+
+//! Rebuilds the indices after intervals were modified in place.
+void
+IdleLog::reindex()
+{
+  for (int pos = 0; pos < static_cast<int>(intervals.size()); pos++)
+    {
+      index(pos);
+    }
+}
+
+//! Returns the number of oldest intervals whose idle period ended before the specified time.
+int
+IdleLog::count_expired(int64_t time) const
+{
+  auto it = std::partition_point(intervals.begin() + first, intervals.end(), [time](const IdleInterval &idle) {
+    return idle.end_idle_time < time;
+  });
+  return static_cast<int>(it - (intervals.begin() + first));
+}
+
+//! Returns the index of the most recent interval with an idle period longer than length.
+int
+IdleLog::find_last_idle(int64_t length) const
+{
+  if (empty())
+    {
+      return NO_INTERVAL;
+    }
+
+  int64_t seq = find_last_idle(base + static_cast<int64_t>(intervals.size()) - 1, length);
+  if (seq < base + first)
+    {
+      return NO_INTERVAL;
+    }
+  return static_cast<int>(seq - base - first);
+}
+
+//! Returns the total active time of the interval at index and all later intervals.
+int64_t
+IdleLog::get_active_time_since(int index) const
+{
+  if (intervals.empty())
+    {
+      return 0;
+    }
+  return active_prefix[intervals.size()] - active_prefix[first + index];
+}
+
+int64_t
+IdleLog::idle_length(const IdleInterval &idle)
+{
+  return idle.end_idle_time - idle.begin_time;
+}
+
+int64_t
+IdleLog::skip(int64_t seq, int level) const
+{
+  if (seq < base)
+    {
+      return -1;
+    }
+
+  int64_t s = skips[seq - base][level];
+  return s >= base ? s : -1;
+}
+
+//! Returns the most recent interval up to seq with an idle period longer than length.
+/*!
+ *  The idle periods increase along the chain of skip pointers, so the
+ *  interval is found by climbing the chain with decreasing step sizes.
+ */
+int64_t
+IdleLog::find_last_idle(int64_t seq, int64_t length) const
+{
+  if (seq < base)
+    {
+      return -1;
+    }
+
+  if (idle_length(intervals[seq - base]) > length)
+    {
+      return seq;
+    }
+
+  for (int level = SKIP_LEVELS - 1; level >= 0; level--)
+    {
+      int64_t s = skip(seq, level);
+      while (s != -1 && idle_length(intervals[s - base]) <= length)
+        {
+          seq = s;
+          s = skip(seq, level);
+        }
+    }
+
+  return skip(seq, 0);
+}
+
+//! Updates the indices of the interval at the specified storage position.
+void
+IdleLog::index(int pos)
+{
+  int64_t seq = base + pos;
+
+  auto &skip_list = skips[pos];
+  skip_list[0] = find_last_idle(seq - 1, idle_length(intervals[pos]));
+  for (int level = 1; level < SKIP_LEVELS; level++)
+    {
+      skip_list[level] = skip(skip_list[level - 1], level - 1);
+    }
+
+  active_prefix[pos + 1] = active_prefix[pos] + intervals[pos].active_time;
+}
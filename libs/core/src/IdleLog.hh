@@ -0,0 +1,117 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef IDLELOG_HH
+#define IDLELOG_HH
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// A Single idle time interval
+struct IdleInterval
+{
+  IdleInterval() = default;
+
+  IdleInterval(int64_t b, int64_t e)
+    : begin_time(b)
+    , end_idle_time(e)
+    , end_time(e)
+  {
+  }
+
+  //! Start time of idle interval
+  int64_t begin_time{0};
+
+  //! End time of idle interval (and start of active part)
+  int64_t end_idle_time{0};
+
+  //! End time of active interval.
+  int64_t end_time{0};
+
+  //! Elapsed active time AFTER the idle interval.
+  int64_t active_time{0};
+
+  //! Yet to be saved
+  bool to_be_saved{false};
+};
+
+//! Idle intervals of a single client, oldest first.
+/*!
+ *  The intervals are stored contiguously. Expired intervals are dropped
+ *  from the front by advancing an offset and the storage is compacted once
+ *  half of it is unused.
+ *
+ *  Two indices are kept up to date when intervals are added or removed: a
+ *  prefix sum of the active time, and for each interval skip pointers to
+ *  earlier intervals with a longer idle period. Together they answer "how
+ *  much active time since the last idle period of at least N seconds" in
+ *  O(log n).
+ */
+class IdleLog
+{
+public:
+  static constexpr int NO_INTERVAL = -1;
+
+  bool empty() const;
+  int size() const;
+  void clear();
+
+  IdleInterval &at(int index);
+  const IdleInterval &at(int index) const;
+  IdleInterval &newest();
+  const IdleInterval &newest() const;
+
+  void push(const IdleInterval &idle);
+  void pop();
+  void expire(int count);
+  void reindex();
+
+  int count_expired(int64_t time) const;
+  int find_last_idle(int64_t length) const;
+  int64_t get_active_time_since(int index) const;
+
+private:
+  static constexpr int SKIP_LEVELS = 16;
+
+  static int64_t idle_length(const IdleInterval &idle);
+  int64_t skip(int64_t seq, int level) const;
+  int64_t find_last_idle(int64_t seq, int64_t length) const;
+  void index(int pos);
+
+private:
+  //! Intervals, oldest first. The first 'first' entries are expired.
+  std::vector<IdleInterval> intervals;
+
+  //! Active time of all intervals before the one at the same position.
+  std::vector<int64_t> active_prefix;
+
+  //! Skip pointers to earlier intervals with a longer idle period.
+  /*!
+   *  Entry 0 is the sequence number of the most recent earlier interval
+   *  with a longer idle period, entry k is 2^k steps up that chain.
+   */
+  std::vector<std::array<int64_t, SKIP_LEVELS>> skips;
+
+  //! Number of expired intervals at the front of the storage.
+  int first{0};
+
+  //! Sequence number of the interval at the front of the storage.
+  int64_t base{0};
+};
+
+#endif // IDLELOG_HH
@@ -27,7 +27,9 @@
 #endif
 
 #include "debug.hh"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <filesystem>
@@ -42,7 +44,11 @@
 #define IDLELOG_MAXAGE (12 * 60 * 60)
 #define IDLELOG_INTERVAL (30 * 60)
 #define IDLELOG_VERSION (3)
-#define IDLELOG_INTERVAL_SIZE (17)
+#define IDLELOG_FILE_VERSION (4)
+#define IDLELOG_LEGACY_INTERVAL_SIZE (17)
+#define IDLELOG_FILE_MAGIC "WRIL"
+#define IDLELOG_HEADER_SIZE (8)
+#define IDLELOG_RECORD_SIZE (20)
 
 using namespace workrave::utils;
 using namespace std;
@@ -145,7 +151,7 @@ IdleLogManager::expire()
     {
       last_expiration_time = current_time + IDLELOG_INTERVAL;
     }
-  else if (current_time <= last_expiration_time)
+  else if (current_time >= last_expiration_time)
     {
       last_expiration_time = current_time + IDLELOG_INTERVAL;
       for (ClientMapIter i = clients.begin(); i != clients.end(); i++)
@@ -162,34 +168,47 @@ IdleLogManager::expire(ClientInfo &info)
 {
   if (info.idlelog.size() > IDLELOG_MAXSIZE)
     {
-      info.idlelog.resize(IDLELOG_MAXSIZE);
+      info.idlelog.expire(info.idlelog.size() - IDLELOG_MAXSIZE);
     }
 
   int64_t current_time = TimeSource::get_real_time_sec();
-  int count = 0;
-  for (IdleLogRIter i = info.idlelog.rbegin(); i != info.idlelog.rend(); i++)
+  info.idlelog.expire(info.idlelog.count_expired(current_time - IDLELOG_MAXAGE));
+  index_client(info);
+}
+
+//! Records the most recent idle interval of the client in the idle index.
+void
+IdleLogManager::index_client(ClientInfo &info)
+{
+  unindex_client(info);
+
+  if (!info.idlelog.empty())
     {
-      IdleInterval &idle = info.idlelog.back();
-      if (idle.end_idle_time < current_time - IDLELOG_MAXAGE)
-        {
-          count++;
-        }
-      else
+      const IdleInterval &idle = info.idlelog.newest();
+      info.indexed = true;
+      info.indexed_begin_time = idle.begin_time;
+      info.indexed_idle = idle.active_time == 0;
+
+      idle_begin_times.insert(info.indexed_begin_time);
+      if (info.indexed_idle)
         {
-          break;
+          idle_clients++;
         }
     }
+}
 
-  if (count != 0)
+//! Removes the client from the idle index.
+void
+IdleLogManager::unindex_client(ClientInfo &info)
+{
+  if (info.indexed)
     {
-      if (info.idlelog.size() > (size_t)count)
+      idle_begin_times.erase(idle_begin_times.find(info.indexed_begin_time));
+      if (info.indexed_idle)
         {
-          info.idlelog.resize(info.idlelog.size() - count);
-        }
-      else
-        {
-          info.idlelog.clear();
+          idle_clients--;
         }
+      info.indexed = false;
     }
 }
 
@@ -217,9 +236,9 @@ IdleLogManager::update_idlelog(ClientInfo &info, ActivityState state, bool maste
           info.update_active_time(current_time);
 
           // save front.
-          if (info.idlelog.size() > 0)
+          if (!info.idlelog.empty())
             {
-              IdleInterval *save_interval = &(info.idlelog.front());
+              IdleInterval *save_interval = &(info.idlelog.newest());
               if (save_interval->to_be_saved)
                 {
                   update_idlelog(info, *save_interval);
@@ -229,7 +248,7 @@ IdleLogManager::update_idlelog(ClientInfo &info, ActivityState state, bool maste
 
           // Push current
           info.current_interval.to_be_saved = true;
-          info.idlelog.push_front(info.current_interval);
+          info.idlelog.push(info.current_interval);
 
           // create a new (empty) idle interval.
           info.current_interval = IdleInterval(current_time, current_time);
@@ -240,12 +259,12 @@ IdleLogManager::update_idlelog(ClientInfo &info, ActivityState state, bool maste
           // State remained idle. Update end time of idle interval.
           idle->end_idle_time = current_time;
 
-          if (info.idlelog.size() > 0)
+          if (!info.idlelog.empty())
             {
               int64_t total_idle = idle->end_idle_time - idle->begin_time;
               if (total_idle >= 10)
                 {
-                  IdleInterval *save_interval = &(info.idlelog.front());
+                  IdleInterval *save_interval = &(info.idlelog.newest());
                   if (save_interval->to_be_saved)
                     {
                       TRACE_MSG("Saving");
@@ -268,12 +287,12 @@ IdleLogManager::update_idlelog(ClientInfo &info, ActivityState state, bool maste
           if (total_idle < 10 && info.idlelog.size() > 1)
             {
               // Idle period too short. remove it. and reuse previous
-              IdleInterval &oldidle = info.idlelog.front();
+              IdleInterval &oldidle = info.idlelog.newest();
 
               if (oldidle.to_be_saved)
                 {
                   info.current_interval = oldidle;
-                  info.idlelog.pop_front();
+                  info.idlelog.pop();
                   idle = &(info.current_interval);
                 }
             }
@@ -290,6 +309,7 @@ IdleLogManager::update_idlelog(ClientInfo &info, ActivityState state, bool maste
     }
 
   info.last_update_time = current_time;
+  index_client(info);
   dump_idlelog(info);
 }
 
@@ -310,34 +330,49 @@ IdleLogManager::compute_total_active_time()
 }
 
 //! Returns the active time since an idle period of a least the specified amount of time.
+/*!
+ *  For a single client the most recent long enough idle period is found
+ *  with a binary search. With multiple clients the idle periods of all
+ *  clients are merged until a common idle period of the requested length is
+ *  found.
+ */
 int64_t
 IdleLogManager::compute_active_time(int length)
 {
   TRACE_ENTRY();
   int64_t current_time = TimeSource::get_real_time_sec();
 
+  for (ClientMapIter i = clients.begin(); i != clients.end(); i++)
+    {
+      ClientInfo &info = (*i).second;
+      info.update_active_time(current_time);
+    }
+
+  if (clients.size() == 1)
+    {
+      const IdleLog &idlelog = clients.begin()->second.idlelog;
+      int index = idlelog.find_last_idle(length);
+
+      int64_t total_active_time = idlelog.get_active_time_since(index == IdleLog::NO_INTERVAL ? 0 : index);
+      TRACE_MSG("total = {}", total_active_time);
+      return total_active_time;
+    }
+
   // Number of client.
   int size = clients.size();
 
-  // Data for each client.
-  IdleLogIter *iterators = new IdleLogIter[size];
-  IdleLogIter *end_iterators = new IdleLogIter[size];
-  bool *at_end = new bool[size];
-  int64_t *active_time = new int64_t[size];
+  // Data for each client, from the most recent interval backwards.
+  std::vector<const IdleLog *> idlelogs;
+  std::vector<int> positions;
+  std::vector<bool> at_end(size, true);
 
-  // Init data for all clients.
-  int count = 0;
+  idlelogs.reserve(size);
+  positions.reserve(size);
   for (ClientMapIter i = clients.begin(); i != clients.end(); i++)
     {
-      ClientInfo &info = (*i).second;
-
-      iterators[count] = info.idlelog.begin();
-      end_iterators[count] = info.idlelog.end();
-      active_time[count] = 0;
-      at_end[count] = true;
-
-      info.update_active_time(current_time);
-      count++;
+      const IdleLog &idlelog = (*i).second.idlelog;
+      idlelogs.push_back(&idlelog);
+      positions.push_back(idlelog.size() - 1);
     }
 
   // Number of simultaneous idle periods.
@@ -346,7 +381,7 @@ IdleLogManager::compute_active_time(int length)
   // Time of last unprocessed event.
   int64_t last_time = -1;
 
-  // Iterator of last unprocessed event.
+  // Client of last unprocessed event.
   int last_iter = -1;
 
   // Stop criterium
@@ -361,9 +396,9 @@ IdleLogManager::compute_active_time(int length)
       last_time = -1;
       for (int i = 0; i < size; i++)
         {
-          if (iterators[i] != end_iterators[i])
+          if (positions[i] >= 0)
             {
-              IdleInterval &ii = *(iterators[i]);
+              const IdleInterval &ii = idlelogs[i]->at(positions[i]);
               int64_t t = at_end[i] ? ii.end_idle_time : ii.begin_time;
 
               if (last_time == -1 || t > last_time)
@@ -377,14 +412,13 @@ IdleLogManager::compute_active_time(int length)
       // Did we found one?
       if (last_time != -1)
         {
-          IdleInterval &ii = *(iterators[last_iter]);
+          const IdleInterval &ii = idlelogs[last_iter]->at(positions[last_iter]);
           if (at_end[last_iter])
             {
-              TRACE_MSG("End time {}", ii.end_idle_time << " active " << ii.active_time);
+              TRACE_MSG("End time {} active {}", ii.end_idle_time, ii.active_time);
               idle_count++;
 
               at_end[last_iter] = false;
-              active_time[last_iter] += ii.active_time;
               end_idle_time = ii.end_idle_time;
             }
           else
@@ -392,7 +426,7 @@ IdleLogManager::compute_active_time(int length)
               TRACE_MSG("Begin time {}", ii.begin_time);
 
               at_end[last_iter] = true;
-              iterators[last_iter]++;
+              positions[last_iter]--;
 
               if (idle_count == size)
                 {
@@ -412,52 +446,37 @@ IdleLogManager::compute_active_time(int length)
         }
     }
 
+  // The active time of all intervals whose end has been processed counts.
   int64_t total_active_time = 0;
   for (int i = 0; i < size; i++)
     {
-      TRACE_MSG("active time of {}", i << " = " << active_time[i]);
-      total_active_time += active_time[i];
+      int from = at_end[i] ? positions[i] + 1 : positions[i];
+      int64_t active_time = idlelogs[i]->get_active_time_since(from);
+
+      TRACE_MSG("active time of {} = {}", i, active_time);
+      total_active_time += active_time;
     }
 
   TRACE_MSG("total = {}", total_active_time);
 
-  delete[] iterators;
-  delete[] end_iterators;
-  delete[] at_end;
-  delete[] active_time;
-
   return total_active_time;
 }
 
 //! Computes the current idle time.
+/*!
+ *  The most recent idle interval of each client is kept in an index, so
+ *  this does not visit the clients.
+ */
 int64_t
 IdleLogManager::compute_idle_time()
 {
   TRACE_ENTRY();
   int64_t current_time = TimeSource::get_real_time_sec();
 
-  int count = 0;
-  int64_t latest_start_time = 0;
-
-  for (ClientMapIter i = clients.begin(); i != clients.end(); i++)
-    {
-      ClientInfo &info = (*i).second;
-      info.update_active_time(current_time);
-
-      IdleInterval &idle = info.idlelog.front();
-      if (idle.active_time == 0)
-        {
-          count++;
-        }
-      if (idle.begin_time > latest_start_time)
-        {
-          latest_start_time = idle.begin_time;
-          TRACE_VAR(current_time - latest_start_time);
-        }
-    }
+  int64_t latest_start_time = idle_begin_times.empty() ? 0 : *idle_begin_times.rbegin();
 
-  TRACE_MSG("count = {}", count);
-  if ((unsigned int)count != clients.size() + 1)
+  TRACE_MSG("count = {}", idle_clients);
+  if ((unsigned int)idle_clients != clients.size() + 1)
     {
       latest_start_time = current_time;
     }
@@ -475,10 +494,21 @@ IdleLogManager::pack_idle_interval(PacketBuffer &buffer, const IdleInterval &idl
 
   buffer.reserve_size(pos);
   buffer.pack_byte(IDLELOG_VERSION);
-  buffer.pack_ulong((guint32)idle.begin_time);
-  buffer.pack_ulong((guint32)idle.end_idle_time);
-  buffer.pack_ulong((guint32)idle.end_time);
-  buffer.pack_ushort((guint32)idle.active_time);
+  if (buffer.is_compact())
+    {
+      // Later times are packed relative to the begin time.
+      buffer.pack_svarint(idle.begin_time);
+      buffer.pack_varint(idle.end_idle_time - idle.begin_time);
+      buffer.pack_varint(idle.end_time - idle.end_idle_time);
+      buffer.pack_varint(idle.active_time);
+    }
+  else
+    {
+      buffer.pack_ulong((guint32)idle.begin_time);
+      buffer.pack_ulong((guint32)idle.end_idle_time);
+      buffer.pack_ulong((guint32)idle.end_time);
+      buffer.pack_ushort((guint32)idle.active_time);
+    }
   buffer.update_size(pos);
 }
 
@@ -493,10 +523,20 @@ IdleLogManager::unpack_idle_interval(PacketBuffer &buffer, IdleInterval &idle, i
     {
       /*int version = */ buffer.unpack_byte();
 
-      idle.begin_time = buffer.unpack_ulong() - delta_time;
-      idle.end_idle_time = buffer.unpack_ulong() - delta_time;
-      idle.end_time = buffer.unpack_ulong() - delta_time;
-      idle.active_time = buffer.unpack_ushort();
+      if (buffer.is_compact())
+        {
+          idle.begin_time = buffer.unpack_svarint() - delta_time;
+          idle.end_idle_time = idle.begin_time + buffer.unpack_varint();
+          idle.end_time = idle.end_idle_time + buffer.unpack_varint();
+          idle.active_time = buffer.unpack_varint();
+        }
+      else
+        {
+          idle.begin_time = buffer.unpack_ulong() - delta_time;
+          idle.end_idle_time = buffer.unpack_ulong() - delta_time;
+          idle.end_time = buffer.unpack_ulong() - delta_time;
+          idle.active_time = buffer.unpack_ushort();
+        }
 
       buffer.skip_size(pos);
     }
@@ -517,12 +557,28 @@ IdleLogManager::pack_idlelog(PacketBuffer &buffer, const ClientInfo &ci) const
   buffer.reserve_size(pos);
 
   // Pack
-  buffer.pack_ulong((guint32)current_time);
-  buffer.pack_string(ci.client_id.c_str());
-  buffer.pack_ulong((guint32)ci.total_active_time);
+  if (buffer.is_compact())
+    {
+      buffer.pack_svarint(current_time);
+      buffer.pack_string_ref(ci.client_id);
+      buffer.pack_varint(ci.total_active_time);
+    }
+  else
+    {
+      buffer.pack_ulong((guint32)current_time);
+      buffer.pack_string(ci.client_id.c_str());
+      buffer.pack_ulong((guint32)ci.total_active_time);
+    }
   buffer.pack_byte(ci.master);
   buffer.pack_byte(ci.state);
-  buffer.pack_ushort(ci.idlelog.size());
+  if (buffer.is_compact())
+    {
+      buffer.pack_varint(ci.idlelog.size());
+    }
+  else
+    {
+      buffer.pack_ushort(ci.idlelog.size());
+    }
 
   buffer.update_size(pos);
 }
@@ -536,22 +592,32 @@ IdleLogManager::unpack_idlelog(PacketBuffer &buffer, ClientInfo &ci, int64_t &pa
 
   if (size > 0 && buffer.bytes_available() >= size)
     {
-      pack_time = buffer.unpack_ulong();
+      if (buffer.is_compact())
+        {
+          pack_time = buffer.unpack_svarint();
+          ci.client_id = buffer.unpack_string_ref();
+          ci.total_active_time = buffer.unpack_varint();
+        }
+      else
+        {
+          pack_time = buffer.unpack_ulong();
 
-      char *id = buffer.unpack_string();
+          char *id = buffer.unpack_string();
 
-      if (id != nullptr)
-        {
-          ci.client_id = id;
+          if (id != nullptr)
+            {
+              ci.client_id = id;
+            }
+
+          ci.total_active_time = buffer.unpack_ulong();
+
+          g_free(id);
         }
 
-      ci.total_active_time = buffer.unpack_ulong();
       ci.master = buffer.unpack_byte() != 0;
       ci.state = (ActivityState)buffer.unpack_byte();
 
-      num_intervals = buffer.unpack_ushort();
-
-      g_free(id);
+      num_intervals = buffer.is_compact() ? buffer.unpack_varint() : buffer.unpack_ushort();
 
       buffer.skip_size(pos);
     }
@@ -605,7 +671,7 @@ IdleLogManager::save_index()
   PacketBuffer buffer;
   buffer.create();
 
-  buffer.pack_ushort(IDLELOG_VERSION);
+  buffer.pack_ushort(IDLELOG_FILE_VERSION);
   buffer.pack_string(myid.c_str());
 
   for (ClientMapIter i = clients.begin(); i != clients.end(); i++)
@@ -627,7 +693,11 @@ IdleLogManager::save_index()
 }
 
 //! Loads the idlelog index.
-void
+/*!
+ *  \return true if the index and the idlelogs are in the format of version
+ *  IDLELOG_VERSION, and must be converted to the current format.
+ */
+bool
 IdleLogManager::load_index()
 {
   TRACE_ENTRY();
@@ -637,6 +707,7 @@ IdleLogManager::load_index()
 
   std::filesystem::path f(ss.str());
   bool exists = std::filesystem::is_regular_file(f);
+  bool legacy = false;
 
   if (exists)
     {
@@ -663,10 +734,13 @@ IdleLogManager::load_index()
       int version = buffer.unpack_ushort();
       TRACE_MSG("Version - {}", version);
 
-      if (version == IDLELOG_VERSION)
+      if (version == IDLELOG_FILE_VERSION || version == IDLELOG_VERSION)
         {
           TRACE_MSG("Version - ok");
 
+          // The index did not change, only the format of the idlelogs.
+          legacy = version == IDLELOG_VERSION;
+
           char *id = buffer.unpack_string();
           if (id != nullptr)
             {
@@ -709,36 +783,88 @@ IdleLogManager::load_index()
           g_free(id);
         }
     }
+
+  return legacy;
 }
 
-//! Saves the idlelog for the specified client.
+//! Writes the header of an idlelog file.
 void
-IdleLogManager::save_idlelog(ClientInfo &info)
+IdleLogManager::write_idlelog_header(std::ostream &stream)
 {
-  info.update_active_time(TimeSource::get_real_time_sec());
+  uint32_t version = IDLELOG_FILE_VERSION;
 
-  PacketBuffer buffer;
-  buffer.create();
+  stream.write(IDLELOG_FILE_MAGIC, 4);
+  stream.write(reinterpret_cast<const char *>(&version), sizeof(version));
+}
 
-  for (IdleLogRIter i = info.idlelog.rbegin(); i != info.idlelog.rend(); i++)
-    {
-      IdleInterval &idle = *i;
+//! Writes a single idle interval to an idlelog file.
+/*!
+ *  An interval is stored as its begin time followed by the lengths of its
+ *  idle and active part and its active time.
+ */
+void
+IdleLogManager::write_idle_interval(std::ostream &stream, const IdleInterval &idle)
+{
+  int64_t begin_time = idle.begin_time;
+  uint32_t values[3] = {
+    static_cast<uint32_t>(std::max<int64_t>(0, idle.end_idle_time - idle.begin_time)),
+    static_cast<uint32_t>(std::max<int64_t>(0, idle.end_time - idle.end_idle_time)),
+    static_cast<uint32_t>(std::max<int64_t>(0, idle.active_time)),
+  };
+
+  stream.write(reinterpret_cast<const char *>(&begin_time), sizeof(begin_time));
+  stream.write(reinterpret_cast<const char *>(values), sizeof(values));
+}
+
+//! Reads a single idle interval from an idlelog file.
+bool
+IdleLogManager::read_idle_interval(std::istream &stream, IdleInterval &idle)
+{
+  int64_t begin_time = 0;
+  uint32_t values[3] = {0, 0, 0};
+
+  stream.read(reinterpret_cast<char *>(&begin_time), sizeof(begin_time));
+  stream.read(reinterpret_cast<char *>(values), sizeof(values));
 
-      pack_idle_interval(buffer, idle);
+  if (!stream.good())
+    {
+      return false;
     }
 
+  idle.begin_time = begin_time;
+  idle.end_idle_time = begin_time + values[0];
+  idle.end_time = idle.end_idle_time + values[1];
+  idle.active_time = values[2];
+  return true;
+}
+
+//! Saves the idlelog for the specified client.
+void
+IdleLogManager::save_idlelog(ClientInfo &info)
+{
+  info.update_active_time(TimeSource::get_real_time_sec());
+
   stringstream ss;
   ss << AssetPath::get_home_directory();
   ss << "idlelog." << info.client_id << ".log" << ends;
 
   ofstream file(ss.str().c_str(), ios::binary);
-  file.write(buffer.get_buffer(), buffer.bytes_written());
+  write_idlelog_header(file);
+
+  for (int i = 0; i < info.idlelog.size(); i++)
+    {
+      write_idle_interval(file, info.idlelog.at(i));
+    }
+
   file.close();
 }
 
 //! Loads the idlelog for the specified client.
+/*!
+ *  \param legacy whether the idlelog is stored in the format of version IDLELOG_VERSION.
+ */
 void
-IdleLogManager::load_idlelog(ClientInfo &info)
+IdleLogManager::load_idlelog(ClientInfo &info, bool legacy)
 {
   TRACE_ENTRY();
   int64_t current_time = TimeSource::get_real_time_sec();
@@ -750,65 +876,118 @@ IdleLogManager::load_idlelog(ClientInfo &info)
   // Open file
   ifstream file(ss.str().c_str(), ios::binary);
 
-  // get file size using buffer's members
-  filebuf *pbuf = file.rdbuf();
-  int size = pbuf->pubseekoff(0, ios::end, ios::in);
-  pbuf->pubseekpos(0, ios::in);
+  char magic[4] = {0};
+  uint32_t version = 0;
+  if (!legacy)
+    {
+      file.read(magic, sizeof(magic));
+      file.read(reinterpret_cast<char *>(&version), sizeof(version));
+    }
 
-  // Process it.
-  int num_intervals = size / IDLELOG_INTERVAL_SIZE;
-  if (num_intervals * IDLELOG_INTERVAL_SIZE == size)
+  if (legacy)
+    {
+      load_legacy_idlelog(info, file);
+    }
+  else if (file.good() && memcmp(magic, IDLELOG_FILE_MAGIC, sizeof(magic)) == 0 && version == IDLELOG_FILE_VERSION)
     {
+      file.seekg(0, ios::end);
+      int64_t size = static_cast<int64_t>(file.tellg()) - IDLELOG_HEADER_SIZE;
+
+      int num_intervals = static_cast<int>(size / IDLELOG_RECORD_SIZE);
+      int skip = 0;
       if (num_intervals > IDLELOG_MAXSIZE)
         {
-          TRACE_MSG("Skipping {}", (num_intervals - IDLELOG_MAXSIZE) << " intervals");
-          int skip = (num_intervals - IDLELOG_MAXSIZE) * IDLELOG_INTERVAL_SIZE;
-          file.seekg(skip);
-          size -= skip;
-          num_intervals = IDLELOG_MAXSIZE;
+          TRACE_MSG("Skipping {} intervals", (num_intervals - IDLELOG_MAXSIZE));
+          skip = num_intervals - IDLELOG_MAXSIZE;
         }
+      file.seekg(IDLELOG_HEADER_SIZE + static_cast<int64_t>(skip) * IDLELOG_RECORD_SIZE);
 
-      // Create buffer and load data.
-      PacketBuffer buffer;
-      buffer.create(size);
-      file.read(buffer.get_buffer(), size);
-      file.close();
-      buffer.write_ptr += size;
-
-      TRACE_MSG("loading {}", num_intervals << " intervals");
-      for (int i = 0; i < num_intervals; i++)
+      TRACE_MSG("loading {} intervals", num_intervals - skip);
+      IdleInterval idle;
+      for (int i = skip; i < num_intervals && read_idle_interval(file, idle); i++)
         {
-          IdleInterval idle;
-          unpack_idle_interval(buffer, idle, 0);
-
           if (idle.end_idle_time >= current_time - IDLELOG_MAXAGE)
             {
-              info.idlelog.push_front(idle);
+              info.idlelog.push(idle);
             }
         }
 
-      if (info.idlelog.size() > 0)
+      if (!info.idlelog.empty())
         {
-          IdleInterval &idle = info.idlelog.back();
-          idle.begin_time = 1;
+          info.idlelog.at(0).begin_time = 1;
         }
     }
 
   dump_idlelog(info);
   fix_idlelog(info);
   dump_idlelog(info);
+  index_client(info);
+}
+
+//! Loads an idlelog in the format of version IDLELOG_VERSION.
+/*!
+ *  Intervals are stored oldest first, in the legacy packet format.
+ */
+void
+IdleLogManager::load_legacy_idlelog(ClientInfo &info, std::istream &file)
+{
+  TRACE_ENTRY();
+  int64_t current_time = TimeSource::get_real_time_sec();
+
+  file.seekg(0, ios::end);
+  int64_t size = file.good() ? static_cast<int64_t>(file.tellg()) : 0;
+
+  int num_intervals = static_cast<int>(size / IDLELOG_LEGACY_INTERVAL_SIZE);
+  if (size <= 0 || num_intervals * IDLELOG_LEGACY_INTERVAL_SIZE != size)
+    {
+      return;
+    }
+
+  int skip = std::max(0, num_intervals - IDLELOG_MAXSIZE);
+  size -= static_cast<int64_t>(skip) * IDLELOG_LEGACY_INTERVAL_SIZE;
+  file.seekg(static_cast<int64_t>(skip) * IDLELOG_LEGACY_INTERVAL_SIZE);
+
+  PacketBuffer buffer;
+  buffer.create(static_cast<int>(size));
+  file.read(buffer.get_buffer(), size);
+  buffer.write_ptr += size;
+
+  TRACE_MSG("converting {} intervals", num_intervals - skip);
+  for (int i = skip; i < num_intervals; i++)
+    {
+      IdleInterval idle;
+      unpack_idle_interval(buffer, idle, 0);
+
+      if (idle.end_idle_time >= current_time - IDLELOG_MAXAGE)
+        {
+          info.idlelog.push(idle);
+        }
+    }
+
+  if (!info.idlelog.empty())
+    {
+      info.idlelog.at(0).begin_time = 1;
+    }
 }
 
 //! Loads the entire idlelog.
+/*!
+ *  Idlelogs of version IDLELOG_VERSION are converted to the current format.
+ */
 void
 IdleLogManager::load()
 {
-  load_index();
+  bool legacy = load_index();
 
   for (ClientMapIter i = clients.begin(); i != clients.end(); i++)
     {
       ClientInfo &info = (*i).second;
-      load_idlelog(info);
+      load_idlelog(info, legacy);
+    }
+
+  if (legacy)
+    {
+      save();
     }
 }
 
@@ -831,17 +1010,20 @@ IdleLogManager::update_idlelog(ClientInfo &info, const IdleInterval &idle)
 {
   info.update_active_time(TimeSource::get_real_time_sec());
 
-  PacketBuffer buffer;
-  buffer.create();
-
-  pack_idle_interval(buffer, idle);
-
   stringstream ss;
   ss << AssetPath::get_home_directory();
   ss << "idlelog." << info.client_id << ".log" << ends;
 
-  ofstream file(ss.str().c_str(), ios::app | ios::binary);
-  file.write(buffer.get_buffer(), buffer.bytes_written());
+  std::error_code ec;
+  std::filesystem::path path(ss.str().c_str());
+  bool is_new = !std::filesystem::is_regular_file(path, ec) || std::filesystem::file_size(path, ec) < IDLELOG_HEADER_SIZE;
+
+  ofstream file(path, is_new ? ios::binary : ios::app | ios::binary);
+  if (is_new)
+    {
+      write_idlelog_header(file);
+    }
+  write_idle_interval(file, idle);
   file.close();
 
   save_index();
@@ -860,9 +1042,9 @@ IdleLogManager::get_idlelog(PacketBuffer &buffer)
   // Pack header.
   pack_idlelog(buffer, myinfo);
 
-  for (IdleLogIter i = myinfo.idlelog.begin(); i != myinfo.idlelog.end(); i++)
+  for (int i = myinfo.idlelog.size() - 1; i >= 0; i--)
     {
-      pack_idle_interval(buffer, *i);
+      pack_idle_interval(buffer, myinfo.idlelog.at(i));
     }
 }
 
@@ -878,21 +1060,36 @@ IdleLogManager::set_idlelog(PacketBuffer &buffer)
   unpack_idlelog(buffer, info, pack_time, num_intervals);
 
   delta_time = pack_time - TimeSource::get_real_time_sec();
-  clients[info.client_id] = info;
-  info.last_update_time = 0;
 
+  auto it = clients.find(info.client_id);
+  if (it != clients.end())
+    {
+      unindex_client(it->second);
+    }
+
+  ClientInfo &client = clients[info.client_id];
+  client = info;
+  client.last_update_time = 0;
+
+  // Intervals are packed most recent first.
+  std::vector<IdleInterval> intervals(num_intervals);
   for (int i = 0; i < num_intervals; i++)
     {
-      IdleInterval idle;
+      IdleInterval &idle = intervals[i];
       unpack_idle_interval(buffer, idle, delta_time);
 
       TRACE_VAR(info.client_id, idle.begin_time, idle.end_idle_time, idle.active_time);
-      clients[info.client_id].idlelog.push_back(idle);
     }
 
-  fix_idlelog(info);
+  for (auto i = intervals.rbegin(); i != intervals.rend(); i++)
+    {
+      client.idlelog.push(*i);
+    }
+
+  fix_idlelog(client);
+  index_client(client);
   save_index();
-  save_idlelog(clients[info.client_id]);
+  save_idlelog(client);
 }
 
 //! A remote client has signed on.
@@ -904,8 +1101,9 @@ IdleLogManager::signon_remote_client(string client_id)
   int64_t current_time = TimeSource::get_real_time_sec();
 
   ClientInfo &info = clients[client_id];
-  info.idlelog.push_front(IdleInterval(1, current_time));
+  info.idlelog.push(IdleInterval(1, current_time));
   info.client_id = client_id;
+  index_client(info);
 
   save_index();
   save_idlelog(info);
@@ -955,10 +1153,9 @@ IdleLogManager::dump_idlelog(ClientInfo &info)
                    );
   }
 
-  IdleLogIter i = info.idlelog.begin();
-  while (i != info.idlelog.end())
+  for (int i = info.idlelog.size() - 1; i >= 0; i--)
     {
-      IdleInterval &idle = *i;
+      IdleInterval &idle = info.idlelog.at(i);
 
       struct tm begin_time;
       localtime_r(&idle.begin_time, &begin_time);
@@ -978,7 +1175,6 @@ IdleLogManager::dump_idlelog(ClientInfo &info)
                    << end_time.tm_min << ":"
                    << end_time.tm_sec
                    );
-      i++;
     }
 #  endif
 #endif
@@ -993,9 +1189,9 @@ IdleLogManager::fix_idlelog(ClientInfo &info)
 
   int64_t next_time = -1;
 
-  for (IdleLogRIter i = info.idlelog.rbegin(); i != info.idlelog.rend(); i++)
+  for (int i = 0; i < info.idlelog.size(); i++)
     {
-      IdleInterval &idle = *i;
+      IdleInterval &idle = info.idlelog.at(i);
 
       TRACE_VAR(idle.begin_time, idle.end_time, idle.end_idle_time, idle.active_time);
 
@@ -1026,5 +1222,6 @@ IdleLogManager::fix_idlelog(ClientInfo &info)
         }
     }
 
-  info.idlelog.push_front(IdleInterval(next_time, current_time));
+  info.idlelog.reindex();
+  info.idlelog.push(IdleInterval(next_time, current_time));
 }
@@ -21,9 +21,11 @@
 
 #include <iostream>
 #include <string>
-#include <list>
 #include <map>
+#include <set>
+#include <vector>
 
+#include "IdleLog.hh"
 #include "LocalActivityMonitor.hh"
 
 class PacketBuffer;
@@ -31,38 +33,6 @@ class PacketBuffer;
 class IdleLogManager
 {
 private:
-  // A Single idle time interval
-  struct IdleInterval
-  {
-    IdleInterval() = default;
-
-    IdleInterval(int64_t b, int64_t e)
-      : begin_time(b)
-      , end_idle_time(e)
-      , end_time(e)
-    {
-    }
-
-    //! Start time of idle interval
-    int64_t begin_time{0};
-
-    //! End time of idle interval (and start of active part)
-    int64_t end_idle_time{0};
-
-    //! End time of active interval.
-    int64_t end_time{0};
-
-    //! Elapsed active time AFTER the idle interval.
-    int64_t active_time{0};
-
-    //! Yet to be saved
-    bool to_be_saved{false};
-  };
-
-  typedef std::list<IdleInterval> IdleLog;
-  typedef IdleLog::iterator IdleLogIter;
-  typedef IdleLog::reverse_iterator IdleLogRIter;
-
   //! Idle information of a single client.
   struct ClientInfo
   {
@@ -95,6 +65,15 @@ private:
     //! Last time this idle log was updated.
     int64_t last_update_time{0};
 
+    //! Is the most recent idle interval recorded in the idle index?
+    bool indexed{false};
+
+    //! Begin time of the most recent idle interval, as recorded in the idle index.
+    int64_t indexed_begin_time{0};
+
+    //! Did the most recent idle interval have no active time, as recorded in the idle index?
+    bool indexed_idle{false};
+
     //! Update the active time of the most recent idle interval.
     void update_active_time(int64_t current_time)
     {
@@ -122,6 +101,12 @@ private:
   //! Last time we performed an expiration run.
   int64_t last_expiration_time{0};
 
+  //! Begin times of the most recent idle interval of all clients.
+  std::multiset<int64_t> idle_begin_times;
+
+  //! Number of clients whose most recent idle interval has no active time.
+  int idle_clients{0};
+
 public:
   IdleLogManager(std::string myid);
 
@@ -144,6 +129,8 @@ private:
   void update_idlelog(ClientInfo &info, ActivityState state, bool master);
   void expire();
   void expire(ClientInfo &info);
+  void index_client(ClientInfo &info);
+  void unindex_client(ClientInfo &info);
 
   void pack_idle_interval(PacketBuffer &buffer, const IdleInterval &idle) const;
   void unpack_idle_interval(PacketBuffer &buffer, IdleInterval &idle, int64_t delta_time) const;
@@ -153,14 +140,19 @@ private:
   void unlink_idlelog(PacketBuffer &buffer) const;
 
   void save_index();
-  void load_index();
+  bool load_index();
   void save_idlelog(ClientInfo &info);
-  void load_idlelog(ClientInfo &info);
+  void load_idlelog(ClientInfo &info, bool legacy);
+  void load_legacy_idlelog(ClientInfo &info, std::istream &file);
 
   void save();
   void load();
   void update_idlelog(ClientInfo &info, const IdleInterval &idle);
 
+  static void write_idlelog_header(std::ostream &stream);
+  static void write_idle_interval(std::ostream &stream, const IdleInterval &idle);
+  static bool read_idle_interval(std::istream &stream, IdleInterval &idle);
+
   void fix_idlelog(ClientInfo &info);
   void dump_idlelog(ClientInfo &info);
 };
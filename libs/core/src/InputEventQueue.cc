@@ -0,0 +1,203 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "InputEventQueue.hh"
+
+#include <cmath>
+#include <cstdlib>
+
+#include "utils/TimeSource.hh"
+
+using namespace workrave::utils;
+
+namespace
+{
+  //! Mouse movements larger than this are not counted in the movement distance.
+  const int MAX_JUMP = 10000;
+
+  //! Pauses in mouse movement longer than this are not counted in the movement time.
+  const int64_t MAX_MOVEMENT_PAUSE = TimeSource::TIME_USEC_PER_SEC;
+} // namespace
+
+InputEventQueue::InputEventQueue(bool coalescing_allowed)
+  : coalescing_allowed(coalescing_allowed)
+{
+}
+
+//! Activity is reported by the input monitor.
+void
+InputEventQueue::action_notify()
+{
+  notify_activity(TimeSource::get_monotonic_time_usec());
+  wakeup();
+}
+
+//! Mouse activity is reported by the input monitor.
+void
+InputEventQueue::mouse_notify(int x, int y, int wheel)
+{
+  int64_t now = TimeSource::get_monotonic_time_usec();
+  int min_delta = sensitivity.load(std::memory_order_relaxed);
+
+  int delta_x = min_delta;
+  int delta_y = min_delta;
+  if (prev_x != -1 && prev_y != -1)
+    {
+      delta_x = abs(x - prev_x);
+      delta_y = abs(y - prev_y);
+    }
+  prev_x = x;
+  prev_y = y;
+
+  bool moved = delta_x >= min_delta || delta_y >= min_delta || wheel != 0;
+  if (moved || button_is_pressed)
+    {
+      notify_activity(now);
+    }
+
+  if (moved && x >= 0 && y >= 0 && delta_x < MAX_JUMP && delta_y < MAX_JUMP)
+    {
+      mouse_distance.fetch_add(int(sqrt(static_cast<double>(delta_x * delta_x + delta_y * delta_y))), std::memory_order_relaxed);
+
+      if (now - last_mouse_time < MAX_MOVEMENT_PAUSE)
+        {
+          mouse_time.fetch_add(now - last_mouse_time, std::memory_order_relaxed);
+        }
+      last_mouse_time = now;
+    }
+
+  wakeup();
+}
+
+//! Mouse button activity is reported by the input monitor.
+void
+InputEventQueue::button_notify(bool is_press)
+{
+  if (click_x != -1 && click_y != -1 && prev_x != -1 && prev_y != -1)
+    {
+      int delta_x = click_x - prev_x;
+      int delta_y = click_y - prev_y;
+      click_distance.fetch_add(int(sqrt(static_cast<double>(delta_x * delta_x + delta_y * delta_y))), std::memory_order_relaxed);
+    }
+  click_x = prev_x;
+  click_y = prev_y;
+
+  button_is_pressed = is_press;
+  if (is_press)
+    {
+      clicks.fetch_add(1, std::memory_order_relaxed);
+      notify_activity(TimeSource::get_monotonic_time_usec());
+    }
+
+  wakeup();
+}
+
+//! Keyboard activity is reported by the input monitor.
+void
+InputEventQueue::keyboard_notify(bool repeat)
+{
+  if (!repeat)
+    {
+      keystrokes.fetch_add(1, std::memory_order_relaxed);
+    }
+  notify_activity(TimeSource::get_monotonic_time_usec());
+  wakeup();
+}
+
+//! Returns whether the input monitor may coalesce mouse movement.
+bool
+InputEventQueue::is_coalescing_allowed() const
+{
+  return coalescing_allowed;
+}
+
+//! Returns the input aggregated since the previous call.
+InputEventQueue::Activity
+InputEventQueue::process()
+{
+  Activity ret;
+
+  int64_t first = first_activity_time.exchange(0, std::memory_order_acq_rel);
+  int64_t last = last_activity_time.load(std::memory_order_acquire);
+  if (last != processed.last_time)
+    {
+      // The first activity may be reported in the next call if it raced with the reset.
+      ret.first_time = (first != 0 && first <= last) ? first : last;
+      ret.last_time = last;
+      processed.last_time = last;
+    }
+
+  auto collect = [](const std::atomic<int64_t> &total, int64_t &previous) {
+    int64_t value = total.load(std::memory_order_relaxed);
+    int64_t delta = value - previous;
+    previous = value;
+    return delta;
+  };
+
+  ret.mouse_distance = collect(mouse_distance, processed.mouse_distance);
+  ret.mouse_time = collect(mouse_time, processed.mouse_time);
+  ret.click_distance = collect(click_distance, processed.click_distance);
+  ret.clicks = collect(clicks, processed.clicks);
+  ret.keystrokes = collect(keystrokes, processed.keystrokes);
+  return ret;
+}
+
+//! Sets the minimal mouse movement that counts as activity.
+void
+InputEventQueue::set_sensitivity(int sensitivity)
+{
+  this->sensitivity.store(sensitivity, std::memory_order_relaxed);
+}
+
+//! Sets the function to call on the first event after arm_wakeup().
+void
+InputEventQueue::set_wakeup_handler(std::function<void()> handler)
+{
+  wakeup_armed.store(false, std::memory_order_relaxed);
+  wakeup_handler = std::move(handler);
+}
+
+//! Calls the wakeup handler on the next event.
+void
+InputEventQueue::arm_wakeup()
+{
+  if (wakeup_handler)
+    {
+      wakeup_armed.store(true, std::memory_order_release);
+    }
+}
+
+void
+InputEventQueue::notify_activity(int64_t now)
+{
+  int64_t none = 0;
+  first_activity_time.compare_exchange_strong(none, now, std::memory_order_relaxed);
+  last_activity_time.store(now, std::memory_order_release);
+}
+
+void
+InputEventQueue::wakeup()
+{
+  if (wakeup_armed.load(std::memory_order_relaxed) && wakeup_armed.exchange(false, std::memory_order_acquire))
+    {
+      wakeup_handler();
+    }
+}
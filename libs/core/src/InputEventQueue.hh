@@ -0,0 +1,132 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef INPUTEVENTQUEUE_HH
+#define INPUTEVENTQUEUE_HH
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+#include "input-monitor/IInputMonitorListener.hh"
+
+//! Passes input from the input monitor thread to the main loop.
+/*!
+ *  The input monitor (producer) aggregates events into lock-free counters:
+ *  movement distance, clicks, keystrokes and activity timestamps. The
+ *  consumer collects everything aggregated since its previous call at once,
+ *  typically once per heartbeat. Memory use does not depend on the number
+ *  of events, and no input is lost when heartbeats are skipped.
+ */
+class InputEventQueue : public workrave::input_monitor::IInputMonitorListener
+{
+public:
+  //! Input aggregated since the previous call to process().
+  struct Activity
+  {
+    //! Monotonic time in microseconds of the first activity, or 0 without activity.
+    int64_t first_time{0};
+
+    //! Monotonic time in microseconds of the last activity, or 0 without activity.
+    int64_t last_time{0};
+
+    //! Distance the mouse moved, in pixels.
+    int64_t mouse_distance{0};
+
+    //! Time the mouse was moving, in microseconds.
+    int64_t mouse_time{0};
+
+    //! Distance the mouse moved between button events, in pixels.
+    int64_t click_distance{0};
+
+    //! Number of button presses.
+    int64_t clicks{0};
+
+    //! Number of keystrokes, excluding repeats.
+    int64_t keystrokes{0};
+  };
+
+  explicit InputEventQueue(bool coalescing_allowed = false);
+  ~InputEventQueue() override = default;
+
+  void action_notify() override;
+  void mouse_notify(int x, int y, int wheel = 0) override;
+  void button_notify(bool is_press) override;
+  void keyboard_notify(bool repeat) override;
+  bool is_coalescing_allowed() const override;
+
+  //! Returns the input aggregated since the previous call. Must be called from a single thread.
+  Activity process();
+
+  //! Sets the minimal mouse movement, in pixels, that counts as activity.
+  void set_sensitivity(int sensitivity);
+
+  //! Sets the function to call on the first event after arm_wakeup(). Must be set before arming.
+  void set_wakeup_handler(std::function<void()> handler);
+
+  //! Calls the wakeup handler, from the producer thread, on the next event.
+  void arm_wakeup();
+
+private:
+  void notify_activity(int64_t now);
+  void wakeup();
+
+private:
+  //! May the input monitor coalesce mouse movement?
+  bool coalescing_allowed;
+
+  //! Minimal mouse movement that counts as activity.
+  std::atomic<int> sensitivity{3};
+
+  //! Monotonic time of the first activity since the consumer last looked, or 0. Reset by the consumer.
+  std::atomic<int64_t> first_activity_time{0};
+
+  //! Monotonic time of the last activity.
+  std::atomic<int64_t> last_activity_time{0};
+
+  //! Running totals, only incremented by the producer.
+  std::atomic<int64_t> mouse_distance{0};
+  std::atomic<int64_t> mouse_time{0};
+  std::atomic<int64_t> click_distance{0};
+  std::atomic<int64_t> clicks{0};
+  std::atomic<int64_t> keystrokes{0};
+
+  //! Producer state: previous mouse position.
+  int prev_x{-1};
+  int prev_y{-1};
+
+  //! Producer state: mouse position at the previous button event.
+  int click_x{-1};
+  int click_y{-1};
+
+  //! Producer state: time of the previous mouse movement.
+  int64_t last_mouse_time{0};
+
+  //! Producer state: is a button pressed?
+  bool button_is_pressed{false};
+
+  //! Consumer state: the totals at the previous call to process().
+  Activity processed;
+
+  //! Called on the first event after arm_wakeup().
+  std::function<void()> wakeup_handler;
+
+  //! Must the next event call the wakeup handler?
+  std::atomic<bool> wakeup_armed{false};
+};
+
+#endif // INPUTEVENTQUEUE_HH
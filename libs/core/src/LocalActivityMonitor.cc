@@ -42,7 +42,7 @@ LocalActivityMonitor::LocalActivityMonitor()
   input_monitor = workrave::input_monitor::InputMonitorFactory::create_monitor(workrave::input_monitor::MonitorCapability::Activity);
   if (input_monitor != nullptr)
     {
-      input_monitor->subscribe(this);
+      input_monitor->subscribe(&input_events);
     }
 }
 
@@ -52,7 +52,7 @@ LocalActivityMonitor::~LocalActivityMonitor()
   TRACE_ENTRY();
   if (input_monitor != NULL)
     {
-      input_monitor->unsubscribe(this);
+      input_monitor->unsubscribe(&input_events);
     }
 }
 
@@ -72,9 +72,7 @@ void
 LocalActivityMonitor::suspend()
 {
   TRACE_ENTRY_PAR(activity_state);
-  lock.lock();
   activity_state = ACTIVITY_SUSPENDED;
-  lock.unlock();
   activity_state.publish();
   TRACE_VAR(activity_state);
 }
@@ -84,9 +82,7 @@ void
 LocalActivityMonitor::resume()
 {
   TRACE_ENTRY_PAR(activity_state);
-  lock.lock();
   activity_state = ACTIVITY_IDLE;
-  lock.unlock();
   activity_state.publish();
   TRACE_VAR(activity_state);
 }
@@ -96,13 +92,11 @@ void
 LocalActivityMonitor::force_idle()
 {
   TRACE_ENTRY_PAR(activity_state);
-  lock.lock();
   if (activity_state != ACTIVITY_SUSPENDED)
     {
       activity_state = ACTIVITY_IDLE;
       last_action_time = 0;
     }
-  lock.unlock();
   activity_state.publish();
   TRACE_VAR(activity_state);
 }
@@ -112,7 +106,7 @@ ActivityState
 LocalActivityMonitor::get_current_state()
 {
   TRACE_ENTRY_PAR(activity_state);
-  lock.lock();
+  process_input_events();
 
   // First update the state...
   if (activity_state == ACTIVITY_ACTIVE)
@@ -125,7 +119,6 @@ LocalActivityMonitor::get_current_state()
         }
     }
 
-  lock.unlock();
   activity_state.publish();
   TRACE_VAR(activity_state);
   return activity_state;
@@ -140,6 +133,7 @@ LocalActivityMonitor::set_parameters(int noise, int activity, int idle, int sens
   idle_threshold = idle * 1000;
 
   this->sensitivity = sensitivity;
+  input_events.set_sensitivity(sensitivity);
 
   // The easy way out.
   activity_state = ACTIVITY_IDLE;
@@ -162,34 +156,73 @@ LocalActivityMonitor::shift_time(int delta)
   int64_t d = delta * workrave::utils::TimeSource::TIME_USEC_PER_SEC;
 
   Diagnostics::instance().log("activity_monitor: shift");
-  lock.lock();
 
   if (last_action_time != 0)
     last_action_time += d;
 
   if (first_action_time != 0)
     first_action_time += d;
-
-  lock.unlock();
 }
 
 //! Sets the callback listener.
 void
 LocalActivityMonitor::set_listener(IActivityMonitorListener *l)
 {
-  lock.lock();
   listener = l;
-  lock.unlock();
+
+  // Make sure the listener is not delayed by skipped heartbeats.
+  arm_wakeup();
 }
 
-//! Activity is reported by the input monitor.
+//! Sets the function to call when input is received after arm_wakeup().
+void
+LocalActivityMonitor::set_wakeup_handler(std::function<void()> handler)
+{
+  input_events.set_wakeup_handler(std::move(handler));
+}
+
+//! Calls the wakeup handler on the next input event.
 void
-LocalActivityMonitor::action_notify()
+LocalActivityMonitor::arm_wakeup()
 {
-  lock.lock();
+  input_events.arm_wakeup();
+}
+
+//! Processes the input aggregated by the input monitor.
+void
+LocalActivityMonitor::process_input_events()
+{
+  if (input_monitor != nullptr)
+    {
+      input_monitor->flush();
+    }
 
-  int64_t now = TimeSource::get_monotonic_time_usec();
+  InputEventQueue::Activity input = input_events.process();
 
+  if (input_monitor != nullptr)
+    {
+      int64_t received = 0;
+      int64_t delivered = 0;
+      input_monitor->get_event_counts(received, delivered);
+      received_events = received;
+      delivered_events = delivered;
+    }
+
+  if (input.last_time != 0)
+    {
+      process_action(input.first_time);
+      if (input.last_time != input.first_time)
+        {
+          process_action(input.last_time);
+        }
+      call_listener();
+    }
+}
+
+//! Activity is reported by the input monitor.
+void
+LocalActivityMonitor::process_action(int64_t now)
+{
   switch (activity_state)
     {
     case ACTIVITY_IDLE:
@@ -231,73 +264,23 @@ LocalActivityMonitor::action_notify()
     }
 
   last_action_time = now;
-  lock.unlock();
-  call_listener();
-}
-
-//! Mouse activity is reported by the input monitor.
-void
-LocalActivityMonitor::mouse_notify(int x, int y, int wheel_delta)
-{
-  lock.lock();
-  const int delta_x = x - prev_x;
-  const int delta_y = y - prev_y;
-  prev_x = x;
-  prev_y = y;
-
-  if (abs(delta_x) >= sensitivity || abs(delta_y) >= sensitivity || wheel_delta != 0 || button_is_pressed)
-    {
-      action_notify();
-    }
-  lock.unlock();
-}
-
-//! Mouse button activity is reported by the input monitor.
-void
-LocalActivityMonitor::button_notify(bool is_press)
-{
-  lock.lock();
-
-  button_is_pressed = is_press;
-
-  if (is_press)
-    {
-      action_notify();
-    }
-
-  lock.unlock();
-}
-
-//! Keyboard activity is reported by the input monitor.
-void
-LocalActivityMonitor::keyboard_notify(bool repeat)
-{
-  (void)repeat;
-
-  lock.lock();
-  action_notify();
-  lock.unlock();
 }
 
 //! Calls the callback listener.
 void
 LocalActivityMonitor::call_listener()
 {
-  IActivityMonitorListener *l = nullptr;
-
-  lock.lock();
-  l = listener;
-  lock.unlock();
-
-  if (l != nullptr)
+  if (listener != nullptr)
     {
       // Listener is set.
-      if (!l->action_notify())
+      if (!listener->action_notify())
         {
           // Remove listener.
-          lock.lock();
           listener = nullptr;
-          lock.unlock();
+        }
+      else
+        {
+          arm_wakeup();
         }
     }
 }
@@ -18,11 +18,9 @@
 #ifndef LOCALACTIVITYMONITOR_HH
 #define LOCALACTIVITYMONITOR_HH
 
-#include <thread>
-#include <mutex>
 #include "IActivityMonitor.hh"
+#include "InputEventQueue.hh"
 #include "input-monitor/IInputMonitor.hh"
-#include "input-monitor/IInputMonitorListener.hh"
 
 #include "utils/Diagnostics.hh"
 #include "utils/TimeSource.hh"
@@ -30,9 +28,7 @@
 class ActivityListener;
 class IInputMonitor;
 
-class LocalActivityMonitor
-  : public workrave::input_monitor::IInputMonitorListener
-  , public IActivityMonitor
+class LocalActivityMonitor : public IActivityMonitor
 {
 public:
   using Ptr = std::shared_ptr<LocalActivityMonitor>;
@@ -53,33 +49,24 @@ public:
 
   void set_listener(IActivityMonitorListener *l) override;
 
-  void action_notify() override;
-  void mouse_notify(int x, int y, int wheel = 0) override;
-  void button_notify(bool is_press) override;
-  void keyboard_notify(bool repeat) override;
+  void set_wakeup_handler(std::function<void()> handler);
+  void arm_wakeup();
 
 private:
+  void process_input_events();
+  void process_action(int64_t now);
   void call_listener();
 
 private:
   //! The actual monitoring driver.
   workrave::input_monitor::IInputMonitor::Ptr input_monitor;
 
+  //! Input received from the monitoring driver. Only activity matters, so mouse movement may be coalesced.
+  InputEventQueue input_events{true};
+
   //! the current state.
   TracedField<ActivityState> activity_state{"monitor.activity_state", ACTIVITY_IDLE, true};
 
-  //! Internal locking
-  std::recursive_mutex lock;
-
-  //! Previous X coordinate
-  int prev_x{-10};
-
-  //! Previous Y coordinate
-  int prev_y{-10};
-
-  //! Is the button currently pressed?
-  bool button_is_pressed{false};
-
   //! Last time activity was detected
   int64_t last_action_time{0};
 
@@ -98,6 +85,12 @@ private:
   //! Mouse sensitivity
   TracedField<int> sensitivity{"monitor.sensitivity", 3};
 
+  //! Number of events received by the monitoring driver.
+  TracedField<int64_t> received_events{"monitor.received_events", 0, true};
+
+  //! Number of notifications delivered by the monitoring driver.
+  TracedField<int64_t> delivered_events{"monitor.delivered_events", 0, true};
+
   //! Activity listener.
   IActivityMonitorListener *listener{nullptr};
 };
@@ -22,39 +22,110 @@
 
 #include "debug.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <mutex>
+#include <utility>
 
 #include "PacketBuffer.hh"
 
-PacketBuffer::~PacketBuffer()
+namespace
 {
-  narrow(0, -1);
-  if (buffer != nullptr)
+  //! Maximum number of released buffers that are kept for reuse.
+  constexpr std::size_t POOL_SIZE = 8;
+
+  //! Released buffers and their sizes. Packets are created and released by several threads.
+  struct BufferPool
+  {
+    ~BufferPool()
+    {
+      for (auto &entry: buffers)
+        {
+          g_free(entry.first);
+        }
+    }
+
+    //! Removes and returns a buffer of at least size bytes, or nullptr.
+    guint8 *take(int &size)
     {
+      std::scoped_lock lock(mutex);
+      auto it = std::find_if(buffers.begin(), buffers.end(), [size](const auto &entry) { return entry.second >= size; });
+      if (it == buffers.end())
+        {
+          return nullptr;
+        }
+
+      guint8 *buffer = it->first;
+      size = it->second;
+      buffers.erase(it);
+      return buffer;
+    }
+
+    //! Keeps the buffer for reuse, or frees it when the pool is full.
+    void put(guint8 *buffer, int size)
+    {
+      {
+        std::scoped_lock lock(mutex);
+        if (buffers.size() < POOL_SIZE)
+          {
+            buffers.emplace_back(buffer, size);
+            return;
+          }
+      }
       g_free(buffer);
     }
+
+    std::mutex mutex;
+    std::vector<std::pair<guint8 *, int>> buffers;
+  } buffer_pool;
+} // namespace
+
+PacketBuffer::~PacketBuffer()
+{
+  release();
 }
 
+//! Creates an empty buffer of at least size bytes.
+/*!
+ *  Buffers released by other packets are reused when they are large enough.
+ */
 void
 PacketBuffer::create(int size)
 {
-  narrow(0, -1);
+  release();
 
-  if (buffer != nullptr)
+  if (size == 0)
     {
-      g_free(buffer);
+      size = 1024;
     }
 
-  if (size == 0)
+  buffer = buffer_pool.take(size);
+  if (buffer == nullptr)
     {
-      size = 1024;
+      buffer = g_new(guint8, size);
     }
 
-  buffer = g_new(guint8, size);
   read_ptr = buffer;
   write_ptr = buffer;
   buffer_size = size;
+  protocol = PACKET_PROTOCOL_LEGACY;
+  reset_string_table();
+}
+
+//! Returns the buffer to the pool.
+void
+PacketBuffer::release()
+{
+  narrow(0, -1);
+
+  if (buffer != nullptr)
+    {
+      buffer_pool.put(buffer, buffer_size);
+    }
+
+  buffer = read_ptr = write_ptr = nullptr;
+  buffer_size = 0;
 }
 
 void
@@ -93,403 +164,595 @@ PacketBuffer::resize(int size)
       write_ptr = buffer + write_offset;
       buffer_size = size;
     }
-  // }
+}
 
-  void PacketBuffer::grow(int size)
-  {
-    // TRACE_ENTRY_PAR(size)
-    if (size < GROW_SIZE)
-      {
-        size = GROW_SIZE;
-      }
+//! Grows the buffer by at least size bytes.
+/*!
+ *  The buffer at least doubles in size so that packing a large packet only
+ *  needs a few reallocations.
+ */
+void
+PacketBuffer::grow(int size)
+{
+  // TRACE_ENTRY_PAR(size)
+  if (size < GROW_SIZE)
+    {
+      size = GROW_SIZE;
+    }
 
-    resize(buffer_size + size);
-    // }
+  resize(buffer_size + std::max(size, buffer_size));
+}
 
-    void PacketBuffer::pack(const guint8 *data, int size)
+void
+PacketBuffer::pack(const guint8 *data, int size)
+{
+  if (write_ptr + size + 2 >= buffer + buffer_size)
     {
-      if (write_ptr + size + 2 >= buffer + buffer_size)
-        {
-          grow(size + 2);
-        }
+      grow(size + 2);
+    }
 
-      pack_ushort(size);
-      memcpy(write_ptr, data, size);
-      write_ptr += size;
+  pack_ushort(size);
+  memcpy(write_ptr, data, size);
+  write_ptr += size;
+}
+
+void
+PacketBuffer::pack_raw(const guint8 *data, int size)
+{
+  if (write_ptr + size >= buffer + buffer_size)
+    {
+      grow(size);
+    }
+
+  memcpy(write_ptr, data, size);
+  write_ptr += size;
+}
+
+void
+PacketBuffer::pack_string(const std::string &data)
+{
+  pack_string(data.c_str());
+}
+
+void
+PacketBuffer::pack_string(const gchar *data)
+{
+  int size = 0;
+  if (data != nullptr)
+    {
+      size = strlen(data);
     }
 
-    void PacketBuffer::pack_raw(const guint8 *data, int size)
+  if (write_ptr + size + 2 >= buffer + buffer_size)
     {
-      if (write_ptr + size >= buffer + buffer_size)
-        {
-          grow(size);
-        }
+      grow(size + 2);
+    }
+
+  pack_ushort(size);
 
+  if (size > 0)
+    {
       memcpy(write_ptr, data, size);
       write_ptr += size;
     }
+}
 
-    void PacketBuffer::pack_string(const std::string &data)
+void
+PacketBuffer::poke_string(int pos, const gchar *data)
+{
+  int size = 0;
+  if (data != nullptr)
     {
-      pack_string(data.c_str());
+      size = strlen(data);
     }
 
-    void PacketBuffer::pack_string(const gchar *data)
+  if (pos + size + 2 >= buffer_size)
     {
-      int size = 0;
-      if (data != nullptr)
-        {
-          size = strlen(data);
-        }
-
-      if (write_ptr + size + 2 >= buffer + buffer_size)
-        {
-          grow(size + 2);
-        }
+      grow(size + 2);
+    }
 
-      pack_ushort(size);
+  poke_ushort(pos, size);
 
-      if (size > 0)
-        {
-          memcpy(write_ptr, data, size);
-          write_ptr += size;
-        }
+  if (size > 0)
+    {
+      memcpy(buffer + pos + 2, data, size);
     }
+}
 
-    void PacketBuffer::poke_string(int pos, const gchar *data)
+void
+PacketBuffer::pack_ushort(guint16 data)
+{
+  if (write_ptr + 2 >= buffer + buffer_size)
     {
-      int size = 0;
-      if (data != nullptr)
-        {
-          size = strlen(data);
-        }
+      grow(2);
+    }
 
-      if (pos + size + 2 >= buffer_size)
-        {
-          grow(size + 2);
-        }
+  guint8 *w = (guint8 *)write_ptr;
+  w[0] = ((data & 0x0000ff00) >> 8);
+  w[1] = ((data & 0x000000ff));
 
-      poke_ushort(pos, size);
+  write_ptr += 2;
+}
 
-      if (size > 0)
-        {
-          memcpy(buffer + pos + 2, data, size);
-        }
+void
+PacketBuffer::pack_ulong(guint32 data)
+{
+  if (write_ptr + 4 >= buffer + buffer_size)
+    {
+      grow(4);
     }
 
-    void PacketBuffer::pack_ushort(guint16 data)
-    {
-      if (write_ptr + 2 >= buffer + buffer_size)
-        {
-          grow(2);
-        }
+  guint8 *w = (guint8 *)write_ptr;
+  w[0] = ((data & 0xff000000) >> 24);
+  w[1] = ((data & 0x00ff0000) >> 16);
+  w[2] = ((data & 0x0000ff00) >> 8);
+  w[3] = ((data & 0x000000ff));
 
-      guint8 *w = (guint8 *)write_ptr;
-      w[0] = ((data & 0x0000ff00) >> 8);
-      w[1] = ((data & 0x000000ff));
+  write_ptr += 4;
+}
 
-      write_ptr += 2;
+void
+PacketBuffer::pack_byte(guint8 data)
+{
+  if (write_ptr + 1 >= buffer + buffer_size)
+    {
+      grow(1);
     }
 
-    void PacketBuffer::pack_ulong(guint32 data)
+  write_ptr[0] = data;
+  write_ptr++;
+}
+
+//! Packs an unsigned integer in 7 bit groups, least significant first.
+void
+PacketBuffer::pack_varint(guint64 data)
+{
+  do
     {
-      if (write_ptr + 4 >= buffer + buffer_size)
+      guint8 byte = data & 0x7f;
+      data >>= 7;
+      if (data != 0)
         {
-          grow(4);
+          byte |= 0x80;
         }
+      pack_byte(byte);
+    }
+  while (data != 0);
+}
 
-      guint8 *w = (guint8 *)write_ptr;
-      w[0] = ((data & 0xff000000) >> 24);
-      w[1] = ((data & 0x00ff0000) >> 16);
-      w[2] = ((data & 0x0000ff00) >> 8);
-      w[3] = ((data & 0x000000ff));
+//! Packs a signed integer as zigzag encoded varint.
+void
+PacketBuffer::pack_svarint(gint64 data)
+{
+  pack_varint((static_cast<guint64>(data) << 1) ^ static_cast<guint64>(data >> 63));
+}
 
-      write_ptr += 4;
+//! Packs a string through the string table of this buffer.
+/*!
+ *  The first occurrence of a string is packed as 0, its length and its
+ *  characters. Later occurrences are packed as the index in the table plus one.
+ */
+void
+PacketBuffer::pack_string_ref(std::string_view data)
+{
+  auto it = std::find(packed_strings.begin(), packed_strings.end(), data);
+  if (it != packed_strings.end())
+    {
+      pack_varint((it - packed_strings.begin()) + 1);
+      return;
     }
 
-    void PacketBuffer::pack_byte(guint8 data)
-    {
-      if (write_ptr + 1 >= buffer + buffer_size)
-        {
-          grow(1);
-        }
+  pack_varint(0);
+  pack_varint(data.size());
+  pack_raw(reinterpret_cast<const guint8 *>(data.data()), data.size());
+  packed_strings.emplace_back(data);
+}
 
-      write_ptr[0] = data;
-      write_ptr++;
+void
+PacketBuffer::poke_byte(int pos, guint8 data)
+{
+  if (pos + 1 > buffer_size)
+    {
+      grow(pos + 1 - buffer_size);
     }
 
-    void PacketBuffer::poke_byte(int pos, guint8 data)
-    {
-      if (pos + 1 > buffer_size)
-        {
-          grow(pos + 1 - buffer_size);
-        }
+  buffer[pos] = data;
+}
 
-      buffer[pos] = data;
+void
+PacketBuffer::poke_ushort(int pos, guint16 data)
+{
+  if (pos + 2 > buffer_size)
+    {
+      grow(pos + 2 - buffer_size);
     }
 
-    void PacketBuffer::poke_ushort(int pos, guint16 data)
-    {
-      if (pos + 2 > buffer_size)
-        {
-          grow(pos + 2 - buffer_size);
-        }
+  guint8 *w = (guint8 *)buffer;
 
-      guint8 *w = (guint8 *)buffer;
+  w[pos] = ((data & 0x0000ff00) >> 8);
+  w[pos + 1] = ((data & 0x000000ff));
+}
 
-      w[pos] = ((data & 0x0000ff00) >> 8);
-      w[pos + 1] = ((data & 0x000000ff));
+void
+PacketBuffer::poke_ulong(int pos, guint32 data)
+{
+  if (pos + 4 > buffer_size)
+    {
+      grow(pos + 4 - buffer_size);
     }
 
-    int PacketBuffer::unpack(guint8 * *data)
-    {
-      g_assert(data != nullptr);
+  guint8 *w = (guint8 *)buffer;
 
-      int size = unpack_ushort();
+  w[pos] = ((data & 0xff000000) >> 24);
+  w[pos + 1] = ((data & 0x00ff0000) >> 16);
+  w[pos + 2] = ((data & 0x0000ff00) >> 8);
+  w[pos + 3] = ((data & 0x000000ff));
+}
 
-      guint8 *r = (guint8 *)read_ptr;
+int
+PacketBuffer::unpack(guint8 **data)
+{
+  g_assert(data != nullptr);
 
-      if (read_ptr + size <= buffer + buffer_size)
-        {
-          *data = g_new(guint8, size);
-          memcpy(*data, r, size);
-          read_ptr += size;
-        }
-      else
-        {
-          size = 0;
-        }
+  int size = unpack_ushort();
 
-      return size;
-    }
+  guint8 *r = (guint8 *)read_ptr;
 
-    int PacketBuffer::unpack_raw(guint8 * *data, int size)
+  if (read_ptr + size <= buffer + buffer_size)
     {
-      g_assert(data != nullptr);
+      *data = g_new(guint8, size);
+      memcpy(*data, r, size);
+      read_ptr += size;
+    }
+  else
+    {
+      size = 0;
+    }
 
-      guint8 *r = (guint8 *)read_ptr;
+  return size;
+}
 
-      if (read_ptr + size <= buffer + buffer_size)
-        {
-          *data = g_new(guint8, size);
-          memcpy(*data, r, size);
-          read_ptr += size;
-        }
-      else
-        {
-          size = 0;
-        }
+int
+PacketBuffer::unpack_raw(guint8 **data, int size)
+{
+  g_assert(data != nullptr);
 
-      return size;
+  guint8 *r = (guint8 *)read_ptr;
+
+  if (read_ptr + size <= buffer + buffer_size)
+    {
+      *data = g_new(guint8, size);
+      memcpy(*data, r, size);
+      read_ptr += size;
+    }
+  else
+    {
+      size = 0;
     }
 
-    gchar *PacketBuffer::unpack_string()
+  return size;
+}
+
+gchar *
+PacketBuffer::unpack_string()
+{
+  gchar *str = nullptr;
+
+  if (read_ptr + 2 <= buffer + buffer_size)
     {
-      gchar *str = nullptr;
+      int length = unpack_ushort();
 
-      if (read_ptr + 2 <= buffer + buffer_size)
+      if (read_ptr + length <= buffer + buffer_size)
         {
-          int length = unpack_ushort();
-
-          if (read_ptr + length <= buffer + buffer_size)
+          str = g_new(gchar, length + 1);
+          for (int i = 0; i < length; i++)
             {
-              str = g_new(gchar, length + 1);
-              for (int i = 0; i < length; i++)
-                {
-                  str[i] = *read_ptr;
-                  read_ptr++;
-                }
-
-              str[length] = '\0';
+              str[i] = *read_ptr;
+              read_ptr++;
             }
+
+          str[length] = '\0';
         }
+    }
+
+  return str;
+}
 
-      return str;
+guint32
+PacketBuffer::unpack_ulong()
+{
+  guint32 ret = 0;
+  guint8 *r = (guint8 *)read_ptr;
+
+  if (read_ptr + 4 <= buffer + buffer_size)
+    {
+      ret = (((guint32)(r[0]) << 24) + ((guint32)(r[1]) << 16) + ((guint32)(r[2]) << 8) + ((guint32)(r[3])));
+      read_ptr += 4;
     }
 
-    guint32 PacketBuffer::unpack_ulong()
+  return ret;
+}
+
+guint16
+PacketBuffer::unpack_ushort()
+{
+  guint16 ret = 0;
+  guint8 *r = (guint8 *)read_ptr;
+
+  if (read_ptr + 2 <= write_ptr)
     {
-      guint32 ret = 0;
-      guint8 *r = (guint8 *)read_ptr;
+      ret = (r[0] << 8) + r[1];
+      read_ptr += 2;
+    }
+  return ret;
+}
 
-      if (read_ptr + 4 <= buffer + buffer_size)
-        {
-          ret = (((guint32)(r[0]) << 24) + ((guint32)(r[1]) << 16) + ((guint32)(r[2]) << 8) + ((guint32)(r[3])));
-          read_ptr += 4;
-        }
+guint8
+PacketBuffer::unpack_byte()
+{
+  guint8 ret = 0;
 
-      return ret;
+  if (read_ptr + 1 <= write_ptr)
+    {
+      ret = read_ptr[0];
+      read_ptr++;
     }
+  return ret;
+}
+
+guint64
+PacketBuffer::unpack_varint()
+{
+  guint64 ret = 0;
 
-    guint16 PacketBuffer::unpack_ushort()
+  for (int shift = 0; shift < 64 && read_ptr < write_ptr && read_ptr < buffer + buffer_size; shift += 7)
     {
-      guint16 ret = 0;
-      guint8 *r = (guint8 *)read_ptr;
+      guint8 byte = read_ptr[0];
+      read_ptr++;
 
-      if (read_ptr + 2 <= write_ptr)
+      ret |= static_cast<guint64>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
         {
-          ret = (r[0] << 8) + r[1];
-          read_ptr += 2;
+          break;
         }
-      return ret;
     }
+  return ret;
+}
 
-    guint8 PacketBuffer::unpack_byte()
+gint64
+PacketBuffer::unpack_svarint()
+{
+  guint64 value = unpack_varint();
+  return static_cast<gint64>(value >> 1) ^ -static_cast<gint64>(value & 1);
+}
+
+//! Unpacks a string without copying it.
+/*!
+ *  The returned view points into the buffer and remains valid until the
+ *  buffer is modified or destroyed.
+ */
+std::string_view
+PacketBuffer::unpack_string_view()
+{
+  std::string_view str;
+
+  if (read_ptr + 2 <= buffer + buffer_size)
     {
-      guint8 ret = 0;
+      int length = unpack_ushort();
 
-      if (read_ptr + 1 <= write_ptr)
+      if (read_ptr + length <= buffer + buffer_size)
         {
-          ret = read_ptr[0];
-          read_ptr++;
+          str = std::string_view(reinterpret_cast<const char *>(read_ptr), length);
+          read_ptr += length;
         }
-      return ret;
     }
 
-    int PacketBuffer::peek(int pos, guint8 **data)
-    {
-      g_assert(data != nullptr);
+  return str;
+}
+
+//! Unpacks a string packed by pack_string_ref without copying it.
+std::string_view
+PacketBuffer::unpack_string_ref()
+{
+  std::string_view str;
+  guint64 index = unpack_varint();
 
-      int size = peek_ushort(pos);
+  if (index == 0)
+    {
+      guint64 length = unpack_varint();
 
-      if (read_ptr + 2 + pos + size <= buffer + buffer_size)
+      if (length <= static_cast<guint64>(buffer + buffer_size - read_ptr))
         {
-          *data = g_new(guint8, size);
-          memcpy(*data, read_ptr + 2 + pos, size);
+          str = std::string_view(reinterpret_cast<const char *>(read_ptr), length);
+          read_ptr += length;
+          unpacked_strings.push_back(str);
         }
-      else
-        {
-          size = 0;
-        }
-
-      return size;
     }
-
-    gchar *PacketBuffer::peek_string(int pos)
+  else if (index <= unpacked_strings.size())
     {
-      gchar *str = nullptr;
+      str = unpacked_strings[index - 1];
+    }
 
-      if (read_ptr + pos + 2 <= buffer + buffer_size)
-        {
-          int length = peek_ushort(pos);
+  return str;
+}
 
-          if (read_ptr + 2 + pos + length <= buffer + buffer_size)
-            {
-              str = g_new(gchar, length + 1);
-              memcpy(str, read_ptr + pos + 2, length);
-              str[length] = '\0';
-            }
-        }
+//! Forgets all strings in the string table.
+void
+PacketBuffer::reset_string_table()
+{
+  packed_strings.clear();
+  unpacked_strings.clear();
+}
+
+int
+PacketBuffer::peek(int pos, guint8 **data)
+{
+  g_assert(data != nullptr);
+
+  int size = peek_ushort(pos);
 
-      return str;
+  if (read_ptr + 2 + pos + size <= buffer + buffer_size)
+    {
+      *data = g_new(guint8, size);
+      memcpy(*data, read_ptr + 2 + pos, size);
+    }
+  else
+    {
+      size = 0;
     }
 
-    guint32 PacketBuffer::peek_ulong(int pos)
+  return size;
+}
+
+gchar *
+PacketBuffer::peek_string(int pos)
+{
+  gchar *str = nullptr;
+
+  if (read_ptr + pos + 2 <= buffer + buffer_size)
     {
-      guint32 ret = 0;
-      if (read_ptr + pos + 4 <= buffer + buffer_size)
-        {
-          guint8 *r = (guint8 *)read_ptr;
+      int length = peek_ushort(pos);
 
-          ret = (((guint32)(r[pos]) << 24) + ((guint32)(r[pos + 1]) << 16) + ((guint32)(r[pos + 2]) << 8) + ((guint32)(r[pos + 3])));
+      if (read_ptr + 2 + pos + length <= buffer + buffer_size)
+        {
+          str = g_new(gchar, length + 1);
+          memcpy(str, read_ptr + pos + 2, length);
+          str[length] = '\0';
         }
+    }
 
-      return ret;
+  return str;
+}
+
+guint32
+PacketBuffer::peek_ulong(int pos)
+{
+  guint32 ret = 0;
+  if (read_ptr + pos + 4 <= buffer + buffer_size)
+    {
+      guint8 *r = (guint8 *)read_ptr;
+
+      ret = (((guint32)(r[pos]) << 24) + ((guint32)(r[pos + 1]) << 16) + ((guint32)(r[pos + 2]) << 8) + ((guint32)(r[pos + 3])));
     }
 
-    guint16 PacketBuffer::peek_ushort(int pos)
+  return ret;
+}
+
+guint16
+PacketBuffer::peek_ushort(int pos)
+{
+  guint16 ret = 0;
+  if (read_ptr + pos + 2 <= write_ptr)
     {
-      guint16 ret = 0;
-      if (read_ptr + pos + 2 <= write_ptr)
-        {
-          guint8 *r = (guint8 *)read_ptr;
-          ret = (r[pos] << 8) + r[pos + 1];
-        }
-      return ret;
+      guint8 *r = (guint8 *)read_ptr;
+      ret = (r[pos] << 8) + r[pos + 1];
     }
+  return ret;
+}
 
-    guint8 PacketBuffer::peek_byte(int pos)
+guint8
+PacketBuffer::peek_byte(int pos)
+{
+  guint8 ret = 0;
+  if (read_ptr + pos + 1 <= buffer + buffer_size)
     {
-      guint8 ret = 0;
-      if (read_ptr + pos + 1 <= buffer + buffer_size)
-        {
-          ret = read_ptr[pos];
-        }
-      return ret;
+      ret = read_ptr[pos];
     }
+  return ret;
+}
 
-    void PacketBuffer::reserve_size(int &pos)
+void
+PacketBuffer::reserve_size(int &pos)
+{
+  pos = bytes_written();
+  if (has_large_sizes())
+    {
+      pack_ulong(0);
+    }
+  else
     {
-      pos = bytes_written();
       pack_ushort(0);
     }
+}
 
-    void PacketBuffer::update_size(int pos)
+void
+PacketBuffer::update_size(int pos)
+{
+  if (has_large_sizes())
+    {
+      poke_ulong(pos, bytes_written() - pos - 4);
+    }
+  else
     {
       poke_ushort(pos, bytes_written() - pos - 2);
     }
+}
 
-    int PacketBuffer::read_size(int &pos)
-    {
-      int size = unpack_ushort();
+int
+PacketBuffer::read_size(int &pos)
+{
+  int size = has_large_sizes() ? (int)unpack_ulong() : unpack_ushort();
 
-      pos = bytes_read() + size;
+  pos = bytes_read() + size;
 
-      return size;
-    }
+  return size;
+}
 
-    void PacketBuffer::skip_size(int &pos)
-    {
-      int size = (pos - bytes_read());
-      skip(size);
-    }
+void
+PacketBuffer::skip_size(int &pos)
+{
+  int size = (pos - bytes_read());
+  skip(size);
+}
 
-    void PacketBuffer::insert(int pos, int size)
+void
+PacketBuffer::insert(int pos, int size)
+{
+  if (pos < bytes_written())
     {
-      if (pos < bytes_written())
-        {
-          int move = bytes_written() - pos;
+      int move = bytes_written() - pos;
 
-          memmove(buffer + pos + size, buffer + pos, move);
+      memmove(buffer + pos + size, buffer + pos, move);
 
-          write_ptr += size;
-        }
+      write_ptr += size;
     }
+}
 
-    void PacketBuffer::narrow(int pos, int size)
+void
+PacketBuffer::narrow(int pos, int size)
+{
+  // TRACE_ENTRY_PAR(pos, size);
+  if (pos == 0 && size == -1)
     {
-      // TRACE_ENTRY_PAR(pos, size);
-      if (pos == 0 && size == -1)
+      if (original_buffer != nullptr)
         {
-          if (original_buffer != nullptr)
-            {
-              // unnarrow.
-              buffer = original_buffer;
-              buffer_size = original_buffer_size;
-              original_buffer_size = 0;
-              original_buffer = nullptr;
-            }
+          // unnarrow.
+          buffer = original_buffer;
+          buffer_size = original_buffer_size;
+          original_buffer_size = 0;
+          original_buffer = nullptr;
         }
-      else
+    }
+  else
+    {
+      if (pos == -1)
         {
-          if (pos == -1)
-            {
-              pos = bytes_read();
-            }
-
-          if (original_buffer == nullptr)
-            {
-              original_buffer = buffer;
-              original_buffer_size = buffer_size;
-            }
+          pos = bytes_read();
+        }
 
-          if (size > original_buffer_size - pos)
-            {
-              size = original_buffer_size - pos;
-            }
+      if (original_buffer == nullptr)
+        {
+          original_buffer = buffer;
+          original_buffer_size = buffer_size;
+        }
 
-          buffer = original_buffer + pos;
-          buffer_size = size;
-          read_ptr = buffer;
+      if (size > original_buffer_size - pos)
+        {
+          size = original_buffer_size - pos;
         }
-      // }
+
+      buffer = original_buffer + pos;
+      buffer_size = size;
+      read_ptr = buffer;
+    }
+}
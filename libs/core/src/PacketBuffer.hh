@@ -19,11 +19,26 @@
 #define PACKETBUFER_HH
 
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "glib.h"
 
 #define GROW_SIZE (4096)
 
+//! Versions of the distribution wire protocol.
+enum PacketProtocol
+{
+  //! Fixed size fields.
+  PACKET_PROTOCOL_LEGACY = 3,
+
+  //! Variable length integers, per-message string table and delta encoded times.
+  PACKET_PROTOCOL_COMPACT = 4,
+
+  //! Compact, with 32 bit sizes. Packets larger than 64 KiB are sent in chunks.
+  PACKET_PROTOCOL_CHUNKED = 5,
+};
+
 class PacketBuffer
 {
 public:
@@ -40,6 +55,7 @@ public:
   {
     narrow(0, -1);
     write_ptr = read_ptr = buffer;
+    reset_string_table();
   }
   void skip(int size)
   {
@@ -55,9 +71,13 @@ public:
   void pack_ushort(guint16 data);
   void pack_ulong(guint32 data);
   void pack_byte(guint8 data);
+  void pack_varint(guint64 data);
+  void pack_svarint(gint64 data);
+  void pack_string_ref(std::string_view data);
 
   void poke_byte(int pos, guint8 data);
   void poke_ushort(int pos, guint16 data);
+  void poke_ulong(int pos, guint32 data);
   void poke_string(int pos, const gchar *data);
 
   int unpack(guint8 **data);
@@ -66,6 +86,11 @@ public:
   guint32 unpack_ulong();
   guint16 unpack_ushort();
   guint8 unpack_byte();
+  guint64 unpack_varint();
+  gint64 unpack_svarint();
+  std::string_view unpack_string_view();
+  std::string_view unpack_string_ref();
+  void reset_string_table();
 
   int peek(int pos, guint8 **data);
   gchar *peek_string(int pos);
@@ -106,6 +131,25 @@ public:
   {
     read_ptr = buffer;
   }
+  int get_protocol() const
+  {
+    return protocol;
+  }
+  void set_protocol(int protocol)
+  {
+    this->protocol = protocol;
+  }
+  bool is_compact() const
+  {
+    return protocol >= PACKET_PROTOCOL_COMPACT;
+  }
+  bool has_large_sizes() const
+  {
+    return protocol >= PACKET_PROTOCOL_CHUNKED;
+  }
+
+private:
+  void release();
 
 public:
   guint8 *buffer{nullptr};
@@ -115,6 +159,16 @@ public:
 
   guint8 *original_buffer{nullptr};
   int original_buffer_size{0};
+
+  //! Protocol used for the contents of this buffer.
+  int protocol{PACKET_PROTOCOL_LEGACY};
+
+private:
+  //! Strings packed by pack_string_ref.
+  std::vector<std::string> packed_strings;
+
+  //! Strings unpacked by unpack_string_ref. They point into the buffer.
+  std::vector<std::string_view> unpacked_strings;
 };
 
 #endif
@@ -0,0 +1,222 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <algorithm>
+
+#include "PacketStream.hh"
+
+PacketStream::PacketStream(guint16 chunk_command)
+  : chunk_command(chunk_command)
+{
+}
+
+guint8 *
+PacketStream::prepare_read(int size)
+{
+  if (read_pos > 0)
+    {
+      // Drop the frames that were processed.
+      read_buffer.erase(read_buffer.begin(), read_buffer.begin() + read_pos);
+      read_end -= read_pos;
+      read_pos = 0;
+    }
+
+  read_buffer.resize(read_end + size);
+  return read_buffer.data() + read_end;
+}
+
+void
+PacketStream::commit_read(int size)
+{
+  read_end += std::max(size, 0);
+  read_buffer.resize(read_end);
+}
+
+PacketStream::ReadStatus
+PacketStream::read_packet(PacketBuffer &packet)
+{
+  while (read_end - read_pos >= 2)
+    {
+      const guint8 *frame = read_buffer.data() + read_pos;
+      int size = (frame[0] << 8) + frame[1];
+
+      if (size < PACKET_HEADER_SIZE)
+        {
+          return ReadStatus::Invalid;
+        }
+
+      if (read_end - read_pos < (size_t)size)
+        {
+          break;
+        }
+      read_pos += size;
+
+      int command = (frame[4] << 8) + frame[5];
+      if (command != chunk_command)
+        {
+          packet.clear();
+          packet.pack_raw(frame, size);
+          return ReadStatus::Packet;
+        }
+
+      guint32 size_of_packet = 0;
+      if (size >= CHUNK_HEADER_SIZE)
+        {
+          size_of_packet = ((guint32)frame[6] << 24) + ((guint32)frame[7] << 16) + ((guint32)frame[8] << 8) + frame[9];
+        }
+
+      if (chunks.empty())
+        {
+          chunked_size = size_of_packet;
+        }
+
+      int chunk_size = size - CHUNK_HEADER_SIZE;
+      if (chunk_size <= 0 || size_of_packet != chunked_size || chunked_size > MAX_PACKET_SIZE
+          || chunks.size() + chunk_size > chunked_size)
+        {
+          return ReadStatus::Invalid;
+        }
+
+      if (chunks.empty())
+        {
+          chunks.reserve(chunked_size);
+        }
+      chunks.insert(chunks.end(), frame + CHUNK_HEADER_SIZE, frame + size);
+
+      if (chunks.size() == chunked_size)
+        {
+          packet.clear();
+          packet.pack_raw(chunks.data(), (int)chunks.size());
+          chunks.clear();
+          chunks.shrink_to_fit();
+          chunked_size = 0;
+          return ReadStatus::Packet;
+        }
+    }
+
+  return ReadStatus::Incomplete;
+}
+
+bool
+PacketStream::queue_packet(PacketBuffer &packet, bool chunked)
+{
+  int size = packet.bytes_written();
+  const guint8 *data = (const guint8 *)packet.get_buffer();
+
+  if (size <= MAX_FRAME_SIZE)
+    {
+      // Length.
+      packet.poke_ushort(0, size);
+      queue_frame(nullptr, 0, data, size);
+    }
+  else if (chunked && (guint32)size <= MAX_PACKET_SIZE)
+    {
+      // The length of a chunked packet is taken from the chunk headers.
+      packet.poke_ushort(0, 0);
+
+      PacketBuffer header;
+      header.create(CHUNK_HEADER_SIZE);
+      header.pack_ushort(0);
+      header.pack_byte(PACKET_PROTOCOL_CHUNKED);
+      header.pack_byte(0);
+      header.pack_ushort(chunk_command);
+      header.pack_ulong(size);
+
+      for (int pos = 0; pos < size; pos += MAX_FRAME_SIZE - CHUNK_HEADER_SIZE)
+        {
+          int chunk_size = std::min(size - pos, MAX_FRAME_SIZE - CHUNK_HEADER_SIZE);
+          header.poke_ushort(0, CHUNK_HEADER_SIZE + chunk_size);
+          queue_frame((const guint8 *)header.get_buffer(), CHUNK_HEADER_SIZE, data + pos, chunk_size);
+        }
+    }
+  else
+    {
+      return false;
+    }
+  return true;
+}
+
+//! Appends a frame, consisting of an optional header and data, to the write queue.
+void
+PacketStream::queue_frame(const guint8 *header, int header_size, const guint8 *data, int size)
+{
+  std::vector<guint8> frame;
+  frame.reserve(header_size + size);
+  if (header != nullptr)
+    {
+      frame.insert(frame.end(), header, header + header_size);
+    }
+  frame.insert(frame.end(), data, data + size);
+
+  write_queue_size += frame.size();
+  write_queue.push_back(std::move(frame));
+}
+
+int
+PacketStream::gather(ISocket::WriteBuffer *buffers, int max_count, int &size) const
+{
+  int count = 0;
+  size = 0;
+
+  for (auto it = write_queue.begin(); it != write_queue.end() && count < max_count; it++)
+    {
+      size_t offset = count == 0 ? write_offset : 0;
+      buffers[count].data = it->data() + offset;
+      buffers[count].size = (int)(it->size() - offset);
+      size += buffers[count].size;
+      count++;
+    }
+  return count;
+}
+
+void
+PacketStream::consume(int bytes_written)
+{
+  size_t remaining = std::max(bytes_written, 0);
+  write_queue_size -= std::min(remaining, write_queue_size);
+
+  while (remaining > 0 && !write_queue.empty())
+    {
+      std::vector<guint8> &frame = write_queue.front();
+      size_t left = frame.size() - write_offset;
+      if (remaining < left)
+        {
+          write_offset += remaining;
+          break;
+        }
+      remaining -= left;
+      write_offset = 0;
+      write_queue.pop_front();
+    }
+}
+
+void
+PacketStream::clear()
+{
+  read_buffer.clear();
+  read_pos = 0;
+  read_end = 0;
+  chunks.clear();
+  chunked_size = 0;
+  write_queue.clear();
+  write_offset = 0;
+  write_queue_size = 0;
+}
@@ -0,0 +1,149 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PACKETSTREAM_HH
+#define PACKETSTREAM_HH
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+
+#include "PacketBuffer.hh"
+#include "SocketDriver.hh"
+
+//! Frames packets on a byte stream.
+/*!
+ *  Each frame starts with its 16 bit length. Packets that do not fit in a
+ *  single frame are split into chunk frames, that carry the packet header,
+ *  the 32 bit size of the chunked packet and a part of the packet.
+ *
+ *  Incoming bytes are collected until they form complete frames, and chunks
+ *  are reassembled. Outgoing frames are queued until the socket accepts them.
+ *  The stream itself does not perform any I/O.
+ */
+class PacketStream
+{
+public:
+  //! Maximum size of a frame on the wire. The size is packed in 16 bits.
+  static constexpr int MAX_FRAME_SIZE = 0xffff;
+
+  //! Size of the length, version, flags and command of a packet.
+  static constexpr int PACKET_HEADER_SIZE = 6;
+
+  //! Size of the header of a chunk: the packet header followed by the size of the chunked packet.
+  static constexpr int CHUNK_HEADER_SIZE = PACKET_HEADER_SIZE + 4;
+
+  //! Maximum size of a chunked packet.
+  static constexpr guint32 MAX_PACKET_SIZE = 64 * 1024 * 1024;
+
+  //! Maximum number of queued bytes. Packets are refused once the queue is larger.
+  static constexpr size_t MAX_WRITE_QUEUE_SIZE = 4 * 1024 * 1024;
+
+  //! Result of reading a packet from the stream.
+  enum class ReadStatus
+  {
+    //! A complete packet was read.
+    Packet,
+
+    //! More data is needed.
+    Incomplete,
+
+    //! The stream contains an invalid frame.
+    Invalid,
+  };
+
+  //! Creates a stream that uses the specified command for chunk frames.
+  explicit PacketStream(guint16 chunk_command);
+
+  //! Returns room for size bytes at the end of the read buffer.
+  guint8 *prepare_read(int size);
+
+  //! Keeps size bytes of the room returned by prepare_read.
+  void commit_read(int size);
+
+  //! Reads the next complete packet from the read buffer.
+  ReadStatus read_packet(PacketBuffer &packet);
+
+  //! Queues the specified packet, in chunks if allowed and needed.
+  /*!
+   *  \return false if the packet is too large and was dropped.
+   */
+  bool queue_packet(PacketBuffer &packet, bool chunked);
+
+  //! Fills buffers with the frames that are not yet written.
+  /*!
+   *  \return the number of buffers used.
+   */
+  int gather(ISocket::WriteBuffer *buffers, int max_count, int &size) const;
+
+  //! Removes the specified number of written bytes from the write queue.
+  void consume(int bytes_written);
+
+  //! Drops all buffered incoming and outgoing data.
+  void clear();
+
+  //! Returns whether there is data to be written.
+  bool is_write_pending() const
+  {
+    return !write_queue.empty();
+  }
+
+  //! Returns whether the write queue exceeds its maximum size.
+  bool is_write_queue_full() const
+  {
+    return write_queue_size > MAX_WRITE_QUEUE_SIZE;
+  }
+
+  //! Returns the number of bytes in the write queue.
+  size_t get_write_queue_size() const
+  {
+    return write_queue_size;
+  }
+
+private:
+  void queue_frame(const guint8 *header, int header_size, const guint8 *data, int size);
+
+private:
+  //! Command of chunk frames.
+  guint16 chunk_command;
+
+  //! Received bytes that do not form a complete frame yet.
+  std::vector<guint8> read_buffer;
+
+  //! Number of bytes at the start of the read buffer that were processed.
+  size_t read_pos{0};
+
+  //! Number of bytes in the read buffer that were received.
+  size_t read_end{0};
+
+  //! Reassembled contents of a chunked packet.
+  std::vector<guint8> chunks;
+
+  //! Size of the chunked packet that is being reassembled.
+  guint32 chunked_size{0};
+
+  //! Frames that are not yet written.
+  std::deque<std::vector<guint8>> write_queue;
+
+  //! Number of bytes of the first frame in the write queue that were written.
+  size_t write_offset{0};
+
+  //! Number of bytes in the write queue.
+  size_t write_queue_size{0};
+};
+
+#endif // PACKETSTREAM_HH
@@ -38,6 +38,10 @@ public:
   //! The specified socket has data ready to be read.
   virtual void socket_io(ISocket *con, void *data) = 0;
 
+  //! The specified socket can accept more data.
+  /*! Only reported while enabled with ISocket::set_write_notify. */
+  virtual void socket_writable(ISocket *con, void *data) = 0;
+
   //! The specified socket closed its connection.
   virtual void socket_closed(ISocket *con, void *data) = 0;
 };
@@ -57,6 +61,13 @@ public:
 class ISocket
 {
 public:
+  //! Data to be written by a gathered write.
+  struct WriteBuffer
+  {
+    const void *data{nullptr};
+    int size{0};
+  };
+
   ISocket() = default;
   virtual ~ISocket() = default;
 
@@ -64,11 +75,21 @@ public:
   virtual void connect(const std::string &hostname, int port) = 0;
 
   //! Read data from the connection.
+  /*! \p bytes_read is 0 if the connection was closed by the peer, and -1 if
+   *  no data is available without blocking.
+   */
   virtual void read(void *buf, int count, int &bytes_read) = 0;
 
   //! Write data to the connection
+  /*! \p bytes_written is less than \p count if the data cannot be written without blocking. */
   virtual void write(void *buf, int count, int &bytes_written) = 0;
 
+  //! Write data from a number of buffers to the connection at once.
+  virtual void write(const WriteBuffer *buffers, int count, int &bytes_written) = 0;
+
+  //! Enables or disables socket_writable notifications.
+  virtual void set_write_notify(bool enabled) = 0;
+
   //! Close the connection.
   virtual void close() = 0;
 
@@ -0,0 +1,215 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "StateWriter.hh"
+
+#include <cstdio>
+#include <vector>
+
+#if defined(PLATFORM_OS_WINDOWS)
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
+#include <spdlog/spdlog.h>
+
+#include "debug.hh"
+
+StateWriter::~StateWriter()
+{
+  commit();
+
+  if (writer_thread)
+    {
+      {
+        std::unique_lock lock(mutex);
+        stopping = true;
+        cond.notify_all();
+      }
+      writer_thread->join();
+    }
+}
+
+//! Stages the contents of a file for the next commit.
+void
+StateWriter::stage(const std::filesystem::path &path, std::string contents)
+{
+  {
+    // Files that failed to write must be written again, even if unchanged.
+    std::unique_lock lock(mutex);
+    for (const auto &[failed_path, failed_contents]: failed)
+      {
+        auto it = last_contents.find(failed_path);
+        if (it != last_contents.end() && it->second == failed_contents)
+          {
+            last_contents.erase(it);
+          }
+      }
+    failed.clear();
+  }
+
+  auto it = last_contents.find(path);
+  if (it != last_contents.end() && it->second == contents)
+    {
+      return;
+    }
+
+  last_contents[path] = contents;
+  staged[path] = std::move(contents);
+}
+
+//! Hands all staged files to the worker thread.
+void
+StateWriter::commit()
+{
+  TRACE_ENTRY();
+  if (staged.empty())
+    {
+      return;
+    }
+
+  std::unique_lock lock(mutex);
+  for (auto &[path, contents]: staged)
+    {
+      pending[path] = std::move(contents);
+    }
+  staged.clear();
+
+  if (!writer_thread)
+    {
+      writer_thread = std::make_shared<std::thread>([this] { run(); });
+    }
+  cond.notify_all();
+}
+
+//! Waits until all committed files are written.
+void
+StateWriter::flush()
+{
+  std::unique_lock lock(mutex);
+  cond.wait(lock, [this] { return pending.empty() && !writing; });
+}
+
+void
+StateWriter::run()
+{
+  std::unique_lock lock(mutex);
+
+  while (true)
+    {
+      cond.wait(lock, [this] { return stopping || !pending.empty(); });
+      if (pending.empty())
+        {
+          break;
+        }
+
+      Batch batch;
+      batch.swap(pending);
+      writing = true;
+
+      lock.unlock();
+      std::vector<std::filesystem::path> failed_paths = write_batch(batch);
+      lock.lock();
+
+      for (const auto &path: failed_paths)
+        {
+          failed[path] = std::move(batch[path]);
+        }
+
+      writing = false;
+      cond.notify_all();
+    }
+}
+
+//! Writes all files of a batch.
+/*!
+ *  All temporary files are written and synced first, and only then renamed
+ *  over the original files, so that the files of a batch are replaced
+ *  together.
+ *
+ *  \return the files that could not be written.
+ */
+std::vector<std::filesystem::path>
+StateWriter::write_batch(const Batch &batch)
+{
+  std::vector<std::filesystem::path> written;
+  std::vector<std::filesystem::path> failed_paths;
+
+  for (const auto &[path, contents]: batch)
+    {
+      std::filesystem::path tmp_path = path;
+      tmp_path += ".tmp";
+
+      if (write_file(tmp_path, contents))
+        {
+          written.push_back(path);
+        }
+      else
+        {
+          failed_paths.push_back(path);
+        }
+    }
+
+  for (const auto &path: written)
+    {
+      std::filesystem::path tmp_path = path;
+      tmp_path += ".tmp";
+
+      std::error_code ec;
+      std::filesystem::rename(tmp_path, path, ec);
+      if (ec)
+        {
+          spdlog::warn("Failed to replace {}: {}", path.string(), ec.message());
+          std::filesystem::remove(tmp_path, ec);
+          failed_paths.push_back(path);
+        }
+    }
+  return failed_paths;
+}
+
+bool
+StateWriter::write_file(const std::filesystem::path &path, const std::string &contents)
+{
+  FILE *file = std::fopen(path.string().c_str(), "wb");
+  if (file == nullptr)
+    {
+      spdlog::warn("Failed to create {}", path.string());
+      return false;
+    }
+
+  bool ok = std::fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+  ok = ok && std::fflush(file) == 0;
+#if defined(PLATFORM_OS_WINDOWS)
+  ok = ok && _commit(_fileno(file)) == 0;
+#else
+  ok = ok && fsync(fileno(file)) == 0;
+#endif
+  ok = (std::fclose(file) == 0) && ok;
+
+  if (!ok)
+    {
+      spdlog::warn("Failed to write {}", path.string());
+      std::error_code ec;
+      std::filesystem::remove(path, ec);
+    }
+  return ok;
+}
@@ -0,0 +1,82 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef STATEWRITER_HH
+#define STATEWRITER_HH
+
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//! Writes state files in the background.
+/*!
+ *  Files are staged from the main loop and written by a worker thread once
+ *  the batch is committed. Each file is written to a temporary file that is
+ *  synced to disk before it replaces the original, so a crash never leaves a
+ *  truncated file behind. Files whose contents did not change since they
+ *  were last staged are not written again, unless writing them failed.
+ */
+class StateWriter
+{
+public:
+  StateWriter() = default;
+  ~StateWriter();
+
+  StateWriter(const StateWriter &) = delete;
+  StateWriter &operator=(const StateWriter &) = delete;
+
+  void stage(const std::filesystem::path &path, std::string contents);
+  void commit();
+  void flush();
+
+private:
+  using Batch = std::map<std::filesystem::path, std::string>;
+
+  void run();
+  static std::vector<std::filesystem::path> write_batch(const Batch &batch);
+  static bool write_file(const std::filesystem::path &path, const std::string &contents);
+
+private:
+  //! Files staged since the last commit. Only accessed by the main loop.
+  Batch staged;
+
+  //! Last staged contents of each file. Only accessed by the main loop.
+  std::map<std::filesystem::path, std::string> last_contents;
+
+  //! Committed files that are not yet written.
+  Batch pending;
+
+  //! Files that the worker thread failed to write, with the contents it tried to write.
+  Batch failed;
+
+  //! True while the worker thread writes a batch.
+  bool writing{false};
+
+  //! True when the worker thread must stop.
+  bool stopping{false};
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::shared_ptr<std::thread> writer_thread;
+};
+
+#endif // STATEWRITER_HH
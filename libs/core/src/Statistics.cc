@@ -30,6 +30,8 @@
 #include <cstring>
 #include <sstream>
 
+#include <spdlog/spdlog.h>
+
 #include "debug.hh"
 
 #include "Statistics.hh"
@@ -48,7 +50,8 @@
 const char *WORKRAVESTATS = "WorkRaveStats";
 const int STATSVERSION = 4;
 
-#define MAX_JUMP (10000)
+//! Maximum number of history days that are kept decoded in memory.
+const std::size_t HISTORY_CACHE_SIZE = 64;
 
 using namespace std;
 using namespace workrave::utils;
@@ -57,16 +60,11 @@ Statistics::~Statistics()
 {
   update();
 
-  for (auto &item: history)
-    {
-      delete item;
-    }
-
   delete current_day;
 
   if (input_monitor != nullptr)
     {
-      input_monitor->unsubscribe(this);
+      input_monitor->unsubscribe(&input_events);
     }
 }
 
@@ -79,7 +77,7 @@ Statistics::init(Core *control)
   input_monitor = workrave::input_monitor::InputMonitorFactory::create_monitor(workrave::input_monitor::MonitorCapability::Statistics);
   if (input_monitor != nullptr)
     {
-      input_monitor->subscribe(this);
+      input_monitor->subscribe(&input_events);
     }
 
 #ifdef HAVE_DISTRIBUTION
@@ -96,11 +94,42 @@ Statistics::init(Core *control)
   load_history();
 }
 
-//! Periodic heartbeat.
+//! Processes the input events received since the previous heartbeat.
+void
+Statistics::heartbeat()
+{
+  // Live statistics are only maintained while someone is interested.
+  if (!current_day_changed_signal.empty() && current_day != nullptr)
+    {
+      refresh_current_day();
+      notify_current_day_changes();
+    }
+  else
+    {
+      process_input_events();
+    }
+}
+
+//! Updates and saves the statistics of the current day.
 void
 Statistics::update()
 {
   TRACE_ENTRY();
+  refresh_current_day();
+  save_day(current_day);
+  notify_current_day_changes();
+}
+
+//! Updates the statistics of the current day in memory.
+void
+Statistics::refresh_current_day()
+{
+  process_input_events();
+  if (current_day == nullptr)
+    {
+      return;
+    }
+
   IActivityMonitor::Ptr monitor = core->get_activity_monitor();
   ActivityState state = monitor->get_current_state();
 
@@ -116,41 +145,92 @@ Statistics::update()
     }
 
   update_current_day(state == ACTIVITY_ACTIVE);
-  save_day(current_day);
+}
+
+//! Notifies the changes of the statistics of the current day since the previous notification.
+void
+Statistics::notify_current_day_changes(bool new_day)
+{
+  if (current_day == nullptr)
+    {
+      return;
+    }
+
+  auto same_time = [](const struct tm &a, const struct tm &b) {
+    return a.tm_year == b.tm_year && a.tm_yday == b.tm_yday && a.tm_hour == b.tm_hour && a.tm_min == b.tm_min
+           && a.tm_sec == b.tm_sec;
+  };
+
+  DailyStatsChanges changes;
+  changes.new_day = new_day;
+  changes.period = !same_time(current_day->start, notified_day.start) || !same_time(current_day->stop, notified_day.stop);
+  bool changed = changes.new_day || changes.period;
+
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      for (int j = 0; j < STATS_BREAKVALUE_SIZEOF; j++)
+        {
+          if (current_day->break_stats[i][j] != notified_day.break_stats[i][j])
+            {
+              changes.break_stats[i] = true;
+              changed = true;
+            }
+        }
+    }
+
+  for (int j = 0; j < STATS_VALUE_SIZEOF; j++)
+    {
+      if (current_day->misc_stats[j] != notified_day.misc_stats[j])
+        {
+          changes.misc_stats[j] = true;
+          changed = true;
+        }
+    }
+
+  if (changed)
+    {
+      notified_day = *current_day;
+      current_day_changed_signal(changes);
+    }
+}
+
+boost::signals2::signal<void(const IStatistics::DailyStatsChanges &)> &
+Statistics::signal_current_day_changed()
+{
+  return current_day_changed_signal;
 }
 
 bool
 Statistics::delete_all_history()
 {
   update();
+  core->get_state_writer()->flush();
 
-  std::filesystem::path histpath = Paths::get_state_directory() / "historystats";
-  if (std::filesystem::is_regular_file(histpath) && std::filesystem::remove(histpath))
+  clear_history_cache();
+  rollup.clear();
+  if (!history.remove())
     {
       return false;
     }
-  else
-    {
-      for (vector<DailyStatsImpl *>::iterator i = history.begin(); (i != history.end()); delete *i++)
-        ;
 
-      history.clear();
+  std::filesystem::path histpath = Paths::get_state_directory() / "historystats";
+  if (std::filesystem::is_regular_file(histpath) && !std::filesystem::remove(histpath))
+    {
+      return false;
     }
 
   std::filesystem::path todaypath = Paths::get_state_directory() / "todaystats";
-  if (std::filesystem::is_regular_file(todaypath) && std::filesystem::remove(todaypath))
+  if (std::filesystem::is_regular_file(todaypath) && !std::filesystem::remove(todaypath))
     {
       return false;
     }
-  else
+
+  if (current_day)
     {
-      if (current_day)
-        {
-          delete current_day;
-          current_day = nullptr;
-        }
-      start_new_day();
+      delete current_day;
+      current_day = nullptr;
     }
+  start_new_day();
 
   return true;
 }
@@ -162,6 +242,7 @@ Statistics::start_new_day()
   TRACE_ENTRY();
   const time_t now = time(nullptr);
   struct tm *tmnow = localtime(&now);
+  bool new_day = false;
 
   if (current_day == nullptr || tmnow->tm_mday != current_day->start.tm_mday || tmnow->tm_mon != current_day->start.tm_mon
       || tmnow->tm_year != current_day->start.tm_year)
@@ -176,6 +257,7 @@ Statistics::start_new_day()
 
       current_day = new DailyStatsImpl();
       been_active = false;
+      new_day = true;
 
       current_day->start = *tmnow;
       current_day->stop = *tmnow;
@@ -183,25 +265,30 @@ Statistics::start_new_day()
 
   update_current_day(false);
   save_day(current_day);
+  core->get_state_writer()->commit();
+  notify_current_day_changes(new_day);
 }
 
 void
 Statistics::day_to_history(DailyStatsImpl *stats)
 {
-  add_history(stats);
+  if (history.is_in_memory())
+    {
+      // The binary history is not available, so append to the text history.
+      std::filesystem::path path = Paths::get_state_directory() / "historystats";
 
-  std::filesystem::path path = Paths::get_state_directory() / "historystats";
+      bool exists = std::filesystem::is_regular_file(path);
+      ofstream stats_file(path.string(), ios::app);
 
-  bool exists = std::filesystem::is_regular_file(path);
-  ofstream stats_file(path.string(), ios::app);
+      if (!exists)
+        {
+          stats_file << WORKRAVESTATS << " " << STATSVERSION << endl;
+        }
 
-  if (!exists)
-    {
-      stats_file << WORKRAVESTATS << " " << STATSVERSION << endl;
+      save_day(stats, stats_file);
     }
 
-  save_day(stats, stats_file);
-  stats_file.close();
+  add_history(stats);
 }
 
 //! Adds the current day to this history.
@@ -229,7 +316,7 @@ Statistics::day_to_remote_history(DailyStatsImpl *stats)
 
 //! Saves the current day to the specified stream.
 void
-Statistics::save_day(DailyStatsImpl *stats, ofstream &stats_file)
+Statistics::save_day(DailyStatsImpl *stats, std::ostream &stats_file)
 {
   stats_file << "D " << stats->start.tm_mday << " " << stats->start.tm_mon << " " << stats->start.tm_year << " " << stats->start.tm_hour
              << " " << stats->start.tm_min << " " << stats->stop.tm_mday << " " << stats->stop.tm_mon << " " << stats->stop.tm_year << " "
@@ -253,71 +340,45 @@ Statistics::save_day(DailyStatsImpl *stats, ofstream &stats_file)
       stats_file << stats->misc_stats[j] << " ";
     }
   stats_file << endl;
-
-  stats_file.close();
 }
 
 //! Saves the statistics of the specified day.
+/*!
+ *  The file is written in the background when the core commits its state.
+ */
 void
 Statistics::save_day(DailyStatsImpl *stats)
 {
-  std::filesystem::path path = Paths::get_state_directory() / "todaystats";
-  ofstream stats_file(path.string());
+  std::stringstream ss;
+
+  ss << WORKRAVESTATS << " " << STATSVERSION << endl;
 
-  stats_file << WORKRAVESTATS << " " << STATSVERSION << endl;
+  save_day(stats, ss);
 
-  save_day(stats, stats_file);
+  core->get_state_writer()->stage(Paths::get_state_directory() / "todaystats", ss.str());
 }
 
 //! Add the stats the the history list.
 void
 Statistics::add_history(DailyStatsImpl *stats)
 {
-  if (history.size() == 0)
+  history.put(*stats);
+  clear_history_cache();
+
+  if (!rollup.add(*stats))
     {
-      history.push_back(stats);
+      rollup.rebuild(history);
     }
-  else
-    {
-      bool found = false;
-      auto i = history.rbegin();
-      while (i != history.rend())
-        {
-          DailyStatsImpl *ref = *i;
-
-          if (stats->start.tm_year == ref->start.tm_year && stats->start.tm_mon == ref->start.tm_mon
-              && stats->start.tm_mday == ref->start.tm_mday)
-            {
-              delete *i;
-              *i = stats;
-              found = true;
-              break;
-            }
 
-          else if (stats->start.tm_year > ref->start.tm_year
-                   || (stats->start.tm_year == ref->start.tm_year
-                       && (stats->start.tm_mon > ref->start.tm_mon
-                           || (stats->start.tm_mon == ref->start.tm_mon && stats->start.tm_mday > ref->start.tm_mday))))
-            {
-              if (i == history.rbegin())
-                {
-                  history.push_back(stats);
-                }
-              else
-                {
-                  history.insert(i.base(), stats);
-                }
-              found = true;
-              break;
-            }
-          i++;
-        }
+  delete stats;
+}
 
-      if (!found)
-        {
-          history.insert(history.begin(), stats);
-        }
-    }
+//! Drops all decoded history days.
+void
+Statistics::clear_history_cache()
+{
+  history_cache.clear();
+  history_cache_lru.clear();
 }
 
 //! Load the statistics of the current day.
@@ -338,6 +399,29 @@ Statistics::load_current_day()
 //! Loads the history.
 void
 Statistics::load_history()
+{
+  TRACE_ENTRY();
+  std::filesystem::path path = Paths::get_state_directory() / "historystats.bin";
+
+  bool exists = std::filesystem::is_regular_file(path);
+  if (!history.open(path))
+    {
+      // Keep using the text history, like before the binary history existed.
+      spdlog::warn("Cannot open statistics history {}, using the text history instead", path.string());
+      history.open_in_memory();
+      migrate_history();
+    }
+  else if (!exists)
+    {
+      migrate_history();
+    }
+
+  rollup.rebuild(history);
+}
+
+//! Converts the history from the old text format.
+void
+Statistics::migrate_history()
 {
   TRACE_ENTRY();
   std::filesystem::path path = Paths::get_state_directory() / "historystats";
@@ -558,6 +642,11 @@ Statistics::get_current_day() const
   return current_day;
 }
 
+//! Returns the statistics of the specified day.
+/*!
+ *  Days of the history are decoded on demand. The returned day remains valid
+ *  until the history changes or HISTORY_CACHE_SIZE other days are retrieved.
+ */
 Statistics::DailyStatsImpl *
 Statistics::get_day(int day) const
 {
@@ -579,9 +668,27 @@ Statistics::get_day(int day) const
           day--;
         }
 
-      if (day < int(history.size()) && day >= 0)
+      if (day < history.size() && day >= 0)
         {
-          ret = history[day];
+          auto it = history_cache.find(day);
+          if (it != history_cache.end())
+            {
+              history_cache_lru.splice(history_cache_lru.begin(), history_cache_lru, it->second.lru);
+            }
+          else
+            {
+              if (history_cache.size() >= HISTORY_CACHE_SIZE)
+                {
+                  history_cache.erase(history_cache_lru.back());
+                  history_cache_lru.pop_back();
+                }
+
+              auto stats = std::make_unique<DailyStatsImpl>();
+              history.get(day, *stats);
+              history_cache_lru.push_front(day);
+              it = history_cache.emplace(day, HistoryCacheEntry{std::move(stats), history_cache_lru.begin()}).first;
+            }
+          ret = it->second.stats.get();
         }
     }
 
@@ -593,29 +700,34 @@ Statistics::get_day_index_by_date(int y, int m, int d, int &idx, int &next, int
 {
   TRACE_ENTRY_PAR(y, m, d);
   idx = next = prev = -1;
-  for (int i = 0; i <= int(history.size()); i++)
+
+  int size = history.size();
+  int date = HistoryStore::to_date(y, m, d);
+  int i = history.lower_bound(date);
+
+  if (i > 0)
     {
-      int j = history.size() - i;
-      DailyStatsImpl *stats = j == 0 ? current_day : history[i];
-      if (idx < 0 && stats->starts_at_date(y, m, d))
-        {
-          idx = j;
-        }
-      else if (stats->starts_before_date(y, m, d))
-        {
-          prev = j;
-        }
-      else if (next < 0)
-        {
-          next = j;
-        }
+      prev = size - (i - 1);
+    }
+  if (i < size && history.get_date(i) == date)
+    {
+      idx = size - i;
+      i++;
+    }
+  if (i < size)
+    {
+      next = size - i;
     }
 
-  if (prev < 0 && current_day->starts_before_date(y, m, d))
+  if (idx < 0 && current_day->starts_at_date(y, m, d))
+    {
+      idx = 0;
+    }
+  else if (current_day->starts_before_date(y, m, d))
     {
       prev = 0;
     }
-  if (next < 0 && !current_day->starts_at_date(y, m, d) && !current_day->starts_before_date(y, m, d))
+  else if (next < 0)
     {
       next = 0;
     }
@@ -627,6 +739,86 @@ Statistics::get_history_size() const
   return history.size();
 }
 
+void
+Statistics::get_totals(int from_y, int from_m, int from_d, int to_y, int to_m, int to_d, StatsTotals &totals) const
+{
+  int from_date = HistoryStore::to_date(from_y, from_m, from_d);
+  int to_date = HistoryStore::to_date(to_y, to_m, to_d);
+
+  rollup.get_totals(from_date, to_date, totals);
+
+  if (current_day != nullptr && !current_day->is_empty())
+    {
+      int date = HistoryStore::to_date(*current_day);
+      if (date >= from_date && date <= to_date)
+        {
+          StatisticsRollup::add(totals, *current_day);
+        }
+    }
+}
+
+void
+Statistics::get_period_totals(StatsPeriod period, int y, int m, int d, StatsTotals &totals) const
+{
+  int date = HistoryStore::to_date(y, m, d);
+
+  rollup.get_period_totals(period, date, totals);
+
+  if (current_day != nullptr && !current_day->is_empty())
+    {
+      int key = StatisticsRollup::get_period_key(period, HistoryStore::to_date(*current_day));
+      if (key == StatisticsRollup::get_period_key(period, date))
+        {
+          StatisticsRollup::add(totals, *current_day);
+        }
+    }
+}
+
+//! Returns the totals of a range of days. Dates are formatted as YYYYMMDD.
+void
+Statistics::get_totals_by_date(int from_date, int to_date, ActivitySummary &activity, BreakSummaryList &breaks) const
+{
+  StatsTotals totals;
+  get_totals(from_date / 10000, (from_date / 100) % 100, from_date % 100, to_date / 10000, (to_date / 100) % 100, to_date % 100, totals);
+  totals_to_dbus(totals, activity, breaks);
+}
+
+//! Returns the totals of the period that contains the date. The date is formatted as YYYYMMDD.
+void
+Statistics::get_period_totals_by_date(StatsPeriod period, int date, ActivitySummary &activity, BreakSummaryList &breaks) const
+{
+  StatsTotals totals;
+  get_period_totals(period, date / 10000, (date / 100) % 100, date % 100, totals);
+  totals_to_dbus(totals, activity, breaks);
+}
+
+void
+Statistics::totals_to_dbus(const StatsTotals &totals, ActivitySummary &activity, BreakSummaryList &breaks)
+{
+  activity.days = totals.days;
+  activity.active_time = totals.misc_stats[STATS_VALUE_TOTAL_ACTIVE_TIME];
+  activity.mouse_movement = totals.misc_stats[STATS_VALUE_TOTAL_MOUSE_MOVEMENT];
+  activity.click_movement = totals.misc_stats[STATS_VALUE_TOTAL_CLICK_MOVEMENT];
+  activity.movement_time = totals.misc_stats[STATS_VALUE_TOTAL_MOVEMENT_TIME];
+  activity.clicks = totals.misc_stats[STATS_VALUE_TOTAL_CLICKS];
+  activity.keystrokes = totals.misc_stats[STATS_VALUE_TOTAL_KEYSTROKES];
+
+  breaks.clear();
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      const auto &bs = totals.break_stats[i];
+      BreakSummary &b = breaks.emplace_back();
+      b.timer_id = static_cast<BreakId>(i);
+      b.prompted = bs[STATS_BREAKVALUE_PROMPTED];
+      b.taken = bs[STATS_BREAKVALUE_TAKEN];
+      b.natural_taken = bs[STATS_BREAKVALUE_NATURAL_TAKEN];
+      b.skipped = bs[STATS_BREAKVALUE_SKIPPED];
+      b.postponed = bs[STATS_BREAKVALUE_POSTPONED];
+      b.unique_breaks = bs[STATS_BREAKVALUE_UNIQUE_BREAKS];
+      b.total_overdue = bs[STATS_BREAKVALUE_TOTAL_OVERDUE];
+    }
+}
+
 void
 Statistics::update_current_day(bool active)
 {
@@ -669,6 +861,13 @@ Statistics::init_distribution_manager()
     }
 }
 
+//! Forgets the replicated statistics of a remote client that signed off.
+void
+Statistics::signoff_remote_client(const std::string &client_id)
+{
+  stats_replicator.forget(client_id);
+}
+
 bool
 Statistics::request_client_message(DistributionClientMessageID id, PacketBuffer &buffer)
 {
@@ -678,6 +877,17 @@ Statistics::request_client_message(DistributionClientMessageID id, PacketBuffer
   update_current_day(false);
   dump();
 
+  if (buffer.is_compact())
+    {
+      DistributionManager *dist_manager = core->get_distribution_manager();
+      stats_replicator.set_number_of_peers(dist_manager->get_number_of_peers());
+
+      buffer.pack_byte(STATS_MARKER_DELTA);
+      stats_replicator.pack(buffer, stats_to_values(current_day));
+      buffer.pack_byte(STATS_MARKER_END);
+      return true;
+    }
+
   buffer.pack_byte(STATS_MARKER_TODAY);
   pack_stats(buffer, current_day);
   buffer.pack_byte(STATS_MARKER_END);
@@ -738,6 +948,65 @@ Statistics::pack_stats(PacketBuffer &buf, const DailyStatsImpl *stats)
   return true;
 }
 
+//! Returns all counters of the specified day as a flat list of values.
+std::vector<int64_t>
+Statistics::stats_to_values(const DailyStatsImpl *stats)
+{
+  std::vector<int64_t> values;
+
+  for (const std::tm *tm: {&stats->start, &stats->stop})
+    {
+      values.push_back(tm->tm_mday);
+      values.push_back(tm->tm_mon);
+      values.push_back(tm->tm_year);
+      values.push_back(tm->tm_hour);
+      values.push_back(tm->tm_min);
+    }
+
+  for (const auto &bs: stats->break_stats)
+    {
+      values.insert(values.end(), std::begin(bs), std::end(bs));
+    }
+
+  values.insert(values.end(), std::begin(stats->misc_stats), std::end(stats->misc_stats));
+  return values;
+}
+
+//! Restores the counters of the specified day from a flat list of values.
+bool
+Statistics::values_to_stats(const std::vector<int64_t> &values, DailyStatsImpl *stats)
+{
+  if (values.size() != stats_to_values(stats).size())
+    {
+      return false;
+    }
+
+  auto v = values.begin();
+
+  for (std::tm *tm: {&stats->start, &stats->stop})
+    {
+      tm->tm_mday = static_cast<int>(*v++);
+      tm->tm_mon = static_cast<int>(*v++);
+      tm->tm_year = static_cast<int>(*v++);
+      tm->tm_hour = static_cast<int>(*v++);
+      tm->tm_min = static_cast<int>(*v++);
+    }
+
+  for (auto &bs: stats->break_stats)
+    {
+      for (auto &value: bs)
+        {
+          value = static_cast<int>(*v++);
+        }
+    }
+
+  for (auto &value: stats->misc_stats)
+    {
+      value = *v++;
+    }
+  return true;
+}
+
 bool
 Statistics::client_message(DistributionClientMessageID id, bool master, const char *client_id, PacketBuffer &buffer)
 {
@@ -837,6 +1106,19 @@ Statistics::client_message(DistributionClientMessageID id, bool master, const ch
           }
           break;
 
+        case STATS_MARKER_DELTA:
+          {
+            std::vector<int64_t> values;
+
+            if (client_id == nullptr || !stats_replicator.unpack(client_id, buffer, values)
+                || !values_to_stats(values, current_day))
+              {
+                TRACE_MSG("Waiting for snapshot");
+                return false;
+              }
+          }
+          break;
+
         case STATS_MARKER_END:
           if (stats_to_history)
             {
@@ -884,109 +1166,34 @@ Statistics::DailyStatsImpl::starts_before_date(int y, int m, int d)
           || (start.tm_year + 1900 == y && (start.tm_mon + 1 < m || (start.tm_mon + 1 == m && start.tm_mday < d))));
 }
 
-//! Activity is reported by the input monitor.
+//! Adds the input aggregated by the input monitor to the current day.
 void
-Statistics::action_notify()
+Statistics::process_input_events()
 {
-}
+  InputEventQueue::Activity input = input_events.process();
 
-//! Mouse activity is reported by the input monitor.
-void
-Statistics::mouse_notify(int x, int y, int wheel_delta)
-{
-  static const int sensitivity = 3;
-
-  lock.lock();
-
-  if (current_day != nullptr && x >= 0 && y >= 0)
+  if (current_day == nullptr)
     {
-      int delta_x = sensitivity;
-      int delta_y = sensitivity;
-
-      if (prev_x != -1 && prev_y != -1)
-        {
-          delta_x = abs(x - prev_x);
-          delta_y = abs(y - prev_y);
-        }
-
-      prev_x = x;
-      prev_y = y;
-
-      // Sanity checks, ignore unreasonable large jumps...
-      if (delta_x < MAX_JUMP && delta_y < MAX_JUMP && (delta_x >= sensitivity || delta_y >= sensitivity || wheel_delta != 0))
-        {
-          int64_t movement = current_day->misc_stats[STATS_VALUE_TOTAL_MOUSE_MOVEMENT];
-          int distance = int(sqrt(static_cast<double>(delta_x * delta_x + delta_y * delta_y)));
-
-          movement += distance;
-          if (movement > 0)
-            {
-              current_day->misc_stats[STATS_VALUE_TOTAL_MOUSE_MOVEMENT] = movement;
-            }
-
-          auto now = std::chrono::system_clock::now();
-          auto tv = now - last_mouse_time;
-
-          if (tv < std::chrono::seconds(1))
-            {
-              current_day->total_mouse_time += tv;
-              current_day->misc_stats[STATS_VALUE_TOTAL_MOVEMENT_TIME] =
-                std::chrono::duration_cast<std::chrono::seconds>(current_day->total_mouse_time.time_since_epoch()).count();
-            }
-
-          last_mouse_time = now;
-        }
+      return;
     }
 
-  lock.unlock();
-}
-
-//! Mouse button activity is reported by the input monitor.
-void
-Statistics::button_notify(bool is_press)
-{
-  lock.lock();
-  if (current_day != nullptr)
+  if (input.mouse_distance > 0)
     {
-      if (click_x != -1 && click_y != -1 && prev_x != -1 && prev_y != -1)
-        {
-          int delta_x = click_x - prev_x;
-          int delta_y = click_y - prev_y;
-
-          int64_t movement = current_day->misc_stats[STATS_VALUE_TOTAL_CLICK_MOVEMENT];
-          int64_t distance = int(sqrt(static_cast<double>(delta_x * delta_x + delta_y * delta_y)));
-
-          movement += distance;
-          if (movement > 0)
-            {
-              current_day->misc_stats[STATS_VALUE_TOTAL_CLICK_MOVEMENT] = movement;
-            }
-        }
-
-      click_x = prev_x;
-      click_y = prev_y;
-
-      if (is_press)
-        {
-          current_day->misc_stats[STATS_VALUE_TOTAL_CLICKS]++;
-        }
+      current_day->misc_stats[STATS_VALUE_TOTAL_MOUSE_MOVEMENT] += input.mouse_distance;
     }
-  lock.unlock();
-}
 
-//! Keyboard activity is reported by the input monitor.
-void
-Statistics::keyboard_notify(bool repeat)
-{
-  if (repeat)
+  if (input.mouse_time > 0)
     {
-      return;
+      current_day->total_mouse_time += std::chrono::microseconds(input.mouse_time);
+      current_day->misc_stats[STATS_VALUE_TOTAL_MOVEMENT_TIME] =
+        std::chrono::duration_cast<std::chrono::seconds>(current_day->total_mouse_time.time_since_epoch()).count();
     }
 
-  lock.lock();
-  if (current_day != nullptr)
+  if (input.click_distance > 0)
     {
-      current_day->misc_stats[STATS_VALUE_TOTAL_KEYSTROKES]++;
+      current_day->misc_stats[STATS_VALUE_TOTAL_CLICK_MOVEMENT] += input.click_distance;
     }
-  lock.unlock();
+
+  current_day->misc_stats[STATS_VALUE_TOTAL_CLICKS] += input.clicks;
+  current_day->misc_stats[STATS_VALUE_TOTAL_KEYSTROKES] += input.keystrokes;
 }
@@ -19,21 +19,22 @@
 #define STATISTICS_HH
 
 #include <memory>
-#include <thread>
-#include <mutex>
 
 #include <chrono>
 
 #include <iostream>
 #include <fstream>
+#include <list>
+#include <unordered_map>
 #include <vector>
 #include <ctime>
 #include <cstring>
 
 #include "core/IStatistics.hh"
+#include "HistoryStore.hh"
+#include "StatisticsRollup.hh"
+#include "InputEventQueue.hh"
 #include "input-monitor/IInputMonitor.hh"
-#include "input-monitor/IInputMonitorListener.hh"
-#include "core/IStatistics.hh"
 
 // Forward declarion of external interface.
 namespace workrave
@@ -49,11 +50,11 @@ class IInputMonitor;
 #ifdef HAVE_DISTRIBUTION
 #  include "IDistributionClientMessage.hh"
 #  include "PacketBuffer.hh"
+#  include "DeltaReplicator.hh"
 #endif
 
 class Statistics
   : public workrave::IStatistics
-  , public workrave::input_monitor::IInputMonitorListener
 #ifdef HAVE_DISTRIBUTION
   , public IDistributionClientMessage
 #endif
@@ -68,6 +69,7 @@ private:
     STATS_MARKER_STOPTIME,
     STATS_MARKER_BREAK_STATS,
     STATS_MARKER_MISC_STATS,
+    STATS_MARKER_DELTA,
   };
 
   struct DailyStatsImpl : public DailyStats
@@ -105,11 +107,32 @@ private:
     }
   };
 
-  typedef std::vector<DailyStatsImpl *> History;
-  typedef std::vector<DailyStatsImpl *>::iterator HistoryIter;
-  typedef std::vector<DailyStatsImpl *>::reverse_iterator HistoryRIter;
-
 public:
+  struct ActivitySummary
+  {
+    int32_t days{0};
+    int64_t active_time{0};
+    int64_t mouse_movement{0};
+    int64_t click_movement{0};
+    int64_t movement_time{0};
+    int64_t clicks{0};
+    int64_t keystrokes{0};
+  };
+
+  struct BreakSummary
+  {
+    workrave::BreakId timer_id{workrave::BREAK_ID_NONE};
+    int64_t prompted{0};
+    int64_t taken{0};
+    int64_t natural_taken{0};
+    int64_t skipped{0};
+    int64_t postponed{0};
+    int64_t unique_breaks{0};
+    int64_t total_overdue{0};
+  };
+
+  using BreakSummaryList = std::vector<BreakSummary>;
+
   Statistics() = default;
   ~Statistics() override;
 
@@ -117,6 +140,7 @@ public:
 
 public:
   void init(Core *core);
+  void heartbeat();
   void update() override;
   void dump() override;
   void start_new_day();
@@ -130,34 +154,49 @@ public:
   void get_day_index_by_date(int y, int m, int d, int &idx, int &next, int &prev) const override;
 
   int get_history_size() const override;
+  void get_totals(int from_y, int from_m, int from_d, int to_y, int to_m, int to_d, StatsTotals &totals) const override;
+  void get_period_totals(StatsPeriod period, int y, int m, int d, StatsTotals &totals) const override;
+  void get_totals_by_date(int from_date, int to_date, ActivitySummary &activity, BreakSummaryList &breaks) const;
+  void get_period_totals_by_date(StatsPeriod period, int date, ActivitySummary &activity, BreakSummaryList &breaks) const;
   void set_counter(StatsValueType t, int value);
   int64_t get_counter(StatsValueType t);
 
+  void refresh_current_day() override;
+  boost::signals2::signal<void(const DailyStatsChanges &)> &signal_current_day_changed() override;
+
+#ifdef HAVE_DISTRIBUTION
+  void signoff_remote_client(const std::string &client_id);
+#endif
+
 private:
-  void action_notify() override;
-  void mouse_notify(int x, int y, int wheel = 0) override;
-  void button_notify(bool is_press) override;
-  void keyboard_notify(bool repeat) override;
+  void process_input_events();
 
   bool load_current_day();
   void update_current_day(bool active);
+  void notify_current_day_changes(bool new_day = false);
   void load_history();
+  void migrate_history();
 
 private:
   void save_day(DailyStatsImpl *stats);
-  void save_day(DailyStatsImpl *stats, std::ofstream &stats_file);
+  void save_day(DailyStatsImpl *stats, std::ostream &stats_file);
   void load(std::ifstream &infile, bool history);
 
   void day_to_history(DailyStatsImpl *stats);
   void day_to_remote_history(DailyStatsImpl *stats);
 
   void add_history(DailyStatsImpl *stats);
+  void clear_history_cache();
+
+  static void totals_to_dbus(const StatsTotals &totals, ActivitySummary &activity, BreakSummaryList &breaks);
 
 #ifdef HAVE_DISTRIBUTION
   void init_distribution_manager();
   bool request_client_message(DistributionClientMessageID id, PacketBuffer &buffer) override;
   bool client_message(DistributionClientMessageID id, bool master, const char *client_id, PacketBuffer &buffer) override;
   bool pack_stats(PacketBuffer &buffer, const DailyStatsImpl *stats);
+  static std::vector<int64_t> stats_to_values(const DailyStatsImpl *stats);
+  static bool values_to_stats(const std::vector<int64_t> &values, DailyStatsImpl *stats);
 #endif
 
 private:
@@ -167,8 +206,8 @@ private:
   //! Mouse/Keyboard monitoring.
   workrave::input_monitor::IInputMonitor::Ptr input_monitor;
 
-  //! Last time a mouse event was received.
-  std::chrono::system_clock::time_point last_mouse_time;
+  //! Input received from the input monitor. Mouse movement is never coalesced, so that the distance is exact.
+  InputEventQueue input_events{false};
 
   //! Statistics of current day.
   DailyStatsImpl *current_day{nullptr};
@@ -176,23 +215,33 @@ private:
   //! Has the user been active on the current day?
   bool been_active{false};
 
+  //! Statistics of the current day at the previous change notification.
+  DailyStats notified_day{};
+
+  boost::signals2::signal<void(const DailyStatsChanges &)> current_day_changed_signal;
+
   //! History
-  History history;
+  HistoryStore history;
 
-  //! Internal locking
-  std::mutex lock;
+  //! Totals of the history.
+  StatisticsRollup rollup;
 
-  //! Previous X coordinate
-  int prev_x{-1};
+  struct HistoryCacheEntry
+  {
+    std::unique_ptr<DailyStatsImpl> stats;
+    std::list<int>::iterator lru;
+  };
 
-  //! Previous Y coordinate
-  int prev_y{-1};
+  //! Days of the history that were recently retrieved from the history store, by index.
+  mutable std::unordered_map<int, HistoryCacheEntry> history_cache;
 
-  //! Previous X-click coordinate
-  int click_x{-1};
+  //! Indices of the cached days, most recently used first.
+  mutable std::list<int> history_cache_lru;
 
-  //! Previous Y-click coordinate
-  int click_y{-1};
+#ifdef HAVE_DISTRIBUTION
+  //! Replicates the statistics of the current day to remote clients.
+  DeltaReplicator stats_replicator;
+#endif
 };
 
 #endif // STATISTICS_HH
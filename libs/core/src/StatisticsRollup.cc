@@ -0,0 +1,256 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "StatisticsRollup.hh"
+
+#include <algorithm>
+
+#include "HistoryStore.hh"
+
+using namespace workrave;
+
+namespace
+{
+  //! Returns the number of days since 1970-01-01.
+  int days_from_civil(int y, int m, int d)
+  {
+    y -= m <= 2 ? 1 : 0;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const int yoe = y - era * 400;
+    const int doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+  }
+} // namespace
+
+void
+StatisticsRollup::clear()
+{
+  dates.clear();
+  running.clear();
+  for (auto &p: periods)
+    {
+      p.clear();
+    }
+}
+
+//! Recomputes all totals from the history.
+void
+StatisticsRollup::rebuild(const HistoryStore &history)
+{
+  clear();
+
+  int size = history.size();
+  dates.reserve(size);
+  running.reserve(size + 1);
+
+  for (int i = 0; i < size; i++)
+    {
+      DailyStats stats;
+      history.get(i, stats);
+      add(stats);
+    }
+}
+
+//! Adds a day to the totals.
+/*!
+ *  \return false if the day precedes the last day added. The totals are then
+ *          unchanged and must be rebuilt from the history.
+ */
+bool
+StatisticsRollup::add(const DailyStats &stats)
+{
+  int date = HistoryStore::to_date(stats);
+
+  StatsTotals day;
+  add(day, stats);
+
+  if (running.empty())
+    {
+      running.emplace_back();
+    }
+
+  if (dates.empty() || date > dates.back())
+    {
+      StatsTotals totals = running.back();
+      add(totals, day);
+
+      dates.push_back(date);
+      running.push_back(totals);
+    }
+  else if (date == dates.back())
+    {
+      // The last day was updated.
+      std::size_t n = dates.size();
+
+      StatsTotals old = running[n];
+      subtract(old, running[n - 1]);
+      subtract_from_periods(date, old);
+
+      running[n] = running[n - 1];
+      add(running[n], day);
+    }
+  else
+    {
+      return false;
+    }
+
+  add_to_periods(date, day);
+  return true;
+}
+
+//! Returns the number of days in the totals.
+int
+StatisticsRollup::size() const
+{
+  return static_cast<int>(dates.size());
+}
+
+//! Returns the totals of the days from the first up to and including the last date.
+void
+StatisticsRollup::get_totals(int from_date, int to_date, StatsTotals &totals) const
+{
+  totals = StatsTotals();
+
+  auto first = std::lower_bound(dates.begin(), dates.end(), from_date);
+  auto last = std::upper_bound(dates.begin(), dates.end(), to_date);
+  if (first < last)
+    {
+      totals = running[last - dates.begin()];
+      subtract(totals, running[first - dates.begin()]);
+    }
+}
+
+//! Returns the totals of the period that contains the date.
+void
+StatisticsRollup::get_period_totals(StatsPeriod period, int date, StatsTotals &totals) const
+{
+  totals = StatsTotals();
+
+  const auto &p = periods[period];
+  auto it = p.find(get_period_key(period, date));
+  if (it != p.end())
+    {
+      totals = it->second;
+    }
+}
+
+//! Returns a key that is unique for the period that contains the date.
+int
+StatisticsRollup::get_period_key(StatsPeriod period, int date)
+{
+  int y = date / 10000;
+  int m = (date / 100) % 100;
+  int d = date % 100;
+
+  switch (period)
+    {
+    case IStatistics::STATS_PERIOD_WEEK:
+      {
+        // Number of the Monday of the week. 1970-01-01 was a Thursday.
+        int days = days_from_civil(y, m, d);
+        return days - ((days % 7 + 10) % 7);
+      }
+
+    case IStatistics::STATS_PERIOD_MONTH:
+      return y * 100 + m;
+
+    case IStatistics::STATS_PERIOD_YEAR:
+      return y;
+
+    default:
+      return 0;
+    }
+}
+
+void
+StatisticsRollup::add(StatsTotals &totals, const DailyStats &stats)
+{
+  totals.days++;
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      for (int j = 0; j < IStatistics::STATS_BREAKVALUE_SIZEOF; j++)
+        {
+          totals.break_stats[i][j] += stats.break_stats[i][j];
+        }
+    }
+
+  for (int j = 0; j < IStatistics::STATS_VALUE_SIZEOF; j++)
+    {
+      totals.misc_stats[j] += stats.misc_stats[j];
+    }
+}
+
+void
+StatisticsRollup::add(StatsTotals &totals, const StatsTotals &other)
+{
+  totals.days += other.days;
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      for (int j = 0; j < IStatistics::STATS_BREAKVALUE_SIZEOF; j++)
+        {
+          totals.break_stats[i][j] += other.break_stats[i][j];
+        }
+    }
+
+  for (int j = 0; j < IStatistics::STATS_VALUE_SIZEOF; j++)
+    {
+      totals.misc_stats[j] += other.misc_stats[j];
+    }
+}
+
+void
+StatisticsRollup::subtract(StatsTotals &totals, const StatsTotals &other)
+{
+  totals.days -= other.days;
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      for (int j = 0; j < IStatistics::STATS_BREAKVALUE_SIZEOF; j++)
+        {
+          totals.break_stats[i][j] -= other.break_stats[i][j];
+        }
+    }
+
+  for (int j = 0; j < IStatistics::STATS_VALUE_SIZEOF; j++)
+    {
+      totals.misc_stats[j] -= other.misc_stats[j];
+    }
+}
+
+void
+StatisticsRollup::add_to_periods(int date, const StatsTotals &day)
+{
+  for (int p = 0; p < IStatistics::STATS_PERIOD_SIZEOF; p++)
+    {
+      auto period = static_cast<StatsPeriod>(p);
+      add(periods[p][get_period_key(period, date)], day);
+    }
+}
+
+void
+StatisticsRollup::subtract_from_periods(int date, const StatsTotals &day)
+{
+  for (int p = 0; p < IStatistics::STATS_PERIOD_SIZEOF; p++)
+    {
+      auto period = static_cast<StatsPeriod>(p);
+      subtract(periods[p][get_period_key(period, date)], day);
+    }
+}
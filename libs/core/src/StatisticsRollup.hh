@@ -0,0 +1,72 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef STATISTICSROLLUP_HH
+#define STATISTICSROLLUP_HH
+
+#include <map>
+#include <vector>
+
+#include "core/IStatistics.hh"
+
+class HistoryStore;
+
+//! Running totals of the statistics history.
+/*!
+ *  The totals are updated incrementally as days are added to the history.
+ *  Totals are kept per week, month and year, and as running sums over all
+ *  days so that the totals of any range of days are found with two binary
+ *  searches.
+ *
+ *  Dates are in the format of HistoryStore::to_date.
+ */
+class StatisticsRollup
+{
+public:
+  using DailyStats = workrave::IStatistics::DailyStats;
+  using StatsTotals = workrave::IStatistics::StatsTotals;
+  using StatsPeriod = workrave::IStatistics::StatsPeriod;
+
+  void clear();
+  void rebuild(const HistoryStore &history);
+  bool add(const DailyStats &stats);
+
+  int size() const;
+  void get_totals(int from_date, int to_date, StatsTotals &totals) const;
+  void get_period_totals(StatsPeriod period, int date, StatsTotals &totals) const;
+
+  static int get_period_key(StatsPeriod period, int date);
+  static void add(StatsTotals &totals, const DailyStats &stats);
+  static void add(StatsTotals &totals, const StatsTotals &other);
+  static void subtract(StatsTotals &totals, const StatsTotals &other);
+
+private:
+  void add_to_periods(int date, const StatsTotals &day);
+  void subtract_from_periods(int date, const StatsTotals &day);
+
+private:
+  //! Dates of the days in the history, in ascending order.
+  std::vector<int> dates;
+
+  //! Totals of the first N days of the history, indexed by N.
+  std::vector<StatsTotals> running;
+
+  //! Totals of each period, by period key.
+  std::map<int, StatsTotals> periods[workrave::IStatistics::STATS_PERIOD_SIZEOF];
+};
+
+#endif // STATISTICSROLLUP_HH
@@ -667,52 +667,7 @@ Timer::process(ActivityState new_activity_state, TimerInfo &info)
   TRACE_MSG("time {}", current_time);
   TRACE_MSG("activity_sensitive {} {}", activity_sensitive, insensitive_mode);
 
-  if (activity_monitor != nullptr)
-    {
-      // The timer uses its own activity monitor and ignores the 'global'
-      // activity monitor state (ie. new_activity_state). So get the state
-      // of the activity monitor used by this timer.
-      new_activity_state = activity_monitor->get_current_state();
-      TRACE_MSG("foreign activity state = {}", new_activity_state);
-    }
-  else if (activity_sensitive)
-    {
-      // This timer responds to the activity monitoring.
-      TRACE_MSG("is activity sensitive");
-    }
-  else
-    {
-      // This timer is activity insensitive. It periodically switches between
-      // idle and active.
-      TRACE_MSG("is not activity sensitive");
-      if (activity_state != ACTIVITY_UNKNOWN)
-        {
-          TRACE_MSG("activity_state = {} new_activity_state = {} elapsed_time = {}",
-                    activity_state,
-                    new_activity_state,
-                    get_elapsed_time());
-
-          if (insensitive_mode == INSENSITIVE_MODE_IDLE_ALWAYS)
-            // Forces ACTIVITY_IDLE every time, regardless of sensitivity
-            {
-              TRACE_MSG("MODE_IDLE_ALWAYS: Forcing ACTIVITY_IDLE");
-              new_activity_state = activity_state = ACTIVITY_IDLE;
-            }
-
-          if (activity_state == ACTIVITY_ACTIVE)
-            {
-              if (insensitive_mode == INSENSITIVE_MODE_IDLE_ON_LIMIT_REACHED)
-                {
-                  TRACE_MSG("MODE_IDLE_ON_LIMIT_REACHED");
-                  new_activity_state = activity_state;
-                }
-
-              TRACE_MSG("new_activity_state = {}", new_activity_state);
-            }
-
-          TRACE_MSG("activity_state = {}", new_activity_state);
-        }
-    }
+  new_activity_state = compute_activity_state(new_activity_state);
 
   // Start or stop timer.
   if (timer_enabled)
@@ -793,13 +748,201 @@ Timer::process(ActivityState new_activity_state, TimerInfo &info)
     }
 }
 
+//! Computes the activity state this timer responds to.
+/*!
+ *  Timers with their own activity monitor ignore the global activity
+ *  state, and activity insensitive timers may override it depending on
+ *  the insensitive mode.
+ */
+ActivityState
+Timer::compute_activity_state(ActivityState new_activity_state) const
+{
+  TRACE_ENTRY_PAR(timer_id, new_activity_state);
+
+  if (activity_monitor != nullptr)
+    {
+      // The timer uses its own activity monitor and ignores the 'global'
+      // activity monitor state (ie. new_activity_state). So get the state
+      // of the activity monitor used by this timer.
+      new_activity_state = activity_monitor->get_current_state();
+      TRACE_MSG("foreign activity state = {}", new_activity_state);
+    }
+  else if (activity_sensitive)
+    {
+      // This timer responds to the activity monitoring.
+      TRACE_MSG("is activity sensitive");
+    }
+  else
+    {
+      // This timer is activity insensitive. It periodically switches between
+      // idle and active.
+      TRACE_MSG("is not activity sensitive");
+      if (activity_state != ACTIVITY_UNKNOWN)
+        {
+          TRACE_MSG("activity_state = {} new_activity_state = {} elapsed_time = {}",
+                    activity_state,
+                    new_activity_state,
+                    get_elapsed_time());
+
+          // The current state is only updated by process(), which stores the returned state.
+          ActivityState current_state = activity_state;
+
+          if (insensitive_mode == INSENSITIVE_MODE_IDLE_ALWAYS)
+            // Forces ACTIVITY_IDLE every time, regardless of sensitivity
+            {
+              TRACE_MSG("MODE_IDLE_ALWAYS: Forcing ACTIVITY_IDLE");
+              new_activity_state = current_state = ACTIVITY_IDLE;
+            }
+
+          if (current_state == ACTIVITY_ACTIVE)
+            {
+              if (insensitive_mode == INSENSITIVE_MODE_IDLE_ON_LIMIT_REACHED)
+                {
+                  TRACE_MSG("MODE_IDLE_ON_LIMIT_REACHED");
+                  new_activity_state = current_state;
+                }
+
+              TRACE_MSG("new_activity_state = {}", new_activity_state);
+            }
+
+          TRACE_MSG("activity_state = {}", new_activity_state);
+        }
+    }
+
+  return new_activity_state;
+}
+
+//! Returns whether processing the specified activity state would change this timer.
+/*!
+ *  When this returns false, process() would neither change the state of the
+ *  timer nor generate an event, so it does not need to be called.
+ */
+bool
+Timer::is_processing_required(ActivityState new_activity_state) const
+{
+  TRACE_ENTRY_PAR(timer_id, new_activity_state);
+
+  int64_t current_time = TimeSource::get_real_time_sec_sync();
+  int64_t next_event_time = get_next_event_time();
+
+  if (next_event_time != 0 && current_time >= next_event_time)
+    {
+      TRACE_MSG("event due at {}", next_event_time);
+      return true;
+    }
+
+  new_activity_state = compute_activity_state(new_activity_state);
+
+  if (timer_enabled && ((new_activity_state == ACTIVITY_ACTIVE) != (timer_state == STATE_RUNNING)))
+    {
+      TRACE_MSG("start/stop required");
+      return true;
+    }
+
+  return new_activity_state != activity_state;
+}
+
+//! Returns the earliest time at which this timer generates an event, or 0 if no event is scheduled.
+int64_t
+Timer::get_next_event_time() const
+{
+  int64_t ret = 0;
+
+  auto consider = [&ret](int64_t t) {
+    if (t != 0 && (ret == 0 || t < ret))
+      {
+        ret = t;
+      }
+  };
+
+  if (autoreset_interval_predicate)
+    {
+      consider(next_pred_reset_time);
+    }
+  consider(next_limit_time);
+  consider(next_reset_time);
+
+  return ret;
+}
+
+//! Processes a period of constant activity in one go.
+/*!
+ *  Equivalent to calling process() with the same activity state once per
+ *  second for duration seconds, starting at the current synchronized
+ *  time. Seconds in which process() would neither change the timer nor
+ *  generate an event are skipped by jumping to the next scheduled event,
+ *  so the cost depends on the number of events instead of the length of
+ *  the period. On return, the synchronized time is at the end of the
+ *  period.
+ *
+ *  Only the synchronized time is moved, using TimeSource::shift_sync(). The
+ *  caller must advance the underlying time source by the same duration,
+ *  otherwise the next TimeSource::sync() moves the time back.
+ *
+ *  \param activityState the activity state during the whole period.
+ *  \param duration length of the period in seconds.
+ *  \return the events generated during the period.
+ */
+std::vector<TimerAdvanceEvent>
+Timer::advance(ActivityState activityState, int64_t duration)
+{
+  TRACE_ENTRY_PAR(timer_id, activityState, duration);
+
+  std::vector<TimerAdvanceEvent> events;
+
+  int64_t current_time = TimeSource::get_real_time_sec_sync();
+  int64_t end_time = current_time + duration;
+
+  while (current_time < end_time)
+    {
+      int64_t next_time = current_time + 1;
+
+      if (is_processing_required(activityState))
+        {
+          TimerInfo info;
+          process(activityState, info);
+
+          if (info.event != TIMER_EVENT_NONE)
+            {
+              events.push_back({current_time, info.event});
+            }
+        }
+      else
+        {
+          // Nothing changes until the next event. It is in the future,
+          // otherwise processing would have been required.
+          next_time = get_next_event_time();
+          if (next_time == 0 || next_time > end_time)
+            {
+              next_time = end_time;
+            }
+        }
+
+      TimeSource::shift_sync((next_time - current_time) * TimeSource::TIME_USEC_PER_SEC);
+      current_time = next_time;
+    }
+
+  return events;
+}
+
 std::string
 Timer::serialize_state() const
 {
   stringstream ss;
 
-  ss << timer_id << " " << TimeSource::get_real_time_sec_sync() << " " << get_elapsed_time() << " " << last_pred_reset_time << " "
-     << total_overdue_time << " " << snooze_inhibited << " " << last_limit_time << " " << last_limit_elapsed << " " << timezone;
+  ss << timer_id << " " << TimeSource::get_real_time_sec_sync() << " " << get_persistent_state();
+
+  return ss.str();
+}
+
+//! Returns the part of the serialized state that does not depend on the current time.
+std::string
+Timer::get_persistent_state() const
+{
+  stringstream ss;
+
+  ss << get_elapsed_time() << " " << last_pred_reset_time << " " << total_overdue_time << " " << snooze_inhibited << " " << last_limit_time
+     << " " << last_limit_elapsed << " " << timezone;
 
   return ss.str();
 }
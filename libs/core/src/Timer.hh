@@ -21,6 +21,7 @@
 #include <ctime>
 #include <string>
 #include <list>
+#include <vector>
 
 #include "IActivityMonitor.hh"
 #include "utils/Diagnostics.hh"
@@ -109,6 +110,16 @@ struct TimerInfo
   int64_t elapsed_time;
 };
 
+//! Event generated by Timer::advance.
+struct TimerAdvanceEvent
+{
+  //! Time at which the event was generated.
+  int64_t time;
+
+  //! Event the timer generated.
+  TimerEvent event;
+};
+
 //! The Timer class.
 /*!
  *  The Timer receives 'active' and 'idle' events from an activity monitor.
@@ -145,6 +156,9 @@ public:
 
   // Timer processing.
   void process(ActivityState activityState, TimerInfo &info);
+  bool is_processing_required(ActivityState activityState) const;
+  int64_t get_next_event_time() const;
+  std::vector<TimerAdvanceEvent> advance(ActivityState activityState, int64_t duration);
 
   // State inquiry
   int64_t get_elapsed_time() const;
@@ -174,6 +188,7 @@ public:
 
   // State serialization.
   std::string serialize_state() const;
+  std::string get_persistent_state() const;
   bool deserialize_state(const std::string &state, int version);
   void set_state(int elapsed, int idle, int overdue = -1);
 
@@ -292,6 +307,7 @@ private:
   TracedField<InsensitiveMode> insensitive_mode;
 
 private:
+  ActivityState compute_activity_state(ActivityState new_activity_state) const;
   void compute_next_limit_time();
   void compute_next_reset_time();
   void compute_next_predicate_reset_time();
@@ -0,0 +1,567 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+// Microbenchmarks of the core hot paths.
+//
+// Each benchmark prints one JSON object per line:
+//
+//   {"name":"core/heartbeat/breaks=3","iterations":100000,"total_ns":...,"ns_per_op":...}
+//
+// Usage: workrave-core-bench [--filter SUBSTRING] [--scale FACTOR]
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "config/ConfiguratorFactory.hh"
+#include "config/IConfigurator.hh"
+#include "config/IConfiguratorListener.hh"
+#include "config/SettingCache.hh"
+#include "core/CoreConfig.hh"
+#include "core/CoreTypes.hh"
+#include "core/IApp.hh"
+#include "input-monitor/InputMonitorFactory.hh"
+#include "utils/Paths.hh"
+#include "utils/TimeSource.hh"
+
+#include "Core.hh"
+#include "ICoreTestHooks.hh"
+#include "InputMonitor.hh"
+#include "Statistics.hh"
+#ifdef HAVE_GLIB
+#  include "PacketBuffer.hh"
+#endif
+
+#include "SimulatedTime.hh"
+
+using namespace workrave;
+using namespace workrave::config;
+using namespace workrave::input_monitor;
+using namespace workrave::utils;
+
+//! Input monitor whose events are generated by the benchmarks.
+class BenchInputMonitor : public InputMonitor
+{
+public:
+  bool init() override
+  {
+    return true;
+  }
+
+  void terminate() override
+  {
+  }
+
+  void mouse(int x, int y)
+  {
+    fire_mouse(x, y);
+  }
+
+  void button(bool is_press)
+  {
+    fire_button(is_press);
+  }
+
+  void keyboard()
+  {
+    fire_keyboard(false);
+  }
+};
+
+namespace
+{
+  std::shared_ptr<BenchInputMonitor> bench_input_monitor;
+  int bench_coalesce_interval = 0;
+} // namespace
+
+// The benchmark replaces the platform input monitors by BenchInputMonitor.
+void
+InputMonitorFactory::init(IConfigurator::Ptr config, const char *display)
+{
+  (void)display;
+  config->get_value_with_default("advanced/coalesce_interval", bench_coalesce_interval, 50);
+}
+
+workrave::input_monitor::IInputMonitor::Ptr
+InputMonitorFactory::create_monitor(MonitorCapability capability)
+{
+  (void)capability;
+  if (!bench_input_monitor)
+    {
+      bench_input_monitor = std::make_shared<BenchInputMonitor>();
+      bench_input_monitor->set_coalesce_interval(bench_coalesce_interval);
+    }
+  return bench_input_monitor;
+}
+
+//! Application without user interface.
+class BenchApp : public IApp
+{
+public:
+  void create_prelude_window(BreakId break_id) override
+  {
+    (void)break_id;
+  }
+
+  void create_break_window(BreakId break_id, workrave::utils::Flags<BreakHint> break_hint) override
+  {
+    (void)break_id;
+    (void)break_hint;
+  }
+
+  void hide_break_window() override
+  {
+  }
+
+  void show_break_window() override
+  {
+  }
+
+  void refresh_break_window() override
+  {
+  }
+
+  void set_break_progress(int value, int max_value) override
+  {
+    (void)value;
+    (void)max_value;
+  }
+
+  void set_prelude_stage(PreludeStage stage) override
+  {
+    (void)stage;
+  }
+
+  void set_prelude_progress_text(PreludeProgressText text) override
+  {
+    (void)text;
+  }
+};
+
+//! Counts configuration notifications.
+class BenchListener : public IConfiguratorListener
+{
+public:
+  void config_changed_notify(const std::string &key) override
+  {
+    (void)key;
+    count++;
+  }
+
+  int64_t count{0};
+};
+
+class Bench
+{
+public:
+  Bench(int argc, char **argv)
+  {
+    for (int i = 1; i < argc; i++)
+      {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+          {
+            filter = argv[++i];
+          }
+        else if (strcmp(argv[i], "--scale") == 0 && i + 1 < argc)
+          {
+            scale = std::max(0.001, atof(argv[++i]));
+          }
+      }
+
+    directory = std::filesystem::temp_directory_path() / ("workrave-core-bench-" + std::to_string(std::random_device{}()));
+    std::filesystem::create_directories(directory);
+    Paths::set_portable_directory(directory.string());
+
+    sim = SimulatedTime::create();
+  }
+
+  ~Bench()
+  {
+    Core::reset_instance();
+    bench_input_monitor.reset();
+
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+  }
+
+  Bench(const Bench &) = delete;
+  Bench &operator=(const Bench &) = delete;
+
+  void run_all()
+  {
+    for (int breaks = 1; breaks <= BREAK_ID_SIZEOF; breaks++)
+      {
+        bench_heartbeat(breaks);
+      }
+    bench_input_events();
+    for (int years: {10, 20})
+      {
+        bench_load_history(years);
+      }
+    for (int keys: {1000, 5000})
+      {
+        bench_configurator(keys);
+      }
+#ifdef HAVE_GLIB
+    bench_packet_buffer();
+#endif
+  }
+
+private:
+  //! Runs func(iterations) and prints the result. func returns the number of operations it performed.
+  void measure(const std::string &name, int64_t iterations, const std::function<int64_t(int64_t)> &func)
+  {
+    if (!filter.empty() && name.find(filter) == std::string::npos)
+      {
+        return;
+      }
+
+    iterations = std::max<int64_t>(1, static_cast<int64_t>(static_cast<double>(iterations) * scale));
+
+    auto start = std::chrono::steady_clock::now();
+    int64_t ops = func(iterations);
+    auto stop = std::chrono::steady_clock::now();
+
+    int64_t total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+    double ns_per_op = ops > 0 ? static_cast<double>(total_ns) / static_cast<double>(ops) : 0.0;
+
+    std::cout << "{\"name\":\"" << name << "\",\"iterations\":" << ops << ",\"total_ns\":" << total_ns << ",\"ns_per_op\":" << ns_per_op
+              << "}" << std::endl;
+  }
+
+  void start_core(int enabled_breaks)
+  {
+    Core::reset_instance();
+    bench_input_monitor.reset();
+    SettingCache::reset();
+
+    std::error_code ec;
+    std::filesystem::remove(directory / "historystats", ec);
+    std::filesystem::remove(directory / "historystats.bin", ec);
+    std::filesystem::remove(directory / "todaystats", ec);
+
+    sim->reset();
+    TimeSource::sync();
+
+    core = Core::get_instance();
+
+    ICoreTestHooks::Ptr test_hooks = std::dynamic_pointer_cast<ICoreTestHooks>(core->get_hooks());
+    test_hooks->hook_create_configurator() = [enabled_breaks]() {
+      IConfigurator::Ptr config = ConfiguratorFactory::create(ConfigFileFormat::Ini);
+      for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+        {
+          config->set_value("breaks/" + CoreConfig::get_break_name(BreakId(i)) + "/enabled", i < enabled_breaks);
+        }
+      return config;
+    };
+    test_hooks->hook_load_timer_state() = [](Timer *timers[BREAK_ID_SIZEOF]) {
+      (void)timers;
+      return true;
+    };
+
+    core->init(0, nullptr, &app, "");
+    core->set_operation_mode(OperationMode::Normal);
+    core->set_usage_mode(UsageMode::Normal);
+  }
+
+  //! Advances the simulated time by one second and runs a heartbeat.
+  void heartbeat(bool active)
+  {
+    sim->current_time += TimeSource::TIME_USEC_PER_SEC;
+    if (active)
+      {
+        mouse_x = (mouse_x + 17) % 1000;
+        bench_input_monitor->mouse(mouse_x, 10);
+      }
+    TimeSource::sync();
+    core->heartbeat();
+  }
+
+  //! Cost of Core::heartbeat, with a number of enabled breaks.
+  void bench_heartbeat(int enabled_breaks)
+  {
+    start_core(enabled_breaks);
+
+    measure("core/heartbeat/breaks=" + std::to_string(enabled_breaks), 100000, [this](int64_t iterations) {
+      for (int64_t i = 0; i < iterations; i++)
+        {
+          // Alternate 10 minutes of activity and 5 minutes of idle time.
+          heartbeat(i % 900 < 600);
+        }
+      return iterations;
+    });
+  }
+
+  //! Throughput of input events from the input monitor to the activity monitor and the statistics.
+  void bench_input_events()
+  {
+    start_core(BREAK_ID_SIZEOF);
+
+    constexpr int events_per_heartbeat = 2000;
+
+    measure("core/input_events", 2000000, [this](int64_t iterations) {
+      int64_t count = 0;
+      while (count < iterations)
+        {
+          for (int i = 0; i < events_per_heartbeat; i++)
+            {
+              sim->current_time += 500;
+              switch (i % 8)
+                {
+                case 0:
+                  bench_input_monitor->button(true);
+                  break;
+                case 1:
+                  bench_input_monitor->button(false);
+                  break;
+                case 2:
+                  bench_input_monitor->keyboard();
+                  break;
+                default:
+                  bench_input_monitor->mouse(i % 1000, (i * 7) % 1000);
+                  break;
+                }
+            }
+          count += events_per_heartbeat;
+
+          TimeSource::sync();
+          core->heartbeat();
+        }
+      return count;
+    });
+  }
+
+  //! Writes a history of the given number of years in the text format.
+  void write_history(int years)
+  {
+    std::ofstream out((directory / "historystats").string());
+    out << "WorkRaveStats 4" << std::endl;
+
+    std::tm tm{};
+    tm.tm_year = 100;
+    tm.tm_mon = 0;
+    tm.tm_mday = 1;
+    tm.tm_hour = 12;
+    tm.tm_isdst = -1;
+    std::time_t t = std::mktime(&tm);
+
+    std::mt19937 gen(years);
+    for (int day = 0; day < years * 365; day++)
+      {
+        std::tm *d = std::localtime(&t);
+        out << "D " << d->tm_mday << " " << d->tm_mon << " " << d->tm_year << " 9 0 " << d->tm_mday << " " << d->tm_mon << " "
+            << d->tm_year << " 17 30" << std::endl;
+        for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+          {
+            out << "B " << i << " " << IStatistics::STATS_BREAKVALUE_SIZEOF << " ";
+            for (int j = 0; j < IStatistics::STATS_BREAKVALUE_SIZEOF; j++)
+              {
+                out << gen() % 100 << " ";
+              }
+            out << std::endl;
+          }
+        out << "m " << IStatistics::STATS_VALUE_SIZEOF << " ";
+        for (int j = 0; j < IStatistics::STATS_VALUE_SIZEOF; j++)
+          {
+            out << gen() % 100000 << " ";
+          }
+        out << std::endl;
+
+        t += 24 * 3600;
+      }
+  }
+
+  //! Cost of loading a long statistics history, and of reading all its days.
+  void bench_load_history(int years)
+  {
+    start_core(BREAK_ID_SIZEOF);
+    write_history(years);
+
+    std::string suffix = "/" + std::to_string(years) + "y";
+
+    measure("statistics/load_history/migrate" + suffix, 3, [this](int64_t iterations) {
+      for (int64_t i = 0; i < iterations; i++)
+        {
+          std::error_code ec;
+          std::filesystem::remove(directory / "historystats.bin", ec);
+
+          Statistics statistics;
+          statistics.init(Core::get_instance());
+        }
+      return iterations;
+    });
+
+    measure("statistics/load_history/open" + suffix, 100, [this](int64_t iterations) {
+      for (int64_t i = 0; i < iterations; i++)
+        {
+          Statistics statistics;
+          statistics.init(Core::get_instance());
+        }
+      return iterations;
+    });
+
+    Statistics statistics;
+    statistics.init(Core::get_instance());
+    measure("statistics/get_day" + suffix, 10, [&statistics](int64_t iterations) {
+      int64_t count = 0;
+      for (int64_t i = 0; i < iterations; i++)
+        {
+          int size = statistics.get_history_size();
+          for (int day = 0; day < size; day++)
+            {
+              statistics.get_day(day);
+            }
+          count += size;
+        }
+      return count;
+    });
+  }
+
+  //! Cost of reading configuration values and of notifying listeners, with a number of keys.
+  void bench_configurator(int key_count)
+  {
+    IConfigurator::Ptr config = ConfiguratorFactory::create(ConfigFileFormat::Ini);
+
+    std::vector<std::string> keys;
+    keys.reserve(key_count);
+    for (int i = 0; i < key_count; i++)
+      {
+        keys.push_back("bench/group" + std::to_string(i / 50) + "/key" + std::to_string(i));
+        config->set_value(keys.back(), i);
+      }
+
+    std::vector<std::unique_ptr<BenchListener>> listeners;
+    for (int i = 0; i < key_count / 50; i++)
+      {
+        listeners.push_back(std::make_unique<BenchListener>());
+        config->add_listener("bench/group" + std::to_string(i) + "/", listeners.back().get());
+      }
+    listeners.push_back(std::make_unique<BenchListener>());
+    config->add_listener("bench/", listeners.back().get());
+
+    std::string suffix = "/keys=" + std::to_string(key_count);
+
+    measure("config/get_value" + suffix, 1000000, [&](int64_t iterations) {
+      int64_t sum = 0;
+      for (int64_t i = 0; i < iterations; i++)
+        {
+          int value = 0;
+          config->get_value(keys[(i * 7919) % key_count], value);
+          sum += value;
+        }
+      return sum >= 0 ? iterations : 0;
+    });
+
+    measure("config/set_value_notify" + suffix, 50000, [&](int64_t iterations) {
+      for (int64_t i = 0; i < iterations; i++)
+        {
+          config->set_value(keys[(i * 7919) % key_count], static_cast<int>(key_count + i));
+        }
+      return iterations;
+    });
+  }
+
+#ifdef HAVE_GLIB
+  //! Cost of packing and unpacking a typical message, in both protocols.
+  void bench_packet_buffer()
+  {
+    for (int protocol: {PACKET_PROTOCOL_LEGACY, PACKET_PROTOCOL_COMPACT})
+      {
+        std::string name = protocol == PACKET_PROTOCOL_COMPACT ? "compact" : "legacy";
+
+        measure("packet/pack_unpack/" + name, 1000000, [protocol](int64_t iterations) {
+          PacketBuffer buffer;
+          int64_t sum = 0;
+          for (int64_t i = 0; i < iterations; i++)
+            {
+              buffer.create();
+              buffer.set_protocol(protocol);
+              for (int t = 0; t < BREAK_ID_SIZEOF; t++)
+                {
+                  if (buffer.is_compact())
+                    {
+                      buffer.pack_string_ref("workrave-client");
+                      buffer.pack_varint(static_cast<guint64>(i + t));
+                      buffer.pack_svarint(-t);
+                    }
+                  else
+                    {
+                      buffer.pack_string("workrave-client");
+                      buffer.pack_ulong(static_cast<guint32>(i + t));
+                      buffer.pack_ushort(static_cast<guint16>(t));
+                    }
+                }
+
+              buffer.restart_read();
+              buffer.reset_string_table();
+              for (int t = 0; t < BREAK_ID_SIZEOF; t++)
+                {
+                  if (buffer.is_compact())
+                    {
+                      sum += static_cast<int64_t>(buffer.unpack_string_ref().size());
+                      sum += static_cast<int64_t>(buffer.unpack_varint());
+                      sum += buffer.unpack_svarint();
+                    }
+                  else
+                    {
+                      gchar *s = buffer.unpack_string();
+                      sum += static_cast<int64_t>(strlen(s));
+                      g_free(s);
+                      sum += buffer.unpack_ulong();
+                      sum += buffer.unpack_ushort();
+                    }
+                }
+            }
+          return sum != 0 ? iterations : 0;
+        });
+      }
+  }
+#endif
+
+private:
+  std::string filter;
+  double scale{1.0};
+  std::filesystem::path directory;
+  SimulatedTime::Ptr sim;
+  BenchApp app;
+  ICore *core{nullptr};
+  int mouse_x{0};
+};
+
+int
+main(int argc, char **argv)
+{
+  spdlog::set_level(spdlog::level::off);
+
+  Bench bench(argc, argv);
+  bench.run_all();
+  return 0;
+}
@@ -0,0 +1,235 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#define BOOST_TEST_MODULE workrave_deltareplicator
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "DeltaReplicator.hh"
+#include "PacketBuffer.hh"
+
+BOOST_AUTO_TEST_SUITE(s)
+
+//! Packs the values into a fresh compact buffer.
+static void
+pack(DeltaReplicator &sender, PacketBuffer &buffer, const std::vector<int64_t> &values)
+{
+  buffer.create();
+  buffer.set_protocol(PACKET_PROTOCOL_COMPACT);
+  sender.pack(buffer, values);
+}
+
+BOOST_AUTO_TEST_CASE(test_deltareplicator_round_trip)
+{
+  DeltaReplicator sender(100);
+  DeltaReplicator receiver;
+  PacketBuffer buffer;
+  std::vector<int64_t> values{1, -2, 3, 1700000000};
+  std::vector<int64_t> received;
+
+  pack(sender, buffer, values);
+  int snapshot_size = buffer.bytes_written();
+  BOOST_REQUIRE(receiver.unpack("a", buffer, received));
+  BOOST_CHECK(received == values);
+
+  for (int i = 0; i < 20; i++)
+    {
+      values[i % values.size()] += i * 7 - 20;
+      pack(sender, buffer, values);
+      BOOST_CHECK_LT(buffer.bytes_written(), snapshot_size);
+      BOOST_REQUIRE(receiver.unpack("a", buffer, received));
+      BOOST_CHECK(received == values);
+    }
+
+  pack(sender, buffer, values);
+  BOOST_REQUIRE(receiver.unpack("a", buffer, received));
+  BOOST_CHECK(received == values);
+}
+
+BOOST_AUTO_TEST_CASE(test_deltareplicator_missed_message)
+{
+  DeltaReplicator sender(4);
+  DeltaReplicator receiver;
+  PacketBuffer buffer;
+  std::vector<int64_t> values{10, 20, 30};
+  std::vector<int64_t> received;
+
+  pack(sender, buffer, values);
+  BOOST_REQUIRE(receiver.unpack("a", buffer, received));
+
+  // Dropped delta.
+  values[0]++;
+  pack(sender, buffer, values);
+
+  // Deltas after the gap are rejected and leave the values alone.
+  std::vector<int64_t> before = received;
+  int rejected = 0;
+  bool ok = false;
+  while (!ok)
+    {
+      values[1]++;
+      pack(sender, buffer, values);
+      ok = receiver.unpack("a", buffer, received);
+      if (!ok)
+        {
+          BOOST_CHECK(received == before);
+          rejected++;
+        }
+    }
+
+  // The periodic snapshot resynchronizes the receiver.
+  BOOST_CHECK_EQUAL(rejected, 3);
+  BOOST_CHECK(received == values);
+}
+
+BOOST_AUTO_TEST_CASE(test_deltareplicator_snapshot_interval)
+{
+  DeltaReplicator sender(2);
+  DeltaReplicator receiver;
+  PacketBuffer buffer;
+  std::vector<int64_t> values{1, 2};
+  std::vector<int64_t> received;
+
+  pack(sender, buffer, values);
+  BOOST_REQUIRE(receiver.unpack("a", buffer, received));
+
+  // A receiver that joins late only accepts the next snapshot.
+  DeltaReplicator late;
+  pack(sender, buffer, values);
+  BOOST_CHECK(!late.unpack("a", buffer, received));
+  pack(sender, buffer, values);
+  BOOST_CHECK(!late.unpack("a", buffer, received));
+  pack(sender, buffer, values);
+  BOOST_CHECK(late.unpack("a", buffer, received));
+  BOOST_CHECK(received == values);
+}
+
+BOOST_AUTO_TEST_CASE(test_deltareplicator_peers_changed)
+{
+  DeltaReplicator sender(100);
+  PacketBuffer buffer;
+  std::vector<int64_t> values{1, 2};
+  std::vector<int64_t> received;
+
+  sender.set_number_of_peers(1);
+  pack(sender, buffer, values);
+  pack(sender, buffer, values);
+
+  DeltaReplicator receiver;
+  BOOST_CHECK(!receiver.unpack("a", buffer, received));
+
+  sender.set_number_of_peers(1);
+  pack(sender, buffer, values);
+  BOOST_CHECK(!receiver.unpack("a", buffer, received));
+
+  // A new peer forces a snapshot.
+  sender.set_number_of_peers(2);
+  pack(sender, buffer, values);
+  BOOST_CHECK(receiver.unpack("a", buffer, received));
+  BOOST_CHECK(received == values);
+
+  sender.request_snapshot();
+  DeltaReplicator other;
+  pack(sender, buffer, values);
+  BOOST_CHECK(other.unpack("a", buffer, received));
+}
+
+BOOST_AUTO_TEST_CASE(test_deltareplicator_forget)
+{
+  DeltaReplicator sender_a(100);
+  DeltaReplicator sender_b(100);
+  DeltaReplicator receiver;
+  PacketBuffer buffer;
+  std::vector<int64_t> values_a{1, 2};
+  std::vector<int64_t> values_b{3, 4, 5};
+  std::vector<int64_t> received;
+
+  pack(sender_a, buffer, values_a);
+  BOOST_REQUIRE(receiver.unpack("a", buffer, received));
+  pack(sender_b, buffer, values_b);
+  BOOST_REQUIRE(receiver.unpack("b", buffer, received));
+  BOOST_CHECK(received == values_b);
+
+  receiver.forget("a");
+
+  // Deltas of a forgotten client are rejected until its next snapshot.
+  values_a[0] = 7;
+  pack(sender_a, buffer, values_a);
+  BOOST_CHECK(!receiver.unpack("a", buffer, received));
+
+  values_b[2] = 9;
+  pack(sender_b, buffer, values_b);
+  BOOST_REQUIRE(receiver.unpack("b", buffer, received));
+  BOOST_CHECK(received == values_b);
+
+  sender_a.request_snapshot();
+  pack(sender_a, buffer, values_a);
+  BOOST_REQUIRE(receiver.unpack("a", buffer, received));
+  BOOST_CHECK(received == values_a);
+}
+
+BOOST_AUTO_TEST_CASE(test_deltareplicator_invalid_count)
+{
+  DeltaReplicator sender(100);
+  DeltaReplicator receiver;
+  PacketBuffer buffer;
+  std::vector<int64_t> values{1, 2, 3};
+  std::vector<int64_t> received{42};
+
+  // Snapshot with a huge number of values.
+  buffer.create();
+  buffer.set_protocol(PACKET_PROTOCOL_COMPACT);
+  buffer.pack_byte(1);
+  buffer.pack_varint(1);
+  buffer.pack_varint(UINT64_C(1) << 60);
+  buffer.pack_svarint(1);
+  BOOST_CHECK(!receiver.unpack("a", buffer, received));
+  BOOST_CHECK(received == std::vector<int64_t>{42});
+
+  // A valid snapshot is still accepted.
+  pack(sender, buffer, values);
+  BOOST_REQUIRE(receiver.unpack("a", buffer, received));
+  BOOST_CHECK(received == values);
+
+  // Delta with a huge number of changes.
+  buffer.create();
+  buffer.set_protocol(PACKET_PROTOCOL_COMPACT);
+  buffer.pack_byte(2);
+  buffer.pack_varint(2);
+  buffer.pack_varint(UINT64_C(1) << 60);
+  BOOST_CHECK(!receiver.unpack("a", buffer, received));
+  BOOST_CHECK(received == values);
+
+  // Snapshot with more values than bytes.
+  buffer.create();
+  buffer.set_protocol(PACKET_PROTOCOL_COMPACT);
+  buffer.pack_byte(1);
+  buffer.pack_varint(3);
+  buffer.pack_varint(4);
+  buffer.pack_svarint(1);
+  buffer.pack_svarint(2);
+  BOOST_CHECK(!receiver.unpack("a", buffer, received));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
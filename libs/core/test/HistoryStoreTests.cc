@@ -0,0 +1,378 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#define BOOST_TEST_MODULE workrave_history
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "HistoryStore.hh"
+#include "StatisticsRollup.hh"
+
+using namespace workrave;
+
+class Fixture
+{
+public:
+  Fixture()
+  {
+    path = std::filesystem::temp_directory_path() / "workrave-history-test.bin";
+    std::filesystem::remove(path);
+  }
+
+  ~Fixture()
+  {
+    std::filesystem::remove(path);
+  }
+
+  static IStatistics::DailyStats make_day(int y, int m, int d, int value)
+  {
+    IStatistics::DailyStats stats;
+    memset((void *)&stats, 0, sizeof(stats));
+
+    stats.start.tm_year = y - 1900;
+    stats.start.tm_mon = m - 1;
+    stats.start.tm_mday = d;
+    stats.start.tm_hour = 8;
+    stats.stop = stats.start;
+    stats.stop.tm_hour = 17;
+
+    for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+      {
+        for (int j = 0; j < IStatistics::STATS_BREAKVALUE_SIZEOF; j++)
+          {
+            stats.break_stats[i][j] = value + i * 10 + j;
+          }
+      }
+
+    for (int j = 0; j < IStatistics::STATS_VALUE_SIZEOF; j++)
+      {
+        stats.misc_stats[j] = value * 1000000000LL + j;
+      }
+    return stats;
+  }
+
+  //! Sums the days of the store from the first up to and including the last date.
+  static IStatistics::StatsTotals sum(const HistoryStore &store, int from_date, int to_date)
+  {
+    IStatistics::StatsTotals totals;
+    for (int i = 0; i < store.size(); i++)
+      {
+        if (store.get_date(i) >= from_date && store.get_date(i) <= to_date)
+          {
+            IStatistics::DailyStats stats;
+            store.get(i, stats);
+            StatisticsRollup::add(totals, stats);
+          }
+      }
+    return totals;
+  }
+
+  static void check_totals(const IStatistics::StatsTotals &totals, const IStatistics::StatsTotals &expected)
+  {
+    BOOST_REQUIRE_EQUAL(totals.days, expected.days);
+    for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+      {
+        for (int j = 0; j < IStatistics::STATS_BREAKVALUE_SIZEOF; j++)
+          {
+            BOOST_REQUIRE_EQUAL(totals.break_stats[i][j], expected.break_stats[i][j]);
+          }
+      }
+    for (int j = 0; j < IStatistics::STATS_VALUE_SIZEOF; j++)
+      {
+        BOOST_REQUIRE_EQUAL(totals.misc_stats[j], expected.misc_stats[j]);
+      }
+  }
+
+  void fill_2024(HistoryStore &store, StatisticsRollup &rollup)
+  {
+    static const int days_in_month[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+    int value = 1;
+    for (int m = 1; m <= 12; m++)
+      {
+        for (int d = 1; d <= days_in_month[m - 1]; d++)
+          {
+            // Skip some days without statistics.
+            if ((d + m) % 5 != 0)
+              {
+                IStatistics::DailyStats stats = make_day(2024, m, d, value++);
+                store.put(stats);
+                BOOST_REQUIRE(rollup.add(stats));
+              }
+          }
+      }
+  }
+
+  std::filesystem::path path;
+};
+
+BOOST_FIXTURE_TEST_SUITE(s, Fixture)
+
+BOOST_AUTO_TEST_CASE(test_history_append)
+{
+  HistoryStore store;
+  BOOST_REQUIRE(store.open(path));
+  BOOST_REQUIRE_EQUAL(store.size(), 0);
+
+  for (int d = 1; d <= 20; d++)
+    {
+      store.put(make_day(2024, 3, d, d));
+    }
+  BOOST_REQUIRE_EQUAL(store.size(), 20);
+
+  IStatistics::DailyStats stats;
+  store.get(4, stats);
+  BOOST_REQUIRE_EQUAL(stats.start.tm_mday, 5);
+  BOOST_REQUIRE_EQUAL(stats.stop.tm_hour, 17);
+  BOOST_REQUIRE_EQUAL(stats.break_stats[BREAK_ID_REST_BREAK][IStatistics::STATS_BREAKVALUE_SKIPPED], 5 + 10 + 3);
+  BOOST_REQUIRE_EQUAL(stats.misc_stats[IStatistics::STATS_VALUE_TOTAL_KEYSTROKES], 5000000005LL);
+}
+
+BOOST_AUTO_TEST_CASE(test_history_reopen)
+{
+  {
+    HistoryStore store;
+    BOOST_REQUIRE(store.open(path));
+    for (int d = 1; d <= 10; d++)
+      {
+        store.put(make_day(2023, 12, d + 20, d));
+      }
+  }
+
+  HistoryStore store;
+  BOOST_REQUIRE(store.open(path));
+  BOOST_REQUIRE_EQUAL(store.size(), 10);
+  BOOST_REQUIRE_EQUAL(store.get_date(9), HistoryStore::to_date(2023, 12, 30));
+
+  store.put(make_day(2024, 1, 1, 11));
+  BOOST_REQUIRE_EQUAL(store.size(), 11);
+  BOOST_REQUIRE_EQUAL(store.get_date(10), HistoryStore::to_date(2024, 1, 1));
+}
+
+BOOST_AUTO_TEST_CASE(test_history_replace_and_insert)
+{
+  HistoryStore store;
+  BOOST_REQUIRE(store.open(path));
+
+  store.put(make_day(2024, 1, 1, 1));
+  store.put(make_day(2024, 1, 5, 5));
+  store.put(make_day(2024, 1, 9, 9));
+
+  store.put(make_day(2024, 1, 5, 50));
+  BOOST_REQUIRE_EQUAL(store.size(), 3);
+
+  IStatistics::DailyStats stats;
+  store.get(1, stats);
+  BOOST_REQUIRE_EQUAL(stats.break_stats[0][0], 50);
+
+  store.put(make_day(2024, 1, 3, 3));
+  BOOST_REQUIRE_EQUAL(store.size(), 4);
+  BOOST_REQUIRE_EQUAL(store.get_date(1), HistoryStore::to_date(2024, 1, 3));
+  BOOST_REQUIRE_EQUAL(store.get_date(3), HistoryStore::to_date(2024, 1, 9));
+
+  store.get(2, stats);
+  BOOST_REQUIRE_EQUAL(stats.break_stats[0][0], 50);
+}
+
+BOOST_AUTO_TEST_CASE(test_history_header)
+{
+  {
+    HistoryStore store;
+    BOOST_REQUIRE(store.open(path));
+    store.put(make_day(2024, 2, 1, 1));
+  }
+
+  std::ifstream file(path.string(), std::ios::binary);
+  char header[32];
+  file.read(header, sizeof(header));
+  BOOST_REQUIRE(file);
+  BOOST_REQUIRE_EQUAL(std::string(header, 4), "WRHS");
+
+  uint32_t version = 0;
+  uint32_t record_size = 0;
+  memcpy(&version, header + 4, sizeof(version));
+  memcpy(&record_size, header + 8, sizeof(record_size));
+  BOOST_REQUIRE_EQUAL(version, 1);
+  BOOST_REQUIRE_EQUAL(std::filesystem::file_size(path), sizeof(header) + record_size);
+}
+
+BOOST_AUTO_TEST_CASE(test_history_invalid_file)
+{
+  {
+    std::ofstream file(path.string(), std::ios::binary);
+    file << "not a history file, but long enough to have a header";
+  }
+
+  HistoryStore store;
+  BOOST_REQUIRE(!store.open(path));
+}
+
+BOOST_AUTO_TEST_CASE(test_history_in_memory)
+{
+  HistoryStore store;
+  store.open_in_memory();
+  BOOST_REQUIRE(store.is_in_memory());
+  BOOST_REQUIRE_EQUAL(store.size(), 0);
+
+  store.put(make_day(2024, 1, 1, 1));
+  store.put(make_day(2024, 1, 9, 9));
+  store.put(make_day(2024, 1, 5, 5));
+  store.put(make_day(2024, 1, 9, 90));
+  BOOST_REQUIRE_EQUAL(store.size(), 3);
+  BOOST_REQUIRE_EQUAL(store.get_date(1), HistoryStore::to_date(2024, 1, 5));
+
+  IStatistics::DailyStats stats;
+  store.get(2, stats);
+  BOOST_REQUIRE_EQUAL(stats.break_stats[0][0], 90);
+  BOOST_REQUIRE_EQUAL(stats.misc_stats[IStatistics::STATS_VALUE_TOTAL_KEYSTROKES], 90000000005LL);
+  BOOST_REQUIRE(!std::filesystem::exists(path));
+}
+
+BOOST_AUTO_TEST_CASE(test_history_lower_bound)
+{
+  HistoryStore store;
+  BOOST_REQUIRE(store.open(path));
+
+  for (int m = 1; m <= 12; m++)
+    {
+      store.put(make_day(2022, m, 15, m));
+    }
+
+  BOOST_REQUIRE_EQUAL(store.lower_bound(HistoryStore::to_date(2021, 1, 1)), 0);
+  BOOST_REQUIRE_EQUAL(store.lower_bound(HistoryStore::to_date(2022, 4, 15)), 3);
+  BOOST_REQUIRE_EQUAL(store.lower_bound(HistoryStore::to_date(2022, 4, 16)), 4);
+  BOOST_REQUIRE_EQUAL(store.lower_bound(HistoryStore::to_date(2023, 1, 1)), 12);
+}
+
+BOOST_AUTO_TEST_CASE(test_history_remove)
+{
+  HistoryStore store;
+  BOOST_REQUIRE(store.open(path));
+
+  store.put(make_day(2024, 1, 1, 1));
+  BOOST_REQUIRE(store.remove());
+  BOOST_REQUIRE_EQUAL(store.size(), 0);
+
+  store.put(make_day(2024, 1, 2, 2));
+  BOOST_REQUIRE_EQUAL(store.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_rollup_range)
+{
+  HistoryStore store;
+  BOOST_REQUIRE(store.open(path));
+
+  StatisticsRollup rollup;
+  fill_2024(store, rollup);
+  BOOST_REQUIRE_EQUAL(rollup.size(), store.size());
+
+  const int ranges[][2] = {
+    {20240101, 20241231},
+    {20230101, 20250101},
+    {20240204, 20240204},
+    {20240205, 20240205},
+    {20240110, 20240320},
+    {20241201, 20240101},
+  };
+
+  for (const auto &range: ranges)
+    {
+      IStatistics::StatsTotals totals;
+      rollup.get_totals(range[0], range[1], totals);
+      check_totals(totals, sum(store, range[0], range[1]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_rollup_periods)
+{
+  HistoryStore store;
+  BOOST_REQUIRE(store.open(path));
+
+  StatisticsRollup rollup;
+  fill_2024(store, rollup);
+
+  IStatistics::StatsTotals totals;
+
+  // 2024-01-10 is a Wednesday.
+  rollup.get_period_totals(IStatistics::STATS_PERIOD_WEEK, 20240110, totals);
+  check_totals(totals, sum(store, 20240108, 20240114));
+
+  rollup.get_period_totals(IStatistics::STATS_PERIOD_WEEK, 20240114, totals);
+  check_totals(totals, sum(store, 20240108, 20240114));
+
+  rollup.get_period_totals(IStatistics::STATS_PERIOD_WEEK, 20240101, totals);
+  check_totals(totals, sum(store, 20240101, 20240107));
+
+  // Week from 2024-12-30 to 2025-01-05.
+  rollup.get_period_totals(IStatistics::STATS_PERIOD_WEEK, 20250102, totals);
+  check_totals(totals, sum(store, 20241230, 20241231));
+
+  rollup.get_period_totals(IStatistics::STATS_PERIOD_MONTH, 20240215, totals);
+  check_totals(totals, sum(store, 20240201, 20240229));
+
+  rollup.get_period_totals(IStatistics::STATS_PERIOD_YEAR, 20240601, totals);
+  check_totals(totals, sum(store, 20240101, 20241231));
+
+  rollup.get_period_totals(IStatistics::STATS_PERIOD_ALL, 20240601, totals);
+  check_totals(totals, sum(store, 0, 99999999));
+
+  rollup.get_period_totals(IStatistics::STATS_PERIOD_MONTH, 20230215, totals);
+  BOOST_REQUIRE_EQUAL(totals.days, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_rollup_update)
+{
+  HistoryStore store;
+  BOOST_REQUIRE(store.open(path));
+
+  StatisticsRollup rollup;
+  fill_2024(store, rollup);
+
+  IStatistics::DailyStats stats = make_day(2024, 12, 31, 500);
+  store.put(stats);
+  BOOST_REQUIRE(rollup.add(stats));
+
+  IStatistics::StatsTotals totals;
+  rollup.get_totals(20241201, 20241231, totals);
+  check_totals(totals, sum(store, 20241201, 20241231));
+
+  rollup.get_period_totals(IStatistics::STATS_PERIOD_MONTH, 20241231, totals);
+  check_totals(totals, sum(store, 20241201, 20241231));
+
+  stats = make_day(2024, 1, 4, 600);
+  store.put(stats);
+  BOOST_REQUIRE(!rollup.add(stats));
+
+  rollup.rebuild(store);
+  BOOST_REQUIRE_EQUAL(rollup.size(), store.size());
+
+  rollup.get_period_totals(IStatistics::STATS_PERIOD_ALL, 0, totals);
+  check_totals(totals, sum(store, 0, 99999999));
+
+  rollup.clear();
+  rollup.get_totals(0, 99999999, totals);
+  BOOST_REQUIRE_EQUAL(totals.days, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
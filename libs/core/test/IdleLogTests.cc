@@ -0,0 +1,209 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#define BOOST_TEST_MODULE workrave_idlelog
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+#include <vector>
+
+#include "IdleLog.hh"
+
+class Fixture
+{
+public:
+  //! Adds an interval with the specified idle and active length after the previous one.
+  void add(int64_t idle_length, int64_t active_time)
+  {
+    IdleInterval idle(time, time + idle_length);
+    idle.active_time = active_time;
+    idle.end_time = idle.end_idle_time + active_time;
+    time = idle.end_time;
+
+    log.push(idle);
+    reference.push_back(idle);
+  }
+
+  void expire(int count)
+  {
+    log.expire(count);
+    reference.erase(reference.begin(), reference.begin() + std::min(count, static_cast<int>(reference.size())));
+  }
+
+  //! Linear reference implementation of IdleLog::find_last_idle().
+  int find_last_idle(int64_t length) const
+  {
+    for (int i = static_cast<int>(reference.size()) - 1; i >= 0; i--)
+      {
+        if (reference[i].end_idle_time - reference[i].begin_time > length)
+          {
+            return i;
+          }
+      }
+    return IdleLog::NO_INTERVAL;
+  }
+
+  //! Linear reference implementation of IdleLog::get_active_time_since().
+  int64_t get_active_time_since(int index) const
+  {
+    int64_t total = 0;
+    for (int i = index; i < static_cast<int>(reference.size()); i++)
+      {
+        total += reference[i].active_time;
+      }
+    return total;
+  }
+
+  void check()
+  {
+    BOOST_REQUIRE_EQUAL(log.size(), static_cast<int>(reference.size()));
+    for (int i = 0; i < log.size(); i++)
+      {
+        BOOST_REQUIRE_EQUAL(log.at(i).begin_time, reference[i].begin_time);
+      }
+
+    for (int64_t length: {0, 5, 10, 30, 60, 120, 300, 1000})
+      {
+        int index = log.find_last_idle(length);
+        BOOST_REQUIRE_EQUAL(index, find_last_idle(length));
+        BOOST_REQUIRE_EQUAL(log.get_active_time_since(index == IdleLog::NO_INTERVAL ? 0 : index),
+                            get_active_time_since(index == IdleLog::NO_INTERVAL ? 0 : index));
+      }
+
+    for (int i = 0; i < log.size(); i++)
+      {
+        BOOST_REQUIRE_EQUAL(log.get_active_time_since(i), get_active_time_since(i));
+      }
+  }
+
+  IdleLog log;
+  std::vector<IdleInterval> reference;
+  int64_t time{1000};
+};
+
+BOOST_FIXTURE_TEST_SUITE(s, Fixture)
+
+BOOST_AUTO_TEST_CASE(test_idlelog_append)
+{
+  BOOST_REQUIRE(log.empty());
+  BOOST_REQUIRE_EQUAL(log.find_last_idle(0), IdleLog::NO_INTERVAL);
+  BOOST_REQUIRE_EQUAL(log.get_active_time_since(0), 0);
+
+  add(100, 10);
+  add(20, 30);
+  add(50, 40);
+  add(10, 50);
+
+  BOOST_REQUIRE(!log.empty());
+  BOOST_REQUIRE_EQUAL(log.newest().active_time, 50);
+  BOOST_REQUIRE_EQUAL(log.find_last_idle(60), 0);
+  BOOST_REQUIRE_EQUAL(log.find_last_idle(30), 2);
+  BOOST_REQUIRE_EQUAL(log.find_last_idle(100), IdleLog::NO_INTERVAL);
+  BOOST_REQUIRE_EQUAL(log.get_active_time_since(2), 90);
+  check();
+
+  log.pop();
+  reference.pop_back();
+  BOOST_REQUIRE_EQUAL(log.newest().active_time, 40);
+  check();
+}
+
+BOOST_AUTO_TEST_CASE(test_idlelog_expire)
+{
+  for (int i = 0; i < 100; i++)
+    {
+      add(10 + (i * 37) % 200, i);
+    }
+
+  int64_t time = log.at(40).end_idle_time;
+  BOOST_REQUIRE_EQUAL(log.count_expired(time), 40);
+  BOOST_REQUIRE_EQUAL(log.count_expired(time + 1), 41);
+  BOOST_REQUIRE_EQUAL(log.count_expired(0), 0);
+
+  // Expire less than half of the storage, then enough to compact it.
+  expire(30);
+  check();
+  expire(30);
+  check();
+
+  // Appending after compaction keeps the indices consistent.
+  for (int i = 0; i < 50; i++)
+    {
+      add(10 + (i * 53) % 300, i);
+    }
+  check();
+
+  expire(1000);
+  BOOST_REQUIRE(log.empty());
+  check();
+
+  add(500, 5);
+  check();
+}
+
+BOOST_AUTO_TEST_CASE(test_idlelog_compute_random)
+{
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> idle_dist(1, 1200);
+  std::uniform_int_distribution<int> active_dist(0, 600);
+  std::uniform_int_distribution<int> action_dist(0, 9);
+
+  for (int i = 0; i < 2000; i++)
+    {
+      int action = action_dist(rng);
+      if (action == 0 && !log.empty())
+        {
+          log.pop();
+          reference.pop_back();
+        }
+      else if (action == 1)
+        {
+          expire(action_dist(rng) * 3);
+        }
+      else
+        {
+          add(idle_dist(rng), active_dist(rng));
+        }
+
+      if (i % 50 == 0)
+        {
+          check();
+        }
+    }
+  check();
+}
+
+BOOST_AUTO_TEST_CASE(test_idlelog_reindex)
+{
+  for (int i = 0; i < 20; i++)
+    {
+      add(10 * (i % 7 + 1), 5);
+    }
+
+  // Modify intervals in place, as IdleLogManager::fix_idlelog() does.
+  log.at(3).begin_time -= 1000;
+  reference[3].begin_time -= 1000;
+  log.reindex();
+  BOOST_REQUIRE_EQUAL(log.find_last_idle(500), 3);
+  check();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
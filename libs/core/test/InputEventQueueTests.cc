@@ -0,0 +1,213 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#define BOOST_TEST_MODULE workrave_input
+#include <boost/test/unit_test.hpp>
+
+#include "InputEventQueue.hh"
+#include "InputMonitor.hh"
+#include "SimulatedTime.hh"
+
+using namespace workrave::utils;
+
+//! Input monitor that delivers the events of the test.
+class InputMonitorStub : public InputMonitor
+{
+public:
+  bool init() override
+  {
+    return true;
+  }
+
+  void terminate() override
+  {
+  }
+
+  using InputMonitor::fire_keyboard;
+  using InputMonitor::fire_mouse;
+};
+
+class Fixture
+{
+public:
+  Fixture()
+  {
+    sim = SimulatedTime::create();
+    sim->reset();
+  }
+
+  void advance_ms(int64_t ms)
+  {
+    sim->current_time += ms * 1000;
+  }
+
+  SimulatedTime::Ptr sim;
+};
+
+BOOST_FIXTURE_TEST_SUITE(s, Fixture)
+
+BOOST_AUTO_TEST_CASE(test_input_no_activity)
+{
+  InputEventQueue queue;
+
+  InputEventQueue::Activity input = queue.process();
+  BOOST_REQUIRE_EQUAL(input.first_time, 0);
+  BOOST_REQUIRE_EQUAL(input.last_time, 0);
+
+  // Movement below the sensitivity is no activity.
+  queue.mouse_notify(100, 100);
+  queue.process();
+  advance_ms(10);
+  queue.mouse_notify(101, 101);
+  input = queue.process();
+  BOOST_REQUIRE_EQUAL(input.last_time, 0);
+  BOOST_REQUIRE_EQUAL(input.mouse_distance, 0);
+
+  // Key repeats are activity, but no keystrokes.
+  queue.keyboard_notify(true);
+  input = queue.process();
+  BOOST_REQUIRE_EQUAL(input.last_time, sim->current_time);
+  BOOST_REQUIRE_EQUAL(input.keystrokes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_input_aggregate)
+{
+  InputEventQueue queue;
+  int64_t start = sim->current_time;
+
+  // Many more events than a heartbeat would ever see.
+  for (int i = 0; i < 100000; i++)
+    {
+      queue.mouse_notify(i % 2 == 0 ? 0 : 30, 40);
+      queue.keyboard_notify(false);
+      advance_ms(1);
+    }
+  queue.button_notify(true);
+  queue.button_notify(false);
+
+  InputEventQueue::Activity input = queue.process();
+  BOOST_REQUIRE_EQUAL(input.first_time, start);
+  BOOST_REQUIRE_EQUAL(input.last_time, sim->current_time);
+  BOOST_REQUIRE_EQUAL(input.keystrokes, 100000);
+  BOOST_REQUIRE_EQUAL(input.clicks, 1);
+  // First move counts the sensitivity in both directions (4 pixels), each later move 30 pixels.
+  BOOST_REQUIRE_EQUAL(input.mouse_distance, 4 + 99999 * 30);
+  BOOST_REQUIRE_EQUAL(input.mouse_time, 99999 * 1000);
+
+  input = queue.process();
+  BOOST_REQUIRE_EQUAL(input.last_time, 0);
+  BOOST_REQUIRE_EQUAL(input.keystrokes, 0);
+  BOOST_REQUIRE_EQUAL(input.mouse_distance, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_input_clicks)
+{
+  InputEventQueue queue;
+
+  queue.mouse_notify(10, 10);
+  queue.button_notify(true);
+  queue.button_notify(false);
+  queue.mouse_notify(10, 50);
+  queue.button_notify(true);
+  queue.button_notify(false);
+  queue.mouse_notify(40, 10);
+  queue.button_notify(true);
+
+  InputEventQueue::Activity input = queue.process();
+  BOOST_REQUIRE_EQUAL(input.clicks, 3);
+  BOOST_REQUIRE_EQUAL(input.click_distance, 40 + 50);
+}
+
+BOOST_AUTO_TEST_CASE(test_input_pressed_button)
+{
+  InputEventQueue queue;
+  queue.set_sensitivity(10);
+
+  queue.mouse_notify(100, 100);
+  queue.process();
+
+  advance_ms(100);
+  queue.mouse_notify(102, 100);
+  BOOST_REQUIRE_EQUAL(queue.process().last_time, 0);
+
+  queue.button_notify(true);
+  queue.process();
+
+  // Small movements while dragging are activity.
+  advance_ms(100);
+  queue.mouse_notify(103, 100);
+  BOOST_REQUIRE_EQUAL(queue.process().last_time, sim->current_time);
+}
+
+BOOST_AUTO_TEST_CASE(test_input_wakeup)
+{
+  InputEventQueue queue;
+  int wakeups = 0;
+  queue.set_wakeup_handler([&wakeups]() { wakeups++; });
+
+  queue.action_notify();
+  BOOST_REQUIRE_EQUAL(wakeups, 0);
+
+  queue.arm_wakeup();
+  queue.action_notify();
+  queue.keyboard_notify(false);
+  BOOST_REQUIRE_EQUAL(wakeups, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_input_coalesced_distance)
+{
+  InputMonitorStub monitor;
+  monitor.set_coalesce_interval(100);
+
+  // Activity monitoring allows coalescing, statistics does not.
+  InputEventQueue activity(true);
+  InputEventQueue statistics;
+  monitor.subscribe(&activity);
+  monitor.subscribe(&statistics);
+
+  monitor.fire_mouse(100, 100);
+  advance_ms(1000);
+  activity.process();
+  statistics.process();
+
+  // Zig-zag burst: 50 movements of 100 pixels, 10 ms apart.
+  for (int i = 1; i <= 50; i++)
+    {
+      monitor.fire_mouse(i % 2 == 0 ? 100 : 200, 100);
+      advance_ms(10);
+    }
+  monitor.flush();
+  monitor.fire_keyboard(false);
+
+  InputEventQueue::Activity input = statistics.process();
+  BOOST_CHECK_EQUAL(input.mouse_distance, 50 * 100);
+  BOOST_CHECK_EQUAL(input.keystrokes, 1);
+
+  // Coalesced movement only samples the positions.
+  input = activity.process();
+  BOOST_CHECK_LT(input.mouse_distance, 50 * 100);
+  BOOST_CHECK_EQUAL(input.keystrokes, 1);
+
+  monitor.unsubscribe(&activity);
+  monitor.unsubscribe(&statistics);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
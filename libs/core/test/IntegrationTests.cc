@@ -2431,6 +2431,177 @@ BOOST_AUTO_TEST_CASE(test_daily_limit_reset)
   verify();
 }
 
+BOOST_AUTO_TEST_CASE(test_timer_snapshot)
+{
+  init();
+
+  TimerSnapshot::Ptr snapshot = core->get_timer_snapshot();
+  BOOST_REQUIRE(snapshot);
+  BOOST_CHECK(snapshot == core->get_timer_snapshot());
+
+  tick(true, 10);
+
+  TimerSnapshot::Ptr next = core->get_timer_snapshot();
+  BOOST_CHECK_GT(next->version, snapshot->version);
+  BOOST_CHECK_EQUAL(next->operation_mode, core->get_regular_operation_mode());
+
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      auto b = core->get_break(BreakId(i));
+      const BreakTimerState &state = next->get(BreakId(i));
+
+      BOOST_CHECK_EQUAL(state.enabled, b->is_enabled());
+      BOOST_CHECK_EQUAL(state.running, b->is_running());
+      BOOST_CHECK_EQUAL(state.elapsed_time, b->get_elapsed_time());
+      BOOST_CHECK_EQUAL(state.elapsed_idle_time, b->get_elapsed_idle_time());
+      BOOST_CHECK_EQUAL(state.limit, b->get_limit());
+      BOOST_CHECK_EQUAL(state.auto_reset, b->get_auto_reset());
+      BOOST_CHECK_EQUAL(state.get_time_left(), b->get_limit() - b->get_elapsed_time());
+    }
+
+  snapshot = next;
+  core->set_operation_mode(OperationMode::Quiet);
+
+  next = core->get_timer_snapshot();
+  BOOST_CHECK_EQUAL(next->version, snapshot->version + 1);
+  BOOST_CHECK_EQUAL(next->operation_mode, OperationMode::Quiet);
+  BOOST_CHECK_EQUAL(snapshot->operation_mode, OperationMode::Normal);
+}
+
+BOOST_AUTO_TEST_CASE(test_get_timers_snapshot)
+{
+  init();
+
+  tick(true, 10);
+  tick(false, 5);
+
+  Core::TimerStatusList timers;
+  Core::get_instance()->get_timers_snapshot(timers);
+  BOOST_REQUIRE_EQUAL(timers.size(), BREAK_ID_SIZEOF);
+
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      auto b = core->get_break(BreakId(i));
+      const Core::TimerStatus &status = timers[i];
+
+      BOOST_CHECK_EQUAL(status.timer_id, BreakId(i));
+      BOOST_CHECK_EQUAL(status.running, b->is_running());
+      BOOST_CHECK_EQUAL(status.idle, b->get_elapsed_idle_time());
+      BOOST_CHECK_EQUAL(status.elapsed, b->get_elapsed_time());
+      BOOST_CHECK_EQUAL(status.remaining, b->get_limit() - b->get_elapsed_time());
+      BOOST_CHECK_EQUAL(status.overdue, 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_timers_changed_granularity)
+{
+  init();
+
+  Core *c = Core::get_instance();
+
+  int count = 0;
+  Core::TimerStatusList last;
+  auto connection = c->signal_timers_changed().connect([&](const Core::TimerStatusList &timers) {
+    count++;
+    last = timers;
+  });
+
+  tick(true, 10);
+  BOOST_CHECK_EQUAL(count, 0);
+
+  c->subscribe_timers(10, ":1.42");
+  tick(true, 1);
+  BOOST_CHECK_EQUAL(count, 1);
+
+  // Elapsed time crosses a multiple of the granularity.
+  tick(true, 9 - last[BREAK_ID_MICRO_BREAK].elapsed % 10);
+  BOOST_CHECK_EQUAL(count, 1);
+  tick(true, 1);
+  BOOST_CHECK_EQUAL(count, 2);
+  BOOST_CHECK_EQUAL(last[BREAK_ID_MICRO_BREAK].elapsed % 10, 0);
+
+  // Once all timers are reset, heartbeats are only needed when an idle time crosses
+  // a multiple of the granularity. Skipping the other heartbeats must not lose any change.
+  tick(false, 305);
+  std::vector<int> idle_times;
+  for (int i = 0; i < 20 && idle_times.size() < 5; i++)
+    {
+      // Ask for the next heartbeat at the time of the last heartbeat, like the GUI does.
+      sim->current_time -= 1000000;
+      TimeSource::sync();
+      int64_t next = core->get_next_heartbeat_time();
+      BOOST_REQUIRE_GT(next, TimeSource::get_real_time_sec());
+
+      int before = count;
+      sim->current_time = next * 1000000;
+      tick(false, 1);
+      if (count != before)
+        {
+          idle_times.push_back(last[BREAK_ID_MICRO_BREAK].idle);
+        }
+    }
+  std::vector<int> expected_idle_times{310, 320, 330, 340, 350};
+  BOOST_CHECK_EQUAL_COLLECTIONS(idle_times.begin(), idle_times.end(), expected_idle_times.begin(), expected_idle_times.end());
+
+  c->unsubscribe_timers(":1.42");
+  int before = count;
+  tick(false, 30);
+  BOOST_CHECK_EQUAL(count, before);
+
+  connection.disconnect();
+}
+
+BOOST_AUTO_TEST_CASE(test_next_heartbeat_rest_progress)
+{
+  init();
+
+  tick(true, 10);
+  tick(false, 5);
+
+  // The rest progress of the rest break grows until its auto-reset.
+  for (int i = 5; i < 300; i++)
+    {
+      TimeSource::sync();
+      BOOST_REQUIRE_EQUAL(core->get_next_heartbeat_time(), TimeSource::get_real_time_sec() + 1);
+      tick(false, 1);
+    }
+
+  tick(false, 2);
+  TimeSource::sync();
+  BOOST_CHECK_GT(core->get_next_heartbeat_time(), TimeSource::get_real_time_sec() + 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_statistics_current_day_changed)
+{
+  init();
+
+  auto statistics = core->get_statistics();
+  auto b = core->get_break(BREAK_ID_DAILY_LIMIT);
+
+  int count = 0;
+  int active_time_changes = 0;
+  auto connection = statistics->signal_current_day_changed().connect([&](const IStatistics::DailyStatsChanges &changes) {
+    count++;
+    if (changes.misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME])
+      {
+        active_time_changes++;
+      }
+  });
+
+  tick(true, 10);
+
+  BOOST_CHECK_GT(count, 0);
+  BOOST_CHECK_GT(active_time_changes, 0);
+  BOOST_CHECK_EQUAL(statistics->get_current_day()->misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME], b->get_elapsed_time());
+
+  connection.disconnect();
+  count = 0;
+
+  tick(true, 10);
+
+  BOOST_CHECK_EQUAL(count, 0);
+}
+
 // TODO: daily limit + change limit
 // TODO: daily limit + statistics reset
 // TODO: forced restbreak in reading mode (active state)
@@ -0,0 +1,256 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#define BOOST_TEST_MODULE workrave_packetbuffer
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "PacketBuffer.hh"
+
+BOOST_AUTO_TEST_SUITE(s)
+
+//! Packs the same values with the fixed size and with the variable length encoding.
+static void
+pack_values(PacketBuffer &buffer, const std::vector<guint32> &values)
+{
+  int pos = 0;
+  buffer.reserve_size(pos);
+  for (auto value: values)
+    {
+      if (buffer.is_compact())
+        {
+          buffer.pack_varint(value);
+        }
+      else
+        {
+          buffer.pack_ulong(value);
+        }
+    }
+  buffer.update_size(pos);
+}
+
+static std::vector<guint32>
+unpack_values(PacketBuffer &buffer)
+{
+  std::vector<guint32> values;
+  int end = 0;
+  buffer.read_size(end);
+  while (buffer.bytes_read() < end)
+    {
+      values.push_back(buffer.is_compact() ? static_cast<guint32>(buffer.unpack_varint()) : buffer.unpack_ulong());
+    }
+  return values;
+}
+
+BOOST_AUTO_TEST_CASE(test_packet_legacy_and_compact)
+{
+  const std::vector<guint32> values = {0, 1, 127, 128, 300, 65535, 65536, 0xffffffff};
+
+  for (int protocol: {PACKET_PROTOCOL_LEGACY, PACKET_PROTOCOL_COMPACT, PACKET_PROTOCOL_CHUNKED})
+    {
+      PacketBuffer buffer;
+      buffer.create();
+      buffer.set_protocol(protocol);
+
+      pack_values(buffer, values);
+      buffer.pack_string("tail");
+
+      BOOST_REQUIRE(unpack_values(buffer) == values);
+      BOOST_REQUIRE_EQUAL(std::string(buffer.unpack_string_view()), "tail");
+      BOOST_REQUIRE_EQUAL(buffer.bytes_available(), 0);
+    }
+
+  PacketBuffer legacy;
+  legacy.create();
+  pack_values(legacy, values);
+
+  PacketBuffer compact;
+  compact.create();
+  compact.set_protocol(PACKET_PROTOCOL_COMPACT);
+  pack_values(compact, values);
+
+  BOOST_REQUIRE_EQUAL(legacy.bytes_written(), 2 + 4 * static_cast<int>(values.size()));
+  BOOST_REQUIRE_EQUAL(compact.bytes_written(), 2 + 1 + 1 + 1 + 2 + 2 + 3 + 3 + 5);
+}
+
+BOOST_AUTO_TEST_CASE(test_packet_varint_boundaries)
+{
+  const std::pair<guint64, int> cases[] = {
+    {0, 1},
+    {127, 1},
+    {128, 2},
+    {16383, 2},
+    {16384, 3},
+    {(1ULL << 21) - 1, 3},
+    {1ULL << 21, 4},
+    {0xffffffffULL, 5},
+    {1ULL << 56, 9},
+    {(1ULL << 63) - 1, 9},
+    {1ULL << 63, 10},
+    {std::numeric_limits<guint64>::max(), 10},
+  };
+
+  for (const auto &[value, length]: cases)
+    {
+      PacketBuffer buffer;
+      buffer.create(4);
+      buffer.pack_varint(value);
+      BOOST_REQUIRE_EQUAL(buffer.bytes_written(), length);
+      BOOST_REQUIRE_EQUAL(buffer.unpack_varint(), value);
+      BOOST_REQUIRE_EQUAL(buffer.bytes_available(), 0);
+    }
+
+  const std::pair<gint64, int> signed_cases[] = {
+    {0, 1},
+    {-1, 1},
+    {1, 1},
+    {-64, 1},
+    {64, 2},
+    {-65, 2},
+    {std::numeric_limits<gint64>::max(), 10},
+    {std::numeric_limits<gint64>::min(), 10},
+  };
+
+  for (const auto &[value, length]: signed_cases)
+    {
+      PacketBuffer buffer;
+      buffer.create(4);
+      buffer.pack_svarint(value);
+      BOOST_REQUIRE_EQUAL(buffer.bytes_written(), length);
+      BOOST_REQUIRE_EQUAL(buffer.unpack_svarint(), value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_packet_varint_truncated)
+{
+  PacketBuffer buffer;
+  buffer.create();
+  buffer.pack_byte(0x80);
+  buffer.pack_byte(0x80);
+
+  // A truncated varint stops at the end of the data.
+  buffer.unpack_varint();
+  BOOST_REQUIRE_EQUAL(buffer.bytes_available(), 0);
+  BOOST_REQUIRE_EQUAL(buffer.unpack_varint(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_packet_string_table)
+{
+  PacketBuffer buffer;
+  buffer.create();
+  buffer.set_protocol(PACKET_PROTOCOL_COMPACT);
+
+  buffer.pack_string_ref("micro_pause");
+  int first = buffer.bytes_written();
+  buffer.pack_string_ref("rest_break");
+  buffer.pack_string_ref("micro_pause");
+  buffer.pack_string_ref("rest_break");
+  buffer.pack_string_ref("");
+  buffer.pack_string_ref("");
+
+  BOOST_REQUIRE_EQUAL(first, 2 + 11);
+  BOOST_REQUIRE_EQUAL(buffer.bytes_written(), first + 2 + 10 + 1 + 1 + 2 + 1);
+
+  BOOST_REQUIRE_EQUAL(std::string(buffer.unpack_string_ref()), "micro_pause");
+  BOOST_REQUIRE_EQUAL(std::string(buffer.unpack_string_ref()), "rest_break");
+  BOOST_REQUIRE_EQUAL(std::string(buffer.unpack_string_ref()), "micro_pause");
+  BOOST_REQUIRE_EQUAL(std::string(buffer.unpack_string_ref()), "rest_break");
+  BOOST_REQUIRE(buffer.unpack_string_ref().empty());
+  BOOST_REQUIRE(buffer.unpack_string_ref().empty());
+  BOOST_REQUIRE_EQUAL(buffer.bytes_available(), 0);
+
+  // Clearing the buffer starts a new table.
+  buffer.clear();
+  buffer.pack_string_ref("rest_break");
+  BOOST_REQUIRE_EQUAL(buffer.bytes_written(), 2 + 10);
+  BOOST_REQUIRE_EQUAL(std::string(buffer.unpack_string_ref()), "rest_break");
+}
+
+BOOST_AUTO_TEST_CASE(test_packet_string_table_invalid)
+{
+  PacketBuffer buffer;
+  buffer.create();
+
+  // Reference to an unknown string.
+  buffer.pack_varint(3);
+  BOOST_REQUIRE(buffer.unpack_string_ref().empty());
+
+  // Length beyond the end of the buffer.
+  buffer.clear();
+  buffer.pack_varint(0);
+  buffer.pack_varint(1000000);
+  BOOST_REQUIRE(buffer.unpack_string_ref().empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_packet_grow)
+{
+  PacketBuffer buffer;
+  buffer.create(8);
+
+  std::string data(100000, 'x');
+  buffer.pack_string_ref(data);
+  for (int i = 0; i < 10000; i++)
+    {
+      buffer.pack_ulong(i);
+    }
+
+  BOOST_REQUIRE_EQUAL(buffer.unpack_string_ref().size(), data.size());
+  for (int i = 0; i < 10000; i++)
+    {
+      BOOST_REQUIRE_EQUAL(buffer.unpack_ulong(), static_cast<guint32>(i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_packet_pool_threads)
+{
+  // Boost.Test assertions are not thread-safe, so collect the failures.
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+    {
+      threads.emplace_back([t, &failures]() {
+        for (int i = 0; i < 2000; i++)
+          {
+            PacketBuffer buffer;
+            buffer.create(64 + (i % 7) * 512);
+            buffer.pack_ulong(t * 100000 + i);
+            if (buffer.unpack_ulong() != static_cast<guint32>(t * 100000 + i))
+              {
+                failures++;
+              }
+          }
+      });
+    }
+
+  for (auto &thread: threads)
+    {
+      thread.join();
+    }
+  BOOST_REQUIRE_EQUAL(failures, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
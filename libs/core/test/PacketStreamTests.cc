@@ -0,0 +1,386 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#define BOOST_TEST_MODULE workrave_packetstream
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "PacketStream.hh"
+
+BOOST_AUTO_TEST_SUITE(s)
+
+static constexpr guint16 PACKET_CHUNK = 0x000B;
+static constexpr guint16 PACKET_DATA = 0x0001;
+
+//! Creates a packet with the specified number of payload bytes.
+static void
+make_packet(PacketBuffer &packet, int payload_size, int seed = 0)
+{
+  packet.create(PacketStream::PACKET_HEADER_SIZE + payload_size);
+  packet.pack_ushort(0);
+  packet.pack_byte(PACKET_PROTOCOL_CHUNKED);
+  packet.pack_byte(0);
+  packet.pack_ushort(PACKET_DATA);
+
+  std::vector<guint8> payload(payload_size);
+  for (int i = 0; i < payload_size; i++)
+    {
+      payload[i] = (i + seed) & 0xff;
+    }
+  packet.pack_raw(payload.data(), payload_size);
+}
+
+static std::vector<guint8>
+get_bytes(PacketBuffer &packet)
+{
+  const guint8 *data = (const guint8 *)packet.get_buffer();
+  return std::vector<guint8>(data, data + packet.bytes_written());
+}
+
+//! Writes the entire write queue of a stream, at most max_write bytes at a time.
+static std::vector<guint8>
+write_all(PacketStream &stream, int max_write = 0x7fffffff)
+{
+  std::vector<guint8> out;
+  while (stream.is_write_pending())
+    {
+      ISocket::WriteBuffer buffers[16];
+      int size = 0;
+      int count = stream.gather(buffers, 16, size);
+
+      int bytes_written = 0;
+      for (int i = 0; i < count && bytes_written < max_write; i++)
+        {
+          int n = std::min(buffers[i].size, max_write - bytes_written);
+          const guint8 *data = (const guint8 *)buffers[i].data;
+          out.insert(out.end(), data, data + n);
+          bytes_written += n;
+        }
+      stream.consume(bytes_written);
+    }
+  return out;
+}
+
+static void
+receive(PacketStream &stream, const guint8 *data, int size)
+{
+  guint8 *buffer = stream.prepare_read(16 * 1024);
+  std::memcpy(buffer, data, size);
+  stream.commit_read(size);
+}
+
+static void
+receive(PacketStream &stream, const std::vector<guint8> &data)
+{
+  for (size_t pos = 0; pos < data.size(); pos += 16 * 1024)
+    {
+      receive(stream, data.data() + pos, (int)std::min(data.size() - pos, (size_t)16 * 1024));
+    }
+}
+
+//! Appends a frame with the specified header fields and payload.
+static void
+append_frame(std::vector<guint8> &data, int size, guint16 command, const std::vector<guint8> &payload)
+{
+  data.push_back(size >> 8);
+  data.push_back(size & 0xff);
+  data.push_back(PACKET_PROTOCOL_CHUNKED);
+  data.push_back(0);
+  data.push_back(command >> 8);
+  data.push_back(command & 0xff);
+  data.insert(data.end(), payload.begin(), payload.end());
+}
+
+//! Appends a chunk frame of a packet with the specified size.
+static void
+append_chunk(std::vector<guint8> &data, guint32 chunked_size, int chunk_size)
+{
+  std::vector<guint8> payload{(guint8)(chunked_size >> 24),
+                              (guint8)(chunked_size >> 16),
+                              (guint8)(chunked_size >> 8),
+                              (guint8)chunked_size};
+  payload.resize(4 + chunk_size, 0x55);
+  append_frame(data, PacketStream::CHUNK_HEADER_SIZE + chunk_size, PACKET_CHUNK, payload);
+}
+
+BOOST_AUTO_TEST_CASE(test_packetstream_multiple_frames)
+{
+  PacketStream sender(PACKET_CHUNK);
+  std::vector<std::vector<guint8>> sent;
+
+  for (int i = 0; i < 3; i++)
+    {
+      PacketBuffer packet;
+      make_packet(packet, 10 + i * 100, i);
+      BOOST_REQUIRE(sender.queue_packet(packet, false));
+      sent.push_back(get_bytes(packet));
+    }
+
+  // All frames arrive in a single read.
+  std::vector<guint8> data = write_all(sender);
+  BOOST_REQUIRE(data.size() < 16 * 1024);
+
+  PacketStream receiver(PACKET_CHUNK);
+  receive(receiver, data.data(), (int)data.size());
+
+  PacketBuffer packet;
+  packet.create();
+  for (const auto &expected: sent)
+    {
+      BOOST_REQUIRE(receiver.read_packet(packet) == PacketStream::ReadStatus::Packet);
+      BOOST_CHECK(get_bytes(packet) == expected);
+    }
+  BOOST_CHECK(receiver.read_packet(packet) == PacketStream::ReadStatus::Incomplete);
+}
+
+BOOST_AUTO_TEST_CASE(test_packetstream_split_frame)
+{
+  PacketStream sender(PACKET_CHUNK);
+  std::vector<std::vector<guint8>> sent;
+
+  for (int i = 0; i < 2; i++)
+    {
+      PacketBuffer packet;
+      make_packet(packet, 20, i);
+      BOOST_REQUIRE(sender.queue_packet(packet, false));
+      sent.push_back(get_bytes(packet));
+    }
+
+  std::vector<guint8> data = write_all(sender);
+
+  // Frames arrive one byte at a time.
+  PacketStream receiver(PACKET_CHUNK);
+  PacketBuffer packet;
+  packet.create();
+  size_t received = 0;
+  size_t end_of_frame = 0;
+  for (const auto &expected: sent)
+    {
+      end_of_frame += expected.size();
+      while (received + 1 < end_of_frame)
+        {
+          receive(receiver, data.data() + received, 1);
+          received++;
+          BOOST_REQUIRE(receiver.read_packet(packet) == PacketStream::ReadStatus::Incomplete);
+        }
+
+      receive(receiver, data.data() + received, 1);
+      received++;
+      BOOST_REQUIRE(receiver.read_packet(packet) == PacketStream::ReadStatus::Packet);
+      BOOST_CHECK(get_bytes(packet) == expected);
+    }
+  BOOST_CHECK(receiver.read_packet(packet) == PacketStream::ReadStatus::Incomplete);
+}
+
+BOOST_AUTO_TEST_CASE(test_packetstream_chunked)
+{
+  const int size = 16 * 1024 * 1024 + 100;
+
+  PacketBuffer packet;
+  make_packet(packet, size - PacketStream::PACKET_HEADER_SIZE);
+
+  // Large packets are only sent to clients that understand chunks.
+  PacketStream sender(PACKET_CHUNK);
+  BOOST_CHECK(!sender.queue_packet(packet, false));
+  BOOST_CHECK(!sender.is_write_pending());
+
+  BOOST_REQUIRE(sender.queue_packet(packet, true));
+  BOOST_CHECK(sender.get_write_queue_size() > (size_t)size);
+  std::vector<guint8> expected = get_bytes(packet);
+
+  std::vector<guint8> data = write_all(sender);
+  BOOST_CHECK_EQUAL(sender.get_write_queue_size(), 0);
+
+  PacketStream receiver(PACKET_CHUNK);
+  receive(receiver, data);
+
+  PacketBuffer received;
+  received.create();
+  BOOST_REQUIRE(receiver.read_packet(received) == PacketStream::ReadStatus::Packet);
+  BOOST_CHECK_EQUAL(received.bytes_written(), size);
+  BOOST_CHECK(get_bytes(received) == expected);
+  BOOST_CHECK(receiver.read_packet(received) == PacketStream::ReadStatus::Incomplete);
+
+  // A small packet following a chunked packet.
+  PacketBuffer small;
+  make_packet(small, 10);
+  BOOST_REQUIRE(sender.queue_packet(packet, true));
+  BOOST_REQUIRE(sender.queue_packet(small, true));
+  expected = get_bytes(small);
+  receive(receiver, write_all(sender, 1000));
+
+  BOOST_REQUIRE(receiver.read_packet(received) == PacketStream::ReadStatus::Packet);
+  BOOST_CHECK_EQUAL(received.bytes_written(), size);
+  BOOST_REQUIRE(receiver.read_packet(received) == PacketStream::ReadStatus::Packet);
+  BOOST_CHECK(get_bytes(received) == expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_packetstream_invalid_length)
+{
+  PacketBuffer packet;
+  packet.create();
+
+  // Frame shorter than the packet header.
+  for (int size = 0; size < PacketStream::PACKET_HEADER_SIZE; size++)
+    {
+      std::vector<guint8> data;
+      append_frame(data, size, PACKET_DATA, {});
+      PacketStream receiver(PACKET_CHUNK);
+      receive(receiver, data.data(), (int)data.size());
+      BOOST_CHECK(receiver.read_packet(packet) == PacketStream::ReadStatus::Invalid);
+    }
+
+  // Chunk without data.
+  std::vector<guint8> data;
+  append_chunk(data, 100, 0);
+  PacketStream empty_chunk(PACKET_CHUNK);
+  receive(empty_chunk, data.data(), (int)data.size());
+  BOOST_CHECK(empty_chunk.read_packet(packet) == PacketStream::ReadStatus::Invalid);
+
+  // Chunk without the size of the chunked packet.
+  data.clear();
+  append_frame(data, PacketStream::PACKET_HEADER_SIZE + 2, PACKET_CHUNK, {0, 0});
+  PacketStream short_chunk(PACKET_CHUNK);
+  receive(short_chunk, data.data(), (int)data.size());
+  BOOST_CHECK(short_chunk.read_packet(packet) == PacketStream::ReadStatus::Invalid);
+
+  // Chunked packet that is too large.
+  data.clear();
+  append_chunk(data, PacketStream::MAX_PACKET_SIZE + 1, 100);
+  PacketStream too_large(PACKET_CHUNK);
+  receive(too_large, data.data(), (int)data.size());
+  BOOST_CHECK(too_large.read_packet(packet) == PacketStream::ReadStatus::Invalid);
+
+  // Chunks that do not agree on the size of the packet.
+  data.clear();
+  append_chunk(data, 300, 100);
+  append_chunk(data, 400, 100);
+  PacketStream mismatch(PACKET_CHUNK);
+  receive(mismatch, data.data(), (int)data.size());
+  BOOST_CHECK(mismatch.read_packet(packet) == PacketStream::ReadStatus::Invalid);
+
+  // Chunks that exceed the size of the packet.
+  data.clear();
+  append_chunk(data, 150, 100);
+  append_chunk(data, 150, 100);
+  PacketStream overflow(PACKET_CHUNK);
+  receive(overflow, data.data(), (int)data.size());
+  BOOST_CHECK(overflow.read_packet(packet) == PacketStream::ReadStatus::Invalid);
+
+  // Chunks that match.
+  data.clear();
+  append_chunk(data, 150, 100);
+  append_chunk(data, 150, 50);
+  PacketStream valid(PACKET_CHUNK);
+  receive(valid, data.data(), (int)data.size());
+  BOOST_REQUIRE(valid.read_packet(packet) == PacketStream::ReadStatus::Packet);
+  BOOST_CHECK_EQUAL(packet.bytes_written(), 150);
+}
+
+BOOST_AUTO_TEST_CASE(test_packetstream_partial_write)
+{
+  PacketStream sender(PACKET_CHUNK);
+  PacketBuffer first;
+  PacketBuffer second;
+  make_packet(first, 10, 1);
+  make_packet(second, 20, 2);
+  BOOST_REQUIRE(sender.queue_packet(first, false));
+  BOOST_REQUIRE(sender.queue_packet(second, false));
+
+  std::vector<guint8> expected = get_bytes(first);
+  std::vector<guint8> bytes = get_bytes(second);
+  expected.insert(expected.end(), bytes.begin(), bytes.end());
+  BOOST_CHECK_EQUAL(sender.get_write_queue_size(), expected.size());
+
+  ISocket::WriteBuffer buffers[16];
+  int size = 0;
+  BOOST_REQUIRE_EQUAL(sender.gather(buffers, 16, size), 2);
+  BOOST_CHECK_EQUAL(size, (int)expected.size());
+
+  // Part of the first frame is written.
+  sender.consume(5);
+  BOOST_REQUIRE_EQUAL(sender.gather(buffers, 16, size), 2);
+  BOOST_CHECK_EQUAL(size, (int)expected.size() - 5);
+  BOOST_CHECK_EQUAL(buffers[0].size, 16 - 5);
+  BOOST_CHECK(std::memcmp(buffers[0].data, expected.data() + 5, buffers[0].size) == 0);
+  BOOST_CHECK_EQUAL(sender.get_write_queue_size(), expected.size() - 5);
+
+  // The remainder of the first frame and part of the second frame are written.
+  sender.consume(20);
+  BOOST_REQUIRE_EQUAL(sender.gather(buffers, 16, size), 1);
+  BOOST_CHECK_EQUAL(size, (int)expected.size() - 25);
+  BOOST_CHECK(std::memcmp(buffers[0].data, expected.data() + 25, buffers[0].size) == 0);
+
+  // Nothing is written.
+  sender.consume(0);
+  BOOST_CHECK_EQUAL(sender.gather(buffers, 16, size), 1);
+  BOOST_CHECK_EQUAL(size, (int)expected.size() - 25);
+
+  sender.consume(size);
+  BOOST_CHECK(!sender.is_write_pending());
+  BOOST_CHECK_EQUAL(sender.get_write_queue_size(), 0);
+
+  // The gathered buffers are limited.
+  for (int i = 0; i < 20; i++)
+    {
+      BOOST_REQUIRE(sender.queue_packet(first, false));
+    }
+  BOOST_CHECK_EQUAL(sender.gather(buffers, 16, size), 16);
+  BOOST_CHECK_EQUAL(size, 16 * 16);
+
+  // Resuming a partial write keeps the stream intact.
+  std::vector<guint8> data = write_all(sender, 7);
+  PacketStream receiver(PACKET_CHUNK);
+  receive(receiver, data.data(), (int)data.size());
+
+  PacketBuffer packet;
+  packet.create();
+  for (int i = 0; i < 20; i++)
+    {
+      BOOST_REQUIRE(receiver.read_packet(packet) == PacketStream::ReadStatus::Packet);
+      BOOST_CHECK(get_bytes(packet) == get_bytes(first));
+    }
+  BOOST_CHECK(receiver.read_packet(packet) == PacketStream::ReadStatus::Incomplete);
+
+  sender.clear();
+  BOOST_CHECK(!sender.is_write_pending());
+}
+
+BOOST_AUTO_TEST_CASE(test_packetstream_write_queue_full)
+{
+  PacketStream sender(PACKET_CHUNK);
+  PacketBuffer packet;
+  make_packet(packet, 60000);
+
+  while (!sender.is_write_queue_full())
+    {
+      BOOST_REQUIRE(sender.queue_packet(packet, false));
+    }
+  BOOST_CHECK(sender.get_write_queue_size() > PacketStream::MAX_WRITE_QUEUE_SIZE);
+
+  sender.consume(60000 + PacketStream::PACKET_HEADER_SIZE);
+  BOOST_CHECK(!sender.is_write_queue_full());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -25,6 +25,8 @@
 #include <boost/signals2.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <random>
+
 #include "utils/ITimeSource.hh"
 #include "utils/TimeSource.hh"
 
@@ -61,6 +63,27 @@ public:
   int64_t next{0};
 };
 
+class PeriodicTimePred : public TimePred
+{
+public:
+  explicit PeriodicTimePred(int64_t period)
+    : period(period)
+  {
+  }
+
+  int64_t get_next(int64_t last_time)
+  {
+    return last_time - (last_time % period) + period;
+  }
+
+  std::string to_string() const
+  {
+    return "periodic";
+  }
+
+  int64_t period;
+};
+
 class Fixture
 {
 public:
@@ -170,6 +193,19 @@ public:
       }
   }
 
+  std::vector<TimerAdvanceEvent> advance(bool active, int seconds)
+  {
+    TimeSource::sync();
+    std::vector<TimerAdvanceEvent> events = timer->advance(active ? ACTIVITY_ACTIVE : ACTIVITY_IDLE, seconds);
+    sim->current_time += seconds * 1000000LL;
+    return events;
+  }
+
+  void tick(bool active, int seconds)
+  {
+    advance(active, seconds);
+  }
+
   SimulatedTime::Ptr sim;
   Timer::Ptr timer;
 };
@@ -2150,4 +2186,168 @@ BOOST_AUTO_TEST_CASE(test_timer_serialize)
   BOOST_REQUIRE_EQUAL(s1, s2);
 }
 
+BOOST_AUTO_TEST_CASE(test_timer_processing_required)
+{
+  init();
+
+  int skipped = 0;
+  auto check = [&](bool active, int seconds) {
+    for (int i = 0; i < seconds; i++)
+      {
+        TimeSource::sync();
+        ActivityState state = active ? ACTIVITY_ACTIVE : ACTIVITY_IDLE;
+        int64_t next_event_time = timer->get_next_event_time();
+        bool required = timer->is_processing_required(state);
+        std::string before = timer->serialize_state();
+        TimerState timer_state = timer->get_state();
+
+        TimerInfo info;
+        timer->process(state, info);
+
+        if (info.event != TIMER_EVENT_NONE)
+          {
+            BOOST_REQUIRE(required);
+            BOOST_REQUIRE_NE(next_event_time, 0);
+            BOOST_REQUIRE_LE(next_event_time, TimeSource::get_real_time_sec());
+          }
+        if (!required)
+          {
+            BOOST_REQUIRE_EQUAL(timer_state, timer->get_state());
+            BOOST_REQUIRE_EQUAL(before, timer->serialize_state());
+            skipped++;
+          }
+        sim->current_time += 1000000;
+      }
+  };
+
+  check(false, 10);
+  check(true, 120);
+  check(false, 30);
+  check(true, 50);
+  check(false, 10);
+
+  BOOST_REQUIRE_GT(skipped, 200);
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_processing_required_no_side_effects)
+{
+  init();
+
+  for (int i = 0; i < 10; i++)
+    {
+      tick(true);
+    }
+  tick(false);
+  BOOST_REQUIRE_EQUAL(timer->get_state(), STATE_STOPPED);
+
+  // An insensitive timer with elapsed time starts as active, and is forced idle by the next process().
+  timer->set_insensitive_mode(INSENSITIVE_MODE_IDLE_ALWAYS);
+  timer->set_activity_sensitive(false);
+
+  TimeSource::sync();
+  BOOST_REQUIRE(timer->is_processing_required(ACTIVITY_ACTIVE));
+  BOOST_REQUIRE(timer->is_processing_required(ACTIVITY_ACTIVE));
+
+  TimerInfo info;
+  timer->process(ACTIVITY_ACTIVE, info);
+  BOOST_REQUIRE_EQUAL(timer->get_state(), STATE_STOPPED);
+  BOOST_REQUIRE(!timer->is_processing_required(ACTIVITY_ACTIVE));
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_advance_matches_process)
+{
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> duration_dist(1, 400);
+  std::vector<std::pair<bool, int>> segments;
+  for (int i = 0; i < 200; i++)
+    {
+      segments.emplace_back(gen() % 2 == 0, duration_dist(gen));
+    }
+
+  std::vector<TimerAdvanceEvent> expected_events;
+  std::vector<std::string> expected_states;
+
+  init();
+  timer->set_auto_reset(new PeriodicTimePred(3600));
+  for (auto [active, seconds]: segments)
+    {
+      for (int i = 0; i < seconds; i++)
+        {
+          TimeSource::sync();
+          TimerInfo info;
+          timer->process(active ? ACTIVITY_ACTIVE : ACTIVITY_IDLE, info);
+          if (info.event != TIMER_EVENT_NONE)
+            {
+              expected_events.push_back({TimeSource::get_real_time_sec_sync(), info.event});
+            }
+          sim->current_time += 1000000;
+        }
+      TimeSource::sync();
+      expected_states.push_back(timer->serialize_state());
+    }
+
+  init();
+  timer->set_auto_reset(new PeriodicTimePred(3600));
+  std::vector<TimerAdvanceEvent> events;
+  for (size_t i = 0; i < segments.size(); i++)
+    {
+      auto [active, seconds] = segments[i];
+      auto segment_events = advance(active, seconds);
+      events.insert(events.end(), segment_events.begin(), segment_events.end());
+
+      TimeSource::sync();
+      BOOST_REQUIRE_EQUAL(timer->serialize_state(), expected_states[i]);
+    }
+
+  BOOST_REQUIRE_EQUAL(events.size(), expected_events.size());
+  for (size_t i = 0; i < events.size(); i++)
+    {
+      BOOST_REQUIRE_EQUAL(events[i].time, expected_events[i].time);
+      BOOST_REQUIRE_EQUAL(events[i].event, expected_events[i].event);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_working_week)
+{
+  init();
+
+  for (int day = 0; day < 5; day++)
+    {
+      tick(true, 8 * 3600);
+      TimeSource::sync();
+      BOOST_REQUIRE_EQUAL(timer->get_elapsed_time(), 8 * 3600);
+      BOOST_REQUIRE_EQUAL(timer->get_elapsed_idle_time(), 0);
+      BOOST_REQUIRE_EQUAL(timer->get_total_overdue_time(), (day + 1) * (8 * 3600 - 100));
+
+      tick(false, 16 * 3600);
+      TimeSource::sync();
+      BOOST_REQUIRE_EQUAL(timer->get_elapsed_time(), 0);
+      BOOST_REQUIRE_EQUAL(timer->get_total_overdue_time(), (day + 1) * (8 * 3600 - 100));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_advance_long_period)
+{
+  init();
+
+  int64_t start = TimeSource::get_real_time_sec_sync();
+
+  auto events = advance(true, 7 * 24 * 3600);
+  BOOST_REQUIRE_EQUAL(events.size(), 1 + (7 * 24 * 3600 - 100 - 1) / 50);
+  BOOST_REQUIRE_EQUAL(events[0].time, start + 100);
+  BOOST_REQUIRE_EQUAL(events[0].event, TIMER_EVENT_LIMIT_REACHED);
+  BOOST_REQUIRE_EQUAL(events[1].time, start + 150);
+
+  TimeSource::sync();
+  BOOST_REQUIRE_EQUAL(timer->get_elapsed_time(), 7 * 24 * 3600);
+
+  events = advance(false, 7 * 24 * 3600);
+  BOOST_REQUIRE_EQUAL(events.size(), 1);
+  BOOST_REQUIRE_EQUAL(events[0].time, start + 7 * 24 * 3600 + 20);
+  BOOST_REQUIRE_EQUAL(events[0].event, TIMER_EVENT_RESET);
+
+  TimeSource::sync();
+  BOOST_REQUIRE_EQUAL(timer->get_elapsed_time(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
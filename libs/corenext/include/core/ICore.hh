@@ -19,6 +19,7 @@
 #define WORKRAVE_BACKEND_ICORE_HH
 
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 #include <boost/signals2.hpp>
@@ -28,6 +29,7 @@
 #include "core/IBreak.hh"
 #include "core/ICoreHooks.hh"
 #include "core/IStatistics.hh"
+#include "core/TimerSnapshot.hh"
 #include "dbus/IDBus.hh"
 
 namespace workrave
@@ -47,15 +49,30 @@ namespace workrave
     //! Initialize the Core. Must be called first.
     virtual void init(IApp *app, const char *display) = 0;
 
-    //! Periodic heartbeat. The GUI *MUST* call this method every second.
+    //! Periodic heartbeat. The GUI *MUST* call this method every second, unless get_next_heartbeat_time() allows fewer heartbeats.
     virtual void heartbeat() = 0;
 
+    //! Returns the (real) time in seconds at which the next heartbeat is needed.
+    /*! Timers only change state at this time, or when user activity is detected.
+     *  Until then, the GUI may skip heartbeats.
+     */
+    [[nodiscard]] virtual int64_t get_next_heartbeat_time() = 0;
+
+    //! Sets the function to call when user input is detected before the next heartbeat is needed.
+    /*! The function is called at most once after each call to get_next_heartbeat_time()
+     *  that allowed heartbeats to be skipped. It may be called from any thread.
+     */
+    virtual void set_input_wakeup_handler(std::function<void()> handler) = 0;
+
     //! Force a break of the specified type.
     virtual void force_break(BreakId id, workrave::utils::Flags<BreakHint> break_hint) = 0;
 
     //! Return the break interface of the specified type.
     [[nodiscard]] virtual IBreak::Ptr get_break(BreakId id) = 0;
 
+    //! Returns the state of all break timers at the last heartbeat.
+    [[nodiscard]] virtual TimerSnapshot::Ptr get_timer_snapshot() const = 0;
+
     //! Return the statistics interface.
     [[nodiscard]] virtual IStatistics::Ptr get_statistics() const = 0;
 
@@ -19,6 +19,7 @@
 #define WORKRAVE_BACKEND_ISTATISTICS_HH
 
 #include <ctime>
+#include <memory>
 
 #ifdef PLATFORM_OS_WINDOWS_NATIVE
 typedef __int64 int64_t;
@@ -26,6 +27,8 @@ typedef __int64 int64_t;
 #  include <cstdint>
 #endif
 
+#include <boost/signals2.hpp>
+
 #include "core/CoreTypes.hh"
 
 namespace workrave
@@ -58,6 +61,15 @@ namespace workrave
       STATS_VALUE_SIZEOF
     };
 
+    enum StatsPeriod
+    {
+      STATS_PERIOD_WEEK = 0,
+      STATS_PERIOD_MONTH,
+      STATS_PERIOD_YEAR,
+      STATS_PERIOD_ALL,
+      STATS_PERIOD_SIZEOF
+    };
+
     using BreakStats = int[STATS_BREAKVALUE_SIZEOF];
     using MiscStats = int64_t[STATS_VALUE_SIZEOF];
 
@@ -76,16 +88,63 @@ namespace workrave
       MiscStats misc_stats;
     };
 
+    using BreakTotals = int64_t[STATS_BREAKVALUE_SIZEOF];
+
+    //! Sums of the statistics of a number of days.
+    struct StatsTotals
+    {
+      //! Number of days with statistics.
+      int days{0};
+
+      //! Statistic of each break
+      BreakTotals break_stats[BREAK_ID_SIZEOF]{};
+
+      //! Misc statistics
+      MiscStats misc_stats{};
+    };
+
+    //! Statistics of the current day that changed since the previous notification.
+    struct DailyStatsChanges
+    {
+      //! The current day was moved to the history and a new day started.
+      bool new_day{false};
+
+      //! The start or stop time changed.
+      bool period{false};
+
+      //! The statistics of each break that changed.
+      bool break_stats[BREAK_ID_SIZEOF]{};
+
+      //! The misc statistics that changed.
+      bool misc_stats[STATS_VALUE_SIZEOF]{};
+    };
+
   public:
     virtual ~IStatistics() = default;
 
     virtual bool delete_all_history() = 0;
     virtual void update() = 0;
+
+    //! Updates the statistics of the current day in memory, without saving them.
+    virtual void refresh_current_day() = 0;
     virtual DailyStats *get_current_day() const = 0;
     virtual DailyStats *get_day(int day) const = 0;
     virtual void get_day_index_by_date(int y, int m, int d, int &idx, int &next, int &prev) const = 0;
     virtual int get_history_size() const = 0;
+
+    //! Returns the totals of the days from the first up to and including the last date.
+    virtual void get_totals(int from_y, int from_m, int from_d, int to_y, int to_m, int to_d, StatsTotals &totals) const = 0;
+
+    //! Returns the totals of the week (starting on Monday), month or year that contains the date.
+    virtual void get_period_totals(StatsPeriod period, int y, int m, int d, StatsTotals &totals) const = 0;
     virtual void dump() = 0;
+
+    //! Emitted when the statistics of the current day change, at most once per second.
+    /*!
+     *  While connected, the statistics of the current day are kept up to date
+     *  in memory. They are written to disk on the normal save interval only.
+     */
+    virtual boost::signals2::signal<void(const DailyStatsChanges &)> &signal_current_day_changed() = 0;
   };
 } // namespace workrave
 
@@ -0,0 +1,101 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef WORKRAVE_BACKEND_TIMERSNAPSHOT_HH
+#define WORKRAVE_BACKEND_TIMERSNAPSHOT_HH
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+
+#include "core/CoreTypes.hh"
+
+namespace workrave
+{
+  //! State of a break timer.
+  struct BreakTimerState
+  {
+    bool enabled{false};
+    bool running{false};
+    bool taking{false};
+    int64_t elapsed_time{0};
+    int64_t elapsed_idle_time{0};
+    int64_t auto_reset{0};
+    bool auto_reset_enabled{false};
+    int64_t limit{0};
+    bool limit_enabled{false};
+
+    //! Returns the time left before the break, negative when overdue.
+    [[nodiscard]] int64_t get_time_left() const
+    {
+      return limit - elapsed_time;
+    }
+
+    [[nodiscard]] bool is_overdue() const
+    {
+      return limit < elapsed_time;
+    }
+
+    bool operator==(const BreakTimerState &other) const
+    {
+      return std::tie(enabled, running, taking, elapsed_time, elapsed_idle_time, auto_reset, auto_reset_enabled, limit, limit_enabled)
+             == std::tie(other.enabled,
+                         other.running,
+                         other.taking,
+                         other.elapsed_time,
+                         other.elapsed_idle_time,
+                         other.auto_reset,
+                         other.auto_reset_enabled,
+                         other.limit,
+                         other.limit_enabled);
+    }
+
+    bool operator!=(const BreakTimerState &other) const
+    {
+      return !(*this == other);
+    }
+  };
+
+  //! State of all break timers, published by the core once per heartbeat.
+  /*!
+   *  A snapshot is never modified after it is published. The version is
+   *  incremented only when the state differs from the previous snapshot, so
+   *  views can skip updates when the version did not change.
+   */
+  struct TimerSnapshot
+  {
+    using Ptr = std::shared_ptr<const TimerSnapshot>;
+
+    uint64_t version{0};
+    OperationMode operation_mode{OperationMode::Normal};
+    std::array<BreakTimerState, BREAK_ID_SIZEOF> timers{};
+
+    [[nodiscard]] const BreakTimerState &get(BreakId id) const
+    {
+      return timers[id];
+    }
+
+    //! Returns whether the state equals that of another snapshot, ignoring the version.
+    [[nodiscard]] bool same_state(const TimerSnapshot &other) const
+    {
+      return operation_mode == other.operation_mode && timers == other.timers;
+    }
+  };
+} // namespace workrave
+
+#endif // WORKRAVE_BACKEND_TIMERSNAPSHOT_HH
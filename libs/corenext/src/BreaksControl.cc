@@ -21,6 +21,7 @@
 
 #include "debug.hh"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -161,12 +162,66 @@ BreaksControl::heartbeat()
       b->process();
     }
 
-  // Make state persistent.
-  if (TimeSource::get_monotonic_time_sec() % SAVESTATETIME == 0)
+  // Make state persistent. Heartbeats may be skipped, so check whether a save time has passed.
+  int64_t current_time = TimeSource::get_monotonic_time_sec();
+  if (last_heartbeat_time != 0 && current_time / SAVESTATETIME != last_heartbeat_time / SAVESTATETIME)
     {
       statistics->update();
       save_state();
     }
+  last_heartbeat_time = current_time;
+}
+
+//! Returns the (real) time at which the next heartbeat is needed.
+int64_t
+BreaksControl::get_next_heartbeat_time()
+{
+  TRACE_ENTRY();
+  int64_t current_time = TimeSource::get_real_time_sec_sync();
+  int64_t monotonic_time = TimeSource::get_monotonic_time_sec_sync();
+
+  // Activity and running breaks need to be processed every second.
+  bool user_is_active = modes->get_usage_mode() == UsageMode::Reading ? reading_activity_monitor->is_active() : activity_monitor->is_active();
+  if (user_is_active || microbreak_activity_monitor->is_active())
+    {
+      return current_time + 1;
+    }
+
+  for (auto &b: breaks)
+    {
+      if (b->is_active())
+        {
+          return current_time + 1;
+        }
+    }
+
+  // The GUI shows the elapsed time of running timers, and the rest progress of
+  // stopped timers until they are reset. Both change every second.
+  for (auto &timer: timers)
+    {
+      bool resting = timer->is_auto_reset_enabled() && timer->get_auto_reset() > 0
+                     && timer->get_elapsed_idle_time() < timer->get_auto_reset();
+      if (timer->is_enabled() && (timer->is_running() || resting))
+        {
+          return current_time + 1;
+        }
+    }
+
+  // Make state persistent.
+  int64_t ret = current_time + (monotonic_time / SAVESTATETIME + 1) * SAVESTATETIME - monotonic_time;
+
+  // Timers only change state at their deadlines, which are in monotonic time.
+  for (auto &timer: timers)
+    {
+      int64_t event_time = timer->get_next_event_time();
+      if (event_time != 0)
+        {
+          ret = std::min(ret, current_time + event_time - monotonic_time);
+        }
+    }
+
+  TRACE_MSG("next heartbeat {}", ret);
+  return ret;
 }
 
 //! Processes all timers.
@@ -184,6 +239,12 @@ BreaksControl::process_timers(bool user_is_active)
           user_is_active_for_break = microbreak_activity_monitor->is_active();
         }
 
+      // Timers only change state on activity changes and at their deadlines.
+      if (!timers[break_id]->is_processing_required(user_is_active_for_break))
+        {
+          continue;
+        }
+
       TimerEvent event = timers[break_id]->process(user_is_active_for_break);
 
       if (breaks[break_id]->is_enabled())
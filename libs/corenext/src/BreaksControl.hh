@@ -48,6 +48,7 @@ public:
 
   void init();
   void heartbeat();
+  int64_t get_next_heartbeat_time();
   void save_state() const;
 
   void force_break(workrave::BreakId id, workrave::utils::Flags<workrave::BreakHint> break_hint);
@@ -86,6 +87,9 @@ private:
 
   workrave::InsistPolicy insist_policy;
   workrave::InsistPolicy active_insist_policy;
+
+  //! Monotonic time of the last heartbeat.
+  int64_t last_heartbeat_time{0};
 };
 
 #endif // BREAKSCONTROL_HH
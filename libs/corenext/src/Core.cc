@@ -25,6 +25,7 @@
 
 #include "debug.hh"
 
+#include <algorithm>
 #include <filesystem>
 
 #include "Core.hh"
@@ -111,6 +112,11 @@ Core::init(IApp *app, const char *display_name)
   breaks_control->init();
 
   init_bus();
+
+  core_modes->signal_operation_mode_changed().connect([this](OperationMode) { update_timer_snapshot(); });
+  CoreConfig::key_timers().connect(this, [this] { timer_config_changed = true; });
+  CoreConfig::key_breaks().connect(this, [this] { timer_config_changed = true; });
+  update_timer_snapshot();
 }
 
 void
@@ -211,6 +217,74 @@ Core::heartbeat()
   configurator->heartbeat();
   breaks_control->heartbeat();
   core_modes->heartbeat();
+  statistics->heartbeat();
+
+  update_timer_snapshot();
+}
+
+//! Returns the time at which the next heartbeat is needed.
+int64_t
+Core::get_next_heartbeat_time()
+{
+  TRACE_ENTRY();
+  int64_t current_time = TimeSource::get_real_time_sec_sync();
+  int64_t ret = breaks_control->get_next_heartbeat_time();
+
+  int64_t auto_reset_time = core_modes->get_next_auto_reset_time();
+  if (auto_reset_time != 0)
+    {
+      ret = std::min(ret, auto_reset_time);
+    }
+
+  ret = std::max(ret, current_time + 1);
+  TRACE_MSG("next heartbeat {}", ret);
+
+  if (ret > current_time + 1)
+    {
+      // Heartbeats may be skipped, so user activity must wake up the GUI.
+      monitor->arm_wakeup();
+    }
+  return ret;
+}
+
+//! Sets the function to call when user input is detected while heartbeats are skipped.
+void
+Core::set_input_wakeup_handler(std::function<void()> handler)
+{
+  monitor->set_wakeup_handler(std::move(handler));
+}
+
+//! Publishes a new timer snapshot if the state or configuration of the timers changed.
+void
+Core::update_timer_snapshot()
+{
+  auto snapshot = std::make_shared<TimerSnapshot>();
+  snapshot->operation_mode = core_modes->get_regular_operation_mode();
+
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      IBreak::Ptr b = breaks_control->get_break(BreakId(i));
+      BreakTimerState &state = snapshot->timers[i];
+
+      state.enabled = b->is_enabled();
+      state.running = b->is_running();
+      state.taking = b->is_taking();
+      state.elapsed_time = b->get_elapsed_time();
+      state.elapsed_idle_time = b->get_elapsed_idle_time();
+      state.auto_reset = b->get_auto_reset();
+      state.auto_reset_enabled = b->is_auto_reset_enabled();
+      state.limit = b->get_limit();
+      state.limit_enabled = b->is_limit_enabled();
+    }
+
+  if (!timer_config_changed && timer_snapshot && timer_snapshot->same_state(*snapshot))
+    {
+      return;
+    }
+
+  timer_config_changed = false;
+  snapshot->version = timer_snapshot ? timer_snapshot->version + 1 : 1;
+  timer_snapshot = snapshot;
 }
 
 /********************************************************************************/
@@ -250,6 +324,13 @@ Core::get_statistics() const
   return statistics;
 }
 
+//! Returns the state of all timers at the last heartbeat.
+TimerSnapshot::Ptr
+Core::get_timer_snapshot() const
+{
+  return timer_snapshot;
+}
+
 //! Returns the configurator.
 IConfigurator::Ptr
 Core::get_configurator() const
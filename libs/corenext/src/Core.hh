@@ -22,6 +22,7 @@
 
 #include "dbus/IDBus.hh"
 #include "config/IConfigurator.hh"
+#include "utils/Signals.hh"
 
 #include "core/ICore.hh"
 #include "LocalActivityMonitor.hh"
@@ -37,7 +38,9 @@ namespace workrave
   class IApp;
 }
 
-class Core : public workrave::ICore
+class Core
+  : public workrave::ICore
+  , public workrave::utils::Trackable
 {
 public:
   Core();
@@ -48,9 +51,12 @@ public:
   boost::signals2::signal<void(workrave::UsageMode)> &signal_usage_mode_changed() override;
   void init(workrave::IApp *application, const char *display_name) override;
   void heartbeat() override;
+  int64_t get_next_heartbeat_time() override;
+  void set_input_wakeup_handler(std::function<void()> handler) override;
   void force_break(workrave::BreakId id, workrave::utils::Flags<workrave::BreakHint> break_hint) override;
   workrave::IBreak::Ptr get_break(workrave::BreakId id) override;
   workrave::IStatistics::Ptr get_statistics() const override;
+  workrave::TimerSnapshot::Ptr get_timer_snapshot() const override;
   workrave::config::IConfigurator::Ptr get_configurator() const override;
   ICoreHooks::Ptr get_hooks() const override;
   workrave::dbus::IDBus::Ptr get_dbus() const override;
@@ -74,6 +80,7 @@ public:
 private:
   void init_configurator();
   void init_bus();
+  void update_timer_snapshot();
 
 private:
   //! List of breaks.
@@ -105,6 +112,12 @@ private:
 
   //! DBUS bridge
   workrave::dbus::IDBus::Ptr dbus;
+
+  //! State of all timers at the last heartbeat.
+  workrave::TimerSnapshot::Ptr timer_snapshot;
+
+  //! Has the timer or break configuration changed since the last snapshot?
+  bool timer_config_changed{false};
 };
 
 #endif // CORE_HH
@@ -258,6 +258,18 @@ CoreModes::heartbeat()
   check_auto_reset();
 }
 
+//! Returns the (real) time at which the operation mode is reset, or 0 if no reset is scheduled.
+int64_t
+CoreModes::get_next_auto_reset_time() const
+{
+  auto next_reset_time = CoreConfig::operation_mode_auto_reset_time()();
+  if (next_reset_time.time_since_epoch().count() <= 0 || CoreConfig::operation_mode()() == OperationMode::Normal)
+    {
+      return 0;
+    }
+  return std::chrono::duration_cast<std::chrono::seconds>(next_reset_time.time_since_epoch()).count();
+}
+
 //! Performs a reset when the daily limit is reached.
 void
 CoreModes::daily_reset()
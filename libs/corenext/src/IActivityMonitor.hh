@@ -18,6 +18,8 @@
 #ifndef IACTIVITYMONITOR_HH
 #define IACTIVITYMONITOR_HH
 
+#include <functional>
+
 #include "config/Config.hh"
 
 class IActivityMonitorListener
@@ -46,6 +48,10 @@ public:
   virtual void force_idle() = 0;
   virtual bool is_active() = 0;
   virtual void set_listener(IActivityMonitorListener::Ptr l) = 0;
+
+  //! Sets the function to call, from any thread, on the first activity after arm_wakeup().
+  virtual void set_wakeup_handler(std::function<void()> handler) = 0;
+  virtual void arm_wakeup() = 0;
 };
 
 #endif // IACTIVITYMONITOR_HH
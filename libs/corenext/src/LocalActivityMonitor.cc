@@ -173,6 +173,22 @@ LocalActivityMonitor::set_listener(IActivityMonitorListener::Ptr l)
 }
 
 //! Activity is reported by the input monitor.
+void
+LocalActivityMonitor::set_wakeup_handler(std::function<void()> handler)
+{
+  wakeup_armed.store(false, std::memory_order_relaxed);
+  wakeup_handler = std::move(handler);
+}
+
+void
+LocalActivityMonitor::arm_wakeup()
+{
+  if (wakeup_handler)
+    {
+      wakeup_armed.store(true, std::memory_order_release);
+    }
+}
+
 void
 LocalActivityMonitor::action_notify()
 {
@@ -224,6 +240,11 @@ LocalActivityMonitor::action_notify()
   last_action_time = now;
   lock.unlock();
   call_listener();
+
+  if (wakeup_armed.load(std::memory_order_relaxed) && wakeup_armed.exchange(false, std::memory_order_acquire))
+    {
+      wakeup_handler();
+    }
 }
 
 //! Mouse activity is reported by the input monitor.
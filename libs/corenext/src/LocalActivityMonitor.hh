@@ -18,6 +18,8 @@
 #ifndef LOCALACTIVITYMONITOR_HH
 #define LOCALACTIVITYMONITOR_HH
 
+#include <atomic>
+#include <functional>
 #include <thread>
 #include <mutex>
 
@@ -45,6 +47,8 @@ public:
   void force_idle() override;
   bool is_active() override;
   void set_listener(IActivityMonitorListener::Ptr l) override;
+  void set_wakeup_handler(std::function<void()> handler) override;
+  void arm_wakeup() override;
 
   // IInputMonitorListener
   void action_notify() override;
@@ -116,6 +120,12 @@ private:
 
   //! Activity listener.
   IActivityMonitorListener::Ptr listener;
+
+  //! Called on the first activity after arm_wakeup().
+  std::function<void()> wakeup_handler;
+
+  //! Must the next activity call the wakeup handler?
+  std::atomic<bool> wakeup_armed{false};
 };
 
 #endif // LOCALACTIVITYMONITOR_HH
@@ -100,13 +100,36 @@ Statistics::init()
 
 //! Periodic heartbeat.
 void
+Statistics::heartbeat()
+{
+  // Live statistics are only maintained while someone is interested.
+  if (!current_day_changed_signal.empty() && current_day != nullptr)
+    {
+      refresh_current_day();
+      notify_current_day_changes();
+    }
+}
+
+//! Updates and saves the statistics of the current day.
+void
 Statistics::update()
 {
   TRACE_ENTRY();
-  if (monitor->is_active())
+  refresh_current_day();
+  save_day(current_day);
+  notify_current_day_changes();
+}
+
+//! Updates the statistics of the current day in memory.
+void
+Statistics::refresh_current_day()
+{
+  if (current_day != nullptr && monitor->is_active())
     {
       const time_t now = time(nullptr);
       struct tm *tmnow = localtime(&now);
+
+      lock.lock();
       current_day->stop = *tmnow;
 
       if (!been_active)
@@ -114,8 +137,66 @@ Statistics::update()
           current_day->start = *tmnow;
           been_active = true;
         }
+      lock.unlock();
     }
-  save_day(current_day);
+}
+
+//! Notifies the changes of the statistics of the current day since the previous notification.
+void
+Statistics::notify_current_day_changes(bool new_day)
+{
+  if (current_day == nullptr)
+    {
+      return;
+    }
+
+  // The input monitor updates the current day concurrently.
+  lock.lock();
+  DailyStats day = *current_day;
+  lock.unlock();
+
+  auto same_time = [](const struct tm &a, const struct tm &b) {
+    return a.tm_year == b.tm_year && a.tm_yday == b.tm_yday && a.tm_hour == b.tm_hour && a.tm_min == b.tm_min
+           && a.tm_sec == b.tm_sec;
+  };
+
+  DailyStatsChanges changes;
+  changes.new_day = new_day;
+  changes.period = !same_time(day.start, notified_day.start) || !same_time(day.stop, notified_day.stop);
+  bool changed = changes.new_day || changes.period;
+
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      for (int j = 0; j < STATS_BREAKVALUE_SIZEOF; j++)
+        {
+          if (day.break_stats[i][j] != notified_day.break_stats[i][j])
+            {
+              changes.break_stats[i] = true;
+              changed = true;
+            }
+        }
+    }
+
+  for (int j = 0; j < STATS_VALUE_SIZEOF; j++)
+    {
+      if (day.misc_stats[j] != notified_day.misc_stats[j])
+        {
+          changes.misc_stats[j] = true;
+          changed = true;
+        }
+    }
+
+  if (changed)
+    {
+      notified_day = day;
+      current_day_changed_signal(changes);
+    }
+}
+
+boost::signals2::signal<void(const IStatistics::DailyStatsChanges &)> &
+Statistics::signal_current_day_changed()
+{
+  return current_day_changed_signal;
 }
 
 bool
@@ -136,6 +217,7 @@ Statistics::delete_all_history()
         }
 
       history.clear();
+      rollup.clear();
     }
 
   std::filesystem::path todaypath = Paths::get_state_directory() / "todaystats";
@@ -163,6 +245,7 @@ Statistics::start_new_day()
   TRACE_ENTRY();
   const time_t now = time(nullptr);
   struct tm *tmnow = localtime(&now);
+  bool new_day = false;
 
   if (current_day == nullptr || tmnow->tm_mday != current_day->start.tm_mday || tmnow->tm_mon != current_day->start.tm_mon
       || tmnow->tm_year != current_day->start.tm_year)
@@ -177,13 +260,15 @@ Statistics::start_new_day()
 
       current_day = new DailyStatsImpl();
       been_active = false;
+      new_day = true;
 
       current_day->start = *tmnow;
       current_day->stop = *tmnow;
     }
 
-  update();
+  refresh_current_day();
   save_day(current_day);
+  notify_current_day_changes(new_day);
 }
 
 void
@@ -303,6 +388,22 @@ Statistics::add_history(DailyStatsImpl *stats)
           history.insert(history.begin(), stats);
         }
     }
+
+  if (!rollup.add(*stats))
+    {
+      rebuild_rollup();
+    }
+}
+
+//! Recomputes the totals of the history.
+void
+Statistics::rebuild_rollup()
+{
+  rollup.clear();
+  for (DailyStatsImpl *stats: history)
+    {
+      rollup.add(*stats);
+    }
 }
 
 //! Load the statistics of the current day.
@@ -608,6 +709,41 @@ Statistics::get_history_size() const
   return static_cast<int>(history.size());
 }
 
+void
+Statistics::get_totals(int from_y, int from_m, int from_d, int to_y, int to_m, int to_d, StatsTotals &totals) const
+{
+  int from_date = StatisticsRollup::to_date(from_y, from_m, from_d);
+  int to_date = StatisticsRollup::to_date(to_y, to_m, to_d);
+
+  rollup.get_totals(from_date, to_date, totals);
+
+  if (current_day != nullptr && !current_day->is_empty())
+    {
+      int date = StatisticsRollup::to_date(*current_day);
+      if (date >= from_date && date <= to_date)
+        {
+          StatisticsRollup::add(totals, *current_day);
+        }
+    }
+}
+
+void
+Statistics::get_period_totals(StatsPeriod period, int y, int m, int d, StatsTotals &totals) const
+{
+  int date = StatisticsRollup::to_date(y, m, d);
+
+  rollup.get_period_totals(period, date, totals);
+
+  if (current_day != nullptr && !current_day->is_empty())
+    {
+      int key = StatisticsRollup::get_period_key(period, StatisticsRollup::to_date(*current_day));
+      if (key == StatisticsRollup::get_period_key(period, date))
+        {
+          StatisticsRollup::add(totals, *current_day);
+        }
+    }
+}
+
 bool
 Statistics::DailyStatsImpl::starts_at_date(int y, int m, int d)
 {
@@ -35,6 +35,7 @@
 
 #include "core/IStatistics.hh"
 #include "IActivityMonitor.hh"
+#include "StatisticsRollup.hh"
 
 class Statistics
   : public workrave::IStatistics
@@ -105,7 +106,9 @@ public:
 
 public:
   void init();
+  void heartbeat();
   void update() override;
+  void refresh_current_day() override;
   void dump() override;
   void start_new_day();
 
@@ -118,9 +121,13 @@ public:
   void get_day_index_by_date(int y, int m, int d, int &idx, int &next, int &prev) const override;
 
   int get_history_size() const override;
+  void get_totals(int from_y, int from_m, int from_d, int to_y, int to_m, int to_d, StatsTotals &totals) const override;
+  void get_period_totals(StatsPeriod period, int y, int m, int d, StatsTotals &totals) const override;
   void set_counter(StatsValueType t, int value);
   int64_t get_counter(StatsValueType t);
 
+  boost::signals2::signal<void(const DailyStatsChanges &)> &signal_current_day_changed() override;
+
 private:
   void action_notify() override;
   void mouse_notify(int x, int y, int wheel = 0) override;
@@ -129,6 +136,7 @@ private:
 
   bool load_current_day();
   void load_history();
+  void notify_current_day_changes(bool new_day = false);
 
 private:
   void save_day(DailyStatsImpl *stats);
@@ -139,6 +147,7 @@ private:
   void day_to_remote_history(DailyStatsImpl *stats);
 
   void add_history(DailyStatsImpl *stats);
+  void rebuild_rollup();
 
 private:
   IActivityMonitor::Ptr monitor;
@@ -155,9 +164,17 @@ private:
   //! Has the user been active on the current day?
   bool been_active;
 
+  //! Statistics of the current day at the previous change notification.
+  DailyStats notified_day{};
+
+  boost::signals2::signal<void(const DailyStatsChanges &)> current_day_changed_signal;
+
   //! History
   History history;
 
+  //! Totals of the history
+  StatisticsRollup rollup;
+
   //! Internal locking
   std::mutex lock;
 
@@ -349,6 +349,101 @@ Timer::process(bool user_is_active)
   return event;
 }
 
+//! Returns whether process() would change the state of the timer or generate an event.
+bool
+Timer::is_processing_required(bool user_is_active) const
+{
+  int64_t current_time = TimeSource::get_monotonic_time_sec_sync();
+
+  if (timer_enabled && user_is_active != (timer_state == STATE_RUNNING))
+    {
+      return true;
+    }
+
+  return (daily_auto_reset && next_daily_reset_time != 0 && TimeSource::get_real_time_sec_sync() >= next_daily_reset_time)
+         || (next_limit_time != 0 && current_time >= next_limit_time) || (next_reset_time != 0 && current_time >= next_reset_time);
+}
+
+//! Returns the earliest monotonic time at which this timer generates an event, or 0 if no event is scheduled.
+int64_t
+Timer::get_next_event_time() const
+{
+  int64_t ret = 0;
+
+  auto consider = [&ret](int64_t t) {
+    if (t != 0 && (ret == 0 || t < ret))
+      {
+        ret = t;
+      }
+  };
+
+  if (daily_auto_reset && next_daily_reset_time != 0)
+    {
+      // The daily reset is scheduled in wall-clock time.
+      consider(next_daily_reset_time - TimeSource::get_real_time_sec_sync() + TimeSource::get_monotonic_time_sec_sync());
+    }
+  consider(next_limit_time);
+  consider(next_reset_time);
+
+  return ret;
+}
+
+//! Processes a period of constant activity in one go.
+/*!
+ *  Equivalent to calling process() with the same activity once per second
+ *  for duration seconds, starting at the current synchronized time.
+ *  Seconds in which process() would neither change the timer nor generate
+ *  an event are skipped by jumping to the next scheduled event. On return,
+ *  the synchronized time is at the end of the period.
+ *
+ *  Only the synchronized time is moved, using TimeSource::shift_sync(). The
+ *  caller must advance the underlying time source by the same duration,
+ *  otherwise the next TimeSource::sync() moves the time back.
+ *
+ *  \param user_is_active whether the user is active during the whole period.
+ *  \param duration length of the period in seconds.
+ *  \return the events generated during the period.
+ */
+std::vector<TimerAdvanceEvent>
+Timer::advance(bool user_is_active, int64_t duration)
+{
+  TRACE_ENTRY_PAR(user_is_active, duration);
+
+  std::vector<TimerAdvanceEvent> events;
+
+  int64_t current_time = TimeSource::get_monotonic_time_sec_sync();
+  int64_t end_time = current_time + duration;
+
+  while (current_time < end_time)
+    {
+      int64_t next_time = current_time + 1;
+
+      if (is_processing_required(user_is_active))
+        {
+          TimerEvent event = process(user_is_active);
+          if (event != TIMER_EVENT_NONE)
+            {
+              events.push_back({current_time, event});
+            }
+        }
+      else
+        {
+          // Nothing changes until the next event. It is in the future,
+          // otherwise processing would have been required.
+          next_time = get_next_event_time();
+          if (next_time == 0 || next_time > end_time)
+            {
+              next_time = end_time;
+            }
+        }
+
+      TimeSource::shift_sync((next_time - current_time) * TimeSource::TIME_USEC_PER_SEC);
+      current_time = next_time;
+    }
+
+  return events;
+}
+
 int64_t
 Timer::get_elapsed_time() const
 {
@@ -21,6 +21,7 @@
 #include <stdint.h>
 #include <memory>
 #include <string>
+#include <vector>
 
 class TimePred;
 
@@ -47,6 +48,16 @@ enum TimerEvent
   TIMER_EVENT_LIMIT_REACHED,
 };
 
+//! Event generated by Timer::advance.
+struct TimerAdvanceEvent
+{
+  //! Monotonic time at which the event was generated.
+  int64_t time;
+
+  //! Event the timer generated.
+  TimerEvent event;
+};
+
 //! The Timer class.
 /*!
  *  The Timer receives 'active' and 'idle' events from an activity monitor.
@@ -78,6 +89,9 @@ public:
 
   // Timer processing.
   TimerEvent process(bool user_is_active);
+  bool is_processing_required(bool user_is_active) const;
+  int64_t get_next_event_time() const;
+  std::vector<TimerAdvanceEvent> advance(bool user_is_active, int64_t duration);
 
   // State inquiry
   int64_t get_elapsed_time() const;
@@ -82,6 +82,17 @@ ActivityMonitorStub::set_listener(IActivityMonitorListener::Ptr l)
   listener = l;
 }
 
+void
+ActivityMonitorStub::set_wakeup_handler(std::function<void()> handler)
+{
+  (void)handler;
+}
+
+void
+ActivityMonitorStub::arm_wakeup()
+{
+}
+
 void
 ActivityMonitorStub::notify()
 {
@@ -40,6 +40,8 @@ public:
   void force_idle() override;
   bool is_active() override;
   void set_listener(IActivityMonitorListener::Ptr l) override;
+  void set_wakeup_handler(std::function<void()> handler) override;
+  void arm_wakeup() override;
 
   void notify();
 
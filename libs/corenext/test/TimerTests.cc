@@ -25,6 +25,9 @@
 #include <boost/signals2.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <random>
+#include <sstream>
+
 #include "utils/ITimeSource.hh"
 #include "utils/TimeSource.hh"
 
@@ -61,6 +64,27 @@ public:
   int64_t next{0};
 };
 
+class PeriodicTimePred : public TimePred
+{
+public:
+  explicit PeriodicTimePred(int64_t period)
+    : period(period)
+  {
+  }
+
+  time_t get_next(time_t last_time)
+  {
+    return last_time - (last_time % period) + period;
+  }
+
+  std::string to_string() const
+  {
+    return "periodic";
+  }
+
+  int64_t period;
+};
+
 class Fixture
 {
 public:
@@ -154,6 +178,19 @@ public:
       }
   }
 
+  std::vector<TimerAdvanceEvent> advance(bool active, int seconds)
+  {
+    TimeSource::sync();
+    std::vector<TimerAdvanceEvent> events = timer->advance(active, seconds);
+    sim->current_time += seconds * 1000000LL;
+    return events;
+  }
+
+  void tick(bool active, int seconds)
+  {
+    advance(active, seconds);
+  }
+
   SimulatedTime::Ptr sim;
   Timer::Ptr timer;
 };
@@ -2123,4 +2160,106 @@ BOOST_AUTO_TEST_CASE(test_timer_serialize)
   BOOST_REQUIRE_EQUAL(s1, s2);
 }
 
+BOOST_AUTO_TEST_CASE(test_timer_advance_matches_process)
+{
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> duration_dist(1, 400);
+  std::vector<std::pair<bool, int>> segments;
+  for (int i = 0; i < 200; i++)
+    {
+      segments.emplace_back(gen() % 2 == 0, duration_dist(gen));
+    }
+
+  auto get_state = [this]() {
+    std::stringstream ss;
+    ss << timer->get_elapsed_time() << " " << timer->get_elapsed_idle_time() << " " << timer->get_total_overdue_time() << " "
+       << timer->is_running() << " " << timer->get_next_event_time() << " " << timer->serialize_state();
+    return ss.str();
+  };
+
+  std::vector<TimerAdvanceEvent> expected_events;
+  std::vector<std::string> expected_states;
+
+  init();
+  timer->set_daily_reset(new PeriodicTimePred(3600));
+  for (auto [active, seconds]: segments)
+    {
+      for (int i = 0; i < seconds; i++)
+        {
+          TimeSource::sync();
+          TimerEvent event = timer->process(active);
+          if (event != TIMER_EVENT_NONE)
+            {
+              expected_events.push_back({TimeSource::get_monotonic_time_sec_sync(), event});
+            }
+          sim->current_time += 1000000;
+        }
+      TimeSource::sync();
+      expected_states.push_back(get_state());
+    }
+
+  init();
+  timer->set_daily_reset(new PeriodicTimePred(3600));
+  std::vector<TimerAdvanceEvent> events;
+  for (size_t i = 0; i < segments.size(); i++)
+    {
+      auto [active, seconds] = segments[i];
+      auto segment_events = advance(active, seconds);
+      events.insert(events.end(), segment_events.begin(), segment_events.end());
+
+      TimeSource::sync();
+      BOOST_REQUIRE_EQUAL(get_state(), expected_states[i]);
+    }
+
+  BOOST_REQUIRE_EQUAL(events.size(), expected_events.size());
+  for (size_t i = 0; i < events.size(); i++)
+    {
+      BOOST_REQUIRE_EQUAL(events[i].time, expected_events[i].time);
+      BOOST_REQUIRE_EQUAL(events[i].event, expected_events[i].event);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_working_week)
+{
+  init();
+
+  for (int day = 0; day < 5; day++)
+    {
+      tick(true, 8 * 3600);
+      TimeSource::sync();
+      BOOST_REQUIRE_EQUAL(timer->get_elapsed_time(), 8 * 3600);
+      BOOST_REQUIRE_EQUAL(timer->get_elapsed_idle_time(), 0);
+      BOOST_REQUIRE_EQUAL(timer->get_total_overdue_time(), (day + 1) * (8 * 3600 - 100));
+
+      tick(false, 16 * 3600);
+      TimeSource::sync();
+      BOOST_REQUIRE_EQUAL(timer->get_elapsed_time(), 0);
+      BOOST_REQUIRE_EQUAL(timer->get_total_overdue_time(), (day + 1) * (8 * 3600 - 100));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_timer_advance_long_period)
+{
+  init();
+
+  int64_t start = TimeSource::get_monotonic_time_sec_sync();
+
+  auto events = advance(true, 7 * 24 * 3600);
+  BOOST_REQUIRE_EQUAL(events.size(), 1 + (7 * 24 * 3600 - 100 - 1) / 50);
+  BOOST_REQUIRE_EQUAL(events[0].time, start + 100);
+  BOOST_REQUIRE_EQUAL(events[0].event, TIMER_EVENT_LIMIT_REACHED);
+  BOOST_REQUIRE_EQUAL(events[1].time, start + 150);
+
+  TimeSource::sync();
+  BOOST_REQUIRE_EQUAL(timer->get_elapsed_time(), 7 * 24 * 3600);
+
+  events = advance(false, 7 * 24 * 3600);
+  BOOST_REQUIRE_EQUAL(events.size(), 1);
+  BOOST_REQUIRE_EQUAL(events[0].time, start + 7 * 24 * 3600 + 20);
+  BOOST_REQUIRE_EQUAL(events[0].event, TIMER_EVENT_RESET);
+
+  TimeSource::sync();
+  BOOST_REQUIRE_EQUAL(timer->get_elapsed_time(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,7 @@
 #ifndef WORKRAVE_INPUT_MONITOR_IINPUTMONITOR_HH
 #define WORKRAVE_INPUT_MONITOR_IINPUTMONITOR_HH
 
+#include <cstdint>
 #include <memory>
 
 namespace workrave
@@ -45,6 +46,24 @@ namespace workrave
 
       //! Unsubscribe for activity monitor.
       virtual void unsubscribe(IInputMonitorListener *listener) = 0;
+
+      //! Sets the minimum interval in milliseconds between coalesced mouse movement notifications.
+      virtual void set_coalesce_interval(int interval)
+      {
+        (void)interval;
+      }
+
+      //! Delivers coalesced mouse movement that is still pending. May be called from any thread.
+      virtual void flush()
+      {
+      }
+
+      //! Returns the number of events received from the system and the number of notifications delivered to listeners.
+      virtual void get_event_counts(int64_t &received, int64_t &delivered) const
+      {
+        received = 0;
+        delivered = 0;
+      }
     };
   } // namespace input_monitor
 } // namespace workrave
@@ -39,6 +39,12 @@ namespace workrave
 
       //! Reports keyboard activity
       virtual void keyboard_notify(bool repeat) = 0;
+
+      //! Returns whether bursts of mouse movement may be reported as a single notification.
+      virtual bool is_coalescing_allowed() const
+      {
+        return false;
+      }
     };
   } // namespace input_monitor
 } // namespace workrave
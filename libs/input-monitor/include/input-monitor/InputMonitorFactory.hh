@@ -35,6 +35,9 @@ namespace workrave
 
     private:
       static workrave::input_monitor::IInputMonitorFactory *factory;
+
+      //! Minimum interval in milliseconds between coalesced mouse notifications.
+      static int coalesce_interval;
     };
   } // namespace input_monitor
 } // namespace workrave
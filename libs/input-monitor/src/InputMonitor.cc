@@ -21,52 +21,137 @@
 
 #include "InputMonitor.hh"
 
+#include "utils/TimeSource.hh"
+
 using namespace workrave::input_monitor;
+using namespace workrave::utils;
 
 void
 InputMonitor::subscribe(IInputMonitorListener *listener)
 {
+  std::scoped_lock lock(mutex);
   listeners.push_back(listener);
 }
 
 void
 InputMonitor::unsubscribe(IInputMonitorListener *listener)
 {
+  std::scoped_lock lock(mutex);
   listeners.remove(listener);
 }
 
+//! Delivers pending coalesced mouse movement from the calling thread.
+void
+InputMonitor::flush()
+{
+  std::scoped_lock lock(mutex);
+  flush_mouse();
+}
+
+//! Sets the minimum interval in milliseconds between coalesced mouse notifications.
+void
+InputMonitor::set_coalesce_interval(int interval)
+{
+  coalesce_interval = static_cast<int64_t>(interval) * 1000;
+}
+
+//! Returns the number of received events and delivered notifications.
+void
+InputMonitor::get_event_counts(int64_t &received, int64_t &delivered) const
+{
+  received = received_events;
+  delivered = delivered_events;
+}
+
 void
 InputMonitor::fire_action()
 {
+  std::scoped_lock lock(mutex);
+  received_events++;
+  flush_mouse();
+
   for (auto &l: listeners)
     {
       l->action_notify();
+      delivered_events++;
     }
 }
 
 void
 InputMonitor::fire_mouse(int x, int y, int wheel)
 {
+  std::scoped_lock lock(mutex);
+  received_events++;
+
+  int64_t now = TimeSource::get_monotonic_time_usec();
+  bool coalesce = wheel == 0 && now - last_mouse_time < coalesce_interval;
+
   for (auto &l: listeners)
     {
-      l->mouse_notify(x, y, wheel);
+      if (!coalesce || !l->is_coalescing_allowed())
+        {
+          l->mouse_notify(x, y, wheel);
+          delivered_events++;
+        }
+    }
+
+  if (coalesce)
+    {
+      mouse_pending = true;
+      pending_x = x;
+      pending_y = y;
+    }
+  else
+    {
+      mouse_pending = false;
+      last_mouse_time = now;
     }
 }
 
 void
 InputMonitor::fire_button(bool is_press)
 {
+  std::scoped_lock lock(mutex);
+  received_events++;
+  flush_mouse();
+
   for (auto &l: listeners)
     {
       l->button_notify(is_press);
+      delivered_events++;
     }
 }
 
 void
 InputMonitor::fire_keyboard(bool repeat)
 {
+  std::scoped_lock lock(mutex);
+  received_events++;
+  flush_mouse();
+
   for (auto &l: listeners)
     {
       l->keyboard_notify(repeat);
+      delivered_events++;
+    }
+}
+
+//! Delivers pending coalesced mouse movement.
+void
+InputMonitor::flush_mouse()
+{
+  if (mouse_pending)
+    {
+      mouse_pending = false;
+      last_mouse_time = TimeSource::get_monotonic_time_usec();
+
+      for (auto &l: listeners)
+        {
+          if (l->is_coalescing_allowed())
+            {
+              l->mouse_notify(pending_x, pending_y, 0);
+              delivered_events++;
+            }
+        }
     }
 }
@@ -18,17 +18,29 @@
 #ifndef INPUTMONITOR_HH
 #define INPUTMONITOR_HH
 
+#include <atomic>
 #include <list>
+#include <mutex>
 
 #include "input-monitor/IInputMonitor.hh"
 #include "input-monitor/IInputMonitorListener.hh"
 
 //!  Base for activity monitors.
+/*!
+ *  Mouse movement is coalesced for listeners that allow it: during a burst
+ *  of movement these listeners receive at most one notification per
+ *  coalesce interval. Pending movement is delivered before any other event,
+ *  or when the consumer calls flush(). Listeners are only called with the
+ *  mutex held, so they never receive events from two threads at once.
+ */
 class InputMonitor : public workrave::input_monitor::IInputMonitor
 {
 public:
   void subscribe(workrave::input_monitor::IInputMonitorListener *listener) override;
   void unsubscribe(workrave::input_monitor::IInputMonitorListener *listener) override;
+  void set_coalesce_interval(int interval) override;
+  void get_event_counts(int64_t &received, int64_t &delivered) const override;
+  void flush() override;
 
 protected:
   void fire_action();
@@ -36,8 +48,33 @@ protected:
   void fire_button(bool is_press);
   void fire_keyboard(bool repeat);
 
+private:
+  void flush_mouse();
+
 private:
   std::list<workrave::input_monitor::IInputMonitorListener *> listeners;
+
+  //! Serializes the notifications to the listeners. Only contended when flushing.
+  std::mutex mutex;
+
+  //! Minimum interval between coalesced mouse notifications in microseconds.
+  std::atomic<int64_t> coalesce_interval{0};
+
+  //! Time of the last coalesced mouse notification.
+  int64_t last_mouse_time{0};
+
+  //! Is a coalesced mouse movement pending?
+  bool mouse_pending{false};
+
+  //! Position of the pending mouse movement.
+  int pending_x{0};
+  int pending_y{0};
+
+  //! Number of events received from the system.
+  std::atomic<int64_t> received_events{0};
+
+  //! Number of notifications delivered to listeners.
+  std::atomic<int64_t> delivered_events{0};
 };
 
 #endif // INPUTMONITOR_HH
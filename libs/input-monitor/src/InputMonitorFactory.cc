@@ -32,6 +32,7 @@ using namespace workrave::config;
 using namespace workrave::input_monitor;
 
 workrave::input_monitor::IInputMonitorFactory *workrave::input_monitor::InputMonitorFactory::factory = nullptr;
+int workrave::input_monitor::InputMonitorFactory::coalesce_interval = 0;
 
 void
 InputMonitorFactory::init(IConfigurator::Ptr config, const char *display)
@@ -47,6 +48,8 @@ InputMonitorFactory::init(IConfigurator::Ptr config, const char *display)
 #endif
     }
 
+  config->get_value_with_default("advanced/coalesce_interval", coalesce_interval, 50);
+
   if (factory != nullptr)
     {
       factory->init(display);
@@ -58,7 +61,12 @@ InputMonitorFactory::create_monitor(MonitorCapability capability)
 {
   if (factory != nullptr)
     {
-      return factory->create_monitor(capability);
+      IInputMonitor::Ptr monitor = factory->create_monitor(capability);
+      if (monitor != nullptr)
+        {
+          monitor->set_coalesce_interval(coalesce_interval);
+        }
+      return monitor;
     }
 
   return IInputMonitor::Ptr();
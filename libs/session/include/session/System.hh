@@ -22,8 +22,15 @@
 #  include <glib.h>
 #endif
 
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include <boost/signals2.hpp>
+
 #if defined(HAVE_DBUS_GIO)
 #  include <glib.h>
 #  include <gio/gio.h>
@@ -71,10 +78,7 @@ public:
     friend class System;
   };
 
-  static bool is_lockable()
-  {
-    return !lock_commands.empty();
-  }
+  static bool is_lockable();
   static bool lock_screen();
 
   static std::vector<SystemOperation> get_supported_system_operations()
@@ -83,6 +87,13 @@ public:
   }
   static bool execute(SystemOperation::SystemOperationType type);
 
+  //! Emitted when the supported system operations changed.
+  /*!
+   *  D-Bus services are discovered in the background, so the supported
+   *  system operations may change some time after init().
+   */
+  static boost::signals2::signal<void()> &signal_system_operations_changed();
+
   // display will not be owned by System,
   // the caller may free it after calling
   // this function
@@ -90,25 +101,46 @@ public:
   static void clear();
 
 private:
+  static void update_supported_system_operations();
+
   static std::vector<IScreenLockMethod *> lock_commands;
   static std::vector<ISystemStateChangeMethod *> system_state_commands;
   static std::vector<SystemOperation> supported_system_operations;
 #if defined(PLATFORM_OS_UNIX)
 
 #  ifdef HAVE_DBUS_GIO
-  static void init_DBus();
-  static void init_DBus_lock_commands();
-  static inline bool add_DBus_lock_cmd(const char *dbus_name,
-                                       const char *dbus_path,
-                                       const char *dbus_interface,
-                                       const char *dbus_lock_method,
-                                       const char *dbus_method_to_check_existence);
+  struct DBusDiscovery;
 
-  static void add_DBus_system_state_command(ISystemStateChangeMethod *method);
-  static void init_DBus_system_state_commands();
+  static void init_DBus();
+  static void init_DBus_name_watches();
+  static void start_DBus_discovery();
+  static void run_DBus_discovery(std::shared_ptr<DBusDiscovery> discovery);
+  static gboolean on_DBus_discovery_done(gpointer data);
+  static gboolean on_DBus_discovery_retry(gpointer data);
 
   static GDBusConnection *session_connection;
   static GDBusConnection *system_connection;
+
+  //! Screen lock methods found on the session bus. These are tried before the command line methods.
+  static std::vector<IScreenLockMethod *> dbus_lock_commands;
+
+  //! Names of the known services that were owned during the last complete discovery.
+  static std::set<std::string> dbus_owned_names;
+
+  static std::vector<guint> dbus_name_watches;
+  static bool dbus_discovery_running;
+  static bool dbus_discovery_pending;
+
+  //! Incremented by clear() to discard the result of a running discovery.
+  static uint64_t dbus_discovery_generation;
+
+  //! The running discovery, cancelled by clear().
+  static std::shared_ptr<DBusDiscovery> dbus_discovery;
+  static std::thread dbus_discovery_thread;
+
+  //! Timer that retries a discovery that timed out, and the current retry delay.
+  static guint dbus_discovery_retry_source;
+  static int dbus_discovery_retry_msec;
 #  endif
 
   static inline void add_cmdline_lock_cmd(const char *command_name, const char *parameters, bool async);
@@ -31,12 +31,14 @@ ScreenLockDBus::ScreenLockDBus(GDBusConnection *connection,
                                const char *dbus_path,
                                const char *dbus_interface,
                                const char *dbus_lock_method,
-                               const char *dbus_method_to_check_existence)
+                               const char *dbus_method_to_check_existence,
+                               GCancellable *cancellable)
   : dbus_lock_method(dbus_lock_method)
 {
   TRACE_ENTRY_PAR(dbus_name);
 
   // We do not allow autospawning services
+  proxy.set_cancellable(cancellable);
   bool r = proxy.init_with_connection(connection,
                                       dbus_name,
                                       dbus_path,
@@ -47,12 +49,15 @@ ScreenLockDBus::ScreenLockDBus(GDBusConnection *connection,
 
   if (r && dbus_method_to_check_existence != nullptr)
     {
-      r = proxy.call_method(dbus_method_to_check_existence, nullptr, nullptr);
+      r = proxy.call_method(dbus_method_to_check_existence, nullptr, nullptr, DBusProxy::PROBE_TIMEOUT_MSEC);
     }
   if (!r)
     {
       proxy.clear();
     }
+
+  // Only the probe can be cancelled, not locking the screen.
+  proxy.set_cancellable(nullptr);
 }
 
 bool
@@ -36,7 +36,8 @@ public:
                  const char *dbus_path,
                  const char *dbus_interface,
                  const char *dbus_lock_method,
-                 const char *dbus_method_to_check_existence);
+                 const char *dbus_method_to_check_existence,
+                 GCancellable *cancellable = nullptr);
 
   ~ScreenLockDBus() override = default;
 
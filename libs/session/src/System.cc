@@ -42,6 +42,15 @@
 #include <algorithm>
 #include <iostream>
 
+#if defined(PLATFORM_OS_UNIX) && defined(HAVE_DBUS_GIO)
+#  include <chrono>
+#  include <condition_variable>
+#  include <mutex>
+#  include <thread>
+
+#  include "utils/DBusProxy-gio.hh"
+#endif
+
 #if defined(HAVE_STRINGS_H)
 #  include <strings.h>
 #endif
@@ -73,8 +82,42 @@ std::vector<System::SystemOperation> System::supported_system_operations;
 #if defined(PLATFORM_OS_UNIX) && defined(HAVE_DBUS_GIO)
 GDBusConnection *System::session_connection = nullptr;
 GDBusConnection *System::system_connection = nullptr;
+std::vector<IScreenLockMethod *> System::dbus_lock_commands;
+std::set<std::string> System::dbus_owned_names;
+std::vector<guint> System::dbus_name_watches;
+bool System::dbus_discovery_running = false;
+bool System::dbus_discovery_pending = false;
+uint64_t System::dbus_discovery_generation = 0;
+std::shared_ptr<System::DBusDiscovery> System::dbus_discovery;
+std::thread System::dbus_discovery_thread;
+guint System::dbus_discovery_retry_source = 0;
+int System::dbus_discovery_retry_msec = 0;
 #endif
 
+//! Signal emitted when the supported system operations changed.
+/*!
+ *  Services are discovered in the background, and may appear or disappear
+ *  while Workrave is running.
+ */
+boost::signals2::signal<void()> &
+System::signal_system_operations_changed()
+{
+  static boost::signals2::signal<void()> signal;
+  return signal;
+}
+
+bool
+System::is_lockable()
+{
+#if defined(PLATFORM_OS_UNIX) && defined(HAVE_DBUS_GIO)
+  if (!dbus_lock_commands.empty())
+    {
+      return true;
+    }
+#endif
+  return !lock_commands.empty();
+}
+
 #if defined(PLATFORM_OS_UNIX)
 #  if defined(HAVE_DBUS_GIO)
 void
@@ -100,153 +143,503 @@ System::init_DBus()
     }
 }
 
-bool
-System::add_DBus_lock_cmd(const char *dbus_name,
-                          const char *dbus_path,
-                          const char *dbus_interface,
-                          const char *dbus_lock_method,
-                          const char *dbus_method_to_check_existence)
+namespace
 {
-  TRACE_ENTRY_PAR(dbus_name);
+  //! Maximum time the discovery of D-Bus services may take.
+  constexpr int DBUS_DISCOVERY_TIMEOUT_MSEC = 3000;
+
+  //! Delay before the first retry of a discovery that timed out. The delay doubles on each retry.
+  constexpr int DBUS_DISCOVERY_RETRY_MIN_MSEC = 5000;
+
+  //! Maximum delay between retries of a discovery that timed out.
+  constexpr int DBUS_DISCOVERY_RETRY_MAX_MSEC = 300000;
+
+  struct DBusLockService
+  {
+    const char *name;
+    const char *path;
+    const char *interface;
+    const char *lock_method;
+    const char *method_to_check_existence;
+  };
+
+  // Screen lock services on the session bus, in order of preference.
+  const DBusLockService dbus_lock_services[] = {
+    //  Unity:
+    //    - Gnome screensaver API + gnome-screensaver-command works,
+    //    - is going to decrease dependence and use of GNOME:
+    //      https://blueprints.launchpad.net/unity/+spec/client-1311-unity7-lockscreen
+    //  GNOME
+    //      https://people.gnome.org/~mccann/gnome-screensaver/docs/gnome-screensaver.html#gs-method-GetSessionIdle
+    //    - Gnome is now implementing the Freedesktop API, but incompletely:
+    //      https://bugzilla.gnome.org/show_bug.cgi?id=689225
+    //      (look for "unimplemented" in the patch), the lock method is still unipmlemented
+    //    - therefore it is required to check the gnome API first.
+    // WORKS: Ubuntu 12.04: GNOME 3 fallback, Unity
+    {"org.gnome.ScreenSaver", "/org/gnome/ScreenSaver", "org.gnome.ScreenSaver", "Lock", "GetActive"},
+
+    //  Cinnamon:   https://github.com/linuxmint/cinnamon-screensaver/blob/master/doc/dbus-interface.html
+    //    Same api as GNOME, but with different name,
+    {"org.cinnamon.ScreenSaver", "/org/cinnamon/ScreenSaver", "org.cinnamon.ScreenSaver", "Lock", "GetActive"},
+
+    //  Mate: https://github.com/mate-desktop/mate-screensaver/blob/master/doc/dbus-interface.xml
+    //  Like GNOME
+    {"org.mate.ScreenSaver", "/org/mate/ScreenSaver", "org.mate.ScreenSaver", "Lock", "GetActive"},
+
+    // The FreeDesktop API - the most important and most widely supported
+    //    LXDE:  https://github.com/lxde/lxqt-powermanagement/blob/master/idleness/idlenesswatcherd.cpp
+    //    KDE:
+    //      https://projects.kde.org/projects/kde/kde-workspace/repository/revisions/master/entry/ksmserver/screenlocker/dbus/org.freedesktop.ScreenSaver.xml
+    //      - there have been claims that this does not work in some installations, but I was unable to find
+    //      any traces of this in git:
+    //                        http://forum.kde.org/viewtopic.php?f=67&t=111003
+    //                      It was probably due to some upgrade problems (and/or a bug in KDE),
+    //                      because in fresh OpenSuse 12.3 (from LiveCD) this works correctly.
+    //    Razor-QT: https://github.com/Razor-qt/razor-qt/blob/master/razorqt-screenlocker/src/razorscreenlocker.cpp
+    //
+    //    The Freedesktop API that these DEs are implementing is being redrafted:
+    //      http://people.freedesktop.org/~hadess/idle-inhibition-spec/
+    //      http://lists.freedesktop.org/pipermail/xdg/2012-November/012577.html
+    //      http://lists.freedesktop.org/pipermail/xdg/2013-September/012875.html
+    //
+    //    the Lock method there is being removed (and not replaced with anything else).
+    //    Probably the DEs will support these APIs in the future in order not to break other software.
+
+    // Is only partially implemented by GNOME, so GNOME has to go before
+    // Works correctly on KDE4 (Ubuntu 12.04)
+    {"org.freedesktop.ScreenSaver", "/ScreenSaver", "org.freedesktop.ScreenSaver", "Lock", "GetActive"},
+
+    //  KDE - old screensaver API - partially verified both
+    {"org.kde.screensaver", "/ScreenSaver", "org.freedesktop.ScreenSaver", "Lock", "GetActive"},
+    {"org.kde.krunner", "/ScreenSaver", "org.freedesktop.ScreenSaver", "Lock", "GetActive"},
+
+    //              - there some accounts that when org.freedesktop.ScreenSaver does not work, this works:
+    //                      qdbus org.kde.ksmserver /ScreenSaver Lock
+    //                      but it is probably a side effect of the fact that implementation of org.kde.ksmserver
+    //                      is in the same process as of org.freedesktop.ScreenSaver
+    {"org.kde.ksmserver", "/ScreenSaver", "org.freedesktop.ScreenSaver", "Lock", "GetActive"},
+
+    // EFL:
+    {"org.enlightenment.wm.service", "/org/enlightenment/wm/RemoteObject", "org.enlightenment.wm.Desktop", "Lock", nullptr},
+  };
+
+  struct DBusSystemStateService
+  {
+    const char *name;
+    ISystemStateChangeMethod *(*create)(GDBusConnection *connection, GCancellable *cancellable);
+  };
+
+  // System state services on the system bus, in order of preference.
+  //
+  // These three DBus interfaces are too diverse to implement support for
+  // them in one class.
+  //
+  // Other interfaces:
+  //  GNOME:
+  //    - there is GNOME Session API:
+  //      https://git.gnome.org/browse/gnome-session/tree/gnome-session/org.gnome.SessionManager.xml
+  //      But shutdown/reboot require confirmation, so this is unusable to us,
+  //
+  //  KDE:
+  //    - there is some support, but probably not worth implementing it
+  //    http://askubuntu.com/questions/1871/how-can-i-safely-shutdown-reboot-logout-kde-from-the-command-line
+  const DBusSystemStateService dbus_system_state_services[] = {
+    // Logind is the future so it goes first
+    {"org.freedesktop.login1",
+     [](GDBusConnection *connection, GCancellable *cancellable) -> ISystemStateChangeMethod * {
+       return new SystemStateChangeLogind(connection, cancellable);
+     }},
+    {"org.freedesktop.UPower",
+     [](GDBusConnection *connection, GCancellable *cancellable) -> ISystemStateChangeMethod * {
+       return new SystemStateChangeUPower(connection, cancellable);
+     }},
+    // ConsoleKit is deprecated so goes last
+    {"org.freedesktop.ConsoleKit",
+     [](GDBusConnection *connection, GCancellable *cancellable) -> ISystemStateChangeMethod * {
+       return new SystemStateChangeConsolekit(connection, cancellable);
+     }},
+  };
+
+  constexpr std::size_t NUM_DBUS_LOCK_SERVICES = sizeof(dbus_lock_services) / sizeof(dbus_lock_services[0]);
+  constexpr std::size_t NUM_DBUS_SYSTEM_STATE_SERVICES = sizeof(dbus_system_state_services) / sizeof(dbus_system_state_services[0]);
+
+  //! Adds the names owned on the bus that are in candidates.
+  void
+  add_owned_names(GDBusConnection *connection,
+                  GCancellable *cancellable,
+                  const std::set<std::string> &candidates,
+                  std::set<std::string> &owned_names)
+  {
+    TRACE_ENTRY();
+    GError *error = nullptr;
+    GVariant *result = g_dbus_connection_call_sync(connection,
+                                                   "org.freedesktop.DBus",
+                                                   "/org/freedesktop/DBus",
+                                                   "org.freedesktop.DBus",
+                                                   "ListNames",
+                                                   nullptr,
+                                                   G_VARIANT_TYPE("(as)"),
+                                                   G_DBUS_CALL_FLAGS_NONE,
+                                                   DBusProxy::PROBE_TIMEOUT_MSEC,
+                                                   cancellable,
+                                                   &error);
+    if (error != nullptr)
+      {
+        TRACE_MSG("ListNames failed: {}", error->message);
+        g_error_free(error);
+        return;
+      }
+
+    GVariantIter *iter = nullptr;
+    const gchar *name = nullptr;
+    g_variant_get(result, "(as)", &iter);
+    while (g_variant_iter_loop(iter, "&s", &name))
+      {
+        if (candidates.find(name) != candidates.end())
+          {
+            owned_names.insert(name);
+          }
+      }
+    g_variant_iter_free(iter);
+    g_variant_unref(result);
+  }
+} // namespace
+
+//! State of a discovery of D-Bus services, shared by the discovery threads and the main loop.
+struct System::DBusDiscovery
+{
+  DBusDiscovery(uint64_t generation, std::set<std::string> previous_owned_names)
+    : generation(generation)
+    , previous_owned_names(std::move(previous_owned_names))
+    , lock_commands(NUM_DBUS_LOCK_SERVICES, nullptr)
+    , system_state_commands(NUM_DBUS_SYSTEM_STATE_SERVICES, nullptr)
+    , cancellable(g_cancellable_new())
+  {
+    if (System::session_connection != nullptr)
+      {
+        session_connection = G_DBUS_CONNECTION(g_object_ref(System::session_connection));
+      }
+    if (System::system_connection != nullptr)
+      {
+        system_connection = G_DBUS_CONNECTION(g_object_ref(System::system_connection));
+      }
+  }
+
+  ~DBusDiscovery()
+  {
+    for (auto *command: lock_commands)
+      {
+        delete command;
+      }
+    for (auto *command: system_state_commands)
+      {
+        delete command;
+      }
+    g_clear_object(&session_connection);
+    g_clear_object(&system_connection);
+    g_clear_object(&cancellable);
+  }
+
+  DBusDiscovery(const DBusDiscovery &) = delete;
+  DBusDiscovery &operator=(const DBusDiscovery &) = delete;
+
+  uint64_t generation;
+  GDBusConnection *session_connection{nullptr};
+  GDBusConnection *system_connection{nullptr};
+
+  //! Owned names of the previous discovery. Services are only probed if these changed.
+  std::set<std::string> previous_owned_names;
+  std::set<std::string> owned_names;
+
+  //! Whether the owned names changed and the services were probed.
+  bool changed{false};
+
+  //! Whether all services were probed before the timeout.
+  bool complete{true};
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  int remaining{0};
+
+  //! Supported methods, in order of preference. Unsupported or unprobed services are nullptr.
+  std::vector<IScreenLockMethod *> lock_commands;
+  std::vector<ISystemStateChangeMethod *> system_state_commands;
+
+  //! Cancels the probes on timeout, and the whole discovery on clear().
+  GCancellable *cancellable{nullptr};
+
+  //! Threads probing the services. Joined before the result is reported.
+  std::vector<std::thread> probes;
+};
 
-  // I wish we could use std::move here
-  IScreenLockMethod *lock_method = nullptr;
-  lock_method =
-    new ScreenLockDBus(session_connection, dbus_name, dbus_path, dbus_interface, dbus_lock_method, dbus_method_to_check_existence);
-  if (!lock_method->is_lock_supported())
+void
+System::init_DBus_name_watches()
+{
+  TRACE_ENTRY();
+  auto on_appeared = [](GDBusConnection *, const gchar *, const gchar *, gpointer) { start_DBus_discovery(); };
+  auto on_vanished = [](GDBusConnection *, const gchar *, gpointer) { start_DBus_discovery(); };
+
+  if (session_connection != nullptr)
     {
-      delete lock_method;
-      lock_method = nullptr;
-      TRACE_VAR(false);
-      return false;
+      for (const auto &service: dbus_lock_services)
+        {
+          dbus_name_watches.push_back(g_bus_watch_name_on_connection(
+            session_connection, service.name, G_BUS_NAME_WATCHER_FLAGS_NONE, on_appeared, on_vanished, nullptr, nullptr));
+        }
     }
-  else
+
+  if (system_connection != nullptr)
     {
-      lock_commands.push_back(lock_method);
-      TRACE_VAR(true);
-      return true;
+      for (const auto &service: dbus_system_state_services)
+        {
+          dbus_name_watches.push_back(g_bus_watch_name_on_connection(
+            system_connection, service.name, G_BUS_NAME_WATCHER_FLAGS_NONE, on_appeared, on_vanished, nullptr, nullptr));
+        }
     }
 }
 
+//! Discovers the D-Bus services in the background.
+/*!
+ *  Only one discovery runs at a time. A request while a discovery is running
+ *  starts a new discovery when the running one is done.
+ */
 void
-System::init_DBus_lock_commands()
+System::start_DBus_discovery()
 {
   TRACE_ENTRY();
-  if (session_connection)
-    {
-      //  Unity:
-      //    - Gnome screensaver API + gnome-screensaver-command works,
-      //    - is going to decrease dependence and use of GNOME:
-      //      https://blueprints.launchpad.net/unity/+spec/client-1311-unity7-lockscreen
-      //  GNOME
-      //      https://people.gnome.org/~mccann/gnome-screensaver/docs/gnome-screensaver.html#gs-method-GetSessionIdle
-      //    - Gnome is now implementing the Freedesktop API, but incompletely:
-      //      https://bugzilla.gnome.org/show_bug.cgi?id=689225
-      //      (look for "unimplemented" in the patch), the lock method is still unipmlemented
-      //    - therefore it is required to check the gnome API first.
-      // WORKS: Ubuntu 12.04: GNOME 3 fallback, Unity
-      add_DBus_lock_cmd("org.gnome.ScreenSaver", "/org/gnome/ScreenSaver", "org.gnome.ScreenSaver", "Lock", "GetActive");
-
-      //  Cinnamon:   https://github.com/linuxmint/cinnamon-screensaver/blob/master/doc/dbus-interface.html
-      //    Same api as GNOME, but with different name,
-      add_DBus_lock_cmd("org.cinnamon.ScreenSaver", "/org/cinnamon/ScreenSaver", "org.cinnamon.ScreenSaver", "Lock", "GetActive");
-
-      //  Mate: https://github.com/mate-desktop/mate-screensaver/blob/master/doc/dbus-interface.xml
-      //  Like GNOME
-      add_DBus_lock_cmd("org.mate.ScreenSaver", "/org/mate/ScreenSaver", "org.mate.ScreenSaver", "Lock", "GetActive");
-
-      // The FreeDesktop API - the most important and most widely supported
-      //    LXDE:  https://github.com/lxde/lxqt-powermanagement/blob/master/idleness/idlenesswatcherd.cpp
-      //    KDE:
-      //      https://projects.kde.org/projects/kde/kde-workspace/repository/revisions/master/entry/ksmserver/screenlocker/dbus/org.freedesktop.ScreenSaver.xml
-      //      - there have been claims that this does not work in some installations, but I was unable to find
-      //      any traces of this in git:
-      //                        http://forum.kde.org/viewtopic.php?f=67&t=111003
-      //                      It was probably due to some upgrade problems (and/or a bug in KDE),
-      //                      because in fresh OpenSuse 12.3 (from LiveCD) this works correctly.
-      //    Razor-QT: https://github.com/Razor-qt/razor-qt/blob/master/razorqt-screenlocker/src/razorscreenlocker.cpp
-      //
-      //    The Freedesktop API that these DEs are implementing is being redrafted:
-      //      http://people.freedesktop.org/~hadess/idle-inhibition-spec/
-      //      http://lists.freedesktop.org/pipermail/xdg/2012-November/012577.html
-      //      http://lists.freedesktop.org/pipermail/xdg/2013-September/012875.html
-      //
-      //    the Lock method there is being removed (and not replaced with anything else).
-      //    Probably the DEs will support these APIs in the future in order not to break other software.
-
-      // Is only partially implemented by GNOME, so GNOME has to go before
-      // Works correctly on KDE4 (Ubuntu 12.04)
-      add_DBus_lock_cmd("org.freedesktop.ScreenSaver", "/ScreenSaver", "org.freedesktop.ScreenSaver", "Lock", "GetActive");
-
-      //  KDE - old screensaver API - partially verified both
-      add_DBus_lock_cmd("org.kde.screensaver", "/ScreenSaver", "org.freedesktop.ScreenSaver", "Lock", "GetActive");
-      add_DBus_lock_cmd("org.kde.krunner", "/ScreenSaver", "org.freedesktop.ScreenSaver", "Lock", "GetActive");
-
-      //              - there some accounts that when org.freedesktop.ScreenSaver does not work, this works:
-      //                      qdbus org.kde.ksmserver /ScreenSaver Lock
-      //                      but it is probably a side effect of the fact that implementation of org.kde.ksmserver
-      //                      is in the same process as of org.freedesktop.ScreenSaver
-      add_DBus_lock_cmd("org.kde.ksmserver", "/ScreenSaver", "org.freedesktop.ScreenSaver", "Lock", "GetActive");
-
-      // EFL:
-      add_DBus_lock_cmd("org.enlightenment.wm.service",
-                        "/org/enlightenment/wm/RemoteObject",
-                        "org.enlightenment.wm.Desktop",
-                        "Lock",
-                        nullptr);
+  if (session_connection == nullptr && system_connection == nullptr)
+    {
+      return;
+    }
+
+  if (dbus_discovery_running)
+    {
+      dbus_discovery_pending = true;
+      return;
+    }
+
+  dbus_discovery_running = true;
+  dbus_discovery_pending = false;
+
+  if (dbus_discovery_retry_source != 0)
+    {
+      g_source_remove(dbus_discovery_retry_source);
+      dbus_discovery_retry_source = 0;
     }
+
+  // The previous discovery thread has reported its result and is about to exit.
+  if (dbus_discovery_thread.joinable())
+    {
+      dbus_discovery_thread.join();
+    }
+
+  dbus_discovery = std::make_shared<DBusDiscovery>(dbus_discovery_generation, dbus_owned_names);
+  dbus_discovery_thread = std::thread([discovery = dbus_discovery]() { run_DBus_discovery(discovery); });
 }
 
+//! Retries a discovery that timed out.
+gboolean
+System::on_DBus_discovery_retry(gpointer data)
+{
+  TRACE_ENTRY();
+  (void)data;
+  dbus_discovery_retry_source = 0;
+  start_DBus_discovery();
+  return G_SOURCE_REMOVE;
+}
+
+//! Probes all known services that are owned on the bus concurrently. Runs on a worker thread.
 void
-System::add_DBus_system_state_command(ISystemStateChangeMethod *method)
+System::run_DBus_discovery(std::shared_ptr<DBusDiscovery> discovery)
 {
   TRACE_ENTRY();
-  if (method->canDoAnything())
+  std::set<std::string> lock_names;
+  for (const auto &service: dbus_lock_services)
     {
-      system_state_commands.push_back(method);
-      TRACE_MSG("DBus service is useful");
+      lock_names.insert(service.name);
     }
-  else
+  std::set<std::string> system_state_names;
+  for (const auto &service: dbus_system_state_services)
+    {
+      system_state_names.insert(service.name);
+    }
+
+  // Services are not auto-started, so services that are not owned cannot be used.
+  if (discovery->session_connection != nullptr)
+    {
+      add_owned_names(discovery->session_connection, discovery->cancellable, lock_names, discovery->owned_names);
+    }
+  if (discovery->system_connection != nullptr)
+    {
+      add_owned_names(discovery->system_connection, discovery->cancellable, system_state_names, discovery->owned_names);
+    }
+
+  if (discovery->owned_names != discovery->previous_owned_names)
+    {
+      discovery->changed = true;
+
+      auto probe_done = [discovery](auto &slot, auto *method) {
+        std::unique_lock lock(discovery->mutex);
+        slot = method;
+        discovery->remaining--;
+        discovery->cond.notify_all();
+      };
+
+      for (std::size_t i = 0; i < NUM_DBUS_LOCK_SERVICES; i++)
+        {
+          const DBusLockService &service = dbus_lock_services[i];
+          if (discovery->owned_names.count(service.name) == 0)
+            {
+              continue;
+            }
+
+          {
+            std::unique_lock lock(discovery->mutex);
+            discovery->remaining++;
+          }
+          discovery->probes.emplace_back([discovery, probe_done, i]() {
+            const DBusLockService &service = dbus_lock_services[i];
+            IScreenLockMethod *method = new ScreenLockDBus(discovery->session_connection,
+                                                           service.name,
+                                                           service.path,
+                                                           service.interface,
+                                                           service.lock_method,
+                                                           service.method_to_check_existence,
+                                                           discovery->cancellable);
+            if (!method->is_lock_supported())
+              {
+                delete method;
+                method = nullptr;
+              }
+            probe_done(discovery->lock_commands[i], method);
+          });
+        }
+
+      for (std::size_t i = 0; i < NUM_DBUS_SYSTEM_STATE_SERVICES; i++)
+        {
+          const DBusSystemStateService &service = dbus_system_state_services[i];
+          if (discovery->owned_names.count(service.name) == 0)
+            {
+              continue;
+            }
+
+          {
+            std::unique_lock lock(discovery->mutex);
+            discovery->remaining++;
+          }
+          discovery->probes.emplace_back([discovery, probe_done, i]() {
+            ISystemStateChangeMethod *method = dbus_system_state_services[i].create(discovery->system_connection, discovery->cancellable);
+            if (!method->canDoAnything())
+              {
+                delete method;
+                method = nullptr;
+              }
+            probe_done(discovery->system_state_commands[i], method);
+          });
+        }
+
+      {
+        std::unique_lock lock(discovery->mutex);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(DBUS_DISCOVERY_TIMEOUT_MSEC);
+        if (!discovery->cond.wait_until(lock, deadline, [&] { return discovery->remaining == 0; }))
+          {
+            TRACE_MSG("{} services did not respond in time", discovery->remaining);
+            discovery->complete = false;
+          }
+      }
+
+      // Probes that did not respond in time fail when cancelled.
+      if (!discovery->complete)
+        {
+          g_cancellable_cancel(discovery->cancellable);
+        }
+      for (auto &probe: discovery->probes)
+        {
+          probe.join();
+        }
+      discovery->probes.clear();
+    }
+
+  if (g_cancellable_is_cancelled(discovery->cancellable))
     {
-      delete method;
-      TRACE_MSG("DBus service is useless");
+      discovery->complete = false;
     }
+
+  // Report the result on the main loop.
+  g_idle_add(&System::on_DBus_discovery_done, new std::shared_ptr<DBusDiscovery>(discovery));
 }
 
-void
-System::init_DBus_system_state_commands()
+gboolean
+System::on_DBus_discovery_done(gpointer data)
 {
   TRACE_ENTRY();
-  if (system_connection)
-    {
-      // These three DBus interfaces are too diverse
-      // to implement support for them in one class
-      // Logind is the future so it goes first
-      add_DBus_system_state_command(new SystemStateChangeLogind(system_connection));
-
-      add_DBus_system_state_command(new SystemStateChangeUPower(system_connection));
-
-      // ConsoleKit is deprecated so goes last
-      add_DBus_system_state_command(new SystemStateChangeConsolekit(system_connection));
-
-      // Other interfaces:
-      //  GNOME:
-      //    - there is GNOME Session API:
-      //      https://git.gnome.org/browse/gnome-session/tree/gnome-session/org.gnome.SessionManager.xml
-      //      But shutdown/reboot require confirmation, so this is unusable to us,
-      //
-      //  KDE:
-      //    - there is some support, but probably not worth implementing it
-      //    http://askubuntu.com/questions/1871/how-can-i-safely-shutdown-reboot-logout-kde-from-the-command-line
-
-      //  Windows:
-      //  http://www.programmingsimplified.com/c-program-shutdown-computer
-      //    winxp
-      //        system("C:\\WINDOWS\\System32\\shutdown -s");
-      //    win7
-      //        system("C:\\WINDOWS\\System32\\shutdown /s");
-#    undef ADD_DBUS_SERVICE
+  std::unique_ptr<std::shared_ptr<DBusDiscovery>> holder(static_cast<std::shared_ptr<DBusDiscovery> *>(data));
+  DBusDiscovery &discovery = **holder;
+
+  if (discovery.generation != dbus_discovery_generation)
+    {
+      // System was cleared in the mean time.
+      return G_SOURCE_REMOVE;
+    }
+
+  dbus_discovery_running = false;
+  dbus_discovery.reset();
+
+  if (discovery.changed)
+    {
+      for (auto *command: dbus_lock_commands)
+        {
+          delete command;
+        }
+      dbus_lock_commands.clear();
+
+      for (auto *command: system_state_commands)
+        {
+          delete command;
+        }
+      system_state_commands.clear();
+
+      for (auto *&command: discovery.lock_commands)
+        {
+          if (command != nullptr)
+            {
+              dbus_lock_commands.push_back(command);
+              command = nullptr;
+            }
+        }
+      for (auto *&command: discovery.system_state_commands)
+        {
+          if (command != nullptr)
+            {
+              system_state_commands.push_back(command);
+              command = nullptr;
+            }
+        }
+
+      // Services that did not respond in time are probed again on the next discovery.
+      dbus_owned_names = discovery.complete ? discovery.owned_names : std::set<std::string>();
+
+      update_supported_system_operations();
+      signal_system_operations_changed()();
+    }
+
+  if (discovery.complete)
+    {
+      dbus_discovery_retry_msec = 0;
+    }
+  else if (dbus_discovery_retry_source == 0)
+    {
+      dbus_discovery_retry_msec = std::clamp(dbus_discovery_retry_msec * 2, DBUS_DISCOVERY_RETRY_MIN_MSEC, DBUS_DISCOVERY_RETRY_MAX_MSEC);
+      TRACE_MSG("Retrying in {} ms", dbus_discovery_retry_msec);
+      dbus_discovery_retry_source = g_timeout_add(dbus_discovery_retry_msec, &System::on_DBus_discovery_retry, nullptr);
     }
+
+  if (dbus_discovery_pending)
+    {
+      start_DBus_discovery();
+    }
+
+  return G_SOURCE_REMOVE;
 }
 
 #  endif // HAVE_DBUS_GIO
@@ -342,6 +735,17 @@ bool
 System::lock_screen()
 {
   TRACE_ENTRY();
+#if defined(PLATFORM_OS_UNIX) && defined(HAVE_DBUS_GIO)
+  for (auto &lock_command: dbus_lock_commands)
+    {
+      if (lock_command->lock())
+        {
+          TRACE_VAR(true);
+          return true;
+        }
+    }
+#endif
+
   for (auto &lock_command: lock_commands)
     {
       if (lock_command->lock())
@@ -411,8 +815,8 @@ System::init()
 #if defined(PLATFORM_OS_UNIX)
 #  if defined(HAVE_DBUS_GIO)
   init_DBus();
-  init_DBus_lock_commands();
-  init_DBus_system_state_commands();
+  start_DBus_discovery();
+  init_DBus_name_watches();
 #  endif
   init_cmdline_lock_commands(display.c_str());
 
@@ -421,6 +825,15 @@ System::init()
   init_windows_system_state_commands();
 #endif
 
+  update_supported_system_operations();
+}
+
+void
+System::update_supported_system_operations()
+{
+  TRACE_ENTRY();
+  supported_system_operations.clear();
+
   if (is_lockable())
     {
       supported_system_operations.push_back(SystemOperation("Lock", SystemOperation::SYSTEM_OPERATION_LOCK_SCREEN));
@@ -465,9 +878,46 @@ System::clear()
   system_state_commands.clear();
 
 #if defined(PLATFORM_OS_UNIX) && defined(HAVE_DBUS_GIO)
+  // Results of a running discovery are dropped.
+  dbus_discovery_generation++;
+  dbus_discovery_running = false;
+  dbus_discovery_pending = false;
+
+  if (dbus_discovery_retry_source != 0)
+    {
+      g_source_remove(dbus_discovery_retry_source);
+      dbus_discovery_retry_source = 0;
+    }
+  dbus_discovery_retry_msec = 0;
+
+  if (dbus_discovery)
+    {
+      g_cancellable_cancel(dbus_discovery->cancellable);
+      dbus_discovery.reset();
+    }
+  if (dbus_discovery_thread.joinable())
+    {
+      dbus_discovery_thread.join();
+    }
+
+  for (auto watch: dbus_name_watches)
+    {
+      g_bus_unwatch_name(watch);
+    }
+  dbus_name_watches.clear();
+
+  for (auto *lock_command: dbus_lock_commands)
+    {
+      delete lock_command;
+    }
+  dbus_lock_commands.clear();
+  dbus_owned_names.clear();
+
   // we shouldn't call g_dbus_connection_close_sync here:
   // http://comments.gmane.org/gmane.comp.freedesktop.dbus/15286
-  g_object_unref(session_connection);
-  g_object_unref(session_connection);
+  g_clear_object(&session_connection);
+  g_clear_object(&system_connection);
 #endif
+
+  supported_system_operations.clear();
 }
@@ -23,9 +23,10 @@
 
 const char *SystemStateChangeConsolekit::dbus_name = "org.freedesktop.ConsoleKit";
 
-SystemStateChangeConsolekit::SystemStateChangeConsolekit(GDBusConnection *connection)
+SystemStateChangeConsolekit::SystemStateChangeConsolekit(GDBusConnection *connection, GCancellable *cancellable)
 {
   TRACE_ENTRY();
+  proxy.set_cancellable(cancellable);
   proxy.init_with_connection(connection,
                              dbus_name,
                              "/org/freedesktop/ConsoleKit/Manager",
@@ -41,7 +42,7 @@ SystemStateChangeConsolekit::SystemStateChangeConsolekit(GDBusConnection *connec
   else
     {
       GVariant *result;
-      if (!proxy.call_method("CanStop", nullptr, &result))
+      if (!proxy.call_method("CanStop", nullptr, &result, DBusProxy::PROBE_TIMEOUT_MSEC))
         {
           TRACE_VAR(false);
           can_shutdown = false;
@@ -55,6 +56,9 @@ SystemStateChangeConsolekit::SystemStateChangeConsolekit(GDBusConnection *connec
           can_shutdown = (r2 == TRUE);
         }
     }
+
+  // Only the probe can be cancelled, not the shutdown.
+  proxy.set_cancellable(nullptr);
 }
 
 bool
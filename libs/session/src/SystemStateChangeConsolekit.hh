@@ -34,7 +34,7 @@ class SystemStateChangeConsolekit : public ISystemStateChangeMethod
 {
 public:
   static const char *dbus_name;
-  explicit SystemStateChangeConsolekit(GDBusConnection *connection);
+  explicit SystemStateChangeConsolekit(GDBusConnection *connection, GCancellable *cancellable = nullptr);
   ~SystemStateChangeConsolekit() override = default;
 
   bool shutdown() override;
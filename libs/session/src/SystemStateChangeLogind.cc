@@ -36,9 +36,10 @@
 
 const char *SystemStateChangeLogind::dbus_name = "org.freedesktop.login1";
 
-SystemStateChangeLogind::SystemStateChangeLogind(GDBusConnection *connection)
+SystemStateChangeLogind::SystemStateChangeLogind(GDBusConnection *connection, GCancellable *cancellable)
 {
   TRACE_ENTRY();
+  proxy.set_cancellable(cancellable);
   proxy.init_with_connection(connection,
                              dbus_name,
                              "/org/freedesktop/login1",
@@ -62,6 +63,9 @@ SystemStateChangeLogind::SystemStateChangeLogind(GDBusConnection *connection)
       can_hibernate = check_method("CanHibernate");
       can_suspend_hybrid = check_method("CanHybridSleep");
     }
+
+  // Only the probes can be cancelled, not the system state changes.
+  proxy.set_cancellable(nullptr);
 }
 
 bool
@@ -71,7 +75,7 @@ SystemStateChangeLogind::check_method(const char *method_name)
 
   bool ret;
   GVariant *result;
-  if (!proxy.call_method(method_name, nullptr, &result))
+  if (!proxy.call_method(method_name, nullptr, &result, DBusProxy::PROBE_TIMEOUT_MSEC))
     {
       TRACE_VAR(false);
       return false;
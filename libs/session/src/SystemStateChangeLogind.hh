@@ -36,7 +36,7 @@
 class SystemStateChangeLogind : public ISystemStateChangeMethod
 {
 public:
-  explicit SystemStateChangeLogind(GDBusConnection *connection);
+  explicit SystemStateChangeLogind(GDBusConnection *connection, GCancellable *cancellable = nullptr);
   ~SystemStateChangeLogind() override = default;
 
   // PowerOff(), Reboot(), Suspend(), Hibernate(), HybridSleep()
@@ -35,9 +35,10 @@
 
 const char *SystemStateChangeUPower::dbus_name = "org.freedesktop.UPower";
 
-SystemStateChangeUPower::SystemStateChangeUPower(GDBusConnection *connection)
+SystemStateChangeUPower::SystemStateChangeUPower(GDBusConnection *connection, GCancellable *cancellable)
 {
   TRACE_ENTRY();
+  proxy.set_cancellable(cancellable);
   proxy.init_with_connection(connection,
                              dbus_name,
                              "/org/freedesktop/UPower",
@@ -46,6 +47,7 @@ SystemStateChangeUPower::SystemStateChangeUPower(GDBusConnection *connection)
                                                           | G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS
                                                           | G_DBUS_PROXY_FLAGS_DO_NOT_AUTO_START));
 
+  property_proxy.set_cancellable(cancellable);
   property_proxy.init_with_connection(connection, "org.freedesktop.UPower", "/org/freedesktop/UPower", "org.freedesktop.DBus.Properties");
 
   if (!proxy.is_valid() || !property_proxy.is_valid())
@@ -58,6 +60,10 @@ SystemStateChangeUPower::SystemStateChangeUPower(GDBusConnection *connection)
       can_suspend = check_method("SuspendAllowed") && check_property("CanSuspend");
       can_hibernate = check_method("HibernateAllowed") && check_property("CanHibernate");
     }
+
+  // Only the probes can be cancelled, not the system state changes.
+  proxy.set_cancellable(nullptr);
+  property_proxy.set_cancellable(nullptr);
 }
 
 bool
@@ -66,7 +72,7 @@ SystemStateChangeUPower::check_method(const char *method_name)
   TRACE_ENTRY_PAR(method_name);
 
   GVariant *result;
-  if (!proxy.call_method(method_name, nullptr, &result))
+  if (!proxy.call_method(method_name, nullptr, &result, DBusProxy::PROBE_TIMEOUT_MSEC))
     {
       TRACE_MSG("{} failed", method_name);
       TRACE_VAR(false);
@@ -89,7 +95,10 @@ SystemStateChangeUPower::check_property(const char *property_name)
 
   GVariant *result;
   bool r1;
-  r1 = property_proxy.call_method("Get", g_variant_new("(ss)", "org.freedesktop.UPower", property_name), &result);
+  r1 = property_proxy.call_method("Get",
+                                 g_variant_new("(ss)", "org.freedesktop.UPower", property_name),
+                                 &result,
+                                 DBusProxy::PROBE_TIMEOUT_MSEC);
 
   if (!r1)
     {
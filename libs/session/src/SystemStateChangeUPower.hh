@@ -36,7 +36,7 @@
 class SystemStateChangeUPower : public ISystemStateChangeMethod
 {
 public:
-  explicit SystemStateChangeUPower(GDBusConnection *connection);
+  explicit SystemStateChangeUPower(GDBusConnection *connection, GCancellable *cancellable = nullptr);
   ~SystemStateChangeUPower() override = default;
 
   bool suspend() override
@@ -36,12 +36,28 @@ private:
   GDBusProxy *proxy{nullptr};
   GError *error{nullptr};
   GDBusProxyFlags flags{G_DBUS_PROXY_FLAGS_NONE};
+  GCancellable *cancellable{nullptr};
 
 public:
   DBusProxy() = default;
   ~DBusProxy()
   {
     clear();
+    set_cancellable(nullptr);
+  }
+
+  //! Sets the cancellable of the initialization and the synchronous method calls, or nullptr for none.
+  void set_cancellable(GCancellable *cancellable_in)
+  {
+    if (cancellable_in != nullptr)
+      {
+        g_object_ref(cancellable_in);
+      }
+    if (cancellable != nullptr)
+      {
+        g_object_unref(cancellable);
+      }
+    cancellable = cancellable_in;
   }
 
   bool init(GBusType bus_type,
@@ -58,9 +74,13 @@ public:
                             GDBusProxyFlags flags_in = static_cast<GDBusProxyFlags>(G_DBUS_PROXY_FLAGS_DO_NOT_LOAD_PROPERTIES
                                                                                     | G_DBUS_PROXY_FLAGS_DO_NOT_CONNECT_SIGNALS));
 
+  //! Timeout of calls that only check whether a service supports a method.
+  static constexpr int PROBE_TIMEOUT_MSEC = 1000;
+
   // Consumes (=deletes) method_parameters if it is floating
   // method_result may be null, in this case the result of the method is ignored
-  bool call_method(const char *method_name, GVariant *method_parameters, GVariant **method_result);
+  // timeout_msec is -1 for the default D-Bus timeout
+  bool call_method(const char *method_name, GVariant *method_parameters, GVariant **method_result, int timeout_msec = -1);
 
   // Calls method asynchronously and does not accept result (no callback will be run)
   // Consumes (=deletes) method_parameters if it is floating
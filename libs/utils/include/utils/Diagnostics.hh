@@ -25,12 +25,17 @@
 #include <sstream>
 #include <map>
 
+#include "utils/TraceRecorder.hh"
+
 class TracedFieldBase
 {
 public:
   TracedFieldBase() noexcept = default;
 
   static bool debug;
+
+  //! Record changes in the TraceRecorder, also when diagnostics are disabled.
+  static bool recording;
 };
 
 class DiagnosticsSink
@@ -91,6 +96,7 @@ public:
 
   explicit TracedField(const TracedField &p) noexcept
     : _name{p._name}
+    , _trace_id{p._trace_id}
     , _value{p._value}
     , _last_published_value{p._last_published_value}
     , _manual{p._manual}
@@ -104,6 +110,7 @@ public:
 
   explicit TracedField(TracedField &&p) noexcept
     : _name{std::move(p._name)}
+    , _trace_id{p._trace_id}
     , _value{std::move(p._value)}
     , _last_published_value{p._last_published_value}
     , _manual{p._manual}
@@ -117,6 +124,7 @@ public:
 
   TracedField(std::string name, const value_type &initial, bool manual = false) noexcept
     : _name{std::move(name)}
+    , _trace_id{workrave::utils::TraceRecorder::instance().register_field<value_type>(_name)}
     , _value{initial}
     , _manual{manual}
   {
@@ -125,10 +133,12 @@ public:
       {
         Diagnostics::instance().report(_name, _value);
       }
+    trace(_value);
   }
 
   TracedField(std::string &&name, value_type &&initial, bool manual = false) noexcept
     : _name{std::move(name)}
+    , _trace_id{workrave::utils::TraceRecorder::instance().register_field<value_type>(_name)}
     , _value{std::move(initial)}
     , _manual{manual}
   {
@@ -137,6 +147,7 @@ public:
       {
         Diagnostics::instance().report(_name, _value);
       }
+    trace(_value);
   }
 
   ~TracedField() noexcept
@@ -190,18 +201,26 @@ public:
 
   void set(const value_type &value) noexcept
   {
-    if (debug && !_manual && value != _value)
+    if ((debug || recording) && !_manual && value != _value)
       {
-        Diagnostics::instance().report(_name, value);
+        if (debug)
+          {
+            Diagnostics::instance().report(_name, value);
+          }
+        trace(value);
       }
     _value = value;
   }
 
   void set(value_type &&value)
   {
-    if (debug && !_manual && value != _value)
+    if ((debug || recording) && !_manual && value != _value)
       {
-        Diagnostics::instance().report(_name, value);
+        if (debug)
+          {
+            Diagnostics::instance().report(_name, value);
+          }
+        trace(value);
       }
     _value = std::move(value);
   }
@@ -485,8 +504,18 @@ public:
     return *this;
   }
 
+private:
+  void trace(const value_type &value)
+  {
+    if (recording && !_manual)
+      {
+        workrave::utils::TraceRecorder::instance().record(_trace_id, value);
+      }
+  }
+
 private:
   std::string _name;
+  uint32_t _trace_id{0};
   value_type _value{};
   value_type _last_published_value{};
   bool _last_published_value_valid{false};
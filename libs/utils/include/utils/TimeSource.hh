@@ -56,6 +56,9 @@ namespace workrave
       //! Synchronize current time.
       static void sync();
 
+      //! Moves the synchronized time by delta microseconds, without consulting the time source.
+      static void shift_sync(int64_t delta);
+
     public:
       static ITimeSource::Ptr source;
       static int64_t synced_real_time;
@@ -0,0 +1,183 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef WORKAVE_LIBS_UTILS_TRACERECORDER_HH
+#define WORKAVE_LIBS_UTILS_TRACERECORDER_HH
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace workrave::utils
+{
+  //! Records changes of traced values as compact binary records.
+  /*!
+   *  Each thread records into its own fixed size ring buffer; the oldest
+   *  records are overwritten when the buffer is full. Records are only
+   *  converted to text when they are decoded.
+   *
+   *  Values of trivially copyable types of at most 8 bytes are stored as-is,
+   *  without locking. Other values are formatted and stored in a shared ring
+   *  of MAX_STRINGS strings, which takes a short lock. Recording strings is
+   *  best-effort: once a string is overwritten by newer strings, records
+   *  that refer to it decode as "...".
+   */
+  class TraceRecorder
+  {
+  public:
+    //! Converts a recorded value to text.
+    using Decoder = std::function<std::string(uint64_t value)>;
+
+    //! A decoded record.
+    struct Entry
+    {
+      int64_t time{0};
+      std::string name;
+      std::string value;
+    };
+
+    //! Number of records kept per thread.
+    static constexpr std::size_t CAPACITY = 4096;
+
+    static TraceRecorder &instance();
+
+    TraceRecorder(const TraceRecorder &) = delete;
+    TraceRecorder &operator=(const TraceRecorder &) = delete;
+
+    uint32_t register_field(const std::string &name, Decoder decoder);
+
+    template<typename T>
+    uint32_t register_field(const std::string &name)
+    {
+      return register_field(name, [this](uint64_t value) { return decode<T>(value); });
+    }
+
+    template<typename T>
+    void record(uint32_t field, const T &value)
+    {
+      record_raw(field, encode(value));
+    }
+
+    void record_raw(uint32_t field, uint64_t value);
+
+    std::vector<Entry> decode();
+    std::string decode_text();
+    bool dump(const std::filesystem::path &path);
+
+    static std::string format_time(int64_t time);
+
+  private:
+    TraceRecorder() = default;
+
+    struct Slot
+    {
+      //! Number of the record plus one, or 0 while the slot is written.
+      std::atomic<uint64_t> seq{0};
+      std::atomic<uint32_t> field{0};
+      std::atomic<int64_t> time{0};
+      std::atomic<uint64_t> value{0};
+    };
+
+    struct Buffer
+    {
+      std::array<Slot, CAPACITY> slots;
+
+      //! Number of records written. Only modified by the owning thread.
+      std::atomic<uint64_t> head{0};
+    };
+
+    struct Field
+    {
+      std::string name;
+      Decoder decoder;
+    };
+
+    template<typename T>
+    static constexpr bool is_inline_v = std::is_trivially_copyable_v<T> && sizeof(T) <= sizeof(uint64_t);
+
+    template<typename T>
+    uint64_t encode(const T &value)
+    {
+      if constexpr (is_inline_v<T>)
+        {
+          uint64_t bits = 0;
+          std::memcpy(&bits, &value, sizeof(T));
+          return bits;
+        }
+      else
+        {
+          std::stringstream ss;
+          ss << value;
+          return intern(ss.str());
+        }
+    }
+
+    template<typename T>
+    std::string decode(uint64_t bits)
+    {
+      if constexpr (is_inline_v<T>)
+        {
+          T value;
+          std::memcpy(&value, &bits, sizeof(T));
+          std::stringstream ss;
+          ss << value;
+          return ss.str();
+        }
+      else
+        {
+          return lookup(bits);
+        }
+    }
+
+    uint64_t intern(const std::string &text);
+    std::string lookup(uint64_t index);
+    Buffer &local_buffer();
+
+  private:
+    //! Number of formatted values kept in the string ring.
+    static constexpr std::size_t MAX_STRINGS = 4096;
+
+    struct String
+    {
+      //! Number of the string plus one, or 0 if unused.
+      uint64_t seq{0};
+      std::string text;
+    };
+
+    std::mutex mutex;
+    std::vector<Field> fields;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    //! Protects the string ring.
+    std::mutex strings_mutex;
+    std::array<String, MAX_STRINGS> strings;
+
+    //! Number of strings recorded.
+    uint64_t strings_head{0};
+  };
+} // namespace workrave::utils
+
+#endif // WORKAVE_LIBS_UTILS_TRACERECORDER_HH
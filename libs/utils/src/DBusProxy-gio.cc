@@ -37,7 +37,7 @@ DBusProxy::init_with_connection(GDBusConnection *connection,
 {
   TRACE_ENTRY_PAR(name);
   this->flags = flags_in;
-  proxy = g_dbus_proxy_new_sync(connection, flags, nullptr, name, object_path, interface_name, nullptr, &error);
+  proxy = g_dbus_proxy_new_sync(connection, flags, nullptr, name, object_path, interface_name, cancellable, &error);
 
   if (error != nullptr)
     {
@@ -53,7 +53,7 @@ DBusProxy::init(GBusType bus_type, const char *name, const char *object_path, co
   TRACE_ENTRY_PAR(name);
   this->flags = flags_in;
   error = nullptr;
-  proxy = g_dbus_proxy_new_for_bus_sync(bus_type, flags, nullptr, name, object_path, interface_name, nullptr, &error);
+  proxy = g_dbus_proxy_new_for_bus_sync(bus_type, flags, nullptr, name, object_path, interface_name, cancellable, &error);
 
   if (error != nullptr)
     {
@@ -66,7 +66,7 @@ DBusProxy::init(GBusType bus_type, const char *name, const char *object_path, co
 // Consumes (=deletes) method_parameters if it is floating
 // method_result may be null, in this case the result of the method is ignored
 bool
-DBusProxy::call_method(const char *method_name, GVariant *method_parameters, GVariant **method_result)
+DBusProxy::call_method(const char *method_name, GVariant *method_parameters, GVariant **method_result, int timeout_msec)
 {
   TRACE_ENTRY_PAR(method_name);
   if (proxy == nullptr)
@@ -78,7 +78,7 @@ DBusProxy::call_method(const char *method_name, GVariant *method_parameters, GVa
       error = nullptr;
     }
 
-  GVariant *result = g_dbus_proxy_call_sync(proxy, method_name, method_parameters, G_DBUS_CALL_FLAGS_NONE, -1, nullptr, &error);
+  GVariant *result = g_dbus_proxy_call_sync(proxy, method_name, method_parameters, G_DBUS_CALL_FLAGS_NONE, timeout_msec, cancellable, &error);
 
   if (method_result == nullptr)
     {
@@ -24,6 +24,7 @@
 #include <time.h>
 
 bool TracedFieldBase::debug = false;
+bool TracedFieldBase::recording = true;
 
 void
 Diagnostics::enable(DiagnosticsSink *sink)
@@ -94,3 +94,10 @@ TimeSource::sync()
   synced_monotonic_time = get_monotonic_time_usec();
   synced_real_time = get_real_time_usec();
 }
+
+void
+TimeSource::shift_sync(int64_t delta)
+{
+  synced_monotonic_time += delta;
+  synced_real_time += delta;
+}
@@ -0,0 +1,213 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "utils/TraceRecorder.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <fstream>
+
+using namespace workrave::utils;
+
+namespace
+{
+  struct RawRecord
+  {
+    int64_t time;
+    uint64_t seq;
+    uint32_t field;
+    uint64_t value;
+  };
+} // namespace
+
+TraceRecorder &
+TraceRecorder::instance()
+{
+  static auto *recorder = new TraceRecorder();
+  return *recorder;
+}
+
+//! Registers a traced value. Values registered with the same name share an ID.
+uint32_t
+TraceRecorder::register_field(const std::string &name, Decoder decoder)
+{
+  std::unique_lock lock(mutex);
+
+  auto it = std::find_if(fields.begin(), fields.end(), [&](const Field &f) { return f.name == name; });
+  if (it != fields.end())
+    {
+      it->decoder = std::move(decoder);
+      return static_cast<uint32_t>(it - fields.begin());
+    }
+
+  fields.push_back(Field{name, std::move(decoder)});
+  return static_cast<uint32_t>(fields.size() - 1);
+}
+
+//! Records a value in the buffer of the calling thread.
+void
+TraceRecorder::record_raw(uint32_t field, uint64_t value)
+{
+  Buffer &buffer = local_buffer();
+
+  uint64_t n = buffer.head.load(std::memory_order_relaxed);
+  Slot &slot = buffer.slots[n % CAPACITY];
+
+  // Invalidate the slot before it is overwritten, so that a concurrent
+  // decode does not mix old and new contents.
+  slot.seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+  slot.field.store(field, std::memory_order_relaxed);
+  slot.time.store(now, std::memory_order_relaxed);
+  slot.value.store(value, std::memory_order_relaxed);
+  slot.seq.store(n + 1, std::memory_order_release);
+
+  buffer.head.store(n + 1, std::memory_order_release);
+}
+
+//! Returns all recorded values, oldest first.
+std::vector<TraceRecorder::Entry>
+TraceRecorder::decode()
+{
+  std::vector<RawRecord> records;
+  std::vector<Field> fields_copy;
+
+  {
+    std::unique_lock lock(mutex);
+    fields_copy = fields;
+
+    for (const auto &buffer: buffers)
+      {
+        for (const auto &slot: buffer->slots)
+          {
+            uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq == 0)
+              {
+                continue;
+              }
+
+            RawRecord record{slot.time.load(std::memory_order_relaxed),
+                             seq,
+                             slot.field.load(std::memory_order_relaxed),
+                             slot.value.load(std::memory_order_relaxed)};
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) == seq)
+              {
+                records.push_back(record);
+              }
+          }
+      }
+  }
+
+  std::sort(records.begin(), records.end(), [](const RawRecord &a, const RawRecord &b) {
+    return a.time < b.time || (a.time == b.time && a.seq < b.seq);
+  });
+
+  std::vector<Entry> entries;
+  entries.reserve(records.size());
+  for (const auto &record: records)
+    {
+      if (record.field < fields_copy.size())
+        {
+          const Field &field = fields_copy[record.field];
+          entries.push_back(Entry{record.time, field.name, field.decoder(record.value)});
+        }
+    }
+  return entries;
+}
+
+//! Returns all recorded values as text, one line per value.
+std::string
+TraceRecorder::decode_text()
+{
+  std::string text;
+  for (const auto &entry: decode())
+    {
+      text += format_time(entry.time) + ": " + entry.name + " -> " + entry.value + "\n";
+    }
+  return text;
+}
+
+//! Writes all recorded values as text to a file.
+bool
+TraceRecorder::dump(const std::filesystem::path &path)
+{
+  std::ofstream file(path, std::ios::trunc);
+  file << decode_text();
+  file.close();
+  return static_cast<bool>(file);
+}
+
+std::string
+TraceRecorder::format_time(int64_t time)
+{
+  time_t seconds = static_cast<time_t>(time / 1000000);
+  char buffer[128];
+
+  struct tm *tmlt = localtime(&seconds);
+  size_t len = strftime(buffer, sizeof(buffer), "%d %b %Y %H:%M:%S", tmlt);
+  snprintf(buffer + len, sizeof(buffer) - len, ".%06d", static_cast<int>(time % 1000000));
+  return buffer;
+}
+
+//! Stores a string in the string ring, overwriting the oldest string.
+/*!
+ *  \return the number of the string plus one.
+ */
+uint64_t
+TraceRecorder::intern(const std::string &text)
+{
+  std::unique_lock lock(strings_mutex);
+
+  uint64_t seq = ++strings_head;
+  String &entry = strings[seq % MAX_STRINGS];
+  entry.seq = seq;
+  entry.text = text;
+  return seq;
+}
+
+//! Returns the string with the specified number, or "..." if it was overwritten.
+std::string
+TraceRecorder::lookup(uint64_t seq)
+{
+  std::unique_lock lock(strings_mutex);
+
+  const String &entry = strings[seq % MAX_STRINGS];
+  return seq != 0 && entry.seq == seq ? entry.text : std::string("...");
+}
+
+TraceRecorder::Buffer &
+TraceRecorder::local_buffer()
+{
+  thread_local Buffer *buffer = nullptr;
+
+  if (buffer == nullptr)
+    {
+      std::unique_lock lock(mutex);
+      buffers.push_back(std::make_unique<Buffer>());
+      buffer = buffers.back().get();
+    }
+  return *buffer;
+}
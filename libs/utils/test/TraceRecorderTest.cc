@@ -0,0 +1,155 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <algorithm>
+#include <thread>
+
+#define BOOST_TEST_MODULE "workrave-utils-tracerecorder"
+#include <boost/test/unit_test.hpp>
+
+#include "utils/Diagnostics.hh"
+#include "utils/TraceRecorder.hh"
+
+using namespace workrave::utils;
+
+namespace
+{
+  std::vector<TraceRecorder::Entry> entries_of(const std::string &name)
+  {
+    std::vector<TraceRecorder::Entry> ret;
+    for (const auto &entry: TraceRecorder::instance().decode())
+      {
+        if (entry.name == name)
+          {
+            ret.push_back(entry);
+          }
+      }
+    return ret;
+  }
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(workrave_utils_tracerecorder)
+
+BOOST_AUTO_TEST_CASE(test_tracerecorder_traced_field)
+{
+  TracedField<int> count{"test.count", 1};
+  TracedField<bool> flag{"test.flag", false};
+  TracedField<std::string> text{"test.text", "a"};
+  TracedField<int64_t> manual{"test.manual", 0, true};
+
+  count = 2;
+  count = 2;
+  count++;
+  flag = true;
+  text = "b";
+  manual = 10;
+
+  auto counts = entries_of("test.count");
+  BOOST_REQUIRE_EQUAL(counts.size(), 3);
+  BOOST_CHECK_EQUAL(counts[0].value, "1");
+  BOOST_CHECK_EQUAL(counts[1].value, "2");
+  BOOST_CHECK_EQUAL(counts[2].value, "3");
+  BOOST_CHECK(counts[0].time <= counts[2].time);
+
+  auto flags = entries_of("test.flag");
+  BOOST_REQUIRE_EQUAL(flags.size(), 2);
+  BOOST_CHECK_EQUAL(flags[1].value, "1");
+
+  auto texts = entries_of("test.text");
+  BOOST_REQUIRE_EQUAL(texts.size(), 2);
+  BOOST_CHECK_EQUAL(texts[0].value, "a");
+  BOOST_CHECK_EQUAL(texts[1].value, "b");
+
+  BOOST_CHECK(entries_of("test.manual").empty());
+
+  std::string text_dump = TraceRecorder::instance().decode_text();
+  BOOST_CHECK(text_dump.find("test.count -> 3\n") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_tracerecorder_wraps)
+{
+  TracedField<int> wrap{"test.wrap", 0};
+  const int num_values = static_cast<int>(TraceRecorder::CAPACITY) * 2;
+
+  for (int i = 1; i <= num_values; i++)
+    {
+      wrap = i;
+    }
+
+  auto wraps = entries_of("test.wrap");
+  BOOST_REQUIRE(!wraps.empty());
+  BOOST_CHECK(wraps.size() <= TraceRecorder::CAPACITY);
+  BOOST_CHECK_EQUAL(wraps.back().value, std::to_string(num_values));
+  BOOST_CHECK_EQUAL(wraps.front().value, std::to_string(num_values - wraps.size() + 1));
+}
+
+BOOST_AUTO_TEST_CASE(test_tracerecorder_strings_wrap)
+{
+  TracedField<std::string> text{"test.strings", "s0"};
+  const int num_values = static_cast<int>(TraceRecorder::CAPACITY) * 3;
+
+  for (int i = 1; i <= num_values; i++)
+    {
+      text = "s" + std::to_string(i);
+    }
+
+  // Recent strings remain available after more strings than the string ring holds were recorded.
+  auto texts = entries_of("test.strings");
+  BOOST_REQUIRE(!texts.empty());
+  BOOST_CHECK_EQUAL(texts.back().value, "s" + std::to_string(num_values));
+  for (size_t i = 0; i < texts.size(); i++)
+    {
+      BOOST_CHECK_EQUAL(texts[i].value, "s" + std::to_string(num_values - texts.size() + 1 + i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_tracerecorder_threads)
+{
+  const int num_values = 1000;
+  uint32_t field = TraceRecorder::instance().register_field<int>("test.thread");
+
+  std::thread writer([&] {
+    for (int i = 0; i < num_values; i++)
+      {
+        TraceRecorder::instance().record(field, i);
+      }
+  });
+
+  // Decoding concurrently with the writer must only return complete records.
+  for (int i = 0; i < 10; i++)
+    {
+      for (const auto &entry: entries_of("test.thread"))
+        {
+          int value = std::stoi(entry.value);
+          BOOST_CHECK(value >= 0 && value < num_values);
+        }
+    }
+  writer.join();
+
+  auto values = entries_of("test.thread");
+  BOOST_REQUIRE_EQUAL(values.size(), num_values);
+  for (int i = 0; i < num_values; i++)
+    {
+      BOOST_CHECK_EQUAL(values[i].value, std::to_string(i));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -39,6 +39,7 @@
 #include "Application.hh"
 
 #include "commonui/nls.h"
+#include "core/CoreConfig.hh"
 #include "core/IBreak.hh"
 #include "core/ICore.hh"
 #include "dbus/IDBus.hh"
@@ -56,6 +57,7 @@
 #include "utils/Logging.hh"
 #include "utils/Paths.hh"
 #include "utils/Platform.hh"
+#include "utils/TimeSource.hh"
 
 #ifdef HAVE_DBUS
 #  include "GenericDBusApplet.hh"
@@ -75,6 +77,8 @@ Application::Application(int argc, char **argv, std::shared_ptr<IToolkitFactory>
 Application::~Application()
 {
   TRACE_ENTRY();
+  break_window_pool.reset();
+
   if (toolkit)
     {
       toolkit->deinit();
@@ -120,6 +124,8 @@ Application::main()
   connect(toolkit->signal_main_window_closed(), this, [this] { on_main_window_closed(); });
   connect(toolkit->signal_status_icon_activated(), this, [this] { on_status_icon_activate(); });
 
+  init_break_window_pool();
+
   on_timer();
 
   init_ready = true;
@@ -250,6 +256,15 @@ Application::init_core()
   core->init(argc, argv, this, toolkit->get_display_name());
   core->set_core_events_listener(this);
 #endif
+
+  std::weak_ptr<IToolkit> weak_toolkit = toolkit;
+  core->set_input_wakeup_handler([weak_toolkit]() {
+    if (auto t = weak_toolkit.lock())
+      {
+        t->wakeup_timer();
+      }
+  });
+
   GUIConfig::init(shared_from_this());
 }
 
@@ -313,6 +328,65 @@ Application::init_updater()
   //   }
 }
 
+void
+Application::init_break_window_pool()
+{
+  TRACE_ENTRY();
+  break_window_pool = std::make_shared<BreakWindowPool>(toolkit);
+
+  // Pooled windows are built for a specific monitor layout, theme and configuration.
+  connect(toolkit->signal_display_changed(), this, [this] { on_break_windows_changed(); });
+  connect(System::signal_system_operations_changed(), this, [this] { on_break_windows_changed(); });
+  GUIConfig::block_mode().connect(this, [this](auto) { on_break_windows_changed(); });
+  GUIConfig::theme_name().connect(this, [this](auto) { on_break_windows_changed(); });
+  GUIConfig::theme_dark().connect(this, [this](auto) { on_break_windows_changed(); });
+  GUIConfig::locale().connect(this, [this](auto) { on_break_windows_changed(); });
+
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      auto break_id = BreakId(i);
+      CoreConfig::break_enabled(break_id).connect(this, [this](auto) { on_break_windows_changed(); });
+      GUIConfig::break_ignorable(break_id).connect(this, [this](auto) { on_break_windows_changed(); });
+      GUIConfig::break_skippable(break_id).connect(this, [this](auto) { on_break_windows_changed(); });
+      GUIConfig::break_enable_shutdown(break_id).connect(this, [this](auto) { on_break_windows_changed(); });
+      GUIConfig::break_exercises(break_id).connect(this, [this](auto) { on_break_windows_changed(); });
+    }
+
+  prepare_break_windows();
+}
+
+//! Builds the windows of all enabled breaks in the background.
+void
+Application::prepare_break_windows()
+{
+  TRACE_ENTRY();
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      auto break_id = BreakId(i);
+      if (!CoreConfig::break_enabled(break_id)())
+        {
+          continue;
+        }
+
+      BreakFlags break_flags = get_break_flags(break_id, BreakHint::Normal);
+      for (int head = 0; head < toolkit->get_head_count(); head++)
+        {
+          break_window_pool->prepare_prelude_window(head, break_id);
+          break_window_pool->prepare_break_window(head, break_id, break_flags);
+
+          break_flags |= BREAK_FLAGS_NO_EXERCISES;
+        }
+    }
+}
+
+void
+Application::on_break_windows_changed()
+{
+  TRACE_ENTRY();
+  break_window_pool->clear();
+  prepare_break_windows();
+}
+
 void
 Application::init_sound_player()
 {
@@ -415,9 +489,11 @@ Application::create_prelude_window(BreakId break_id)
   hide_break_window();
   active_break_id = break_id;
 
+  break_window_request_time = std::chrono::steady_clock::now();
+
   for (int i = 0; i < toolkit->get_head_count(); i++)
     {
-      prelude_windows.push_back(toolkit->create_prelude_window(i, break_id));
+      prelude_windows.push_back(break_window_pool->get_prelude_window(i, break_id));
     }
 }
 
@@ -427,6 +503,21 @@ Application::create_break_window(BreakId break_id, workrave::utils::Flags<BreakH
   TRACE_ENTRY_PAR(break_id, break_hint);
   hide_break_window();
 
+  active_break_id = break_id;
+  break_window_request_time = std::chrono::steady_clock::now();
+
+  BreakFlags break_flags = get_break_flags(break_id, break_hint);
+  for (int i = 0; i < toolkit->get_head_count(); i++)
+    {
+      break_windows.push_back(break_window_pool->get_break_window(i, break_id, break_flags));
+
+      break_flags |= BREAK_FLAGS_NO_EXERCISES;
+    }
+}
+
+auto
+Application::get_break_flags(BreakId break_id, workrave::utils::Flags<BreakHint> break_hint) -> BreakFlags
+{
   BreakFlags break_flags = BREAK_FLAGS_NONE;
   bool ignorable = GUIConfig::break_ignorable(break_id)();
   bool skippable = GUIConfig::break_skippable(break_id)();
@@ -458,17 +549,7 @@ Application::create_break_window(BreakId break_id, workrave::utils::Flags<BreakH
       break_flags |= (BREAK_FLAGS_NO_EXERCISES | BREAK_FLAGS_NATURAL | BREAK_FLAGS_POSTPONABLE);
     }
 
-  active_break_id = break_id;
-
-  for (int i = 0; i < toolkit->get_head_count(); i++)
-    {
-      IBreakWindow::Ptr break_window = toolkit->create_break_window(i, break_id, break_flags);
-
-      break_windows.push_back(break_window);
-      break_window->init();
-
-      break_flags |= BREAK_FLAGS_NO_EXERCISES;
-    }
+  return break_flags;
 }
 
 void
@@ -511,6 +592,12 @@ Application::show_break_window()
     {
       toolkit->get_locker()->lock();
     }
+
+  auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - break_window_request_time);
+  spdlog::debug("{} window(s) of break {} shown {} us after request",
+                prelude_windows.size() + break_windows.size(),
+                static_cast<int>(active_break_id),
+                elapsed.count());
 }
 
 void
@@ -562,13 +649,22 @@ Application::set_prelude_progress_text(PreludeProgressText text)
 void
 Application::on_timer()
 {
-  std::string tip = get_timers_tooltip();
-
   core->heartbeat();
 
-  // TODO: tip changed.
-  // applet_control->set_tooltip(tip);
-  toolkit->show_tooltip(tip);
+  // Skip heartbeats while no timer, and nothing shown of the timers, can change. User input
+  // wakes up the timer, and timer views limit the delay when they change by themselves.
+  int64_t delay = core->get_next_heartbeat_time() - TimeSource::get_real_time_sec();
+  if (delay > 1)
+    {
+      toolkit->set_timer_delay(static_cast<int>(delay * 1000));
+    }
+
+  TimerSnapshot::Ptr snapshot = core->get_timer_snapshot();
+  if (snapshot->version != tooltip_version)
+    {
+      tooltip_version = snapshot->version;
+      toolkit->show_tooltip(get_timers_tooltip());
+    }
 
   if (!break_windows.empty() && muted)
     {
@@ -629,8 +725,8 @@ Application::get_timers_tooltip()
   const char *labels[] = {_("Micro-break"), _("Rest break"), _("Daily limit")};
   std::string tip = "";
 
-  OperationMode mode = core->get_regular_operation_mode();
-  switch (mode)
+  TimerSnapshot::Ptr snapshot = core->get_timer_snapshot();
+  switch (snapshot->operation_mode)
     {
     case OperationMode::Suspended:
       tip = std::string(_("Mode: ")) + _("Suspended");
@@ -651,18 +747,17 @@ Application::get_timers_tooltip()
 
   for (int count = 0; count < BREAK_ID_SIZEOF; count++)
     {
-      auto b = core->get_break(BreakId(count));
-      bool on = b->is_enabled();
+      const BreakTimerState &b = snapshot->get(BreakId(count));
 
-      if (b != nullptr && on)
+      if (b.enabled)
         {
           // Collect some data.
-          int64_t maxActiveTime = b->get_limit();
-          int64_t activeTime = b->get_elapsed_time();
+          int64_t maxActiveTime = b.limit;
+          int64_t activeTime = b.elapsed_time;
           std::string text;
 
           // Set the text
-          if (b->is_limit_enabled() && maxActiveTime != 0)
+          if (b.limit_enabled && maxActiveTime != 0)
             {
               text = Text::time_to_string(maxActiveTime - activeTime);
             }
@@ -18,6 +18,7 @@
 #ifndef APPLICATION_HH
 #define APPLICATION_HH
 
+#include <chrono>
 #include <list>
 #include <vector>
 #include <string>
@@ -30,6 +31,7 @@
 #include "Menus.hh"
 #include "core/IApp.hh"
 #include "core/ICore.hh"
+#include "ui/BreakWindowPool.hh"
 #include "ui/IApplication.hh"
 #include "ui/IBreakWindow.hh"
 #include "ui/IPreludeWindow.hh"
@@ -88,6 +90,11 @@ private:
   void init_dbus();
   void init_operation_mode_warning();
   void init_updater();
+  void init_break_window_pool();
+
+  auto get_break_flags(workrave::BreakId break_id, workrave::utils::Flags<workrave::BreakHint> break_hint) -> BreakFlags;
+  void prepare_break_windows();
+  void on_break_windows_changed();
 
   void on_status_icon_activate();
   void on_main_window_closed();
@@ -110,6 +117,10 @@ private:
   char **argv{nullptr};
   std::vector<IBreakWindow::Ptr> break_windows;
   std::vector<IPreludeWindow::Ptr> prelude_windows;
+  BreakWindowPool::Ptr break_window_pool;
+
+  //! Time at which the current break or prelude windows were requested by the core.
+  std::chrono::steady_clock::time_point break_window_request_time;
   workrave::BreakId active_break_id{workrave::BREAK_ID_NONE};
   std::list<std::shared_ptr<IPlugin>> plugins;
   bool init_ready{false};
@@ -117,6 +128,9 @@ private:
   bool closewarn_shown{false};
   bool is_idle{false};
   bool taking{false};
+
+  //! Version of the timer snapshot shown in the tooltip.
+  uint64_t tooltip_version{0};
 };
 
 inline auto
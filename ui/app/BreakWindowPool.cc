@@ -0,0 +1,143 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "ui/BreakWindowPool.hh"
+
+#include "debug.hh"
+
+using namespace workrave;
+
+BreakWindowPool::BreakWindowPool(IToolkit::Ptr toolkit)
+  : toolkit(std::move(toolkit))
+{
+}
+
+//! Returns a hidden prelude window, creating it if the pool has none.
+IPreludeWindow::Ptr
+BreakWindowPool::get_prelude_window(int head, BreakId break_id)
+{
+  Key key{Kind::Prelude, head, break_id, BREAK_FLAGS_NONE};
+
+  auto it = prelude_windows.find(key);
+  if (it != prelude_windows.end())
+    {
+      TRACE_MSG("reusing prelude window {} {}", head, break_id);
+      return it->second;
+    }
+
+  IPreludeWindow::Ptr window = toolkit->create_prelude_window(head, break_id);
+  prelude_windows[key] = window;
+  return window;
+}
+
+//! Returns a hidden, initialized break window, creating it if the pool has none.
+IBreakWindow::Ptr
+BreakWindowPool::get_break_window(int head, BreakId break_id, BreakFlags break_flags)
+{
+  Key key{Kind::Break, head, break_id, break_flags};
+
+  auto it = break_windows.find(key);
+  if (it != break_windows.end())
+    {
+      TRACE_MSG("reusing break window {} {} {}", head, break_id, break_flags);
+      return it->second;
+    }
+
+  IBreakWindow::Ptr window = toolkit->create_break_window(head, break_id, break_flags);
+  if (window)
+    {
+      window->init();
+      break_windows[key] = window;
+    }
+  return window;
+}
+
+//! Builds the prelude window while the toolkit is idle.
+void
+BreakWindowPool::prepare_prelude_window(int head, BreakId break_id)
+{
+  pending.emplace_back(Kind::Prelude, head, break_id, BREAK_FLAGS_NONE);
+  schedule_prepare();
+}
+
+//! Builds the break window while the toolkit is idle.
+void
+BreakWindowPool::prepare_break_window(int head, BreakId break_id, BreakFlags break_flags)
+{
+  pending.emplace_back(Kind::Break, head, break_id, break_flags);
+  schedule_prepare();
+}
+
+//! Drops all windows. Windows that are currently shown remain alive until they are released.
+void
+BreakWindowPool::clear()
+{
+  TRACE_ENTRY();
+  prelude_windows.clear();
+  break_windows.clear();
+  pending.clear();
+}
+
+//! Builds one pending window, so that the toolkit can handle events in between.
+void
+BreakWindowPool::on_prepare()
+{
+  prepare_scheduled = false;
+  if (pending.empty())
+    {
+      return;
+    }
+
+  auto [kind, head, break_id, break_flags] = pending.front();
+  pending.pop_front();
+
+  if (head < toolkit->get_head_count())
+    {
+      if (kind == Kind::Prelude)
+        {
+          get_prelude_window(head, break_id);
+        }
+      else
+        {
+          get_break_window(head, break_id, break_flags);
+        }
+    }
+
+  schedule_prepare();
+}
+
+void
+BreakWindowPool::schedule_prepare()
+{
+  if (prepare_scheduled || pending.empty())
+    {
+      return;
+    }
+
+  prepare_scheduled = true;
+  std::weak_ptr<BreakWindowPool> self = shared_from_this();
+  toolkit->create_oneshot_timer(0, [self]() {
+    if (auto pool = self.lock())
+      {
+        pool->on_prepare();
+      }
+  });
+}
@@ -22,12 +22,19 @@
 
 #include "ui/Exercise.hh"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <numeric>
+#include <random>
 #include <string>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 
 #include "debug.hh"
 #include "utils/AssetPath.hh"
+#include "utils/Paths.hh"
 
 #ifdef HAVE_GLIB
 #  include <glib.h>
@@ -36,6 +43,67 @@
 using namespace std;
 using namespace workrave::utils;
 
+namespace
+{
+  const char CATALOG_MAGIC[4] = {'W', 'R', 'E', 'X'};
+  const uint32_t CATALOG_VERSION = 1;
+
+  //! Largest string accepted from a catalog file.
+  const uint32_t CATALOG_MAX_STRING = 1024 * 1024;
+
+  //! Parsed exercises of a catalog key.
+  struct Catalog
+  {
+    std::string key;
+    std::list<Exercise> exercises;
+  };
+
+  //! Parsed exercises, by language.
+  std::map<std::string, Catalog> catalogs;
+
+  void write_u32(std::ostream &out, uint32_t value)
+  {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(value));
+  }
+
+  void write_string(std::ostream &out, const std::string &value)
+  {
+    write_u32(out, static_cast<uint32_t>(value.size()));
+    out.write(value.data(), static_cast<std::streamsize>(value.size()));
+  }
+
+  bool read_u32(std::istream &in, uint32_t &value)
+  {
+    in.read(reinterpret_cast<char *>(&value), sizeof(value));
+    return static_cast<bool>(in);
+  }
+
+  bool read_string(std::istream &in, std::string &value)
+  {
+    uint32_t size = 0;
+    if (!read_u32(in, size) || size > CATALOG_MAX_STRING)
+      {
+        return false;
+      }
+    value.resize(size);
+    in.read(value.data(), size);
+    return static_cast<bool>(in);
+  }
+
+  std::string get_languages()
+  {
+    std::string ret;
+#ifdef HAVE_GLIB
+    for (const char *const *language = g_get_language_names(); *language != nullptr; language++)
+      {
+        ret += *language;
+        ret += ':';
+      }
+#endif
+    return ret;
+  }
+} // namespace
+
 /* Updates language dependent attribute */
 static void
 exercise_parse_update_i18n_attribute(const char *const *languages,
@@ -186,19 +254,204 @@ Exercise::parse_exercises(const char *file_name, std::list<Exercise> &exercises)
 std::string
 Exercise::get_exercises_file_name()
 {
-  return AssetPath::complete_directory("exercises.xml", AssetPath::SEARCH_PATH_EXERCISES);
+  static std::string file_name;
+
+  if (file_name.empty() || !std::filesystem::is_regular_file(file_name))
+    {
+      file_name = AssetPath::complete_directory("exercises.xml", AssetPath::SEARCH_PATH_EXERCISES);
+    }
+  return file_name;
+}
+
+//! Returns the key that identifies the parsed contents of the exercises file.
+/*!
+ *  The key changes when the file is modified, or when the preferred languages
+ *  change.
+ */
+std::string
+Exercise::get_catalog_key(const std::string &file_name)
+{
+  std::error_code ec;
+  auto mtime = std::filesystem::last_write_time(file_name, ec);
+  auto size = std::filesystem::file_size(file_name, ec);
+
+  return file_name + '\n' + std::to_string(mtime.time_since_epoch().count()) + '\n' + std::to_string(size) + '\n'
+         + get_languages();
 }
 
+//! Returns the exercises.
 std::list<Exercise>
 Exercise::get_exercises()
 {
-  std::list<Exercise> exercises;
+  TRACE_ENTRY();
   std::string file_name = get_exercises_file_name();
-  if (file_name.length() > 0)
+  if (file_name.empty())
+    {
+      return std::list<Exercise>();
+    }
+
+  return get_exercises(file_name, Paths::get_state_directory() / "exercises.cache");
+}
+
+//! Returns the exercises of the specified exercises file.
+/*!
+ *  The exercises file is parsed at most once per language. The parsed
+ *  exercises are also cached on disk, so that the file is not parsed again
+ *  until it is modified.
+ */
+std::list<Exercise>
+Exercise::get_exercises(const std::string &file_name, const std::filesystem::path &cache_path)
+{
+  TRACE_ENTRY_PAR(file_name);
+  std::string key = get_catalog_key(file_name);
+  Catalog &catalog = catalogs[get_languages()];
+
+  if (catalog.key != key)
+    {
+      catalog.exercises.clear();
+      if (!load_catalog(cache_path, key, catalog.exercises))
+        {
+          catalog.exercises.clear();
+          parse_exercises(file_name.c_str(), catalog.exercises);
+          save_catalog(cache_path, key, catalog.exercises);
+        }
+      catalog.key = key;
+    }
+
+  return catalog.exercises;
+}
+
+//! Loads the exercises from the on-disk cache.
+/*!
+ *  \return false if the cache does not exist, is invalid or was created for
+ *          another key.
+ */
+bool
+Exercise::load_catalog(const std::filesystem::path &path, const std::string &key, std::list<Exercise> &exercises)
+{
+  TRACE_ENTRY_PAR(path.string());
+  std::ifstream file(path, std::ios::binary);
+
+  char magic[4] = {};
+  uint32_t version = 0;
+  std::string file_key;
+  uint32_t count = 0;
+
+  file.read(magic, sizeof(magic));
+  if (!file || memcmp(magic, CATALOG_MAGIC, sizeof(CATALOG_MAGIC)) != 0 || !read_u32(file, version)
+      || version != CATALOG_VERSION || !read_string(file, file_key) || file_key != key || !read_u32(file, count))
+    {
+      TRACE_MSG("no valid cache");
+      return false;
+    }
+
+  for (uint32_t i = 0; i < count; i++)
+    {
+      Exercise exercise;
+      uint32_t duration = 0;
+      uint32_t image_count = 0;
+
+      if (!read_string(file, exercise.title) || !read_string(file, exercise.description) || !read_u32(file, duration)
+          || !read_u32(file, image_count))
+        {
+          return false;
+        }
+      exercise.duration = static_cast<int>(duration);
+
+      for (uint32_t j = 0; j < image_count; j++)
+        {
+          std::string src;
+          uint32_t image_duration = 0;
+          uint32_t mirror_x = 0;
+
+          if (!read_string(file, src) || !read_u32(file, image_duration) || !read_u32(file, mirror_x))
+            {
+              return false;
+            }
+          exercise.sequence.emplace_back(src, static_cast<int>(image_duration), mirror_x != 0);
+        }
+
+      exercises.push_back(exercise);
+    }
+
+  return true;
+}
+
+//! Saves the exercises to the on-disk cache.
+void
+Exercise::save_catalog(const std::filesystem::path &path, const std::string &key, const std::list<Exercise> &exercises)
+{
+  TRACE_ENTRY_PAR(path.string());
+  std::filesystem::path temp_path = path;
+  temp_path += ".new";
+
+  {
+    std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+
+    file.write(CATALOG_MAGIC, sizeof(CATALOG_MAGIC));
+    write_u32(file, CATALOG_VERSION);
+    write_string(file, key);
+    write_u32(file, static_cast<uint32_t>(exercises.size()));
+
+    for (const auto &exercise: exercises)
+      {
+        write_string(file, exercise.title);
+        write_string(file, exercise.description);
+        write_u32(file, static_cast<uint32_t>(exercise.duration));
+        write_u32(file, static_cast<uint32_t>(exercise.sequence.size()));
+
+        for (const auto &image: exercise.sequence)
+          {
+            write_string(file, image.image);
+            write_u32(file, static_cast<uint32_t>(image.duration));
+            write_u32(file, image.mirror_x ? 1 : 0);
+          }
+      }
+
+    file.close();
+    if (!file)
+      {
+        TRACE_MSG("failed to write cache");
+        std::error_code ec;
+        std::filesystem::remove(temp_path, ec);
+        return;
+      }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(temp_path, path, ec);
+  if (ec)
+    {
+      TRACE_MSG("failed to rename cache: {}", ec.message());
+    }
+}
+
+//! Returns the exercises in a random order that is fixed for the session.
+/*!
+ *  A fixed order allows the images of the exercises of the next break to be
+ *  decoded before the break starts.
+ */
+std::vector<Exercise>
+Exercise::get_shuffled_exercises()
+{
+  static std::vector<size_t> order;
+
+  std::list<Exercise> exercises = get_exercises();
+  if (order.size() != exercises.size())
+    {
+      order.resize(exercises.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::shuffle(order.begin(), order.end(), std::mt19937(std::random_device()()));
+    }
+
+  std::vector<Exercise> all(exercises.begin(), exercises.end());
+  std::vector<Exercise> shuffled;
+  shuffled.reserve(all.size());
+  for (size_t index: order)
     {
-      parse_exercises(file_name.c_str(), exercises);
+      shuffled.push_back(all[index]);
     }
-  return exercises;
+  return shuffled;
 }
 
 bool
@@ -19,6 +19,8 @@
 #  include "config.h"
 #endif
 
+#include <algorithm>
+
 #include "commonui/nls.h"
 #include "debug.hh"
 
@@ -37,6 +39,9 @@
 #define WORKRAVE_APPLET_SERVICE_IFACE "org.workrave.AppletInterface"
 #define WORKRAVE_APPLET_SERVICE_OBJ "/org/workrave/Workrave/UI"
 
+//! Applets that do not set update options consider Workrave gone after 5s without a TimersUpdated signal.
+static constexpr auto APPLET_KEEPALIVE_INTERVAL = std::chrono::seconds(2);
+
 GenericDBusApplet::GenericDBusApplet(std::shared_ptr<IApplication> app)
   : app(app)
   , toolkit(app->get_toolkit())
@@ -55,6 +60,7 @@ GenericDBusApplet::GenericDBusApplet(std::shared_ptr<IApplication> app)
       data[i].bar_secondary_color = 0;
       data[i].bar_secondary_val = 0;
       data[i].bar_secondary_max = 0;
+      text_value[i] = -1;
     }
 
   GUIConfig::trayicon_enabled().connect(this, [this](bool) { send_tray_icon_enabled(); });
@@ -78,7 +84,18 @@ GenericDBusApplet::set_time_bar(BreakId id,
                                 int secondary_max)
 {
   TRACE_ENTRY_PAR(int(id), value);
-  data[id].bar_text = Text::time_to_string(value);
+  if (update_granularity > 1)
+    {
+      value -= value % update_granularity;
+      primary_val -= primary_val % update_granularity;
+      secondary_val -= secondary_val % update_granularity;
+    }
+
+  if (value != text_value[id])
+    {
+      data[id].bar_text = Text::time_to_string(value);
+      text_value[id] = value;
+    }
   data[id].bar_primary_color = (int)primary_color;
   data[id].bar_primary_val = primary_val;
   data[id].bar_primary_max = primary_max;
@@ -91,9 +108,40 @@ void
 GenericDBusApplet::update_view()
 {
   TRACE_ENTRY();
+  if (!embedded)
+    {
+      return;
+    }
+
   org_workrave_AppletInterface *iface = org_workrave_AppletInterface::instance(dbus);
   assert(iface != nullptr);
-  iface->TimersUpdated(WORKRAVE_APPLET_SERVICE_OBJ, data[BREAK_ID_MICRO_BREAK], data[BREAK_ID_REST_BREAK], data[BREAK_ID_DAILY_LIMIT]);
+
+  auto now = std::chrono::steady_clock::now();
+  bool changed = false;
+
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      if (sent_data_valid && data[i] == sent_data[i])
+        {
+          continue;
+        }
+
+      changed = true;
+      if (incremental_updates)
+        {
+          iface->TimerUpdated(WORKRAVE_APPLET_SERVICE_OBJ, i, data[i]);
+        }
+      sent_data[i] = data[i];
+    }
+
+  bool keepalive = !incremental_updates && now - last_update_time >= APPLET_KEEPALIVE_INTERVAL;
+
+  if (!incremental_updates && (changed || keepalive))
+    {
+      iface->TimersUpdated(WORKRAVE_APPLET_SERVICE_OBJ, data[BREAK_ID_MICRO_BREAK], data[BREAK_ID_REST_BREAK], data[BREAK_ID_DAILY_LIMIT]);
+      last_update_time = now;
+    }
+  sent_data_valid = true;
 }
 
 void
@@ -113,7 +161,7 @@ GenericDBusApplet::init()
           menu_helper.setup_event();
           send_menu_updated_event();
 
-          workrave::utils::connect(toolkit->signal_timer(), control, [this]() { control->update(); });
+          workrave::utils::connect(toolkit->signal_timer(), control, [this]() { on_timer(); });
         }
     }
   catch (workrave::dbus::DBusException &)
@@ -121,6 +169,18 @@ GenericDBusApplet::init()
     }
 }
 
+void
+GenericDBusApplet::on_timer()
+{
+  // The timer box only updates the view when the timers change. Applets that
+  // receive all timers expect them periodically, even if nothing changed.
+  if (embedded && !incremental_updates && std::chrono::steady_clock::now() - last_update_time >= APPLET_KEEPALIVE_INTERVAL)
+    {
+      control->invalidate();
+    }
+  control->update();
+}
+
 void
 GenericDBusApplet::applet_embed(bool enable, const std::string &sender)
 {
@@ -138,6 +198,19 @@ GenericDBusApplet::applet_embed(bool enable, const std::string &sender)
       dbus->watch(sender, this);
     }
 
+  // A (new) applet starts with the default update options and must set its
+  // own options after embedding. Send it the complete state.
+  update_granularity = 1;
+  incremental_updates = false;
+  sent_data_valid = false;
+  last_update_time = {};
+  control->invalidate();
+
+  for (int &value: text_value)
+    {
+      value = -1;
+    }
+
   if (!enable)
     {
       TRACE_MSG("Disabling");
@@ -146,6 +219,28 @@ GenericDBusApplet::applet_embed(bool enable, const std::string &sender)
     }
 }
 
+//! Sets how the applet wants to receive timer updates.
+/*!
+ *  Time values are rounded down to the granularity in seconds, so that an
+ *  applet that shows minutes is only updated once per minute. Incremental
+ *  applets receive a TimerUpdated signal for each changed timer instead of
+ *  TimersUpdated, and no periodic updates when nothing changed.
+ */
+void
+GenericDBusApplet::applet_set_update_options(int granularity, bool incremental)
+{
+  TRACE_ENTRY_PAR(granularity, incremental);
+  update_granularity = std::max(granularity, 1);
+  incremental_updates = incremental;
+  sent_data_valid = false;
+  control->invalidate();
+
+  for (int &value: text_value)
+    {
+      value = -1;
+    }
+}
+
 void
 GenericDBusApplet::get_menu(std::list<MenuItem> &out)
 {
@@ -18,6 +18,7 @@
 #ifndef GENERICDBUSAPPLET_HH
 #define GENERICDBUSAPPLET_HH
 
+#include <chrono>
 #include <string>
 #include <set>
 
@@ -51,6 +52,18 @@ public:
     uint32_t bar_primary_color;
     uint32_t bar_primary_val;
     uint32_t bar_primary_max;
+
+    bool operator==(const TimerData &other) const
+    {
+      return bar_text == other.bar_text && slot == other.slot && bar_secondary_color == other.bar_secondary_color
+             && bar_secondary_val == other.bar_secondary_val && bar_secondary_max == other.bar_secondary_max
+             && bar_primary_color == other.bar_primary_color && bar_primary_val == other.bar_primary_val
+             && bar_primary_max == other.bar_primary_max;
+    }
+    bool operator!=(const TimerData &other) const
+    {
+      return !(*this == other);
+    }
   };
 
   struct MenuItem
@@ -93,6 +106,7 @@ public:
   virtual void applet_menu_action(const std::string &action);
   virtual void applet_command(int command);
   virtual void applet_embed(bool enable, const std::string &sender);
+  virtual void applet_set_update_options(int granularity, bool incremental);
   virtual void button_clicked(int button);
 
   using MenuItems = std::list<MenuItem>;
@@ -113,6 +127,7 @@ private:
   // IDBusWatch
   void bus_name_presence(const std::string &name, bool present) override;
 
+  void on_timer();
   void send_menu_updated_event();
   void init_menu_list(std::list<MenuItem> &items, menus::Node::Ptr node);
   void update_menu_item(menus::Node::Ptr node);
@@ -127,6 +142,24 @@ private:
   bool visible{false};
   bool embedded{false};
   TimerData data[workrave::BREAK_ID_SIZEOF];
+
+  //! Timer data last sent to the applet.
+  TimerData sent_data[workrave::BREAK_ID_SIZEOF];
+
+  //! Whether sent_data holds the state of the applet.
+  bool sent_data_valid{false};
+
+  //! Time value from which the text of each timer was formatted.
+  int text_value[workrave::BREAK_ID_SIZEOF];
+
+  //! Time of the last TimersUpdated signal.
+  std::chrono::steady_clock::time_point last_update_time;
+
+  //! Resolution in seconds of the time values shown by the applet.
+  int update_granularity{1};
+
+  //! Whether the applet receives changed timers only, through TimerUpdated.
+  bool incremental_updates{false};
   std::set<std::string> active_bus_names;
   workrave::dbus::IDBus::Ptr dbus;
   std::shared_ptr<TimerBoxControl> control;
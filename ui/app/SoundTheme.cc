@@ -189,6 +189,13 @@ SoundTheme::init()
   player->init();
   load_themes();
   register_sound_events();
+  preload_sounds();
+
+  for (SoundEvent event: events())
+    {
+      sound_event(event).connect(this, [this](const std::string &) { preload_sounds(); });
+      sound_event_enabled(event).connect(this, [this](bool) { preload_sounds(); });
+    }
 }
 
 void
@@ -209,6 +216,25 @@ SoundTheme::register_sound_events()
     }
 }
 
+//! Lets the player decode the sounds of all enabled events ahead of playback.
+void
+SoundTheme::preload_sounds()
+{
+  TRACE_ENTRY();
+  std::vector<std::string> filenames;
+
+  for (SoundEvent event: events())
+    {
+      std::string filename = sound_event(event)();
+      if (sound_event_enabled(event)() && !filename.empty())
+        {
+          filenames.push_back(filename);
+        }
+    }
+
+  player->preload_sounds(filenames);
+}
+
 void
 SoundTheme::activate_theme(const std::string &theme_id)
 {
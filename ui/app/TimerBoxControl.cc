@@ -25,6 +25,7 @@
 #  include "MacOSHelpers.hh"
 #endif
 
+#include <algorithm>
 #include <iostream>
 #include <utility>
 
@@ -32,7 +33,7 @@
 
 #include "ui/GUIConfig.hh"
 #include "core/CoreConfig.hh"
-#include "core/IBreak.hh"
+#include "core/TimerSnapshot.hh"
 
 using namespace std;
 using namespace workrave;
@@ -52,32 +53,28 @@ void
 TimerBoxControl::update()
 {
   auto core = app->get_core();
-  OperationMode mode = core->get_regular_operation_mode();
+  TimerSnapshot::Ptr snapshot = core->get_timer_snapshot();
+  OperationMode mode = snapshot->operation_mode;
+
+  // Updates may be skipped while the timers do not change, so cycling is
+  // based on the wall clock instead of on the number of updates.
+  time_t now = time(nullptr);
 
   if (reconfigure)
     {
       // Configuration was changed. reinit.
-      init_table();
+      init_table(*snapshot);
 
       operation_mode = mode;
       init_icon();
       reconfigure = false;
+      next_cycle_time = now - now % cycle_time + cycle_time;
     }
-  else
+  else if (!is_forced() && now >= next_cycle_time)
     {
-      if (force_duration == 0)
-        {
-          time_t t = time(nullptr);
-          if (t % cycle_time == 0)
-            {
-              init_table();
-              cycle_slots();
-            }
-        }
-      else
-        {
-          force_duration--;
-        }
+      init_table(*snapshot);
+      cycle_slots();
+      next_cycle_time = now - now % cycle_time + cycle_time;
     }
 
   // Update visual feedback of operating mode.
@@ -87,17 +84,31 @@ TimerBoxControl::update()
       init_icon();
     }
 
-  // Update the timer widgets.
-  update_widgets();
-  view->update_view();
+  // Update the timer widgets, unless nothing changed since the last update.
+  if (view_changed || snapshot->version != snapshot_version)
+    {
+      update_widgets(*snapshot);
+      view->update_view();
+
+      snapshot_version = snapshot->version;
+      view_changed = false;
+    }
+
+  // Make sure the next update is not skipped when the view changes by itself.
+  time_t deadline = is_forced() ? force_until : (is_cycling() ? next_cycle_time : 0);
+  if (deadline != 0)
+    {
+      app->get_toolkit()->limit_timer_delay(static_cast<int>(std::max<time_t>(deadline - now, 1) * 1000));
+    }
 }
 
 void
 TimerBoxControl::force_cycle()
 {
-  force_duration = cycle_time;
-  init_table();
+  force_until = time(nullptr) + cycle_time;
+  init_table(*app->get_core()->get_timer_snapshot());
   cycle_slots();
+  app->get_toolkit()->limit_timer_delay(cycle_time * 1000);
 }
 
 void
@@ -106,6 +117,13 @@ TimerBoxControl::set_force_empty(bool s)
   force_empty = s;
 }
 
+//! Updates the view on the next update, even if the timers did not change.
+void
+TimerBoxControl::invalidate()
+{
+  view_changed = true;
+}
+
 //! Initializes the timerbox.
 void
 TimerBoxControl::init()
@@ -134,12 +152,11 @@ TimerBoxControl::init()
 
 //! Updates the main window.
 void
-TimerBoxControl::update_widgets()
+TimerBoxControl::update_widgets(const TimerSnapshot &snapshot)
 {
   for (int count = 0; count < BREAK_ID_SIZEOF; count++)
     {
-      auto core = app->get_core();
-      auto b = core->get_break(static_cast<BreakId>(count));
+      const BreakTimerState &b = snapshot.get(static_cast<BreakId>(count));
 
       time_t value = 0;
       TimerColorId primary_color;
@@ -150,14 +167,14 @@ TimerBoxControl::update_widgets()
       int secondary_max = 0;
 
       // Collect some data.
-      int64_t maxActiveTime = b->get_limit();
-      int64_t activeTime = b->get_elapsed_time();
-      int64_t breakDuration = b->get_auto_reset();
-      int64_t idleTime = b->get_elapsed_idle_time();
-      bool overdue = (maxActiveTime < activeTime);
+      int64_t maxActiveTime = b.limit;
+      int64_t activeTime = b.elapsed_time;
+      int64_t breakDuration = b.auto_reset;
+      int64_t idleTime = b.elapsed_idle_time;
+      bool overdue = b.is_overdue();
 
       // Set the value
-      if (b->is_limit_enabled() && maxActiveTime != 0)
+      if (b.limit_enabled && maxActiveTime != 0)
         {
           value = maxActiveTime - activeTime;
         }
@@ -175,7 +192,7 @@ TimerBoxControl::update_widgets()
 
       primary_color = overdue ? TimerColorId::Overdue : TimerColorId::Active;
 
-      if (b->is_auto_reset_enabled() && breakDuration != 0)
+      if (b.auto_reset_enabled && breakDuration != 0)
         {
           // resting.
           secondary_color = TimerColorId::Inactive;
@@ -211,13 +228,16 @@ TimerBoxControl::init_icon()
       view->set_icon(StatusIconType::Quiet);
       break;
     }
+  view_changed = true;
 }
 
 //! Initializes the applet.
 void
-TimerBoxControl::init_table()
+TimerBoxControl::init_table(const TimerSnapshot &snapshot)
 {
   TRACE_ENTRY();
+  view_changed = true;
+
   if (force_empty)
     {
       for (int i = 0; i < BREAK_ID_SIZEOF; i++)
@@ -230,7 +250,7 @@ TimerBoxControl::init_table()
       // Determine what breaks to show.
       for (int i = 0; i < BREAK_ID_SIZEOF; i++)
         {
-          init_slot(i);
+          init_slot(snapshot, i);
         }
 
       // New content.
@@ -254,7 +274,7 @@ TimerBoxControl::init_table()
 
 //! Compute what break to show on the specified location.
 void
-TimerBoxControl::init_slot(int slot)
+TimerBoxControl::init_slot(const TimerSnapshot &snapshot, int slot)
 {
   // TRACE_ENTRY_PAR(slot);
   int count = 0;
@@ -263,10 +283,7 @@ TimerBoxControl::init_slot(int slot)
   // Collect all timers for this slot.
   for (int i = 0; i < BREAK_ID_SIZEOF; i++)
     {
-      auto core = app->get_core();
-      auto b = core->get_break(BreakId(i));
-
-      bool on = b->is_enabled();
+      bool on = snapshot.get(BreakId(i)).enabled;
 
       if (on && break_position[i] == slot && !(break_flags[i] & GUIConfig::BREAK_HIDE))
         {
@@ -285,13 +302,10 @@ TimerBoxControl::init_slot(int slot)
       int id = breaks_id[i];
       int flags = break_flags[id];
 
-      auto core = app->get_core();
-      auto b = core->get_break(static_cast<BreakId>(i));
-
-      int64_t time_left = b->get_limit() - b->get_elapsed_time();
+      int64_t time_left = snapshot.get(BreakId(id)).get_time_left();
 
       // Exclude break if not imminent.
-      if (flags & GUIConfig::BREAK_WHEN_IMMINENT && time_left > break_imminent_time[id] && force_duration == 0)
+      if (flags & GUIConfig::BREAK_WHEN_IMMINENT && time_left > break_imminent_time[id] && !is_forced())
         {
           break_flags[id] |= GUIConfig::BREAK_SKIP;
         }
@@ -312,7 +326,7 @@ TimerBoxControl::init_slot(int slot)
 
       if (!(flags & GUIConfig::BREAK_SKIP))
         {
-          if (flags & GUIConfig::BREAK_WHEN_FIRST && first_id != id && force_duration == 0)
+          if (flags & GUIConfig::BREAK_WHEN_FIRST && first_id != id && !is_forced())
             {
               break_flags[id] |= GUIConfig::BREAK_SKIP;
             }
@@ -329,7 +343,7 @@ TimerBoxControl::init_slot(int slot)
 
       if (!(flags & GUIConfig::BREAK_SKIP))
         {
-          if (flags & GUIConfig::BREAK_EXCLUSIVE && have_one && force_duration == 0)
+          if (flags & GUIConfig::BREAK_EXCLUSIVE && have_one && !is_forced())
             {
               break_flags[id] |= GUIConfig::BREAK_SKIP;
             }
@@ -391,6 +405,27 @@ TimerBoxControl::cycle_slots()
     }
 }
 
+//! Returns whether all breaks are shown because of a forced cycle.
+bool
+TimerBoxControl::is_forced() const
+{
+  return time(nullptr) < force_until;
+}
+
+//! Returns whether a slot cycles through more than one break.
+bool
+TimerBoxControl::is_cycling() const
+{
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      if (break_slots[i][1] != -1)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
 //! Reads the applet configuration.
 void
 TimerBoxControl::load_configuration()
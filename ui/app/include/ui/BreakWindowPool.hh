@@ -0,0 +1,81 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef WORKRAVE_UI_BREAKWINDOWPOOL_HH
+#define WORKRAVE_UI_BREAKWINDOWPOOL_HH
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "core/CoreTypes.hh"
+#include "ui/IBreakWindow.hh"
+#include "ui/IPreludeWindow.hh"
+#include "ui/IToolkit.hh"
+#include "ui/UiTypes.hh"
+
+//! Hidden break and prelude windows, ready to be shown.
+/*!
+ *  Creating a break window builds its complete widget tree, which is slow
+ *  enough to be visible when a break starts. The pool keeps the windows of
+ *  previous breaks and builds the windows of upcoming breaks while the
+ *  toolkit is idle. Windows are reused until the pool is cleared, e.g.
+ *  because the monitor layout or the configuration changed.
+ */
+class BreakWindowPool : public std::enable_shared_from_this<BreakWindowPool>
+{
+public:
+  using Ptr = std::shared_ptr<BreakWindowPool>;
+
+  explicit BreakWindowPool(IToolkit::Ptr toolkit);
+
+  IPreludeWindow::Ptr get_prelude_window(int head, workrave::BreakId break_id);
+  IBreakWindow::Ptr get_break_window(int head, workrave::BreakId break_id, BreakFlags break_flags);
+
+  void prepare_prelude_window(int head, workrave::BreakId break_id);
+  void prepare_break_window(int head, workrave::BreakId break_id, BreakFlags break_flags);
+
+  void clear();
+
+private:
+  enum class Kind
+  {
+    Prelude,
+    Break
+  };
+
+  using Key = std::tuple<Kind, int, workrave::BreakId, BreakFlags>;
+
+  void schedule_prepare();
+  void on_prepare();
+
+private:
+  IToolkit::Ptr toolkit;
+
+  std::map<Key, IPreludeWindow::Ptr> prelude_windows;
+  std::map<Key, IBreakWindow::Ptr> break_windows;
+
+  //! Windows to be built while the toolkit is idle.
+  std::deque<Key> pending;
+
+  //! Whether building the pending windows is scheduled.
+  bool prepare_scheduled{false};
+};
+
+#endif // WORKRAVE_UI_BREAKWINDOWPOOL_HH
@@ -18,9 +18,11 @@
 #ifndef WORKRAVE_UI_EXERCISE_HH
 #define WORKRAVE_UI_EXERCISE_HH
 
+#include <filesystem>
 #include <list>
 #include <string>
 #include <utility>
+#include <vector>
 
 struct Exercise
 {
@@ -47,10 +49,15 @@ public:
 
 public:
   static std::list<Exercise> get_exercises();
+  static std::list<Exercise> get_exercises(const std::string &file_name, const std::filesystem::path &cache_path);
+  static std::vector<Exercise> get_shuffled_exercises();
+  static std::string get_catalog_key(const std::string &file_name);
 
 private:
   static std::string get_exercises_file_name();
   static void parse_exercises(const char *file_name, std::list<Exercise> &);
+  static bool load_catalog(const std::filesystem::path &path, const std::string &key, std::list<Exercise> &exercises);
+  static void save_catalog(const std::filesystem::path &path, const std::string &key, const std::list<Exercise> &exercises);
 };
 
 #endif // WORKRAVE_UI_EXERCISE_HH
@@ -0,0 +1,250 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef WORKRAVE_UI_EXERCISEIMAGECACHE_HH
+#define WORKRAVE_UI_EXERCISEIMAGECACHE_HH
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "ui/Exercise.hh"
+#include "utils/AssetPath.hh"
+
+//! Decoded exercise images.
+/*!
+ *  Images are decoded by a worker thread ahead of time, or by the caller when
+ *  an image is needed that was not prefetched. Images are cached by source,
+ *  mirroring and scale. The least recently used images are dropped when the
+ *  decoded images exceed the memory budget.
+ *
+ *  ImageType must be safe to create on one thread and use on another, e.g.
+ *  a Gdk::Pixbuf or a QImage.
+ */
+template<typename ImageType>
+class ExerciseImageCache
+{
+public:
+  //! Decodes an image file, mirrors it horizontally if requested and scales it.
+  using Loader = std::function<ImageType(const std::string &filename, bool mirror_x, double scale)>;
+
+  //! Returns the number of bytes used by a decoded image.
+  using SizeOf = std::function<std::size_t(const ImageType &image)>;
+
+  ExerciseImageCache(Loader loader, SizeOf size_of, std::size_t budget)
+    : loader(std::move(loader))
+    , size_of(std::move(size_of))
+    , budget(budget)
+  {
+  }
+
+  ~ExerciseImageCache()
+  {
+    if (worker_thread)
+      {
+        {
+          std::unique_lock lock(mutex);
+          stopping = true;
+        }
+        cond.notify_all();
+        worker_thread->join();
+      }
+  }
+
+  ExerciseImageCache(const ExerciseImageCache &) = delete;
+  ExerciseImageCache &operator=(const ExerciseImageCache &) = delete;
+
+  //! Decodes the specified images in the background, in the specified order.
+  void prefetch(const std::vector<Exercise::Image> &images, double scale = 1.0)
+  {
+    bool queued = false;
+    {
+      std::unique_lock lock(mutex);
+      for (const auto &image: images)
+        {
+          Key key{image.image, image.mirror_x, scale};
+          if (entries.find(key) == entries.end() && loading.find(key) == loading.end())
+            {
+              loading.insert(key);
+              queue.emplace_back(key, resolve(image.image));
+              queued = true;
+            }
+        }
+    }
+
+    if (queued)
+      {
+        if (!worker_thread)
+          {
+            worker_thread = std::make_shared<std::thread>([this] { run(); });
+          }
+        cond.notify_all();
+      }
+  }
+
+  //! Returns the decoded image, decoding it now if it was not prefetched.
+  ImageType get(const Exercise::Image &image, double scale = 1.0)
+  {
+    Key key{image.image, image.mirror_x, scale};
+
+    {
+      std::unique_lock lock(mutex);
+      auto it = std::find_if(queue.begin(), queue.end(), [&](const auto &item) { return item.first == key; });
+      if (it != queue.end())
+        {
+          // Not started by the worker yet. Decode it here instead.
+          queue.erase(it);
+          loading.erase(key);
+        }
+
+      cond.wait(lock, [&] { return loading.find(key) == loading.end(); });
+
+      auto entry = entries.find(key);
+      if (entry != entries.end())
+        {
+          lru.splice(lru.begin(), lru, entry->second.lru);
+          return entry->second.image;
+        }
+    }
+
+    ImageType decoded = loader(resolve(image.image), image.mirror_x, scale);
+
+    std::unique_lock lock(mutex);
+    insert(key, decoded);
+    return decoded;
+  }
+
+private:
+  struct Key
+  {
+    std::string src;
+    bool mirror_x{false};
+    double scale{1.0};
+
+    bool operator<(const Key &other) const
+    {
+      return std::tie(src, mirror_x, scale) < std::tie(other.src, other.mirror_x, other.scale);
+    }
+
+    bool operator==(const Key &other) const
+    {
+      return std::tie(src, mirror_x, scale) == std::tie(other.src, other.mirror_x, other.scale);
+    }
+  };
+
+  struct Entry
+  {
+    ImageType image;
+    std::size_t size{0};
+    typename std::list<Key>::iterator lru;
+  };
+
+  static std::string resolve(const std::string &src)
+  {
+    return workrave::utils::AssetPath::complete_directory(src, workrave::utils::AssetPath::SEARCH_PATH_EXERCISES);
+  }
+
+  void run()
+  {
+    std::unique_lock lock(mutex);
+    while (true)
+      {
+        cond.wait(lock, [this] { return stopping || !queue.empty(); });
+        if (stopping)
+          {
+            break;
+          }
+
+        auto [key, filename] = queue.front();
+        queue.pop_front();
+
+        lock.unlock();
+        ImageType decoded = loader(filename, key.mirror_x, key.scale);
+        lock.lock();
+
+        insert(key, decoded);
+        loading.erase(key);
+        cond.notify_all();
+      }
+  }
+
+  //! Adds a decoded image as the most recently used one. Must be called with the mutex locked.
+  void insert(const Key &key, const ImageType &image)
+  {
+    auto it = entries.find(key);
+    if (it != entries.end())
+      {
+        used -= it->second.size;
+        lru.erase(it->second.lru);
+        entries.erase(it);
+      }
+
+    lru.push_front(key);
+    std::size_t size = size_of(image);
+    entries[key] = Entry{image, size, lru.begin()};
+    used += size;
+
+    while (used > budget && lru.size() > 1)
+      {
+        auto oldest = entries.find(lru.back());
+        used -= oldest->second.size;
+        entries.erase(oldest);
+        lru.pop_back();
+      }
+  }
+
+private:
+  Loader loader;
+  SizeOf size_of;
+
+  //! Maximum number of bytes used by decoded images.
+  std::size_t budget;
+
+  //! Number of bytes used by decoded images.
+  std::size_t used{0};
+
+  std::map<Key, Entry> entries;
+
+  //! Keys of the decoded images, most recently used first.
+  std::list<Key> lru;
+
+  //! Images to be decoded by the worker thread, with their filenames.
+  std::deque<std::pair<Key, std::string>> queue;
+
+  //! Images that are queued or being decoded by the worker thread.
+  std::set<Key> loading;
+
+  bool stopping{false};
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::shared_ptr<std::thread> worker_thread;
+};
+
+#endif // WORKRAVE_UI_EXERCISEIMAGECACHE_HH
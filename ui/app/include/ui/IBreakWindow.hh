@@ -31,13 +31,13 @@ public:
   using Ptr = std::shared_ptr<IBreakWindow>;
   virtual ~IBreakWindow() = default;
 
-  //! Initializes the break window.
+  //! Initializes the break window. Does nothing if it was already initialized.
   virtual void init() = 0;
 
   //! Starts (i.e. shows) the break window.
   virtual void start() = 0;
 
-  //! Stops (i.e. hides) the break window.
+  //! Stops (i.e. hides) the break window. The window may be started again later.
   virtual void stop() = 0;
 
   //! Refreshes the content of the break window.
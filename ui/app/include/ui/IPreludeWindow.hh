@@ -32,7 +32,7 @@ public:
   //! Starts (i.e. shows) the prelude window.
   virtual void start() = 0;
 
-  //! Stops (i.e. hides) the prelude window.
+  //! Stops (i.e. hides) the prelude window. The window may be started again later.
   virtual void stop() = 0;
 
   //! Refreshes the content of the prelude window.
@@ -67,8 +67,20 @@ public:
   virtual boost::signals2::signal<void()> &signal_session_unlocked() = 0;
   virtual boost::signals2::signal<void()> &signal_status_icon_activated() = 0;
 
+  //! Emitted when the monitor layout or the theme changed.
+  virtual boost::signals2::signal<void()> &signal_display_changed() = 0;
+
   virtual const char *get_display_name() const = 0;
   virtual void create_oneshot_timer(int ms, std::function<void()> func) = 0;
+
+  //! Sets the delay until the next timer signal. Unless a new delay is set, the timer signal repeats every second.
+  virtual void set_timer_delay(int ms) = 0;
+
+  //! Emits the timer signal within ms milliseconds, unless it is already due earlier. The limit ends at the next timer signal.
+  virtual void limit_timer_delay(int ms) = 0;
+
+  //! Emits the timer signal as soon as possible, but not within a second of the previous one. May be called from any thread.
+  virtual void wakeup_timer() = 0;
   virtual void show_notification(const std::string &id,
                                  const std::string &title,
                                  const std::string &balloon,
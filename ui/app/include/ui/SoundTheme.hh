@@ -27,6 +27,7 @@
 #include "config/IConfigurator.hh"
 #include "config/Setting.hh"
 #include "audio/ISoundPlayer.hh"
+#include "utils/Signals.hh"
 
 enum class SoundEvent
 {
@@ -42,7 +43,7 @@ enum class SoundEvent
   ExerciseStep,
 };
 
-class SoundTheme
+class SoundTheme : public workrave::utils::Trackable
 {
 public:
   auto sound_enabled() -> workrave::config::Setting<bool> &;
@@ -108,6 +109,7 @@ private:
   void load_themes();
   auto load_sound_theme(const std::string &themedir) -> ThemeInfo::Ptr;
   void register_sound_events();
+  void preload_sounds();
 
 #if defined(PLATFORM_OS_WINDOWS)
   void windows_remove_deprecated_appevents();
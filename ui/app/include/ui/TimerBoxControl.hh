@@ -18,6 +18,7 @@
 #ifndef WORKRAVE_UI_TIMERBOXCONTROL_HH
 #define WORKRAVE_UI_TIMERBOXCONTROL_HH
 
+#include <ctime>
 #include <string>
 
 #include "utils/Signals.hh"
@@ -35,16 +36,19 @@ public:
   void update();
   void force_cycle();
   void set_force_empty(bool s);
+  void invalidate();
 
 private:
-  void update_widgets();
-  void init_table();
+  void update_widgets(const workrave::TimerSnapshot &snapshot);
+  void init_table(const workrave::TimerSnapshot &snapshot);
   void init_icon();
 
   void load_configuration();
 
-  void init_slot(int slot);
+  void init_slot(const workrave::TimerSnapshot &snapshot, int slot);
   void cycle_slots();
+  bool is_forced() const;
+  bool is_cycling() const;
 
 private:
   std::shared_ptr<IApplication> app;
@@ -58,8 +62,18 @@ private:
   int break_slot_cycle[workrave::BREAK_ID_SIZEOF]{};
   std::string name;
   workrave::OperationMode operation_mode{};
-  int force_duration{0};
+  //! Time until which all breaks are shown after a forced cycle.
+  time_t force_until{0};
+
+  //! Time at which the slots are cycled next.
+  time_t next_cycle_time{0};
   bool force_empty{false};
+
+  //! Version of the timer snapshot shown by the view.
+  uint64_t snapshot_version{0};
+
+  //! Has the view been changed since the last update?
+  bool view_changed{true};
 };
 
 #endif // WORKRAVE_UI_TIMERBOXCONTROL_HH
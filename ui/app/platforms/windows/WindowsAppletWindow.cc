@@ -374,7 +374,15 @@ WindowsAppletWindow::init()
 {
   TRACE_ENTRY();
 
-  workrave::utils::connect(toolkit->signal_timer(), this, [this]() { control->update(); });
+  workrave::utils::connect(toolkit->signal_timer(), this, [this]() {
+    // The applet window is searched for on each view update. Keep updating
+    // until it is found, and then send it the current timers.
+    if (applet_window == nullptr)
+      {
+        control->invalidate();
+      }
+    control->update();
+  });
   auto toolkit_win = std::dynamic_pointer_cast<IToolkitWindows>(toolkit);
   if (toolkit_win)
     {
@@ -0,0 +1,174 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#define BOOST_TEST_MODULE workrave_exerciseimagecache
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ui/ExerciseImageCache.hh"
+
+//! Image loader that records which images were decoded on which thread.
+class Fixture
+{
+public:
+  using Cache = ExerciseImageCache<std::string>;
+
+  //! Returns a cache of images of 4 bytes each, e.g. "a!x2", with room for the specified number of images.
+  std::unique_ptr<Cache> make_cache(std::size_t images, std::chrono::milliseconds delay = std::chrono::milliseconds(0))
+  {
+    return std::make_unique<Cache>(
+      [this, delay](const std::string &filename, bool mirror_x, double scale) {
+        std::this_thread::sleep_for(delay);
+        std::string image = filename + (mirror_x ? "!" : "-") + "x" + std::to_string(static_cast<int>(scale));
+
+        std::unique_lock lock(mutex);
+        loads[image]++;
+        threads[image] = std::this_thread::get_id();
+        return image;
+      },
+      [](const std::string &image) { return image.size(); },
+      images * 4);
+  }
+
+  int get_loads(const std::string &image)
+  {
+    std::unique_lock lock(mutex);
+    return loads[image];
+  }
+
+  std::thread::id get_thread(const std::string &image)
+  {
+    std::unique_lock lock(mutex);
+    return threads[image];
+  }
+
+  std::mutex mutex;
+  std::map<std::string, int> loads;
+  std::map<std::string, std::thread::id> threads;
+};
+
+BOOST_FIXTURE_TEST_SUITE(s, Fixture)
+
+BOOST_AUTO_TEST_CASE(test_exerciseimagecache_get)
+{
+  auto cache = make_cache(10);
+  Exercise::Image image("a", 1, false);
+  Exercise::Image mirrored("a", 1, true);
+
+  BOOST_CHECK_EQUAL(cache->get(image), "a-x1");
+  BOOST_CHECK_EQUAL(get_thread("a-x1"), std::this_thread::get_id());
+  BOOST_CHECK_EQUAL(cache->get(image), "a-x1");
+  BOOST_CHECK_EQUAL(get_loads("a-x1"), 1);
+
+  // Mirroring and scale are part of the key.
+  BOOST_CHECK_EQUAL(cache->get(mirrored), "a!x1");
+  BOOST_CHECK_EQUAL(cache->get(image, 2.0), "a-x2");
+  BOOST_CHECK_EQUAL(cache->get(mirrored), "a!x1");
+  BOOST_CHECK_EQUAL(get_loads("a!x1"), 1);
+  BOOST_CHECK_EQUAL(get_loads("a-x2"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_exerciseimagecache_prefetch)
+{
+  auto cache = make_cache(10, std::chrono::milliseconds(5));
+  std::vector<Exercise::Image> images{{"a", 1, false}, {"b", 1, true}, {"c", 1, false}};
+
+  cache->prefetch(images);
+  cache->prefetch(images);
+
+  // Wait for the worker.
+  for (int i = 0; i < 1000 && get_loads("c-x1") == 0; i++)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+  for (const auto &image: images)
+    {
+      cache->get(image);
+    }
+
+  for (const std::string &name: {"a-x1", "b!x1", "c-x1"})
+    {
+      BOOST_CHECK_EQUAL(get_loads(name), 1);
+      BOOST_CHECK_NE(get_thread(name), std::this_thread::get_id());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_exerciseimagecache_get_while_prefetching)
+{
+  auto cache = make_cache(10, std::chrono::milliseconds(20));
+  std::vector<Exercise::Image> images{{"a", 1, false}, {"b", 1, false}, {"c", 1, false}};
+
+  // Images that are being decoded by the worker are waited for, queued
+  // images are decoded by the caller. Each image is decoded once.
+  cache->prefetch(images);
+  BOOST_CHECK_EQUAL(cache->get(images[2]), "c-x1");
+  BOOST_CHECK_EQUAL(cache->get(images[0]), "a-x1");
+  BOOST_CHECK_EQUAL(cache->get(images[1]), "b-x1");
+
+  for (const std::string &name: {"a-x1", "b-x1", "c-x1"})
+    {
+      BOOST_CHECK_EQUAL(get_loads(name), 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_exerciseimagecache_budget)
+{
+  auto cache = make_cache(2);
+  Exercise::Image a("a", 1, false);
+  Exercise::Image b("b", 1, false);
+  Exercise::Image c("c", 1, false);
+
+  cache->get(a);
+  cache->get(b);
+  cache->get(a);
+
+  // b is the least recently used image and is dropped.
+  cache->get(c);
+  cache->get(a);
+  BOOST_CHECK_EQUAL(get_loads("a-x1"), 1);
+  cache->get(b);
+  BOOST_CHECK_EQUAL(get_loads("b-x1"), 2);
+
+  // c was dropped for b.
+  cache->get(a);
+  cache->get(c);
+  BOOST_CHECK_EQUAL(get_loads("c-x1"), 2);
+  BOOST_CHECK_EQUAL(get_loads("a-x1"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_exerciseimagecache_destroy)
+{
+  // Destroying the cache with a queued prefetch stops the worker.
+  auto cache = make_cache(10, std::chrono::milliseconds(10));
+  cache->prefetch({{"a", 1, false}, {"b", 1, false}, {"c", 1, false}});
+  cache.reset();
+
+  BOOST_CHECK_LE(get_loads("a-x1") + get_loads("b-x1") + get_loads("c-x1"), 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+// Copyright (C) 2024 Rob Caelers <robc@krandor.nl>
+// All rights reserved.
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#define BOOST_TEST_MODULE workrave_exercise
+#include <boost/test/unit_test.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "ui/Exercise.hh"
+
+class Fixture
+{
+public:
+  Fixture()
+  {
+    directory = std::filesystem::temp_directory_path() / "workrave-exercise-test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    file_name = (directory / "exercises.xml").string();
+    cache_path = directory / "exercises.cache";
+  }
+
+  ~Fixture()
+  {
+    std::filesystem::remove_all(directory);
+  }
+
+  //! Writes an exercises file with one exercise.
+  void write_exercises(const std::string &path, const std::string &title, const std::string &image)
+  {
+    std::ofstream file(path, std::ios::trunc);
+    file << "<?xml version=\"1.0\"?>\n"
+         << "<exercises>\n"
+         << "  <exercise>\n"
+         << "    <title>" << title << "</title>\n"
+         << "    <description>Description of " << title << "</description>\n"
+         << "    <sequence duration=\"30\">\n"
+         << "      <image src=\"" << image << "\" duration=\"5\"/>\n"
+         << "      <image src=\"" << image << "\" duration=\"5\" mirrorx=\"yes\"/>\n"
+         << "    </sequence>\n"
+         << "  </exercise>\n"
+         << "</exercises>\n";
+  }
+
+  std::filesystem::path directory;
+  std::string file_name;
+  std::filesystem::path cache_path;
+};
+
+BOOST_FIXTURE_TEST_SUITE(s, Fixture)
+
+BOOST_AUTO_TEST_CASE(test_exercise_catalog_key)
+{
+  write_exercises(file_name, "Neck", "neck.png");
+  std::string key = Exercise::get_catalog_key(file_name);
+  BOOST_CHECK_EQUAL(Exercise::get_catalog_key(file_name), key);
+
+  // Another file with the same contents.
+  std::string other_file_name = (directory / "other.xml").string();
+  write_exercises(other_file_name, "Neck", "neck.png");
+  std::filesystem::last_write_time(other_file_name, std::filesystem::last_write_time(file_name));
+  BOOST_CHECK_NE(Exercise::get_catalog_key(other_file_name), key);
+
+  // Modified size.
+  auto mtime = std::filesystem::last_write_time(file_name);
+  write_exercises(file_name, "Shoulders", "neck.png");
+  std::filesystem::last_write_time(file_name, mtime);
+  BOOST_CHECK_NE(Exercise::get_catalog_key(file_name), key);
+
+  // Modified time.
+  write_exercises(file_name, "Neck", "neck.png");
+  std::filesystem::last_write_time(file_name, mtime + std::chrono::seconds(10));
+  BOOST_CHECK_NE(Exercise::get_catalog_key(file_name), key);
+
+  std::filesystem::last_write_time(file_name, mtime);
+  BOOST_CHECK_EQUAL(Exercise::get_catalog_key(file_name), key);
+}
+
+BOOST_AUTO_TEST_CASE(test_exercise_catalog_parse)
+{
+  write_exercises(file_name, "Neck", "neck.png");
+
+  auto exercises = Exercise::get_exercises(file_name, cache_path);
+  BOOST_REQUIRE_EQUAL(exercises.size(), 1);
+
+  const Exercise &exercise = exercises.front();
+  BOOST_CHECK_EQUAL(exercise.title, "Neck");
+  BOOST_CHECK_EQUAL(exercise.description, "Description of Neck");
+  BOOST_CHECK_EQUAL(exercise.duration, 30);
+  BOOST_REQUIRE_EQUAL(exercise.sequence.size(), 2);
+  BOOST_CHECK_EQUAL(exercise.sequence.front().image, "neck.png");
+  BOOST_CHECK_EQUAL(exercise.sequence.front().duration, 5);
+  BOOST_CHECK(!exercise.sequence.front().mirror_x);
+  BOOST_CHECK(exercise.sequence.back().mirror_x);
+
+  BOOST_CHECK(std::filesystem::exists(cache_path));
+}
+
+BOOST_AUTO_TEST_CASE(test_exercise_catalog_invalidate)
+{
+  write_exercises(file_name, "Neck", "neck.png");
+  BOOST_CHECK_EQUAL(Exercise::get_exercises(file_name, cache_path).front().title, "Neck");
+
+  // A modified file is parsed again, and replaces the cached exercises.
+  write_exercises(file_name, "Shoulders", "shoulders.png");
+  std::filesystem::last_write_time(file_name, std::filesystem::last_write_time(file_name) + std::chrono::seconds(10));
+
+  auto exercises = Exercise::get_exercises(file_name, cache_path);
+  BOOST_CHECK_EQUAL(exercises.front().title, "Shoulders");
+  BOOST_CHECK_EQUAL(exercises.front().sequence.front().image, "shoulders.png");
+}
+
+BOOST_AUTO_TEST_CASE(test_exercise_catalog_disk_cache)
+{
+  std::string other_file_name = (directory / "other.xml").string();
+  std::filesystem::path other_cache_path = directory / "other.cache";
+  write_exercises(file_name, "Neck", "neck.png");
+  write_exercises(other_file_name, "Back", "back.png");
+
+  BOOST_CHECK_EQUAL(Exercise::get_exercises(other_file_name, other_cache_path).front().title, "Back");
+  BOOST_CHECK_EQUAL(Exercise::get_exercises(file_name, cache_path).front().title, "Neck");
+
+  // Change the file without changing its key. The exercises are now only
+  // correct if they come from a cache.
+  auto mtime = std::filesystem::last_write_time(file_name);
+  write_exercises(file_name, "Legs", "legs.png");
+  std::filesystem::last_write_time(file_name, mtime);
+
+  // Replace the exercises in memory, so that the next call for the first file has to use the disk cache.
+  BOOST_CHECK_EQUAL(Exercise::get_exercises(other_file_name, other_cache_path).front().title, "Back");
+  BOOST_CHECK_EQUAL(Exercise::get_exercises(file_name, cache_path).front().title, "Neck");
+
+  // An invalid disk cache is ignored.
+  BOOST_CHECK_EQUAL(Exercise::get_exercises(other_file_name, other_cache_path).front().title, "Back");
+  {
+    std::ofstream file(cache_path, std::ios::binary | std::ios::trunc);
+    file << "WREX garbage";
+  }
+  BOOST_CHECK_EQUAL(Exercise::get_exercises(file_name, cache_path).front().title, "Legs");
+
+  // The rewritten disk cache is used again.
+  BOOST_CHECK_EQUAL(Exercise::get_exercises(other_file_name, other_cache_path).front().title, "Back");
+  write_exercises(file_name, "Arms", "arms.png");
+  std::filesystem::last_write_time(file_name, mtime);
+  BOOST_CHECK_EQUAL(Exercise::get_exercises(file_name, cache_path).front().title, "Legs");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
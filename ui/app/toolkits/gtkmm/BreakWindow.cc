@@ -130,17 +130,12 @@ BreakWindow::BreakWindow(std::shared_ptr<IApplication> app,
 
   this->head = head;
 
-  bool initial_ignore_activity = false;
-
 #ifdef PLATFORM_OS_WINDOWS
   if (WindowsForceFocus::GetForceFocusValue())
     initial_ignore_activity = true;
 
   app->get_core()->get_configurator()->get_value_with_default("advanced/force_focus_on_break_start", force_focus_on_break_start, true);
 #endif
-
-  auto core = app->get_core();
-  core->set_insist_policy(initial_ignore_activity ? InsistPolicy::Ignore : InsistPolicy::Halt);
 }
 
 //! Init Application
@@ -673,6 +668,8 @@ void
 BreakWindow::start()
 {
   TRACE_ENTRY();
+  update_insist_policy();
+
   // Need to realize window before it is shown
   // Otherwise, there is not gobj()...
   realize_if_needed();
@@ -733,7 +730,9 @@ BreakWindow::stop()
   if (frame != nullptr)
     {
       frame->set_frame_flashing(0);
+      frame->set_frame_visible(false);
     }
+  is_flashing = false;
 
   hide();
 
@@ -743,6 +742,14 @@ BreakWindow::stop()
 #endif
 }
 
+//! Sets the insist policy of the core when the window is shown.
+void
+BreakWindow::update_insist_policy()
+{
+  auto core = app->get_core();
+  core->set_insist_policy(initial_ignore_activity ? InsistPolicy::Ignore : InsistPolicy::Halt);
+}
+
 void
 BreakWindow::refresh()
 {
@@ -72,6 +72,7 @@ protected:
   void init_gui();
 
   void center();
+  virtual void update_insist_policy();
 
   Gtk::Box *create_bottom_box(bool lockable, bool shutdownable);
   void update_skip_postpone_lock();
@@ -105,6 +106,9 @@ protected:
   //! Flash frame
   Frame *frame{nullptr};
 
+  //! Whether the frame is flashing because the user is active
+  bool is_flashing{false};
+
   //! Use fullscreen window to perform blocking
   bool fullscreen_grab;
 
@@ -149,6 +153,9 @@ private:
   Glib::RefPtr<Gtk::SizeGroup> box_size_group;
   Glib::RefPtr<Gtk::SizeGroup> button_size_group;
 
+  //! Ignore activity while the break window is shown
+  bool initial_ignore_activity{false};
+
 #ifdef PLATFORM_OS_WINDOWS
   DesktopWindow *desktop_window{nullptr};
   bool force_focus_on_break_start{false};
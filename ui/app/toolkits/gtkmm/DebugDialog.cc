@@ -30,9 +30,15 @@
 #include "debug.hh"
 
 #include "core/ICore.hh"
+#include "utils/Paths.hh"
+#include "utils/TraceRecorder.hh"
 #include "Hig.hh"
 
 using namespace workrave;
+using namespace workrave::utils;
+
+//! Response of the button that saves the recorded trace.
+static const int RESPONSE_SAVE_TRACE = 1;
 
 DebugDialog::DebugDialog()
   : Gtk::Dialog(_("Debug log"), false)
@@ -53,6 +59,7 @@ DebugDialog::DebugDialog()
 
   get_vbox()->pack_start(*box, true, true, 0);
 
+  add_button(_("Save trace"), RESPONSE_SAVE_TRACE);
   add_button(_("Close"), Gtk::RESPONSE_CLOSE);
 
   show_all();
@@ -76,6 +83,11 @@ DebugDialog::diagnostics_log(const std::string &log)
 void
 DebugDialog::init()
 {
+  std::string trace = TraceRecorder::instance().decode_text();
+  if (!trace.empty())
+    {
+      text_buffer->insert(text_buffer->end(), "Recorded trace:\n" + trace + "\n");
+    }
   Diagnostics::instance().enable(this);
 }
 
@@ -91,7 +103,16 @@ DebugDialog::run()
 void
 DebugDialog::on_response(int response)
 {
-  (void)response;
   TRACE_ENTRY();
+  if (response == RESPONSE_SAVE_TRACE)
+    {
+      std::filesystem::path path = Paths::get_log_directory() / "trace.log";
+      std::error_code ec;
+      std::filesystem::create_directories(path.parent_path(), ec);
+      bool ok = TraceRecorder::instance().dump(path);
+      diagnostics_log((ok ? "Trace saved to " : "Failed to save trace to ") + path.string());
+      return;
+    }
+
   Diagnostics::instance().disable();
 }
@@ -18,7 +18,6 @@
 #include "config.h"
 
 #include <algorithm>
-#include <random>
 
 #include <cstring>
 #include <gtkmm.h>
@@ -60,16 +59,16 @@ text_buffer_set_markup(GtkTextBuffer *buffer, const gchar *markup, gint len)
 
 int ExercisesPanel::exercises_pointer = 0;
 
+//! Memory budget of the decoded exercise images, enough for all images of the default exercises.
+static constexpr size_t IMAGE_CACHE_BUDGET = 8 * 1024 * 1024;
+
 ExercisesPanel::ExercisesPanel(SoundTheme::Ptr sound_theme, Gtk::ButtonBox *dialog_action_area)
   : Gtk::HBox(false, 6)
   , sound_theme(sound_theme)
-  , exercises(Exercise::get_exercises())
+  , shuffled_exercises(Exercise::get_shuffled_exercises())
 {
   standalone = dialog_action_area != nullptr;
 
-  copy(exercises.begin(), exercises.end(), back_inserter(shuffled_exercises));
-  shuffle(shuffled_exercises.begin(), shuffled_exercises.end(), std::mt19937(std::random_device()()));
-
   progress_bar.set_orientation(Gtk::ORIENTATION_VERTICAL);
 
   description_scroll.add(description_text);
@@ -206,11 +205,78 @@ ExercisesPanel::start_exercise()
       exercise_time = 0;
       seq_time = 0;
       image_iterator = exercise.sequence.end();
+      prefetch_upcoming_images();
       refresh_progress();
       refresh_sequence();
     }
 }
 
+//! Starts decoding the images of the exercises of the next rest break.
+void
+ExercisesPanel::prefetch_images(int count)
+{
+  TRACE_ENTRY_PAR(count);
+  prefetch_images(Exercise::get_shuffled_exercises(), exercises_pointer, count);
+}
+
+void
+ExercisesPanel::prefetch_images(const std::vector<Exercise> &exercises, size_t first, int count)
+{
+  if (exercises.empty())
+    {
+      return;
+    }
+
+  std::vector<Exercise::Image> images;
+  for (int i = 0; i < count && i < static_cast<int>(exercises.size()); i++)
+    {
+      const Exercise &exercise = exercises[(first + i) % exercises.size()];
+      images.insert(images.end(), exercise.sequence.begin(), exercise.sequence.end());
+    }
+  get_image_cache().prefetch(images);
+}
+
+//! Starts decoding the images of the current and the next exercise.
+void
+ExercisesPanel::prefetch_upcoming_images()
+{
+  size_t current = exercise_iterator - shuffled_exercises.begin();
+  prefetch_images(shuffled_exercises, current, 2);
+}
+
+ExerciseImageCache<Glib::RefPtr<Gdk::Pixbuf>> &
+ExercisesPanel::get_image_cache()
+{
+  static ExerciseImageCache<Glib::RefPtr<Gdk::Pixbuf>> cache(
+    [](const std::string &filename, bool mirror_x, double scale) -> Glib::RefPtr<Gdk::Pixbuf> {
+      try
+        {
+          Glib::RefPtr<Gdk::Pixbuf> pixbuf = Gdk::Pixbuf::create_from_file(filename);
+          if (scale != 1.0)
+            {
+              pixbuf = pixbuf->scale_simple(static_cast<int>(pixbuf->get_width() * scale + 0.5),
+                                            static_cast<int>(pixbuf->get_height() * scale + 0.5),
+                                            Gdk::INTERP_BILINEAR);
+            }
+          if (mirror_x)
+            {
+              pixbuf = GtkUtil::flip_pixbuf(pixbuf, true, false);
+            }
+          return pixbuf;
+        }
+      catch (const Glib::Error &e)
+        {
+          TRACE_MSG("cannot load {}: {}", filename, std::string(e.what()));
+          return {};
+        }
+    },
+    [](const Glib::RefPtr<Gdk::Pixbuf> &pixbuf) -> size_t {
+      return pixbuf ? static_cast<size_t>(pixbuf->get_rowstride()) * pixbuf->get_height() : 0;
+    },
+    IMAGE_CACHE_BUDGET);
+  return cache;
+}
+
 void
 ExercisesPanel::show_image()
 {
@@ -218,16 +284,14 @@ ExercisesPanel::show_image()
   const Exercise::Image &img = (*image_iterator);
   seq_time += img.duration;
   TRACE_MSG("image= {}", img.image);
-  string file = AssetPath::complete_directory(img.image, AssetPath::SEARCH_PATH_EXERCISES);
-  if (!img.mirror_x)
+  Glib::RefPtr<Gdk::Pixbuf> pixbuf = get_image_cache().get(img);
+  if (pixbuf)
     {
-      image.set(file);
+      image.set(pixbuf);
     }
   else
     {
-      Glib::RefPtr<Gdk::Pixbuf> pixbuf = Gdk::Pixbuf::create_from_file(file);
-      Glib::RefPtr<Gdk::Pixbuf> flip = GtkUtil::flip_pixbuf(pixbuf, true, false);
-      image.set(flip);
+      image.set(AssetPath::complete_directory(img.image, AssetPath::SEARCH_PATH_EXERCISES));
     }
 }
 
@@ -20,6 +20,7 @@
 
 #include "ui/SoundTheme.hh"
 #include "ui/Exercise.hh"
+#include "ui/ExerciseImageCache.hh"
 
 #include <gtkmm.h>
 
@@ -36,6 +37,7 @@ public:
   ~ExercisesPanel() override;
 
   void set_exercise_count(int num);
+  static void prefetch_images(int count);
   sigc::signal0<void> &signal_stop()
   {
     return stop_signal;
@@ -53,6 +55,7 @@ private:
   bool heartbeat();
   void start_exercise();
   void show_image();
+  void prefetch_upcoming_images();
   void refresh_progress();
   void refresh_sequence();
   void refresh_pause();
@@ -67,6 +70,9 @@ private:
     return ret;
   }
 
+  static void prefetch_images(const std::vector<Exercise> &exercises, size_t first, int count);
+  static ExerciseImageCache<Glib::RefPtr<Gdk::Pixbuf>> &get_image_cache();
+
   SoundTheme::Ptr sound_theme;
   Gtk::Frame image_frame;
   Gtk::Image image;
@@ -78,7 +84,6 @@ private:
   Gtk::Button *forward_button{nullptr};
   Gtk::Button *stop_button{nullptr};
   Glib::RefPtr<Gtk::SizeGroup> size_group;
-  const std::list<Exercise> exercises;
   std::vector<Exercise> shuffled_exercises;
   std::vector<Exercise>::const_iterator exercise_iterator;
   std::list<Exercise::Image>::const_iterator image_iterator;
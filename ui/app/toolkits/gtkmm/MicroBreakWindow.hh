@@ -62,7 +62,6 @@ private:
   Gtk::Label *label{nullptr};
   int progress_value{0};
   int progress_max_value{0};
-  bool is_flashing{false};
   bool fixed_size{false};
 };
 
@@ -25,6 +25,8 @@
 #include "debug.hh"
 #include "commonui/nls.h"
 
+#include "ui/Exercise.hh"
+#include "ui/GUIConfig.hh"
 #include "ui/Text.hh"
 #include "utils/AssetPath.hh"
 #include "utils/Platform.hh"
@@ -32,6 +34,7 @@
 #include "core/ICore.hh"
 
 #include "PreludeWindow.hh"
+#include "ExercisesPanel.hh"
 #include "Frame.hh"
 #include "TimeBar.hh"
 #include "Hig.hh"
@@ -47,6 +50,7 @@ using namespace workrave::utils;
 
 PreludeWindow::PreludeWindow(HeadInfo head, BreakId break_id)
   : Gtk::Window(Gtk::WINDOW_POPUP)
+  , break_id(break_id)
 {
   TRACE_ENTRY();
   // On W32, must be *before* realize, otherwise a border is drawn.
@@ -65,10 +69,6 @@ PreludeWindow::PreludeWindow(HeadInfo head, BreakId break_id)
       set_size_request(head.get_width(), head.get_height());
     }
 
-#ifdef PLATFORM_OS_WINDOWS
-  init_avoid_pointer_polling();
-#endif
-
   realize();
 
   time_bar = Gtk::manage(new TimeBar);
@@ -143,6 +143,25 @@ PreludeWindow::start()
   // Otherwise, there is not gobj()...
   realize_if_needed();
 
+  // The window may have been moved away from the pointer when it was shown before.
+  did_avoid = false;
+  flash_visible = true;
+  set_position(Gtk::WIN_POS_CENTER_ALWAYS);
+  if (align != nullptr)
+    {
+      align->set(0.5, 0.5, 0.0, 0.0);
+    }
+
+#ifdef PLATFORM_OS_WINDOWS
+  init_avoid_pointer_polling();
+#endif
+
+  if (break_id == BREAK_ID_REST_BREAK && head.monitor == 0 && Exercise::has_exercises())
+    {
+      // Decode the exercise images while the prelude is shown.
+      ExercisesPanel::prefetch_images(GUIConfig::break_exercises(BREAK_ID_REST_BREAK)());
+    }
+
   // Set some window hints.
   set_skip_pager_hint(true);
   set_skip_taskbar_hint(true);
@@ -197,6 +216,14 @@ PreludeWindow::stop()
 {
   TRACE_ENTRY();
   frame->set_frame_flashing(0);
+
+#ifdef PLATFORM_OS_WINDOWS
+  if (avoid_signal.connected())
+    {
+      avoid_signal.disconnect();
+    }
+#endif
+
   hide();
 }
 
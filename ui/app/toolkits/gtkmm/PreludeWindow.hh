@@ -112,6 +112,9 @@ private:
   //! Head
   HeadInfo head;
 
+  //! Break
+  workrave::BreakId break_id;
+
   // Alignment in Wayland
   Gtk::Alignment *align{nullptr};
 };
@@ -103,6 +103,12 @@ RestBreakWindow::start()
   BreakWindow::start();
 }
 
+//! The insist policy is set by the installed panel.
+void
+RestBreakWindow::update_insist_policy()
+{
+}
+
 void
 RestBreakWindow::update_break_window()
 {
@@ -45,6 +45,7 @@ public:
 
 protected:
   Gtk::Widget *create_gui() override;
+  void update_insist_policy() override;
   void draw_time_bar();
 
 private:
@@ -62,7 +63,6 @@ private:
   int progress_value{0};
   int progress_max_value{0};
   Gtk::HBox *pluggable_panel{nullptr};
-  bool is_flashing{false};
 };
 
 #endif // RESTBREAKWINDOW_HH
@@ -47,7 +47,6 @@ StatisticsDialog::StatisticsDialog(std::shared_ptr<IApplication> app)
 {
   auto core = app->get_core();
   statistics = core->get_statistics();
-  statistics->update();
 
   for (int i = 0; i < 5; i++)
     {
@@ -55,15 +54,19 @@ StatisticsDialog::StatisticsDialog(std::shared_ptr<IApplication> app)
     }
 
   init_gui();
+
+  workrave::utils::connect(statistics->signal_current_day_changed(), this, [this](const auto &changes) {
+    on_current_day_changed(changes);
+  });
+
+  // The current day is only kept up to date in memory while connected.
+  statistics->refresh_current_day();
   display_calendar_date();
 }
 
 int
 StatisticsDialog::run()
 {
-  // Periodic timer.
-  Glib::signal_timeout().connect(sigc::mem_fun(*this, &StatisticsDialog::on_timer), 1000);
-
   show_all();
   return 0;
 }
@@ -308,6 +311,23 @@ StatisticsDialog::display_statistics(IStatistics::DailyStats *stats)
       stats = &empty;
     }
 
+  display_date(stats);
+
+  int64_t value = stats->misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME];
+  daily_usage_time_label->set_text(Text::time_to_string(value));
+
+  // Put the breaks in table.
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      display_break_statistics(stats, i);
+    }
+
+  display_activity_statistics(stats);
+}
+
+void
+StatisticsDialog::display_date(IStatistics::DailyStats *stats)
+{
   if (stats->start.tm_year == 0 /*stats->is_empty() */)
     {
       date_label->set_text("-");
@@ -324,50 +344,52 @@ StatisticsDialog::display_statistics(IStatistics::DailyStats *stats)
       sprintf(buf, _("%s, from %s to %s"), date, start, stop);
       date_label->set_text(buf);
     }
+}
 
-  int64_t value = stats->misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME];
-  daily_usage_time_label->set_text(Text::time_to_string(value));
-
-  // Put the breaks in table.
-  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
-    {
-      stringstream ss;
+void
+StatisticsDialog::display_break_statistics(IStatistics::DailyStats *stats, int i)
+{
+  stringstream ss;
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_UNIQUE_BREAKS];
-      ss.str("");
-      ss << value;
-      break_labels[i][0]->set_text(ss.str());
+  int64_t value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_UNIQUE_BREAKS];
+  ss.str("");
+  ss << value;
+  break_labels[i][0]->set_text(ss.str());
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_PROMPTED] - value;
-      ss.str("");
-      ss << value;
-      break_labels[i][1]->set_text(ss.str());
+  value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_PROMPTED] - value;
+  ss.str("");
+  ss << value;
+  break_labels[i][1]->set_text(ss.str());
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_TAKEN];
-      ss.str("");
-      ss << value;
-      break_labels[i][2]->set_text(ss.str());
+  value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_TAKEN];
+  ss.str("");
+  ss << value;
+  break_labels[i][2]->set_text(ss.str());
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_NATURAL_TAKEN];
-      ss.str("");
-      ss << value;
-      break_labels[i][3]->set_text(ss.str());
+  value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_NATURAL_TAKEN];
+  ss.str("");
+  ss << value;
+  break_labels[i][3]->set_text(ss.str());
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_SKIPPED];
-      ss.str("");
-      ss << value;
-      break_labels[i][4]->set_text(ss.str());
+  value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_SKIPPED];
+  ss.str("");
+  ss << value;
+  break_labels[i][4]->set_text(ss.str());
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_POSTPONED];
-      ss.str("");
-      ss << value;
-      break_labels[i][5]->set_text(ss.str());
+  value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_POSTPONED];
+  ss.str("");
+  ss << value;
+  break_labels[i][5]->set_text(ss.str());
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_TOTAL_OVERDUE];
+  value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_TOTAL_OVERDUE];
 
-      break_labels[i][6]->set_text(Text::time_to_string(value));
-    }
+  break_labels[i][6]->set_text(Text::time_to_string(value));
+}
 
+void
+StatisticsDialog::display_activity_statistics(IStatistics::DailyStats *stats)
+{
+  int64_t value = 0;
   stringstream ss;
 
   if (activity_labels[0] != nullptr)
@@ -419,30 +441,32 @@ StatisticsDialog::display_week_statistics()
   std::tm const *time_loc = std::localtime(&t);
 
   int offset = (time_loc->tm_wday - Locale::get_week_start() + 7) % 7;
-  int64_t total_week = 0;
-  for (int i = 0; i < 7; i++)
-    {
-      std::memset(&timeinfo, 0, sizeof(timeinfo));
-      timeinfo.tm_mday = d - offset + i;
-      timeinfo.tm_mon = m;
-      timeinfo.tm_year = y - 1900;
-      t = std::mktime(&timeinfo);
-      time_loc = std::localtime(&t);
 
-      int idx, next, prev;
-      statistics->get_day_index_by_date(time_loc->tm_year + 1900, time_loc->tm_mon + 1, time_loc->tm_mday, idx, next, prev);
-
-      if (idx >= 0)
-        {
-          IStatistics::DailyStats *stats = statistics->get_day(idx);
-          if (stats != nullptr)
-            {
-              total_week += stats->misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME];
-            }
-
-          update_usage_real_time |= (idx == 0);
-        }
-    }
+  std::tm first{};
+  first.tm_mday = d - offset;
+  first.tm_mon = m;
+  first.tm_year = y - 1900;
+  first.tm_isdst = -1;
+  std::mktime(&first);
+
+  std::tm last{};
+  last.tm_mday = d - offset + 6;
+  last.tm_mon = m;
+  last.tm_year = y - 1900;
+  last.tm_isdst = -1;
+  std::mktime(&last);
+
+  IStatistics::StatsTotals totals;
+  statistics->get_totals(first.tm_year + 1900,
+                         first.tm_mon + 1,
+                         first.tm_mday,
+                         last.tm_year + 1900,
+                         last.tm_mon + 1,
+                         last.tm_mday,
+                         totals);
+
+  int64_t total_week = totals.misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME];
+  update_usage_real_time |= is_current_day_between(first, last);
 
   weekly_usage_time_label->set_text(total_week > 0 ? Text::time_to_string(total_week) : "");
 }
@@ -453,48 +477,41 @@ StatisticsDialog::display_month_statistics()
   guint y, m, d;
   calendar->get_date(y, m, d);
 
-  guint max_mday;
-  if (m == 3 || m == 5 || m == 8 || m == 10)
-    {
-      max_mday = 30;
-    }
-  else if (m == 1)
-    {
-      bool is_leap = (y % 4 == 0 && y % 100 != 0) || (y % 400 == 0);
-      if (is_leap)
-        {
-          max_mday = 29;
-        }
-      else
-        {
-          max_mday = 28;
-        }
-    }
-  else
-    {
-      max_mday = 31;
-    }
+  IStatistics::StatsTotals totals;
+  statistics->get_period_totals(IStatistics::STATS_PERIOD_MONTH, y, m + 1, d, totals);
 
-  int64_t total_month = 0;
-  for (guint i = 1; i <= max_mday; i++)
-    {
-      int idx, next, prev;
-      statistics->get_day_index_by_date(y, m + 1, i, idx, next, prev);
-      if (idx >= 0)
-        {
-          IStatistics::DailyStats *stats = statistics->get_day(idx);
-          if (stats != nullptr)
-            {
-              total_month += stats->misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME];
-            }
+  std::tm first{};
+  first.tm_mday = 1;
+  first.tm_mon = m;
+  first.tm_year = y - 1900;
 
-          update_usage_real_time |= (idx == 0);
-        }
-    }
+  std::tm last{};
+  last.tm_mday = 31;
+  last.tm_mon = m;
+  last.tm_year = y - 1900;
+
+  int64_t total_month = totals.misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME];
+  update_usage_real_time |= is_current_day_between(first, last);
 
   monthly_usage_time_label->set_text(total_month > 0 ? Text::time_to_string(total_month) : "");
 }
 
+//! Returns whether the current day lies between the first and the last date.
+bool
+StatisticsDialog::is_current_day_between(const std::tm &first, const std::tm &last) const
+{
+  IStatistics::DailyStats *stats = statistics->get_current_day();
+  if (stats == nullptr)
+    {
+      return false;
+    }
+
+  auto to_date = [](const std::tm &tm) { return (tm.tm_year * 100 + tm.tm_mon) * 100 + tm.tm_mday; };
+
+  int date = to_date(stats->start);
+  return date >= to_date(first) && date <= to_date(last);
+}
+
 void
 StatisticsDialog::clear_display_statistics()
 {
@@ -564,6 +581,7 @@ StatisticsDialog::display_calendar_date()
     {
       clear_display_statistics();
     }
+  showing_current_day = idx == 0;
   update_usage_real_time = false;
   display_week_statistics();
   display_month_statistics();
@@ -651,16 +669,49 @@ StatisticsDialog::on_history_delete_all()
   app->get_core()->remove_operation_mode_override(funcname);
 }
 
-//! Periodic heartbeat.
-bool
-StatisticsDialog::on_timer()
+//! Shows the changes of the statistics of the current day.
+void
+StatisticsDialog::on_current_day_changed(const IStatistics::DailyStatsChanges &changes)
 {
-  if (update_usage_real_time)
+  if (changes.new_day)
     {
-      statistics->update();
       display_calendar_date();
+      return;
+    }
+
+  if (showing_current_day)
+    {
+      IStatistics::DailyStats *stats = statistics->get_current_day();
+      if (changes.period)
+        {
+          display_date(stats);
+        }
+      if (changes.misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME])
+        {
+          daily_usage_time_label->set_text(Text::time_to_string(stats->misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME]));
+        }
+      for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+        {
+          if (changes.break_stats[i])
+            {
+              display_break_statistics(stats, i);
+            }
+        }
+      for (int j = IStatistics::STATS_VALUE_TOTAL_MOUSE_MOVEMENT; j < IStatistics::STATS_VALUE_SIZEOF; j++)
+        {
+          if (changes.misc_stats[j])
+            {
+              display_activity_statistics(stats);
+              break;
+            }
+        }
+    }
+
+  if (update_usage_real_time && changes.misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME])
+    {
+      display_week_statistics();
+      display_month_statistics();
     }
-  return true;
 }
 
 void
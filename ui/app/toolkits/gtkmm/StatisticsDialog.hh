@@ -21,6 +21,7 @@
 #include <sstream>
 
 #include "core/IStatistics.hh"
+#include "utils/Signals.hh"
 #include "Hig.hh"
 #include "ui/IApplication.hh"
 
@@ -33,7 +34,9 @@ namespace Gtk
   class Widget;
 } // namespace Gtk
 
-class StatisticsDialog : public HigDialog
+class StatisticsDialog
+  : public HigDialog
+  , public workrave::utils::Trackable
 {
 public:
   StatisticsDialog(std::shared_ptr<IApplication> app);
@@ -90,6 +93,9 @@ private:
 
   bool update_usage_real_time{false};
 
+  /** Whether the statistics of the current day are shown. */
+  bool showing_current_day{false};
+
   void on_history_delete_all();
 
   void init_gui();
@@ -109,10 +115,14 @@ private:
   void on_history_goto_first();
   void display_calendar_date();
   void display_statistics(workrave::IStatistics::DailyStats *stats);
+  void display_date(workrave::IStatistics::DailyStats *stats);
+  void display_break_statistics(workrave::IStatistics::DailyStats *stats, int break_id);
+  void display_activity_statistics(workrave::IStatistics::DailyStats *stats);
   void clear_display_statistics();
   void display_week_statistics();
   void display_month_statistics();
-  bool on_timer();
+  bool is_current_day_between(const std::tm &first, const std::tm &last) const;
+  void on_current_day_changed(const workrave::IStatistics::DailyStatsChanges &changes);
 };
 
 #endif // STATISTICSWINDOW_HH
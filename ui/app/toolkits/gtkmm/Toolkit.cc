@@ -21,6 +21,8 @@
 
 #include "Toolkit.hh"
 
+#include <algorithm>
+
 #include "DailyLimitWindow.hh"
 #include "GtkUtil.hh"
 #include "MicroBreakWindow.hh"
@@ -42,6 +44,7 @@ Toolkit::Toolkit(int argc, char **argv)
 
 Toolkit::~Toolkit()
 {
+  timer_connection.disconnect();
   delete status_icon;
   status_icon = nullptr;
 }
@@ -76,7 +79,7 @@ Toolkit::init(std::shared_ptr<IApplication> app)
   event_connections.emplace_back(
     status_icon->signal_balloon_activated().connect(sigc::mem_fun(*this, &Toolkit::on_status_icon_balloon_activated)));
 
-  Glib::signal_timeout().connect(sigc::mem_fun(*this, &Toolkit::on_timer), 1000);
+  set_timer_delay(1000);
 
   init_multihead();
   init_gui();
@@ -355,6 +358,12 @@ Toolkit::signal_status_icon_activated()
   return status_icon_activated_signal;
 }
 
+boost::signals2::signal<void()> &
+Toolkit::signal_display_changed()
+{
+  return display_changed_signal;
+}
+
 const char *
 Toolkit::get_display_name() const
 {
@@ -383,6 +392,38 @@ Toolkit::create_oneshot_timer(int ms, std::function<void()> func)
     }
 }
 
+void
+Toolkit::set_timer_delay(int ms)
+{
+  auto now = std::chrono::steady_clock::now();
+  timer_deadline = std::min(now + std::chrono::milliseconds(ms), timer_limit);
+  auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(timer_deadline - now).count();
+
+  timer_connection.disconnect();
+  timer_connection = Glib::signal_timeout().connect(sigc::mem_fun(*this, &Toolkit::on_timer), static_cast<int>(std::max<int64_t>(delay, 0)));
+}
+
+void
+Toolkit::limit_timer_delay(int ms)
+{
+  timer_limit = std::min(timer_limit, std::chrono::steady_clock::now() + std::chrono::milliseconds(ms));
+  if (timer_limit < timer_deadline)
+    {
+      set_timer_delay(ms);
+    }
+}
+
+void
+Toolkit::wakeup_timer()
+{
+  // g_main_context_invoke is thread-safe, unlike connecting a timeout.
+  Glib::MainContext::get_default()->invoke([this]() {
+    gint64 elapsed_ms = (g_get_monotonic_time() - last_timer_time) / 1000;
+    set_timer_delay(static_cast<int>(std::clamp<gint64>(1000 - elapsed_ms, 0, 1000)));
+    return false;
+  });
+}
+
 void
 Toolkit::show_notification(const std::string &id, const std::string &title, const std::string &balloon, std::function<void()> func)
 {
@@ -408,7 +449,8 @@ Toolkit::init_multihead()
   TRACE_ENTRY();
   Glib::RefPtr<Gdk::Display> display = Gdk::Display::get_default();
   Glib::RefPtr<Gdk::Screen> screen = display->get_default_screen();
-  // screen->signal_monitors_changed().connect(sigc::mem_fun(*this, &Application::update_multihead));
+  event_connections.emplace_back(screen->signal_monitors_changed().connect([this]() { display_changed_signal(); }));
+  event_connections.emplace_back(screen->signal_size_changed().connect([this]() { display_changed_signal(); }));
 }
 
 void
@@ -429,6 +471,11 @@ Toolkit::init_gui()
   gtk_rc_parse_string(rc_string);
 
 #endif
+  auto gtk_settings = Gtk::Settings::get_default();
+  event_connections.emplace_back(gtk_settings->property_gtk_theme_name().signal_changed().connect([this]() { display_changed_signal(); }));
+  event_connections.emplace_back(
+    gtk_settings->property_gtk_application_prefer_dark_theme().signal_changed().connect([this]() { display_changed_signal(); }));
+
 #if defined(PLATFORM_OS_WINDOWS)
   auto settings = Gtk::Settings::get_default();
   settings->property_gtk_application_prefer_dark_theme().set_value(GUIConfig::theme_dark()());
@@ -493,9 +540,14 @@ Toolkit::init_debug()
 bool
 Toolkit::on_timer()
 {
+  // Repeat every second, unless a handler of the timer signal sets another delay.
+  timer_limit = std::chrono::steady_clock::time_point::max();
+  set_timer_delay(1000);
+  last_timer_time = g_get_monotonic_time();
+
   timer_signal();
   main_window->update();
-  return true;
+  return false;
 }
 
 void
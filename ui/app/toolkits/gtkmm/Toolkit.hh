@@ -18,6 +18,7 @@
 #ifndef TOOLKIT_HH
 #define TOOLKIT_HH
 
+#include <chrono>
 #include <memory>
 #include <map>
 #include <boost/signals2.hpp>
@@ -67,6 +68,9 @@ public:
 
   const char *get_display_name() const override;
   void create_oneshot_timer(int ms, std::function<void()> func) override;
+  void set_timer_delay(int ms) override;
+  void limit_timer_delay(int ms) override;
+  void wakeup_timer() override;
   void show_notification(const std::string &id, const std::string &title, const std::string &balloon, std::function<void()> func) override;
   void show_tooltip(const std::string &tip) override;
 
@@ -75,6 +79,7 @@ public:
   boost::signals2::signal<void(bool)> &signal_session_idle_changed() override;
   boost::signals2::signal<void()> &signal_session_unlocked() override;
   boost::signals2::signal<void()> &signal_status_icon_activated() override;
+  boost::signals2::signal<void()> &signal_display_changed() override;
 
   // IToolkitPrivate
   void attach_menu(Gtk::Menu *menu) override;
@@ -122,6 +127,10 @@ private:
   std::map<std::string, std::function<void()>> notifiers;
 
   std::list<sigc::connection> event_connections;
+  sigc::connection timer_connection;
+  gint64 last_timer_time{0};
+  std::chrono::steady_clock::time_point timer_deadline;
+  std::chrono::steady_clock::time_point timer_limit{std::chrono::steady_clock::time_point::max()};
   workrave::utils::Trackable tracker;
 
   boost::signals2::signal<void()> timer_signal;
@@ -129,6 +138,7 @@ private:
   boost::signals2::signal<void(bool)> session_idle_changed_signal;
   boost::signals2::signal<void()> session_unlocked_signal;
   boost::signals2::signal<void()> status_icon_activated_signal;
+  boost::signals2::signal<void()> display_changed_signal;
 };
 
 #endif // TOOLKIT_HH
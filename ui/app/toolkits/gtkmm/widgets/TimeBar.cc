@@ -21,7 +21,9 @@
 
 #include "debug.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <climits>
 #include <cstdio>
 #include <cstdlib>
 #include <sstream>
@@ -117,13 +119,167 @@ void
 TimeBar::set_rotation(int r)
 {
   rotation = r;
+  text_layout.reset();
+  drawn = false;
   queue_resize();
 }
 
+//! Redraws the parts of the time bar of which the shown contents changed.
 void
 TimeBar::update()
 {
-  queue_draw();
+  DrawState state = get_draw_state();
+  if (drawn && state == drawn_state)
+    {
+      return;
+    }
+
+  DrawState bars_changed = drawn_state;
+  bars_changed.bar_width = state.bar_width;
+  bars_changed.sbar_width = state.sbar_width;
+
+  if (drawn && state == bars_changed)
+    {
+      queue_draw_bars(state);
+    }
+  else
+    {
+      queue_draw();
+    }
+}
+
+bool
+TimeBar::DrawState::operator==(const DrawState &other) const
+{
+  return std::tie(width, height, bar_width, sbar_width, bar_color, secondary_bar_color, text, text_align, rotation)
+         == std::tie(other.width,
+                     other.height,
+                     other.bar_width,
+                     other.sbar_width,
+                     other.bar_color,
+                     other.secondary_bar_color,
+                     other.text,
+                     other.text_align,
+                     other.rotation);
+}
+
+TimeBar::DrawState
+TimeBar::get_draw_state() const
+{
+  const int border_size = 1;
+
+  Gtk::Allocation allocation = get_allocation();
+
+  DrawState state;
+  state.width = allocation.get_width() - 2;
+  state.height = allocation.get_height();
+  state.bar_color = bar_color;
+  state.secondary_bar_color = secondary_bar_color;
+  state.text = bar_text;
+  state.text_align = bar_text_align;
+  state.rotation = rotation;
+
+  // Logical width: direction of bar
+  int win_lw = (rotation == 0 || rotation == 180) ? state.width : state.height;
+
+  if (bar_max_value > 0)
+    {
+      state.bar_width = (bar_value * (win_lw - 2 * border_size - 1)) / bar_max_value;
+    }
+
+  if (secondary_bar_max_value > 0)
+    {
+      state.sbar_width = (secondary_bar_value * (win_lw - 2 * border_size - 1)) / secondary_bar_max_value;
+    }
+
+  return state;
+}
+
+//! Redraws the part of the bar between the old and new ends of the bars.
+void
+TimeBar::queue_draw_bars(const DrawState &state)
+{
+  const int border_size = 1;
+
+  int from = INT_MAX;
+  int to = INT_MIN;
+
+  auto extend = [&](int old_width, int new_width) {
+    if (old_width != new_width)
+      {
+        from = std::min({from, old_width, new_width});
+        to = std::max({to, old_width, new_width});
+      }
+  };
+  extend(drawn_state.bar_width, state.bar_width);
+  extend(drawn_state.sbar_width, state.sbar_width);
+
+  // Include a pixel on each side for the text that is split at the end of the bar.
+  int x = border_size + from - 1;
+  int width = to - from + 2;
+
+  if (rotation == 0 || rotation == 180)
+    {
+      queue_draw_area(x, 0, width, state.height);
+    }
+  else
+    {
+      queue_draw_area(0, state.height - x - width, state.width, width);
+    }
+}
+
+void
+TimeBar::on_style_updated()
+{
+  frame_surface.reset();
+  text_layout.reset();
+  drawn = false;
+  Gtk::DrawingArea::on_style_updated();
+}
+
+//! Draws the background and frame from a cached surface.
+void
+TimeBar::draw_frame(const Cairo::RefPtr<Cairo::Context> &cr, int win_w, int win_h)
+{
+  if (win_w <= 0 || win_h <= 0)
+    {
+      return;
+    }
+
+  if (!frame_surface || frame_width != win_w || frame_height != win_h)
+    {
+      Glib::RefPtr<Gtk::StyleContext> style_context = get_style_context();
+
+      frame_surface = Cairo::Surface::create(cr->get_target(), Cairo::CONTENT_COLOR_ALPHA, win_w, win_h);
+      frame_width = win_w;
+      frame_height = win_h;
+
+      Cairo::RefPtr<Cairo::Context> frame_cr = Cairo::Context::create(frame_surface);
+      style_context->render_background(frame_cr, 0, 0, win_w - 1, win_h - 1);
+      style_context->render_frame(frame_cr, 0, 0, win_w - 1, win_h - 1);
+    }
+
+  cr->set_source(frame_surface, 0, 0);
+  cr->paint();
+}
+
+Glib::RefPtr<Pango::Layout>
+TimeBar::get_text_layout()
+{
+  if (!text_layout)
+    {
+      Pango::Matrix matrix = PANGO_MATRIX_INIT;
+      pango_matrix_rotate(&matrix, 360 - rotation);
+
+      text_layout = create_pango_layout(bar_text);
+      text_layout->get_context()->set_matrix(matrix);
+    }
+  else if (text_layout->get_text().raw() != bar_text)
+    {
+      text_layout->set_text(bar_text);
+    }
+
+  return text_layout;
 }
 
 void
@@ -232,14 +388,14 @@ TimeBar::on_draw(const Cairo::RefPtr<Cairo::Context> &cr)
   const int border_size = 1;
 
   Glib::RefPtr<Gtk::StyleContext> style_context = get_style_context();
-  Gtk::Allocation allocation = get_allocation();
+  DrawState state = get_draw_state();
 
   style_context->context_save();
   style_context->add_class(GTK_STYLE_CLASS_FRAME);
 
   // Physical width/height
-  int win_w = allocation.get_width() - 2;
-  int win_h = allocation.get_height();
+  int win_w = state.width;
+  int win_h = state.height;
 
   // Logical width/height
   // width = direction of bar
@@ -258,35 +414,16 @@ TimeBar::on_draw(const Cairo::RefPtr<Cairo::Context> &cr)
 
   // Draw background
   style_context->set_state(Gtk::STATE_FLAG_ACTIVE);
-  Gdk::RGBA back_color = style_context->get_background_color();
-  set_color(cr, back_color);
 
   // clip to the area indicated by the expose event so that we only redraw
   // the portion of the window that needs to be redrawn
   cr->rectangle(0, 0, win_w, win_h);
   cr->clip();
 
-  style_context->render_background(cr, 0, 0, win_w - 1, win_h - 1);
-  style_context->render_frame(cr, 0, 0, win_w - 1, win_h - 1);
-
-  // set_color(cr, back_color);
-  // cr->rectangle(border_size, border_size, win_w - 2*border_size, win_h - 2*border_size);
-  // cr->fill();
-
-  // Bar
-  int bar_width = 0;
-  if (bar_max_value > 0)
-    {
-      bar_width = (bar_value * (win_lw - 2 * border_size - 1)) / bar_max_value;
-    }
-
-  // Secondary bar
-  int sbar_width = 0;
-  if (secondary_bar_max_value > 0)
-    {
-      sbar_width = (secondary_bar_value * (win_lw - 2 * border_size - 1)) / secondary_bar_max_value;
-    }
+  draw_frame(cr, win_w, win_h);
 
+  int bar_width = state.bar_width;
+  int sbar_width = state.sbar_width;
   int bar_height = win_lh - 2 * border_size - 1;
 
   if (sbar_width > 0)
@@ -347,13 +484,7 @@ TimeBar::on_draw(const Cairo::RefPtr<Cairo::Context> &cr)
     }
 
   // Text
-  Pango::Matrix matrix = PANGO_MATRIX_INIT;
-  pango_matrix_rotate(&matrix, 360 - rotation);
-
-  Glib::RefPtr<Pango::Layout> pl1 = create_pango_layout(bar_text);
-  Glib::RefPtr<Pango::Context> pc1 = pl1->get_context();
-
-  pc1->set_matrix(matrix);
+  Glib::RefPtr<Pango::Layout> pl1 = get_text_layout();
 
   int text_width = 0;
   int text_height = 0;
@@ -453,6 +584,9 @@ TimeBar::on_draw(const Cairo::RefPtr<Cairo::Context> &cr)
   pl1->show_in_cairo_context(cr);
   style_context->context_restore();
 
+  drawn_state = state;
+  drawn = true;
+
   return Gtk::Widget::on_draw(cr);
 }
 
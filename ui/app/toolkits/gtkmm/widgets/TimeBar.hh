@@ -19,6 +19,7 @@
 #define TIMEBAR_HH
 
 #include <string>
+#include <tuple>
 
 #include <gtkmm.h>
 #include <gdkmm.h>
@@ -48,6 +49,26 @@ public:
   void get_preferred_size(int &width, int &height) const;
 
 private:
+  //! What is shown by the time bar, at the resolution at which it is shown.
+  struct DrawState
+  {
+    int width{0};
+    int height{0};
+    int bar_width{0};
+    int sbar_width{0};
+    TimerColorId bar_color{TimerColorId::Inactive};
+    TimerColorId secondary_bar_color{TimerColorId::Inactive};
+    std::string text;
+    int text_align{0};
+    int rotation{0};
+
+    bool operator==(const DrawState &other) const;
+  };
+
+  DrawState get_draw_state() const;
+  void queue_draw_bars(const DrawState &state);
+  void draw_frame(const Cairo::RefPtr<Cairo::Context> &cr, int win_w, int win_h);
+  Glib::RefPtr<Pango::Layout> get_text_layout();
   void draw_bar(const Cairo::RefPtr<Cairo::Context> &cr, int x, int y, int width, int height, int winw, int winh);
   void set_color(const Cairo::RefPtr<Cairo::Context> &cr, const Gdk::Color &color);
   void set_color(const Cairo::RefPtr<Cairo::Context> &cr, const Gdk::RGBA &color);
@@ -61,6 +82,7 @@ protected:
   void get_preferred_height_for_width_vfunc(int width, int &minimum_height, int &natural_height) const override;
   void on_size_allocate(Gtk::Allocation &allocation) override;
   bool on_draw(const Cairo::RefPtr<Cairo::Context> &cr) override;
+  void on_style_updated() override;
 
 private:
   static std::map<TimerColorId, Gdk::Color> bar_colors;
@@ -94,6 +116,20 @@ private:
 
   //! Bar rotation (clockwise degrees)
   int rotation{0};
+
+  //! What was shown when the time bar was last drawn.
+  DrawState drawn_state;
+
+  //! Whether the time bar was drawn since it was last invalidated completely.
+  bool drawn{false};
+
+  //! Background and frame, rendered once per size and style.
+  Cairo::RefPtr<Cairo::Surface> frame_surface;
+  int frame_width{0};
+  int frame_height{0};
+
+  //! Layout of the text, kept while the style and rotation are unchanged.
+  Glib::RefPtr<Pango::Layout> text_layout;
 };
 
 #endif // TIMEBAR_HH
@@ -49,6 +49,11 @@ BreakWindow::BreakWindow(std::shared_ptr<IApplication> app, QScreen *screen, Bre
 void
 BreakWindow::init()
 {
+  if (gui != nullptr)
+    {
+      return;
+    }
+
   if (block_mode != GUIConfig::BLOCK_MODE_NONE)
     {
       setWindowFlags(windowFlags() | Qt::WindowStaysOnTopHint | Qt::FramelessWindowHint | Qt::SplashScreen);
@@ -483,13 +488,16 @@ BreakWindow::stop()
   if (frame != nullptr)
     {
       frame->set_frame_flashing(0);
+      frame->set_frame_visible(false);
     }
+  is_flashing = false;
 
   if (block_window != nullptr)
     {
       block_window->showNormal();
       block_window->hide();
       delete block_window;
+      block_window = nullptr;
     }
 
   hide();
@@ -22,30 +22,23 @@
 #  include "config.h"
 #endif
 
-#include <random>
-
 #include "ExercisesPanel.hh"
 
 #include "debug.hh"
 
-#include "utils/AssetPath.hh"
-
 #include "UiUtil.hh"
 
 using namespace workrave::utils;
 
 int ExercisesPanel::exercises_pointer = 0;
 
+//! Memory budget of the decoded exercise images, enough for all images of the default exercises.
+static constexpr size_t IMAGE_CACHE_BUDGET = 8 * 1024 * 1024;
+
 ExercisesPanel::ExercisesPanel(std::shared_ptr<IApplication> app, bool standalone)
   : sound_theme(app->get_sound_theme())
-  , exercises(Exercise::get_exercises())
+  , shuffled_exercises(Exercise::get_shuffled_exercises())
 {
-  copy(exercises.begin(), exercises.end(), back_inserter(shuffled_exercises));
-
-  std::random_device rd;
-  std::mt19937 g(rd());
-  std::shuffle(shuffled_exercises.begin(), shuffled_exercises.end(), g);
-
   auto *box = new QGridLayout;
 
   image = new QLabel;
@@ -161,11 +154,67 @@ ExercisesPanel::start_exercise()
       exercise_time = 0;
       seq_time = 0;
       image_iterator = exercise.sequence.end();
+      prefetch_upcoming_images();
       refresh_progress();
       refresh_sequence();
     }
 }
 
+//! Starts decoding the images of the exercises of the next rest break.
+void
+ExercisesPanel::prefetch_images(int count)
+{
+  TRACE_ENTRY_PAR(count);
+  prefetch_images(Exercise::get_shuffled_exercises(), exercises_pointer, count);
+}
+
+void
+ExercisesPanel::prefetch_images(const std::vector<Exercise> &exercises, size_t first, int count)
+{
+  if (exercises.empty())
+    {
+      return;
+    }
+
+  std::vector<Exercise::Image> images;
+  for (int i = 0; i < count && i < static_cast<int>(exercises.size()); i++)
+    {
+      const Exercise &exercise = exercises[(first + i) % exercises.size()];
+      images.insert(images.end(), exercise.sequence.begin(), exercise.sequence.end());
+    }
+  get_image_cache().prefetch(images);
+}
+
+//! Starts decoding the images of the current and the next exercise.
+void
+ExercisesPanel::prefetch_upcoming_images()
+{
+  size_t current = exercise_iterator - shuffled_exercises.begin();
+  prefetch_images(shuffled_exercises, current, 2);
+}
+
+auto
+ExercisesPanel::get_image_cache() -> ExerciseImageCache<QImage> &
+{
+  // QImage, unlike QPixmap, can be created outside the GUI thread.
+  static ExerciseImageCache<QImage> cache(
+    [](const std::string &filename, bool mirror_x, double scale) {
+      QImage image(QString::fromStdString(filename));
+      if (!image.isNull() && scale != 1.0)
+        {
+          image = image.scaled(image.size() * scale, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }
+      if (mirror_x)
+        {
+          image = image.mirrored(true, false);
+        }
+      return image;
+    },
+    [](const QImage &image) { return static_cast<size_t>(image.sizeInBytes()); },
+    IMAGE_CACHE_BUDGET);
+  return cache;
+}
+
 void
 ExercisesPanel::show_image()
 {
@@ -173,16 +222,7 @@ ExercisesPanel::show_image()
   const Exercise::Image &img = (*image_iterator);
   seq_time += img.duration;
   TRACE_MSG("image= {}", img.image);
-  std::string file = AssetPath::complete_directory(img.image, AssetPath::SEARCH_PATH_EXERCISES);
-  if (!img.mirror_x)
-    {
-      image->setPixmap(QPixmap(file.c_str()));
-    }
-  else
-    {
-      QPixmap pixmap(file.c_str());
-      image->setPixmap(pixmap.transformed(QTransform::fromScale(-1, 1)));
-    }
+  image->setPixmap(QPixmap::fromImage(get_image_cache().get(img)));
 }
 
 void
@@ -27,6 +27,7 @@
 
 #include "ui/IApplication.hh"
 #include "ui/Exercise.hh"
+#include "ui/ExerciseImageCache.hh"
 
 class ExercisesPanel : public QWidget
 {
@@ -37,6 +38,7 @@ public:
   ~ExercisesPanel() override = default;
 
   void set_exercise_count(int num);
+  static void prefetch_images(int count);
   auto signal_stop() -> boost::signals2::signal<void()> &;
 
 public Q_SLOTS:
@@ -50,6 +52,7 @@ private:
   void on_stop();
   void start_exercise();
   void show_image();
+  void prefetch_upcoming_images();
   void refresh_progress();
   void refresh_sequence();
   void refresh_pause();
@@ -64,6 +67,9 @@ private:
     return ret;
   }
 
+  static void prefetch_images(const std::vector<Exercise> &exercises, size_t first, int count);
+  static auto get_image_cache() -> ExerciseImageCache<QImage> &;
+
   SoundTheme::Ptr sound_theme;
   QTimer *timer{nullptr};
   QLabel *image{nullptr};
@@ -72,7 +78,6 @@ private:
   QScrollArea *description_scroll{nullptr};
   QPushButton *pause_button{nullptr};
 
-  const std::list<Exercise> exercises;
   std::vector<Exercise> shuffled_exercises;
   std::vector<Exercise>::const_iterator exercise_iterator;
   std::list<Exercise::Image>::const_iterator image_iterator;
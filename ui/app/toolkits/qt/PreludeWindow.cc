@@ -29,8 +29,11 @@
 #include "debug.hh"
 
 #include "core/IApp.hh"
+#include "ui/Exercise.hh"
+#include "ui/GUIConfig.hh"
 #include "utils/AssetPath.hh"
 
+#include "ExercisesPanel.hh"
 #include "UiUtil.hh"
 #include "qformat.hh"
 
@@ -127,6 +130,15 @@ PreludeWindow::PreludeWindow(QScreen *screen, workrave::BreakId break_id)
 void
 PreludeWindow::start()
 {
+  // The window may have been moved away from the pointer when it was shown before.
+  did_avoid = false;
+
+  if (break_id == BREAK_ID_REST_BREAK && screen == QGuiApplication::screens().first() && Exercise::has_exercises())
+    {
+      // Decode the exercise images while the prelude is shown.
+      ExercisesPanel::prefetch_images(GUIConfig::break_exercises(BREAK_ID_REST_BREAK)());
+    }
+
   timebar->set_bar_color(TimerColorId::Overdue);
   refresh();
   show();
@@ -49,6 +49,20 @@ RestBreakWindow::create_gui() -> QWidget *
   pluggable_panel = new QHBoxLayout;
   box->addLayout(pluggable_panel);
 
+  timebar = new TimeBar;
+  box->addWidget(timebar);
+
+  auto *widget = new QWidget;
+  widget->setLayout(box);
+
+  return widget;
+}
+
+//! Installs a new panel each time the window is shown, as it may be reused for the next rest break.
+void
+RestBreakWindow::start()
+{
+  TRACE_ENTRY();
   if (((get_break_flags() & BREAK_FLAGS_NO_EXERCISES) != 0) || get_exercise_count() == 0)
     {
       install_info_panel();
@@ -58,13 +72,7 @@ RestBreakWindow::create_gui() -> QWidget *
       install_exercises_panel();
     }
 
-  timebar = new TimeBar;
-  box->addWidget(timebar);
-
-  auto *widget = new QWidget;
-  widget->setLayout(box);
-
-  return widget;
+  BreakWindow::start();
 }
 
 void
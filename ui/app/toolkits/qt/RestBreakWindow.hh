@@ -33,6 +33,7 @@ class RestBreakWindow
 public:
   RestBreakWindow(std::shared_ptr<IApplication> app, QScreen *screen, BreakFlags break_flags);
 
+  void start() override;
   void set_progress(int value, int max_value) override;
 
 private:
@@ -50,18 +50,19 @@ StatisticsDialog::StatisticsDialog(std::shared_ptr<IApplication> app)
     }
 
   init_gui();
+
+  workrave::utils::connect(statistics->signal_current_day_changed(), this, [this](const auto &changes) {
+    on_current_day_changed(changes);
+  });
+
+  // The current day is only kept up to date in memory while connected.
+  statistics->refresh_current_day();
   display_calendar_date();
 }
 
 auto
 StatisticsDialog::run() -> int
 {
-  // Periodic timer.
-  auto *timer = new QTimer(this);
-  timer->setInterval(1000);
-  connect(timer, SIGNAL(timeout()), this, SLOT(on_timer()));
-  timer->start();
-
   return 0;
 }
 
@@ -268,6 +269,21 @@ StatisticsDialog::display_statistics(IStatistics::DailyStats *stats)
       stats = &empty;
     }
 
+  display_date(stats);
+
+  int64_t value = stats->misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME];
+  daily_usage_time_label->setText(UiUtil::time_to_string(value));
+
+  // Put the breaks in table.
+  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+    {
+      display_break_statistics(stats, i);
+    }
+}
+
+void
+StatisticsDialog::display_date(IStatistics::DailyStats *stats)
+{
   if (stats->start.tm_year == 0 /*stats->is_empty() */)
     {
       date_label->setText("-");
@@ -291,84 +307,50 @@ StatisticsDialog::display_statistics(IStatistics::DailyStats *stats)
 
       date_label->setText(text);
     }
+}
 
-  int64_t value = stats->misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME];
-  daily_usage_time_label->setText(UiUtil::time_to_string(value));
-
-  // Put the breaks in table.
-  for (int i = 0; i < BREAK_ID_SIZEOF; i++)
-    {
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_UNIQUE_BREAKS];
-      break_labels[i][0]->setText(QString::number(value));
+void
+StatisticsDialog::display_break_statistics(IStatistics::DailyStats *stats, int i)
+{
+  int64_t value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_UNIQUE_BREAKS];
+  break_labels[i][0]->setText(QString::number(value));
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_PROMPTED] - value;
-      break_labels[i][1]->setText(QString::number(value));
+  value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_PROMPTED] - value;
+  break_labels[i][1]->setText(QString::number(value));
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_TAKEN];
-      break_labels[i][2]->setText(QString::number(value));
+  value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_TAKEN];
+  break_labels[i][2]->setText(QString::number(value));
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_NATURAL_TAKEN];
-      break_labels[i][3]->setText(QString::number(value));
+  value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_NATURAL_TAKEN];
+  break_labels[i][3]->setText(QString::number(value));
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_SKIPPED];
-      break_labels[i][4]->setText(QString::number(value));
+  value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_SKIPPED];
+  break_labels[i][4]->setText(QString::number(value));
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_POSTPONED];
-      break_labels[i][5]->setText(QString::number(value));
+  value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_POSTPONED];
+  break_labels[i][5]->setText(QString::number(value));
 
-      value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_TOTAL_OVERDUE];
+  value = stats->break_stats[i][IStatistics::STATS_BREAKVALUE_TOTAL_OVERDUE];
 
-      break_labels[i][6]->setText(UiUtil::time_to_string(value));
-    }
+  break_labels[i][6]->setText(UiUtil::time_to_string(value));
 }
 
 void
 StatisticsDialog::display_week_statistics()
 {
   QDate date = calendar->selectedDate();
-  int y = date.year();
-  int m = date.month() - 1;
-  int d = date.day();
-
-  std::tm timeinfo{};
-  std::memset(&timeinfo, 0, sizeof(timeinfo));
-  timeinfo.tm_mday = d;
-  timeinfo.tm_mon = m;
-  timeinfo.tm_year = y - 1900;
-
-  std::time_t t = std::mktime(&timeinfo);
-  std::tm const *time_loc = std::localtime(&t);
 
   QLocale locale;
-  int week_start = locale.firstDayOfWeek() % 7;
+  int offset = (date.dayOfWeek() - locale.firstDayOfWeek() + 7) % 7;
 
-  int offset = (time_loc->tm_wday - week_start + 7) % 7;
-  int64_t total_week = 0;
-  for (int i = 0; i < 7; i++)
-    {
-      std::memset(&timeinfo, 0, sizeof(timeinfo));
-      timeinfo.tm_mday = d - offset + i;
-      timeinfo.tm_mon = m;
-      timeinfo.tm_year = y - 1900;
-      t = std::mktime(&timeinfo);
-      time_loc = std::localtime(&t);
-
-      int idx = 0;
-      int next = 0;
-      int prev = 0;
-      statistics->get_day_index_by_date(time_loc->tm_year + 1900, time_loc->tm_mon + 1, time_loc->tm_mday, idx, next, prev);
-
-      if (idx >= 0)
-        {
-          IStatistics::DailyStats *stats = statistics->get_day(idx);
-          if (stats != nullptr)
-            {
-              total_week += stats->misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME];
-            }
+  QDate first = date.addDays(-offset);
+  QDate last = first.addDays(6);
 
-          update_usage_real_time |= (idx == 0);
-        }
-    }
+  IStatistics::StatsTotals totals;
+  statistics->get_totals(first.year(), first.month(), first.day(), last.year(), last.month(), last.day(), totals);
+
+  int64_t total_week = totals.misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME];
+  update_usage_real_time |= is_current_day_between(first, last);
 
   weekly_usage_time_label->setText(total_week > 0 ? UiUtil::time_to_string(total_week) : "");
 }
@@ -377,53 +359,33 @@ void
 StatisticsDialog::display_month_statistics()
 {
   QDate date = calendar->selectedDate();
-  int y = date.year();
-  int m = date.month() - 1;
 
-  int max_mday = 0;
-  if (m == 3 || m == 5 || m == 8 || m == 10)
-    {
-      max_mday = 30;
-    }
-  else if (m == 1)
-    {
-      bool is_leap = (y % 4 == 0 && y % 100 != 0) || (y % 400 == 0);
-      if (is_leap)
-        {
-          max_mday = 29;
-        }
-      else
-        {
-          max_mday = 28;
-        }
-    }
-  else
-    {
-      max_mday = 31;
-    }
+  IStatistics::StatsTotals totals;
+  statistics->get_period_totals(IStatistics::STATS_PERIOD_MONTH, date.year(), date.month(), date.day(), totals);
 
-  int64_t total_month = 0;
-  for (int i = 1; i <= max_mday; i++)
-    {
-      int idx = 0;
-      int next = 0;
-      int prev = 0;
-      statistics->get_day_index_by_date(y, m + 1, i, idx, next, prev);
-      if (idx >= 0)
-        {
-          IStatistics::DailyStats *stats = statistics->get_day(idx);
-          if (stats != nullptr)
-            {
-              total_month += stats->misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME];
-            }
+  QDate first(date.year(), date.month(), 1);
+  QDate last(date.year(), date.month(), date.daysInMonth());
 
-          update_usage_real_time |= (idx == 0);
-        }
-    }
+  int64_t total_month = totals.misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME];
+  update_usage_real_time |= is_current_day_between(first, last);
 
   monthly_usage_time_label->setText(total_month > 0 ? UiUtil::time_to_string(total_month) : "");
 }
 
+//! Returns whether the current day lies between the first and the last date.
+bool
+StatisticsDialog::is_current_day_between(const QDate &first, const QDate &last) const
+{
+  IStatistics::DailyStats *stats = statistics->get_current_day();
+  if (stats == nullptr)
+    {
+      return false;
+    }
+
+  QDate today(stats->start.tm_year + 1900, stats->start.tm_mon + 1, stats->start.tm_mday);
+  return today >= first && today <= last;
+}
+
 void
 StatisticsDialog::clear_display_statistics()
 {
@@ -494,6 +456,7 @@ StatisticsDialog::display_calendar_date()
     {
       clear_display_statistics();
     }
+  showing_current_day = idx == 0;
   update_usage_real_time = false;
   display_week_statistics();
   display_month_statistics();
@@ -597,16 +560,41 @@ StatisticsDialog::on_history_delete_all()
   // app->get_core()->remove_operation_mode_override( funcname );
 }
 
-//! Periodic heartbeat.
-auto
-StatisticsDialog::on_timer() -> bool
+//! Shows the changes of the statistics of the current day.
+void
+StatisticsDialog::on_current_day_changed(const IStatistics::DailyStatsChanges &changes)
 {
-  if (update_usage_real_time)
+  if (changes.new_day)
     {
-      statistics->update();
       display_calendar_date();
+      return;
+    }
+
+  if (showing_current_day)
+    {
+      IStatistics::DailyStats *stats = statistics->get_current_day();
+      if (changes.period)
+        {
+          display_date(stats);
+        }
+      if (changes.misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME])
+        {
+          daily_usage_time_label->setText(UiUtil::time_to_string(stats->misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME]));
+        }
+      for (int i = 0; i < BREAK_ID_SIZEOF; i++)
+        {
+          if (changes.break_stats[i])
+            {
+              display_break_statistics(stats, i);
+            }
+        }
+    }
+
+  if (update_usage_real_time && changes.misc_stats[IStatistics::STATS_VALUE_TOTAL_ACTIVE_TIME])
+    {
+      display_week_statistics();
+      display_month_statistics();
     }
-  return true;
 }
 
 void
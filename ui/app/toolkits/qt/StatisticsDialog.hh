@@ -25,9 +25,12 @@
 #include <memory>
 
 #include "core/IStatistics.hh"
+#include "utils/Signals.hh"
 #include "ui/IApplication.hh"
 
-class StatisticsDialog : public QDialog
+class StatisticsDialog
+  : public QDialog
+  , public workrave::utils::Trackable
 {
   Q_OBJECT
 
@@ -58,6 +61,7 @@ private:
   QPushButton *delete_button{nullptr};
 
   bool update_usage_real_time{false};
+  bool showing_current_day{false};
 
   void on_history_delete_all();
 
@@ -81,10 +85,13 @@ private:
   void on_history_goto_first();
   void display_calendar_date();
   void display_statistics(workrave::IStatistics::DailyStats *stats);
+  void display_date(workrave::IStatistics::DailyStats *stats);
+  void display_break_statistics(workrave::IStatistics::DailyStats *stats, int break_id);
   void clear_display_statistics();
   void display_week_statistics();
   void display_month_statistics();
-  auto on_timer() -> bool;
+  bool is_current_day_between(const QDate &first, const QDate &last) const;
+  void on_current_day_changed(const workrave::IStatistics::DailyStatsChanges &changes);
 };
 
 #endif // STATISTICSDIALOG_HH
@@ -21,9 +21,14 @@
 
 #include "TimeBar.hh"
 
+#include <QEvent>
 #include <QStylePainter>
 #include <QStyleOptionProgressBar>
 
+#include <algorithm>
+#include <climits>
+#include <tuple>
+
 #include "UiUtil.hh"
 #include "debug.hh"
 
@@ -46,6 +51,7 @@ TimeBar::TimeBar(QWidget *parent)
 {
   setBackgroundRole(QPalette::Base);
   setAutoFillBackground(true);
+  static_text.setTextFormat(Qt::PlainText);
 }
 
 void
@@ -96,10 +102,141 @@ TimeBar::set_secondary_bar_color(TimerColorId color)
   secondary_bar_color = color;
 }
 
+//! Repaints the parts of the time bar of which the shown contents changed.
 void
 TimeBar::update()
 {
-  QWidget::update();
+  DrawState state = get_draw_state();
+  if (painted && state == painted_state)
+    {
+      return;
+    }
+
+  DrawState bars_changed = painted_state;
+  bars_changed.bar_width = state.bar_width;
+  bars_changed.sbar_width = state.sbar_width;
+
+  if (painted && state == bars_changed)
+    {
+      update_bars(state);
+    }
+  else
+    {
+      QWidget::update();
+    }
+}
+
+auto
+TimeBar::DrawState::operator==(const DrawState &other) const -> bool
+{
+  return std::tie(width, height, bar_width, sbar_width, bar_color, secondary_bar_color, text, text_align)
+         == std::tie(other.width,
+                     other.height,
+                     other.bar_width,
+                     other.sbar_width,
+                     other.bar_color,
+                     other.secondary_bar_color,
+                     other.text,
+                     other.text_align);
+}
+
+auto
+TimeBar::get_draw_state() const -> DrawState
+{
+  const int border_size = 1;
+
+  DrawState state;
+  state.width = width();
+  state.height = height();
+  state.bar_color = bar_color;
+  state.secondary_bar_color = secondary_bar_color;
+  state.text = bar_text;
+  state.text_align = bar_text_align;
+
+  if (bar_max_value > 0)
+    {
+      state.bar_width = (bar_value * (width() - 2 * border_size - 1)) / bar_max_value;
+    }
+
+  if (secondary_bar_max_value > 0)
+    {
+      state.sbar_width = (secondary_bar_value * (width() - 2 * border_size - 1)) / secondary_bar_max_value;
+    }
+
+  return state;
+}
+
+//! Repaints the part of the bar between the old and new ends of the bars.
+void
+TimeBar::update_bars(const DrawState &state)
+{
+  const int border_size = 1;
+
+  int from = INT_MAX;
+  int to = INT_MIN;
+
+  auto extend = [&](int old_width, int new_width) {
+    if (old_width != new_width)
+      {
+        from = std::min({from, old_width, new_width});
+        to = std::max({to, old_width, new_width});
+      }
+  };
+  extend(painted_state.bar_width, state.bar_width);
+  extend(painted_state.sbar_width, state.sbar_width);
+
+  // Include a pixel on each side for antialiased text.
+  QWidget::update(border_size + from - 1, 0, to - from + 2, state.height);
+}
+
+void
+TimeBar::changeEvent(QEvent *event)
+{
+  switch (event->type())
+    {
+    case QEvent::StyleChange:
+    case QEvent::PaletteChange:
+    case QEvent::FontChange:
+      frame_cache = QPixmap();
+      static_text = QStaticText();
+      static_text.setTextFormat(Qt::PlainText);
+      painted = false;
+      break;
+    default:
+      break;
+    }
+  QWidget::changeEvent(event);
+}
+
+//! Draws the background and frame from a cached pixmap.
+void
+TimeBar::draw_frame(QStylePainter &painter)
+{
+  qreal ratio = devicePixelRatioF();
+  QSize size = this->size() * ratio;
+
+  if (frame_cache.size() != size)
+    {
+      frame_cache = QPixmap(size);
+      frame_cache.setDevicePixelRatio(ratio);
+      frame_cache.fill(Qt::transparent);
+
+      QStylePainter frame_painter(&frame_cache, this);
+      frame_painter.fillRect(0, 0, width() - 1, height() - 1, QColor("white"));
+      frame_painter.setPen(QColor("black"));
+      frame_painter.drawRect(0, 0, width() - 1, height() - 1);
+
+      QStyleOptionFrame option;
+      option.initFrom(this);
+      option.features = QStyleOptionFrame::Flat;
+      option.frameShape = QFrame::Panel;
+      option.lineWidth = 2;
+      option.midLineWidth = 0;
+
+      frame_painter.drawPrimitive(QStyle::PE_Frame, option);
+    }
+
+  painter.drawPixmap(0, 0, frame_cache);
 }
 
 auto
@@ -133,36 +270,15 @@ TimeBar::paintEvent(QPaintEvent * /* event */)
 {
   TRACE_ENTRY();
   QStylePainter painter(this);
+  DrawState state = get_draw_state();
 
   const int border_size = 1;
 
   // Draw background
-  painter.fillRect(0, 0, width() - 1, height() - 1, QColor("white"));
-  painter.setPen(QColor("black"));
-  painter.drawRect(0, 0, width() - 1, height() - 1);
-
-  QStyleOptionFrame option;
-  option.initFrom(this);
-  option.features = QStyleOptionFrame::Flat;
-  option.frameShape = QFrame::Panel;
-  option.lineWidth = 2;
-  option.midLineWidth = 0;
-
-  painter.drawPrimitive(QStyle::PE_Frame, option);
+  draw_frame(painter);
 
-  // Bar
-  int bar_width = 0;
-  if (bar_max_value > 0)
-    {
-      bar_width = (bar_value * (width() - 2 * border_size - 1)) / bar_max_value;
-    }
-
-  // Secondary bar
-  int sbar_width = 0;
-  if (secondary_bar_max_value > 0)
-    {
-      sbar_width = (secondary_bar_value * (width() - 2 * border_size - 1)) / secondary_bar_max_value;
-    }
+  int bar_width = state.bar_width;
+  int sbar_width = state.sbar_width;
 
   int bar_height = height() - 2 * border_size;
 
@@ -218,7 +334,13 @@ TimeBar::paintEvent(QPaintEvent * /* event */)
       painter.fillRect(border_size, border_size, bar_width, bar_height, bar_colors[bar_color]);
     }
 
-  int text_width = painter.fontMetrics().horizontalAdvance(bar_text);
+  if (static_text.text() != bar_text)
+    {
+      static_text.setText(bar_text);
+      static_text.prepare(QTransform(), painter.font());
+    }
+
+  int text_width = static_cast<int>(static_text.size().width());
   int text_height = painter.fontMetrics().height();
 
   int text_x = 0;
@@ -246,7 +368,10 @@ TimeBar::paintEvent(QPaintEvent * /* event */)
   QRegion right_rect(left_width, 0, width() - left_width, height());
 
   painter.setPen(QColor("black"));
-  painter.drawText(text_x, text_y, bar_text);
+  painter.drawStaticText(text_x, text_y - painter.fontMetrics().ascent(), static_text);
 
   TRACE_MSG("width = {} height = {}", text_width, text_height);
+
+  painted_state = state;
+  painted = true;
 }
@@ -20,6 +20,10 @@
 
 #include "ui/UiTypes.hh"
 
+class QStylePainter;
+
+#include <QPixmap>
+#include <QStaticText>
 #include <QWidget>
 
 class TimeBar : public QWidget
@@ -45,6 +49,27 @@ public:
 
 protected:
   void paintEvent(QPaintEvent *event) override;
+  void changeEvent(QEvent *event) override;
+
+private:
+  //! What is shown by the time bar, at the resolution at which it is shown.
+  struct DrawState
+  {
+    int width{0};
+    int height{0};
+    int bar_width{0};
+    int sbar_width{0};
+    TimerColorId bar_color{TimerColorId::Active};
+    TimerColorId secondary_bar_color{TimerColorId::Active};
+    QString text;
+    int text_align{0};
+
+    auto operator==(const DrawState &other) const -> bool;
+  };
+
+  auto get_draw_state() const -> DrawState;
+  void update_bars(const DrawState &state);
+  void draw_frame(QStylePainter &painter);
 
 private:
   static std::map<TimerColorId, QColor> bar_colors;
@@ -57,6 +82,18 @@ private:
   int secondary_bar_max_value{0};
   QString bar_text;
   int bar_text_align{0};
+
+  //! What was shown when the time bar was last painted.
+  DrawState painted_state;
+
+  //! Whether the time bar was painted since it was last invalidated completely.
+  bool painted{false};
+
+  //! Background and frame, rendered once per size and style.
+  QPixmap frame_cache;
+
+  //! Layout of the text.
+  QStaticText static_text;
 };
 
 #endif // TIMEBAR_HH
@@ -21,7 +21,10 @@
 
 #include "Toolkit.hh"
 
+#include <algorithm>
+
 #include <QApplication>
+#include <QScreen>
 
 #include "DailyLimitWindow.hh"
 #include "MicroBreakWindow.hh"
@@ -66,13 +69,48 @@ Toolkit::init(std::shared_ptr<IApplication> app)
   // event_connections.emplace_back(status_icon->signal_balloon_activated().connect(sigc::mem_fun(*this,
   // &Toolkit::on_status_icon_balloon_activated)));
 
+  heartbeat_timer->setSingleShot(true);
   connect(heartbeat_timer, SIGNAL(timeout()), this, SLOT(on_timer()));
-  heartbeat_timer->start(1000);
+  set_timer_delay(1000);
+
+  init_multihead();
 
   main_window->show();
   main_window->raise();
 }
 
+void
+Toolkit::init_multihead()
+{
+  for (QScreen *screen: screens())
+    {
+      watch_screen(screen);
+    }
+
+  connect(this, &QGuiApplication::screenAdded, this, [this](QScreen *screen) {
+    watch_screen(screen);
+    display_changed_signal();
+  });
+  connect(this, &QGuiApplication::screenRemoved, this, [this](QScreen *) { display_changed_signal(); });
+  connect(this, &QGuiApplication::primaryScreenChanged, this, [this](QScreen *) { display_changed_signal(); });
+}
+
+void
+Toolkit::watch_screen(QScreen *screen)
+{
+  connect(screen, &QScreen::geometryChanged, this, [this](const QRect &) { display_changed_signal(); });
+}
+
+auto
+Toolkit::event(QEvent *event) -> bool
+{
+  if (event->type() == QEvent::ApplicationPaletteChange)
+    {
+      display_changed_signal();
+    }
+  return QApplication::event(event);
+}
+
 void
 Toolkit::deinit()
 {
@@ -266,6 +304,12 @@ Toolkit::signal_status_icon_activated() -> boost::signals2::signal<void()> &
   return status_icon_activated_signal;
 }
 
+auto
+Toolkit::signal_display_changed() -> boost::signals2::signal<void()> &
+{
+  return display_changed_signal;
+}
+
 auto
 Toolkit::get_display_name() const -> const char *
 {
@@ -279,6 +323,39 @@ Toolkit::create_oneshot_timer(int ms, std::function<void()> func)
   new OneshotTimer(ms, func);
 }
 
+void
+Toolkit::set_timer_delay(int ms)
+{
+  auto now = std::chrono::steady_clock::now();
+  timer_deadline = std::min(now + std::chrono::milliseconds(ms), timer_limit);
+  auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(timer_deadline - now).count();
+
+  heartbeat_timer->start(static_cast<int>(std::max<int64_t>(delay, 0)));
+}
+
+void
+Toolkit::limit_timer_delay(int ms)
+{
+  timer_limit = std::min(timer_limit, std::chrono::steady_clock::now() + std::chrono::milliseconds(ms));
+  if (timer_limit < timer_deadline)
+    {
+      set_timer_delay(ms);
+    }
+}
+
+void
+Toolkit::wakeup_timer()
+{
+  // Queued invocations are thread-safe; the timer itself may only be used from the main thread.
+  QMetaObject::invokeMethod(
+    this,
+    [this]() {
+      qint64 elapsed_ms = last_timer_time.isValid() ? last_timer_time.elapsed() : 1000;
+      set_timer_delay(static_cast<int>(std::clamp<qint64>(1000 - elapsed_ms, 0, 1000)));
+    },
+    Qt::QueuedConnection);
+}
+
 void
 Toolkit::show_notification(const std::string &id, const std::string &title, const std::string &balloon, std::function<void()> func)
 {
@@ -294,6 +371,11 @@ Toolkit::show_tooltip(const std::string &tip)
 void
 Toolkit::on_timer()
 {
+  // Repeat every second, unless a handler of the timer signal sets another delay.
+  timer_limit = std::chrono::steady_clock::time_point::max();
+  set_timer_delay(1000);
+  last_timer_time.start();
+
   timer_signal();
   main_window->heartbeat();
 }
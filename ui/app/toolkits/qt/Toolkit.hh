@@ -18,11 +18,13 @@
 #ifndef TOOLKIT_HH
 #define TOOLKIT_HH
 
+#include <chrono>
 #include <memory>
 #include <map>
 #include <boost/signals2.hpp>
 
 #include <QApplication>
+#include <QElapsedTimer>
 #include <QTimer>
 
 #include "AboutDialog.hh"
@@ -69,6 +71,9 @@ public:
 
   auto get_display_name() const -> const char * override;
   void create_oneshot_timer(int ms, std::function<void()> func) override;
+  void set_timer_delay(int ms) override;
+  void limit_timer_delay(int ms) override;
+  void wakeup_timer() override;
   void show_notification(const std::string &id, const std::string &title, const std::string &balloon, std::function<void()> func) override;
   void show_tooltip(const std::string &tip) override;
 
@@ -77,11 +82,18 @@ public:
   auto signal_session_idle_changed() -> boost::signals2::signal<void(bool)> & override;
   auto signal_session_unlocked() -> boost::signals2::signal<void()> & override;
   auto signal_status_icon_activated() -> boost::signals2::signal<void()> & override;
+  auto signal_display_changed() -> boost::signals2::signal<void()> & override;
 
 public Q_SLOTS:
   void on_timer();
 
+protected:
+  auto event(QEvent *event) -> bool override;
+
 private:
+  void init_multihead();
+  void watch_screen(QScreen *screen);
+
   void show_about();
   void show_debug();
   void show_exercises();
@@ -113,6 +125,9 @@ private:
   int hold_count{0};
 
   QTimer *heartbeat_timer{nullptr};
+  QElapsedTimer last_timer_time;
+  std::chrono::steady_clock::time_point timer_deadline;
+  std::chrono::steady_clock::time_point timer_limit{std::chrono::steady_clock::time_point::max()};
 
   std::shared_ptr<MenuModel> menu_model;
   std::shared_ptr<SoundTheme> sound_theme;
@@ -124,6 +139,7 @@ private:
   boost::signals2::signal<void(bool)> session_idle_changed_signal;
   boost::signals2::signal<void()> session_unlocked_signal;
   boost::signals2::signal<void()> status_icon_activated_signal;
+  boost::signals2::signal<void()> display_changed_signal;
 };
 
 class OneshotTimer : public QObject
@@ -21,6 +21,10 @@ const IndicatorIface = '<node>\
         <arg type="b" name="enabled" direction="in" /> \
         <arg type="s" name="sender" direction="in" /> \
     </method> \
+    <method name="SetUpdateOptions"> \
+        <arg type="i" name="granularity" direction="in" /> \
+        <arg type="b" name="incremental" direction="in" /> \
+    </method> \
     <method name="Command"> \
         <arg type="i" name="command" direction="in" /> \
     </method> \
@@ -35,6 +39,10 @@ const IndicatorIface = '<node>\
         <arg type="(siuuuuuu)" /> \
         <arg type="(siuuuuuu)" /> \
     </signal> \
+    <signal name="TimerUpdated"> \
+        <arg type="u" /> \
+        <arg type="(siuuuuuu)" /> \
+    </signal> \
     <signal name="MenuUpdated"> \
         <arg type="a(sssuyy)" /> \
     </signal> \
@@ -209,6 +217,7 @@ const WorkraveButton = new Lang.Class({
 
         this._ui_proxy = new IndicatorProxy(Gio.DBus.session, 'org.workrave.Workrave', '/org/workrave/Workrave/UI', Lang.bind(this, this._connectUI));
         this._timers_updated_id = this._ui_proxy.connectSignal("TimersUpdated", Lang.bind(this, this._onTimersUpdated));
+        this._timer_updated_id = this._ui_proxy.connectSignal("TimerUpdated", Lang.bind(this, this._onTimerUpdated));
         this._menu_updated_id = this._ui_proxy.connectSignal("MenuUpdated", Lang.bind(this, this._onMenuUpdated));
         this._menu_item_updated_id = this._ui_proxy.connectSignal("MenuItemUpdated", Lang.bind(this, this._onMenuItemUpdated));
         this._trayicon_updated_id = this._ui_proxy.connectSignal("TrayIconUpdated", Lang.bind(this, this._onTrayIconUpdated));
@@ -262,6 +271,7 @@ const WorkraveButton = new Lang.Class({
         if (this._ui_proxy != null)
         {
             this._ui_proxy.disconnectSignal(this._timers_updated_id);
+            this._ui_proxy.disconnectSignal(this._timer_updated_id);
             this._ui_proxy.disconnectSignal(this._menu_updated_id);
             this._ui_proxy.disconnectSignal(this._menu_item_updated_id);
             this._ui_proxy.disconnectSignal(this._trayicon_updated_id);
@@ -281,6 +291,9 @@ const WorkraveButton = new Lang.Class({
             this._ui_proxy.GetMenuRemote(Lang.bind(this, this._onGetMenuReply));
             this._ui_proxy.GetTrayIconEnabledRemote(Lang.bind(this, this._onGetTrayIconEnabledReply));
             this._ui_proxy.EmbedRemote(true, this._bus_name);
+            // Older versions of Workrave do not support this and keep sending all timers every second.
+            this._incremental_updates = false;
+            this._ui_proxy.SetUpdateOptionsRemote(1, true, Lang.bind(this, this._onSetUpdateOptionsReply));
             this._core_proxy.GetOperationModeRemote(Lang.bind(this, this._onGetOperationModeReply));
             this._timeoutId = Mainloop.timeout_add(5000, Lang.bind(this, this._onTimer));
             this._alive = true;
@@ -322,7 +335,8 @@ const WorkraveButton = new Lang.Class({
             return false;
         }
 
-        if (this._update_count == 0)
+        // Incremental updates are only sent when a timer changes.
+        if (this._update_count == 0 && !this._incremental_updates)
         {
             this._timerbox.set_enabled(false);
             this._area.queue_repaint();
@@ -352,38 +366,49 @@ const WorkraveButton = new Lang.Class({
         this._timerbox.set_slot(1, restbreak[1]);
         this._timerbox.set_slot(2, daily[1]);
 
-        var timebar = this._timerbox.get_time_bar(0);
-        if (timebar != null)
+        this._updateTimebar(0, microbreak);
+        this._updateTimebar(1, restbreak);
+        this._updateTimebar(2, daily);
+
+        let timerbox_width = this._timerbox.get_width();
+        let timerbox_height = this._timerbox.get_height();
+
+        this._area.set_width(this._width=timerbox_width);
+        this._area.queue_repaint();
+    },
+
+    _onTimerUpdated : function(emitter, senderName, [id, data]) {
+        if (! this._alive)
         {
-            this._timerbox.set_enabled(true);
-            timebar.set_progress(microbreak[6], microbreak[7], microbreak[5]);
-            timebar.set_secondary_progress(microbreak[3], microbreak[4], microbreak[2]);
-            timebar.set_text(microbreak[0]);
+            this._start();
         }
 
-        timebar = this._timerbox.get_time_bar(1);
-        if (timebar != null)
+        this._update_count++;
+
+        if (id < 3)
         {
-            this._timerbox.set_enabled(true);
-            timebar.set_progress(restbreak[6], restbreak[7], restbreak[5]);
-            timebar.set_secondary_progress(restbreak[3], restbreak[4], restbreak[2]);
-            timebar.set_text(restbreak[0]);
+            this._timerbox.set_slot(id, data[1]);
+            this._updateTimebar(id, data);
+
+            let timerbox_width = this._timerbox.get_width();
+            this._area.set_width(this._width=timerbox_width);
+            this._area.queue_repaint();
         }
+    },
 
-        timebar = this._timerbox.get_time_bar(2);
+    _updateTimebar : function(id, data) {
+        let timebar = this._timerbox.get_time_bar(id);
         if (timebar != null)
         {
             this._timerbox.set_enabled(true);
-            timebar.set_progress(daily[6], daily[7], daily[5]);
-            timebar.set_secondary_progress(daily[3], daily[4], daily[2]);
-            timebar.set_text(daily[0]);
+            timebar.set_progress(data[6], data[7], data[5]);
+            timebar.set_secondary_progress(data[3], data[4], data[2]);
+            timebar.set_text(data[0]);
         }
+    },
 
-        let timerbox_width = this._timerbox.get_width();
-        let timerbox_height = this._timerbox.get_height();
-
-        this._area.set_width(this._width=timerbox_width);
-        this._area.queue_repaint();
+    _onSetUpdateOptionsReply : function(result, excp) {
+        this._incremental_updates = (excp == null);
     },
 
     _onGetMenuReply : function([menuitems], excp) {
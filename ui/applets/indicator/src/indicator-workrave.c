@@ -101,6 +101,7 @@ struct _IndicatorWorkravePrivate
   guint startup_timer;
   guint startup_count;
   guint update_count;
+  gboolean incremental_updates;
 
   WorkraveTimerbox *timerbox;
 };
@@ -144,6 +145,7 @@ static void on_dbus_ui_ready(GObject *object, GAsyncResult *res, gpointer user_d
 static void on_dbus_core_ready(GObject *object, GAsyncResult *res, gpointer user_data);
 static void on_dbus_signal(GDBusProxy *proxy, gchar *sender_name, gchar *signal_name, GVariant *parameters, gpointer user_data);
 static void on_update_indicator(IndicatorWorkrave *self, GVariant *parameters);
+static void on_update_timer(IndicatorWorkrave *self, GVariant *parameters);
 static void on_bus_acquired(GDBusConnection *connection, const gchar *name, gpointer user_data);
 static void on_workrave_appeared(GDBusConnection *connection, const gchar *name, const gchar *name_owner, gpointer user_data);
 static void on_workrave_vanished(GDBusConnection *connection, const gchar *name, gpointer user_data);
@@ -191,6 +193,7 @@ indicator_workrave_init(IndicatorWorkrave *self)
   priv->startup_count = 0;
   priv->timerbox = NULL;
   priv->update_count = 0;
+  priv->incremental_updates = FALSE;
 
   priv->menu = dbusmenu_gtkmenu_new(WORKRAVE_INDICATOR_MENU_NAME, WORKRAVE_INDICATOR_MENU_OBJ);
   priv->timerbox = g_object_new(WORKRAVE_TYPE_TIMERBOX, NULL);
@@ -336,6 +339,29 @@ indicator_workrave_start(IndicatorWorkrave *self)
         }
     }
 
+  if (error == NULL)
+    {
+      /* Older versions of Workrave do not support this and keep sending all timers every second. */
+      GError *options_error = NULL;
+      GVariant *result = g_dbus_proxy_call_sync(priv->workrave_ui_proxy,
+                                                "SetUpdateOptions",
+                                                g_variant_new("(ib)", 1, TRUE),
+                                                G_DBUS_CALL_FLAGS_NONE,
+                                                -1,
+                                                NULL,
+                                                &options_error);
+
+      priv->incremental_updates = (options_error == NULL);
+      if (options_error != NULL)
+        {
+          g_error_free(options_error);
+        }
+      if (result != NULL)
+        {
+          g_variant_unref(result);
+        }
+    }
+
   if (error == NULL)
     {
       GVariant *result =
@@ -480,7 +506,8 @@ on_timer(gpointer user_data)
   IndicatorWorkrave *self = INDICATOR_WORKRAVE(user_data);
   IndicatorWorkravePrivate *priv = indicator_workrave_get_instance_private(self);
 
-  if (priv->alive && priv->update_count == 0)
+  /* Incremental updates are only sent when a timer changes. */
+  if (priv->alive && priv->update_count == 0 && !priv->incremental_updates)
     {
       workrave_timerbox_set_enabled(priv->timerbox, FALSE);
       workrave_timerbox_set_force_icon(priv->timerbox, FALSE);
@@ -560,6 +587,11 @@ on_dbus_signal(GDBusProxy *proxy, gchar *sender_name, gchar *signal_name, GVaria
       on_update_indicator(self, parameters);
     }
 
+  else if (g_strcmp0(signal_name, "TimerUpdated") == 0)
+    {
+      on_update_timer(self, parameters);
+    }
+
   else if (g_strcmp0(signal_name, "TrayIconUpdated") == 0)
     {
       g_variant_get(parameters, "(b)", &priv->force_icon);
@@ -576,6 +608,22 @@ on_dbus_signal(GDBusProxy *proxy, gchar *sender_name, gchar *signal_name, GVaria
     }
 }
 
+static void
+update_time_bar(IndicatorWorkrave *self, int id, TimerData *td)
+{
+  IndicatorWorkravePrivate *priv = indicator_workrave_get_instance_private(self);
+
+  WorkraveTimebar *timebar = workrave_timerbox_get_time_bar(priv->timerbox, id);
+  if (timebar != NULL)
+    {
+      workrave_timerbox_set_enabled(priv->timerbox, TRUE);
+      workrave_timerbox_set_force_icon(priv->timerbox, priv->force_icon);
+      workrave_timebar_set_progress(timebar, td->bar_primary_val, td->bar_primary_max, td->bar_primary_color);
+      workrave_timebar_set_secondary_progress(timebar, td->bar_secondary_val, td->bar_secondary_max, td->bar_secondary_color);
+      workrave_timebar_set_text(timebar, td->bar_text);
+    }
+}
+
 static void
 on_update_indicator(IndicatorWorkrave *self, GVariant *parameters)
 {
@@ -624,20 +672,49 @@ on_update_indicator(IndicatorWorkrave *self, GVariant *parameters)
 
   for (int i = 0; i < BREAK_ID_SIZEOF; i++)
     {
-      WorkraveTimebar *timebar = workrave_timerbox_get_time_bar(priv->timerbox, i);
-      if (timebar != NULL)
-        {
-          workrave_timerbox_set_enabled(priv->timerbox, TRUE);
-          workrave_timerbox_set_force_icon(priv->timerbox, priv->force_icon);
-          workrave_timebar_set_progress(timebar, td[i].bar_primary_val, td[i].bar_primary_max, td[i].bar_primary_color);
-          workrave_timebar_set_secondary_progress(timebar, td[i].bar_secondary_val, td[i].bar_secondary_max, td[i].bar_secondary_color);
-          workrave_timebar_set_text(timebar, td[i].bar_text);
-        }
+      update_time_bar(self, i, &td[i]);
     }
 
   workrave_timerbox_update(priv->timerbox, priv->image);
 }
 
+static void
+on_update_timer(IndicatorWorkrave *self, GVariant *parameters)
+{
+  IndicatorWorkravePrivate *priv = indicator_workrave_get_instance_private(self);
+
+  if (!priv->alive)
+    {
+      indicator_workrave_start(self);
+    }
+
+  priv->update_count++;
+
+  guint32 id;
+  TimerData td;
+
+  g_variant_get(parameters,
+                "(u(siuuuuuu))",
+                &id,
+                &td.bar_text,
+                &td.slot,
+                &td.bar_secondary_color,
+                &td.bar_secondary_val,
+                &td.bar_secondary_max,
+                &td.bar_primary_color,
+                &td.bar_primary_val,
+                &td.bar_primary_max);
+
+  if (id < BREAK_ID_SIZEOF)
+    {
+      workrave_timerbox_set_slot(priv->timerbox, id, td.slot);
+      update_time_bar(self, id, &td);
+      workrave_timerbox_update(priv->timerbox, priv->image);
+    }
+
+  g_free(td.bar_text);
+}
+
 static void
 on_bus_acquired(GDBusConnection *connection, const gchar *name, gpointer user_data)
 {